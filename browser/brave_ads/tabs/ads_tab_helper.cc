@@ -6,14 +6,16 @@
 #include "brave/browser/brave_ads/tabs/ads_tab_helper.h"
 
 #include <string>
+#include <utility>
 
 #include "brave/browser/brave_ads/ads_service_factory.h"
+#include "brave/components/brave_ads/browser/ads_service.h"
 #include "chrome/browser/profiles/profile.h"
-#include "chrome/common/chrome_isolated_world_ids.h"
 #include "components/sessions/content/session_tab_helper.h"
 #include "content/public/browser/navigation_handle.h"
 #include "content/public/browser/render_frame_host.h"
 #include "content/public/browser/web_contents.h"
+#include "services/service_manager/public/cpp/interface_provider.h"
 #include "ui/base/page_transition_types.h"
 #include "url/gurl.h"
 
@@ -27,10 +29,7 @@ namespace brave_ads {
 
 namespace {
 
-constexpr char16_t kGetDocumentHTMLScript[] =
-    u"new XMLSerializer().serializeToString(document)";
-
-constexpr char16_t kGetInnerTextScript[] = u"document?.body?.innerText";
+constexpr uint32_t kMaxTextSampleLength = 32 * 1024;
 
 }  // namespace
 
@@ -73,49 +72,31 @@ void AdsTabHelper::TabUpdated() {
   ads_service_->NotifyTabDidChange(tab_id_.id(), redirect_chain_, is_visible);
 }
 
-void AdsTabHelper::RunIsolatedJavaScript(
+void AdsTabHelper::ExtractPageSignals(
     content::RenderFrameHost* render_frame_host) {
   CHECK(render_frame_host);
 
-  render_frame_host->ExecuteJavaScriptInIsolatedWorld(
-      kGetDocumentHTMLScript,
-      base::BindOnce(&AdsTabHelper::OnJavaScriptHtmlResult,
-                     weak_factory_.GetWeakPtr()),
-      ISOLATED_WORLD_ID_BRAVE_INTERNAL);
-
-  render_frame_host->ExecuteJavaScriptInIsolatedWorld(
-      kGetInnerTextScript,
-      base::BindOnce(&AdsTabHelper::OnJavaScriptTextResult,
-                     weak_factory_.GetWeakPtr()),
-      ISOLATED_WORLD_ID_BRAVE_INTERNAL);
+  // Rebinding drops the reply for the previous page, if still pending.
+  page_signal_extractor_.reset();
+  render_frame_host->GetRemoteInterfaces()->GetInterface(
+      page_signal_extractor_.BindNewPipeAndPassReceiver());
+  page_signal_extractor_->ExtractPageSignals(
+      kMaxTextSampleLength,
+      base::BindOnce(&AdsTabHelper::OnExtractPageSignals,
+                     weak_factory_.GetWeakPtr()));
 }
 
-void AdsTabHelper::OnJavaScriptHtmlResult(base::Value value) {
-  if (!ads_service_) {
-    return;
-  }
+void AdsTabHelper::OnExtractPageSignals(mojom::PageSignalsPtr page_signals) {
+  page_signal_extractor_.reset();
 
-  if (!value.is_string()) {
+  if (!ads_service_ || !page_signals) {
     return;
   }
 
-  const std::string& html = value.GetString();
   ads_service_->NotifyTabHtmlContentDidChange(tab_id_.id(), redirect_chain_,
-                                              html);
-}
-
-void AdsTabHelper::OnJavaScriptTextResult(base::Value value) {
-  if (!ads_service_) {
-    return;
-  }
-
-  if (!value.is_string()) {
-    return;
-  }
-
-  const std::string& text = value.GetString();
+                                              page_signals->html);
   ads_service_->NotifyTabTextContentDidChange(tab_id_.id(), redirect_chain_,
-                                              text);
+                                              page_signals->text_sample);
 }
 
 void AdsTabHelper::DidFinishNavigation(
@@ -147,14 +128,14 @@ void AdsTabHelper::DidFinishNavigation(
 
   content::RenderFrameHost* render_frame_host =
       navigation_handle->GetRenderFrameHost();
-  RunIsolatedJavaScript(render_frame_host);
+  ExtractPageSignals(render_frame_host);
 }
 
 void AdsTabHelper::DocumentOnLoadCompletedInPrimaryMainFrame() {
   content::RenderFrameHost* render_frame_host =
       web_contents()->GetPrimaryMainFrame();
   if (should_process_) {
-    RunIsolatedJavaScript(render_frame_host);
+    ExtractPageSignals(render_frame_host);
   }
 }
 
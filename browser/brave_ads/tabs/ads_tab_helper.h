@@ -10,11 +10,13 @@
 
 #include "base/memory/raw_ptr.h"
 #include "base/memory/weak_ptr.h"
+#include "brave/components/brave_ads/content/common/page_signal_extractor.mojom.h"
 #include "build/build_config.h"
 #include "components/sessions/core/session_id.h"
 #include "content/public/browser/media_player_id.h"
 #include "content/public/browser/web_contents_observer.h"
 #include "content/public/browser/web_contents_user_data.h"
+#include "mojo/public/cpp/bindings/remote.h"
 
 #if !BUILDFLAG(IS_ANDROID)
 #include "chrome/browser/ui/browser_list_observer.h"  // IWYU pragma: keep
@@ -44,11 +46,9 @@ class AdsTabHelper : public content::WebContentsObserver,
 
   void TabUpdated();
 
-  void RunIsolatedJavaScript(content::RenderFrameHost* render_frame_host);
+  void ExtractPageSignals(content::RenderFrameHost* render_frame_host);
 
-  void OnJavaScriptHtmlResult(base::Value value);
-
-  void OnJavaScriptTextResult(base::Value value);
+  void OnExtractPageSignals(mojom::PageSignalsPtr page_signals);
 
   // content::WebContentsObserver overrides
   void DidFinishNavigation(
@@ -77,6 +77,7 @@ class AdsTabHelper : public content::WebContentsObserver,
   bool is_browser_active_ = true;
   std::vector<GURL> redirect_chain_;
   bool should_process_ = false;
+  mojo::Remote<mojom::PageSignalExtractor> page_signal_extractor_;
 
   base::WeakPtrFactory<AdsTabHelper> weak_factory_;
   WEB_CONTENTS_USER_DATA_KEY_DECL();
@@ -0,0 +1,224 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/callback_list.h"
+#include "base/run_loop.h"
+#include "base/strings/strcat.h"
+#include "base/test/bind.h"
+#include "base/timer/elapsed_timer.h"
+#include "brave/browser/brave_ads/ads_service_factory.h"
+#include "brave/components/brave_ads/browser/ads_service_mock.h"
+#include "brave/components/brave_ads/content/common/page_signal_extractor.mojom.h"
+#include "chrome/browser/ui/browser.h"
+#include "chrome/browser/ui/tabs/tab_strip_model.h"
+#include "chrome/common/chrome_isolated_world_ids.h"
+#include "chrome/test/base/in_process_browser_test.h"
+#include "chrome/test/base/ui_test_utils.h"
+#include "components/keyed_service/content/browser_context_dependency_manager.h"
+#include "components/keyed_service/core/keyed_service.h"
+#include "content/public/browser/render_frame_host.h"
+#include "content/public/browser/web_contents.h"
+#include "content/public/test/browser_test.h"
+#include "content/public/test/browser_test_utils.h"
+#include "mojo/public/cpp/bindings/remote.h"
+#include "net/test/embedded_test_server/embedded_test_server.h"
+#include "net/test/embedded_test_server/http_request.h"
+#include "net/test/embedded_test_server/http_response.h"
+#include "services/service_manager/public/cpp/interface_provider.h"
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "ui/base/window_open_disposition.h"
+#include "url/gurl.h"
+
+// npm run test -- brave_browser_tests --filter=AdsTabHelperTest*
+
+namespace brave_ads {
+
+namespace {
+
+using testing::_;
+using testing::HasSubstr;
+using testing::NiceMock;
+
+constexpr char kLargePagePath[] = "/large_page.html";
+constexpr size_t kLargePageSize = 5 * 1024 * 1024;
+constexpr size_t kMaxTextSampleLength = 32 * 1024;
+
+constexpr char kOgTitle[] = "The quick brown fox";
+constexpr char kConversionIdElement[] = R"(<div id="xyzzy-id">waldo</div>)";
+constexpr char kHiddenConversionIdElement[] =
+    R"(<div id="plugh-id" style="display: none"><span>thud</span></div>)";
+constexpr char kConversionIdMetaTag[] =
+    R"(<meta name="ad-conversion-id" content="fred">)";
+constexpr char kVisibilityHiddenElement[] =
+    R"(<div style="visibility: hidden">corge)"
+    R"(<span style="visibility: visible">grault</span></div>)";
+constexpr char kConversionIdScript[] =
+    R"(<script>window.conversion = {id: "garply"};</script>)";
+
+std::string BuildLargePage() {
+  std::string html = base::StrCat(
+      {"<html><head><meta property=\"og:title\" content=\"", kOgTitle, "\">",
+       kConversionIdMetaTag, "</head><body>", kConversionIdElement,
+       kHiddenConversionIdElement, kVisibilityHiddenElement,
+       kConversionIdScript});
+  while (html.size() < kLargePageSize) {
+    html +=
+        "<div class=\"item\"><p>Lorem ipsum dolor sit amet, consectetur "
+        "adipiscing elit.</p><script>var x = 1;</script></div>";
+  }
+  html += "</body></html>";
+  return html;
+}
+
+std::unique_ptr<net::test_server::HttpResponse> HandleRequest(
+    const net::test_server::HttpRequest& request) {
+  if (request.GetURL().path_piece() != kLargePagePath) {
+    return nullptr;
+  }
+
+  auto http_response = std::make_unique<net::test_server::BasicHttpResponse>();
+  http_response->set_content_type("text/html");
+  http_response->set_content(BuildLargePage());
+  return http_response;
+}
+
+}  // namespace
+
+class AdsTabHelperTest : public InProcessBrowserTest {
+ public:
+  void SetUpInProcessBrowserTestFixture() override {
+    InProcessBrowserTest::SetUpInProcessBrowserTestFixture();
+
+    create_services_subscription_ =
+        BrowserContextDependencyManager::GetInstance()
+            ->RegisterCreateServicesCallbackForTesting(base::BindRepeating(
+                &AdsTabHelperTest::OnWillCreateBrowserContextServices));
+  }
+
+  void SetUpOnMainThread() override {
+    InProcessBrowserTest::SetUpOnMainThread();
+
+    embedded_test_server()->RegisterRequestHandler(
+        base::BindRepeating(&HandleRequest));
+    ASSERT_TRUE(embedded_test_server()->Start());
+  }
+
+  static void OnWillCreateBrowserContextServices(
+      content::BrowserContext* context) {
+    AdsServiceFactory::GetInstance()->SetTestingFactory(
+        context,
+        base::BindRepeating([](content::BrowserContext* /*context*/)
+                                -> std::unique_ptr<KeyedService> {
+          return std::make_unique<NiceMock<AdsServiceMock>>();
+        }));
+  }
+
+  content::WebContents* NavigateToLargePageInNewTab() {
+    EXPECT_TRUE(ui_test_utils::NavigateToURLWithDisposition(
+        browser(), embedded_test_server()->GetURL(kLargePagePath),
+        WindowOpenDisposition::NEW_FOREGROUND_TAB,
+        ui_test_utils::BROWSER_TEST_WAIT_FOR_LOAD_STOP));
+    return browser()->tab_strip_model()->GetActiveWebContents();
+  }
+
+  AdsServiceMock& ads_service() {
+    AdsService* ads_service =
+        AdsServiceFactory::GetForProfile(browser()->profile());
+    CHECK(ads_service);
+    return *static_cast<AdsServiceMock*>(ads_service);
+  }
+
+ private:
+  base::CallbackListSubscription create_services_subscription_;
+};
+
+IN_PROC_BROWSER_TEST_F(AdsTabHelperTest, NotifyContentForLargePage) {
+  std::string html;
+  std::string text;
+  base::RunLoop run_loop;
+  EXPECT_CALL(ads_service(), NotifyTabHtmlContentDidChange(_, _, _))
+      .WillOnce([&html](int32_t, const std::vector<GURL>&,
+                        const std::string& content) { html = content; });
+  EXPECT_CALL(ads_service(), NotifyTabTextContentDidChange(_, _, _))
+      .WillOnce([&text, &run_loop](int32_t, const std::vector<GURL>&,
+                                   const std::string& content) {
+        text = content;
+        run_loop.Quit();
+      });
+
+  NavigateToLargePageInNewTab();
+  run_loop.Run();
+
+  LOG(INFO) << "Notified " << html.size() + text.size()
+            << " bytes of content for a " << kLargePageSize << " byte page";
+  EXPECT_LE(text.size(), kMaxTextSampleLength);
+
+  // Conversion id patterns may match anywhere in the markup.
+  EXPECT_THAT(html, HasSubstr(base::StrCat(
+                        {"<meta property=\"og:title\" content=\"", kOgTitle,
+                         "\">"})));
+  EXPECT_THAT(html, HasSubstr(kConversionIdMetaTag));
+  EXPECT_THAT(html, HasSubstr(kConversionIdElement));
+  EXPECT_THAT(html, HasSubstr(kHiddenConversionIdElement));
+  EXPECT_THAT(html, HasSubstr(kConversionIdScript));
+
+  EXPECT_THAT(text, HasSubstr("Lorem ipsum dolor sit amet"));
+  EXPECT_THAT(text, testing::Not(HasSubstr("var x")));
+  EXPECT_THAT(text, testing::Not(HasSubstr("thud")));
+  EXPECT_THAT(text, testing::Not(HasSubstr("corge")));
+  EXPECT_THAT(text, HasSubstr("grault"));
+}
+
+IN_PROC_BROWSER_TEST_F(AdsTabHelperTest, MeasureRendererTimeForLargePage) {
+  content::WebContents* web_contents = NavigateToLargePageInNewTab();
+  ASSERT_TRUE(web_contents);
+  content::RenderFrameHost* render_frame_host =
+      web_contents->GetPrimaryMainFrame();
+
+  mojo::Remote<mojom::PageSignalExtractor> page_signal_extractor;
+  render_frame_host->GetRemoteInterfaces()->GetInterface(
+      page_signal_extractor.BindNewPipeAndPassReceiver());
+
+  const base::ElapsedTimer extract_timer;
+  mojom::PageSignalsPtr page_signals;
+  base::RunLoop run_loop;
+  page_signal_extractor->ExtractPageSignals(
+      kMaxTextSampleLength,
+      base::BindLambdaForTesting(
+                     [&page_signals, &run_loop](mojom::PageSignalsPtr result) {
+                       page_signals = std::move(result);
+                       run_loop.Quit();
+                     }));
+  run_loop.Run();
+  const base::TimeDelta extract_duration = extract_timer.Elapsed();
+  ASSERT_TRUE(page_signals);
+
+  const size_t extracted_size =
+      page_signals->html.size() + page_signals->text_sample.size();
+
+  // The scripts which were used before the renderer side extractor.
+  const base::ElapsedTimer serialize_timer;
+  const content::EvalJsResult serialized_size = content::EvalJs(
+      web_contents,
+      "new XMLSerializer().serializeToString(document).length + "
+      "document.body.innerText.length",
+      content::EXECUTE_SCRIPT_DEFAULT_OPTIONS,
+      ISOLATED_WORLD_ID_BRAVE_INTERNAL);
+  const base::TimeDelta serialize_duration = serialize_timer.Elapsed();
+
+  LOG(INFO) << "Extracted " << extracted_size << " bytes in "
+            << extract_duration << ", serialized "
+            << serialized_size.ExtractInt() << " characters in "
+            << serialize_duration;
+  EXPECT_LE(page_signals->text_sample.size(), kMaxTextSampleLength);
+}
+
+}  // namespace brave_ads
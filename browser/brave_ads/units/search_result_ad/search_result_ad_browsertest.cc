@@ -5,11 +5,17 @@
 
 #include <memory>
 
+#include "base/files/file_util.h"
+#include "base/functional/bind.h"
+#include "base/functional/callback.h"
 #include "base/path_service.h"
+#include "base/run_loop.h"
 #include "base/strings/strcat.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
+#include "base/task/sequenced_task_runner.h"
 #include "base/test/scoped_feature_list.h"
+#include "base/threading/thread_restrictions.h"
 #include "brave/browser/brave_ads/units/search_result_ad/search_result_ad_tab_helper.h"
 #include "brave/components/brave_ads/browser/ads_service.h"
 #include "brave/components/brave_ads/browser/ads_service_mock.h"
@@ -19,6 +25,7 @@
 #include "brave/components/constants/brave_paths.h"
 #include "chrome/browser/profiles/profile.h"
 #include "chrome/browser/ui/browser.h"
+#include "chrome/common/chrome_isolated_world_ids.h"
 #include "chrome/test/base/in_process_browser_test.h"
 #include "chrome/test/base/testing_profile.h"
 #include "chrome/test/base/ui_test_utils.h"
@@ -51,6 +58,10 @@ constexpr char kTargetDomain[] = "example.com";
 constexpr char kTargetPath[] = "/simple.html";
 constexpr char kSearchResultUrlPath[] =
     "/brave_ads/search_result_ad_sample.html";
+constexpr char kBelowTheFoldSearchResultUrlPath[] =
+    "/brave_ads/search_result_ad_below_the_fold.html";
+constexpr char kBelowTheFoldSpacer[] =
+    R"(<div id="below_the_fold_spacer" style="height: 10000px"></div>)";
 
 SearchResultAdTabHelper* GetSearchResultAdTabHelper(Browser* browser) {
   auto* web_contents = browser->tab_strip_model()->GetActiveWebContents();
@@ -92,9 +103,8 @@ class SearchResultAdTest : public InProcessBrowserTest {
         &SearchResultAdTest::HandleRequest, base::Unretained(this)));
 
     brave::RegisterPathProvider();
-    base::FilePath test_data_dir;
-    base::PathService::Get(brave::DIR_TEST_DATA, &test_data_dir);
-    https_server_->ServeFilesFromDirectory(test_data_dir);
+    base::PathService::Get(brave::DIR_TEST_DATA, &test_data_dir_);
+    https_server_->ServeFilesFromDirectory(test_data_dir_);
     ASSERT_TRUE(https_server_->Start());
   }
 
@@ -129,6 +139,10 @@ class SearchResultAdTest : public InProcessBrowserTest {
     const GURL url = request.GetURL();
     const std::string_view path = url.path_piece();
 
+    if (path == kBelowTheFoldSearchResultUrlPath) {
+      return HandleBelowTheFoldSearchResultRequest();
+    }
+
     if (!base::StartsWith(path, kClickRedirectPath)) {
       return nullptr;
     }
@@ -142,12 +156,37 @@ class SearchResultAdTest : public InProcessBrowserTest {
     return http_response;
   }
 
+  // Serves the sample search result page with the ads pushed below the fold.
+  std::unique_ptr<net::test_server::HttpResponse>
+  HandleBelowTheFoldSearchResultRequest() const {
+    base::ScopedAllowBlockingForTesting allow_blocking;
+    std::string html;
+    if (!base::ReadFileToString(
+            test_data_dir_.AppendASCII("brave_ads")
+                .AppendASCII("search_result_ad_sample.html"),
+            &html)) {
+      return nullptr;
+    }
+
+    const size_t body_pos = html.find("<body");
+    const size_t insert_pos =
+        body_pos == std::string::npos ? 0 : html.find('>', body_pos) + 1;
+    html.insert(insert_pos, kBelowTheFoldSpacer);
+
+    auto http_response =
+        std::make_unique<net::test_server::BasicHttpResponse>();
+    http_response->set_content_type("text/html");
+    http_response->set_content(html);
+    return http_response;
+  }
+
   net::EmbeddedTestServer* https_server() { return https_server_.get(); }
 
   AdsServiceMock* ads_service() { return &ads_service_mock_; }
 
  private:
   base::test::ScopedFeatureList scoped_feature_list_;
+  base::FilePath test_data_dir_;
   content::ContentMockCertVerifier mock_cert_verifier_;
   std::unique_ptr<net::EmbeddedTestServer> https_server_;
   AdsServiceMock ads_service_mock_;
@@ -301,6 +340,42 @@ class SampleSearchResultAdTest : public SearchResultAdTest {
 
     return web_contents;
   }
+
+  // Loads the sample page with the ads below the fold and waits until they are
+  // observed, without triggering any viewed events.
+  content::WebContents* LoadBelowTheFoldSearchResultAdWebPage() {
+    EXPECT_CALL(*ads_service(), TriggerSearchResultAdEvent(_, _, _)).Times(0);
+
+    const GURL url = GetURL(kAllowedDomain, kBelowTheFoldSearchResultUrlPath);
+    EXPECT_TRUE(ui_test_utils::NavigateToURL(browser(), url));
+    content::WebContents* web_contents =
+        browser()->tab_strip_model()->GetActiveWebContents();
+
+    for (int i = 0; i < 500 && !IsObservingSearchResultAds(web_contents);
+         ++i) {
+      base::RunLoop run_loop;
+      base::SequencedTaskRunner::GetCurrentDefault()->PostDelayedTask(
+          FROM_HERE, run_loop.QuitClosure(), base::Milliseconds(10));
+      run_loop.Run();
+    }
+    EXPECT_TRUE(IsObservingSearchResultAds(web_contents));
+
+    // Let the observer process a frame while the ads are below the fold.
+    EXPECT_TRUE(content::EvalJsAfterLifecycleUpdate(web_contents, "", "true")
+                    .ExtractBool());
+    base::RunLoop().RunUntilIdle();
+    Mock::VerifyAndClearExpectations(ads_service());
+
+    return web_contents;
+  }
+
+  static bool IsObservingSearchResultAds(content::WebContents* web_contents) {
+    return content::EvalJs(web_contents,
+                           "!!window.braveSearchResultAdObservers",
+                           content::EXECUTE_SCRIPT_DEFAULT_OPTIONS,
+                           ISOLATED_WORLD_ID_BRAVE_INTERNAL)
+        .ExtractBool();
+  }
 };
 
 IN_PROC_BROWSER_TEST_F(SampleSearchResultAdTest,
@@ -354,4 +429,85 @@ IN_PROC_BROWSER_TEST_F(SampleSearchResultAdTest, SearchResultAdOpenedInNewTab) {
   run_loop.Run();
 }
 
+IN_PROC_BROWSER_TEST_F(SampleSearchResultAdTest,
+                       TriggerViewedEventsWhenScrolledIntoView) {
+  ScopedTestingAdsServiceSetter scoped_setter(ads_service());
+
+  browser()->profile()->GetPrefs()->SetBoolean(brave_rewards::prefs::kEnabled,
+                                               true);
+
+  content::WebContents* web_contents = LoadBelowTheFoldSearchResultAdWebPage();
+
+  auto run_loop1 = std::make_unique<base::RunLoop>();
+  auto run_loop2 = std::make_unique<base::RunLoop>();
+  EXPECT_CALL(
+      *ads_service(),
+      TriggerSearchResultAdEvent(_, mojom::SearchResultAdEventType::kViewed, _))
+      .Times(2)
+      .WillRepeatedly([this, &run_loop1, &run_loop2](
+                          mojom::SearchResultAdInfoPtr ad_mojom,
+                          const mojom::SearchResultAdEventType event_type,
+                          TriggerAdEventCallback callback) {
+        if (CheckSampleSearchAdMetadata(ad_mojom, 1)) {
+          run_loop1->Quit();
+        } else if (CheckSampleSearchAdMetadata(ad_mojom, 2)) {
+          run_loop2->Quit();
+        } else {
+          ADD_FAILURE() << "Unexpected search result ad";
+        }
+      });
+
+  EXPECT_TRUE(content::ExecJs(web_contents,
+                              "document.getElementById('ad_link_1')"
+                              "    .scrollIntoView();"));
+  run_loop1->Run();
+  EXPECT_TRUE(content::ExecJs(web_contents,
+                              "document.getElementById('ad_link_2')"
+                              "    .scrollIntoView();"));
+  run_loop2->Run();
+
+  // Scrolling the ads out of and back into view doesn't trigger them again.
+  EXPECT_TRUE(content::ExecJs(web_contents, "window.scrollTo(0, 0);"));
+  EXPECT_TRUE(content::ExecJs(web_contents,
+                              "document.getElementById('ad_link_1')"
+                              "    .scrollIntoView();"));
+  EXPECT_TRUE(content::EvalJsAfterLifecycleUpdate(web_contents, "", "true")
+                  .ExtractBool());
+  base::RunLoop().RunUntilIdle();
+}
+
+IN_PROC_BROWSER_TEST_F(SampleSearchResultAdTest,
+                       TriggerViewedEventForSearchResultAdAddedAfterLoad) {
+  ScopedTestingAdsServiceSetter scoped_setter(ads_service());
+
+  browser()->profile()->GetPrefs()->SetBoolean(brave_rewards::prefs::kEnabled,
+                                               true);
+
+  content::WebContents* web_contents = LoadBelowTheFoldSearchResultAdWebPage();
+
+  base::RunLoop run_loop;
+  EXPECT_CALL(
+      *ads_service(),
+      TriggerSearchResultAdEvent(_, mojom::SearchResultAdEventType::kViewed, _))
+      .WillOnce([this, &run_loop](
+                    mojom::SearchResultAdInfoPtr ad_mojom,
+                    const mojom::SearchResultAdEventType event_type,
+                    TriggerAdEventCallback callback) {
+        EXPECT_TRUE(CheckSampleSearchAdMetadata(ad_mojom, 1));
+        run_loop.Quit();
+      });
+
+  // Replace the first ad with a copy above the fold. Only the mutation
+  // observer knows about the copy.
+  EXPECT_TRUE(content::ExecJs(web_contents,
+                              R"(
+        const ad = document.getElementById('ad_link_1')
+                       .closest('div[data-placement-id]');
+        const ad_copy = ad.cloneNode(/*deep=*/true);
+        ad.remove();
+        document.body.prepend(ad_copy);
+      )"));
+  run_loop.Run();
+}
+
 }  // namespace brave_ads
@@ -7,20 +7,18 @@
 
 #include <utility>
 
-#include "base/containers/contains.h"
 #include "base/feature_list.h"
-#include "base/strings/utf_string_conversions.h"
 #include "brave/browser/brave_ads/ads_service_factory.h"
 #include "brave/components/brave_ads/browser/ads_service.h"
 #include "brave/components/brave_ads/content/browser/units/search_result_ad/search_result_ad_handler.h"
 #include "brave/components/brave_ads/core/public/ads_feature.h"
 #include "brave/components/brave_rewards/common/pref_names.h"
 #include "brave/components/brave_search/common/brave_search_utils.h"
-#include "chrome/common/chrome_isolated_world_ids.h"
 #include "components/prefs/pref_service.h"
 #include "content/public/browser/browser_context.h"
 #include "content/public/browser/navigation_handle.h"
 #include "content/public/browser/render_frame_host.h"
+#include "services/service_manager/public/cpp/interface_provider.h"
 #include "url/gurl.h"
 
 namespace brave_ads {
@@ -29,18 +27,6 @@ namespace {
 
 AdsService* g_ads_service_for_testing = nullptr;
 
-constexpr char kCheckForAdWithDataPlacementIdVisible[] =
-    R"(
-        (function () {
-          const element = document.querySelector('div[data-placement-id="$1"]');
-          if (!element) {
-            return false;
-          }
-          const style = window.getComputedStyle(element);
-          return style.display !== 'none' && style.visibility !== 'hidden';
-        })()
-    )";
-
 }  // namespace
 
 SearchResultAdTabHelper::SearchResultAdTabHelper(
@@ -109,6 +95,8 @@ void SearchResultAdTabHelper::DidFinishNavigation(
 
   MaybeProcessSearchResultAdClickedEvent(navigation_handle);
 
+  ResetSearchResultAdVisibilityObserver();
+
   if (!ShouldHandleSearchResultAdEvents()) {
     return;
   }
@@ -140,6 +128,7 @@ void SearchResultAdTabHelper::DocumentOnLoadCompletedInPrimaryMainFrame() {
 }
 
 void SearchResultAdTabHelper::WebContentsDestroyed() {
+  ResetSearchResultAdVisibilityObserver();
   search_result_ad_handler_.reset();
 }
 
@@ -186,28 +175,43 @@ void SearchResultAdTabHelper::OnRetrieveSearchResultAd(
     return;
   }
 
-  for (const auto& placement_id : placement_ids) {
-    if (placement_id.empty() || base::Contains(placement_id, '\"')) {
-      continue;
-    }
-    const std::string script = base::ReplaceStringPlaceholders(
-        kCheckForAdWithDataPlacementIdVisible, {placement_id}, nullptr);
-    content::RenderFrameHost* render_frame_host =
-        web_contents()->GetPrimaryMainFrame();
-    render_frame_host->ExecuteJavaScriptInIsolatedWorld(
-        base::ASCIIToUTF16(script),
-        base::BindOnce(
-            &SearchResultAdTabHelper::OnCheckForAdWithDataPlacementIdVisible,
-            weak_factory_.GetWeakPtr(), placement_id),
-        ISOLATED_WORLD_ID_BRAVE_INTERNAL);
+  ResetSearchResultAdVisibilityObserver();
+
+  not_viewed_placement_ids_ =
+      base::flat_set<std::string>(std::move(placement_ids));
+  not_viewed_placement_ids_.erase(std::string());
+  if (not_viewed_placement_ids_.empty()) {
+    return;
   }
+
+  // A single observer reports the ads as they become visible, including those
+  // which are scrolled into view or added to the page later on.
+  content::RenderFrameHost* render_frame_host =
+      web_contents()->GetPrimaryMainFrame();
+  render_frame_host->GetRemoteInterfaces()->GetInterface(
+      search_result_ad_visibility_observer_.BindNewPipeAndPassReceiver());
+  search_result_ad_visibility_observer_->ObserveSearchResultAds(
+      std::vector<std::string>(not_viewed_placement_ids_.cbegin(),
+                               not_viewed_placement_ids_.cend()),
+      search_result_ad_impression_reporter_receiver_
+          .BindNewPipeAndPassRemote());
 }
 
-void SearchResultAdTabHelper::OnCheckForAdWithDataPlacementIdVisible(
-    const std::string& placement_id,
-    base::Value value) {
-  if (ShouldHandleSearchResultAdEvents() && search_result_ad_handler_ &&
-      value.is_bool() && value.GetBool()) {
+void SearchResultAdTabHelper::ResetSearchResultAdVisibilityObserver() {
+  search_result_ad_visibility_observer_.reset();
+  search_result_ad_impression_reporter_receiver_.reset();
+  not_viewed_placement_ids_.clear();
+}
+
+void SearchResultAdTabHelper::ReportSearchResultAdVisible(
+    const std::string& placement_id) {
+  // Only trigger one viewed event per observed ad, whatever the renderer
+  // reports.
+  if (!not_viewed_placement_ids_.erase(placement_id)) {
+    return;
+  }
+
+  if (ShouldHandleSearchResultAdEvents() && search_result_ad_handler_) {
     search_result_ad_handler_->MaybeTriggerSearchResultAdViewedEvent(
         placement_id);
   }
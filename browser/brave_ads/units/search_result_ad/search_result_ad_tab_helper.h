@@ -10,9 +10,13 @@
 #include <string>
 #include <vector>
 
+#include "base/containers/flat_set.h"
 #include "base/memory/weak_ptr.h"
+#include "brave/components/brave_ads/content/common/search_result_ad_visibility_observer.mojom.h"
 #include "content/public/browser/web_contents_observer.h"
 #include "content/public/browser/web_contents_user_data.h"
+#include "mojo/public/cpp/bindings/receiver.h"
+#include "mojo/public/cpp/bindings/remote.h"
 
 class GURL;
 
@@ -27,7 +31,8 @@ class SearchResultAdHandler;
 
 class SearchResultAdTabHelper
     : public content::WebContentsObserver,
-      public content::WebContentsUserData<SearchResultAdTabHelper> {
+      public content::WebContentsUserData<SearchResultAdTabHelper>,
+      public mojom::SearchResultAdImpressionReporter {
  public:
   explicit SearchResultAdTabHelper(content::WebContents* web_contents);
   ~SearchResultAdTabHelper() override;
@@ -62,11 +67,19 @@ class SearchResultAdTabHelper
 
   void OnRetrieveSearchResultAd(std::vector<std::string> placement_ids);
 
-  void OnCheckForAdWithDataPlacementIdVisible(const std::string& placement_id,
-                                              base::Value value);
+  void ResetSearchResultAdVisibilityObserver();
+
+  // mojom::SearchResultAdImpressionReporter:
+  void ReportSearchResultAdVisible(const std::string& placement_id) override;
 
   std::unique_ptr<SearchResultAdHandler> search_result_ad_handler_;
 
+  mojo::Remote<mojom::SearchResultAdVisibilityObserver>
+      search_result_ad_visibility_observer_;
+  mojo::Receiver<mojom::SearchResultAdImpressionReporter>
+      search_result_ad_impression_reporter_receiver_{this};
+  base::flat_set</*placement_id*/ std::string> not_viewed_placement_ids_;
+
   base::WeakPtrFactory<SearchResultAdTabHelper> weak_factory_{this};
 
   WEB_CONTENTS_USER_DATA_KEY_DECL();
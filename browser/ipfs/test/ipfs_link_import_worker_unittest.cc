@@ -0,0 +1,168 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/ipfs/import/ipfs_link_import_worker.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "base/base_paths.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/functional/bind.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/synchronization/lock.h"
+#include "base/test/scoped_path_override.h"
+#include "base/test/test_future.h"
+#include "base/thread_annotations.h"
+#include "base/threading/thread_restrictions.h"
+#include "base/time/time.h"
+#include "brave/components/ipfs/import/imported_data.h"
+#include "content/public/test/browser_task_environment.h"
+#include "net/http/http_status_code.h"
+#include "net/test/embedded_test_server/embedded_test_server.h"
+#include "net/test/embedded_test_server/http_request.h"
+#include "net/test/embedded_test_server/http_response.h"
+#include "services/network/test/test_shared_url_loader_factory.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace ipfs {
+
+namespace {
+
+constexpr char kContentPath[] = "/content/resource.bin";
+constexpr char kPartialContentPath[] = "/content/partial.bin";
+constexpr char kContentHash[] = "QmContentHash";
+constexpr size_t kContentSize = 32 * 1024 * 1024;
+
+}  // namespace
+
+class IpfsLinkImportWorkerTest : public testing::Test {
+ public:
+  IpfsLinkImportWorkerTest()
+      : url_loader_factory_(
+            base::MakeRefCounted<network::TestSharedURLLoaderFactory>()) {}
+
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    temp_dir_override_ = std::make_unique<base::ScopedPathOverride>(
+        base::DIR_TEMP, temp_dir_.GetPath());
+    content_.assign(kContentSize, 'x');
+    test_server_.RegisterRequestHandler(
+        base::BindRepeating(&IpfsLinkImportWorkerTest::HandleRequest,
+                            base::Unretained(this)));
+    ASSERT_TRUE(test_server_.Start());
+  }
+
+  ImportedData Import(const GURL& url) {
+    base::test::TestFuture<const ImportedData&> future;
+    IpfsLinkImportWorker worker(nullptr, url_loader_factory_.get(),
+                                test_server_.base_url(), future.GetCallback(),
+                                url);
+    return future.Take();
+  }
+
+  void SetAddResponseSuffix(const std::string& suffix) {
+    base::AutoLock lock(lock_);
+    add_response_suffix_ = suffix;
+  }
+
+  size_t uploaded_content_size() {
+    base::AutoLock lock(lock_);
+    return uploaded_content_size_;
+  }
+
+  int64_t temp_dir_size_during_add() {
+    base::AutoLock lock(lock_);
+    return temp_dir_size_during_add_;
+  }
+
+ protected:
+  content::BrowserTaskEnvironment task_environment_{
+      content::BrowserTaskEnvironment::IO_MAINLOOP};
+  base::ScopedTempDir temp_dir_;
+  std::unique_ptr<base::ScopedPathOverride> temp_dir_override_;
+  net::EmbeddedTestServer test_server_;
+  scoped_refptr<network::TestSharedURLLoaderFactory> url_loader_factory_;
+  std::string content_;
+
+ private:
+  std::unique_ptr<net::test_server::HttpResponse> HandleRequest(
+      const net::test_server::HttpRequest& request) {
+    auto response = std::make_unique<net::test_server::BasicHttpResponse>();
+    if (request.relative_url == kContentPath) {
+      response->set_content_type("application/octet-stream");
+      response->set_content(content_);
+      return response;
+    }
+    if (request.relative_url == kPartialContentPath) {
+      response->set_code(net::HTTP_PARTIAL_CONTENT);
+      response->set_content_type("application/octet-stream");
+      response->set_content(content_);
+      return response;
+    }
+    if (request.GetURL().path() == "/api/v0/add") {
+      base::ScopedAllowBlockingForTesting allow_blocking;
+      base::AutoLock lock(lock_);
+      // Anything the importer spooled to disk is there by now.
+      temp_dir_size_during_add_ =
+          base::ComputeDirectorySize(temp_dir_.GetPath());
+      if (request.content.find(content_) != std::string::npos)
+        uploaded_content_size_ = content_.size();
+      response->set_content(
+          "{\"Name\":\"resource.bin\",\"Hash\":\"" + std::string(kContentHash) +
+          "\",\"Size\":\"" + base::NumberToString(kContentSize) + "\"}\n" +
+          "{\"Name\":\"\",\"Hash\":\"QmDirectoryHash\",\"Size\":\"1\"}\n" +
+          add_response_suffix_);
+      return response;
+    }
+    if (request.GetURL().path() == "/api/v0/files/mkdir" ||
+        request.GetURL().path() == "/api/v0/files/cp") {
+      return response;
+    }
+    return nullptr;
+  }
+
+  base::Lock lock_;
+  std::string add_response_suffix_ GUARDED_BY(lock_);
+  size_t uploaded_content_size_ GUARDED_BY(lock_) = 0;
+  int64_t temp_dir_size_during_add_ GUARDED_BY(lock_) = -1;
+};
+
+TEST_F(IpfsLinkImportWorkerTest, StreamsLinkedContentWithoutTempFile) {
+  base::TimeTicks start = base::TimeTicks::Now();
+  ImportedData data = Import(test_server_.GetURL(kContentPath));
+  LOG(INFO) << "Imported " << kContentSize << " bytes in "
+            << (base::TimeTicks::Now() - start).InMilliseconds() << " ms";
+
+  EXPECT_EQ(data.state, IPFS_IMPORT_SUCCESS);
+  EXPECT_EQ(data.hash, kContentHash);
+  EXPECT_EQ(data.size, static_cast<int64_t>(kContentSize));
+  EXPECT_EQ(data.filename, "resource.bin");
+  EXPECT_EQ(uploaded_content_size(), kContentSize);
+  LOG(INFO) << "Temp dir size during add: " << temp_dir_size_during_add();
+  EXPECT_EQ(temp_dir_size_during_add(), 0);
+}
+
+TEST_F(IpfsLinkImportWorkerTest, FailsOnMissingContent) {
+  ImportedData data = Import(test_server_.GetURL("/content/missing.bin"));
+  EXPECT_EQ(data.state, IPFS_IMPORT_ERROR_REQUEST_EMPTY);
+  EXPECT_EQ(uploaded_content_size(), 0u);
+}
+
+TEST_F(IpfsLinkImportWorkerTest, FailsOnNonOkSuccessResponse) {
+  ImportedData data = Import(test_server_.GetURL(kPartialContentPath));
+  EXPECT_EQ(data.state, IPFS_IMPORT_ERROR_REQUEST_EMPTY);
+  EXPECT_EQ(uploaded_content_size(), 0u);
+}
+
+TEST_F(IpfsLinkImportWorkerTest, RejectsOversizedAddResponseLine) {
+  SetAddResponseSuffix(std::string(1024 * 1024, 'a'));
+  ImportedData data = Import(test_server_.GetURL(kContentPath));
+  EXPECT_EQ(data.state, IPFS_IMPORT_ERROR_ADD_FAILED);
+}
+
+}  // namespace ipfs
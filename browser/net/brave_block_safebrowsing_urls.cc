@@ -5,8 +5,8 @@
 
 #include "brave/browser/net/brave_block_safebrowsing_urls.h"
 
-#include <vector>
-
+#include "base/no_destructor.h"
+#include "brave/browser/net/host_keyed_url_pattern_set.h"
 #include "extensions/common/url_pattern.h"
 #include "net/base/net_errors.h"
 #include "url/gurl.h"
@@ -15,34 +15,67 @@ namespace brave {
 
 const char kDummyUrl[] = "https://no-thanks.invalid";
 
-bool IsSafeBrowsingReportingURL(const GURL& gurl) {
-  static const std::vector<URLPattern> allowed_patterns({
+namespace {
+
+enum SafeBrowsingPattern : size_t {
+  // Allowed, even though they fall under the reporting patterns.
+  kDownloadReportPattern,
+  kCrxListInfoPattern,
+  // Reporting.
+  kSbSslClientReportPattern,
+  kClientReportPattern,
+  kReportPattern,
+  kUploadsPattern,
+};
+
+HostKeyedURLPatternSet BuildSafeBrowsingPatterns() {
+  HostKeyedURLPatternSet patterns;
+  patterns.Add(
+      kDownloadReportPattern,
       URLPattern(
           URLPattern::SCHEME_HTTPS,
-          "https://sb-ssl.google.com/safebrowsing/clientreport/download*"),
+          "https://sb-ssl.google.com/safebrowsing/clientreport/download*"));
+  patterns.Add(kCrxListInfoPattern,
+               URLPattern(URLPattern::SCHEME_HTTPS,
+                          "https://safebrowsing.google.com/safebrowsing/"
+                          "clientreport/crx-list-info*"));
+  patterns.Add(
+      kSbSslClientReportPattern,
       URLPattern(URLPattern::SCHEME_HTTPS,
-                 "https://safebrowsing.google.com/safebrowsing/clientreport/"
-                 "crx-list-info*"),
-  });
-  static const std::vector<URLPattern> reporting_patterns({
+                 "https://sb-ssl.google.com/safebrowsing/clientreport/*"));
+  patterns.Add(kClientReportPattern,
+               URLPattern(URLPattern::SCHEME_HTTPS,
+                          "https://safebrowsing.google.com/safebrowsing/"
+                          "clientreport/*"));
+  patterns.Add(kReportPattern,
+               URLPattern(URLPattern::SCHEME_HTTPS,
+                          "https://safebrowsing.google.com/safebrowsing/"
+                          "report*"));
+  patterns.Add(
+      kUploadsPattern,
       URLPattern(URLPattern::SCHEME_HTTPS,
-                 "https://sb-ssl.google.com/safebrowsing/clientreport/*"),
-      URLPattern(URLPattern::SCHEME_HTTPS,
-                 "https://safebrowsing.google.com/safebrowsing/clientreport/*"),
-      URLPattern(URLPattern::SCHEME_HTTPS,
-                 "https://safebrowsing.google.com/safebrowsing/report*"),
-      URLPattern(URLPattern::SCHEME_HTTPS,
-                 "https://safebrowsing.google.com/safebrowsing/uploads/*"),
-  });
+                 "https://safebrowsing.google.com/safebrowsing/uploads/*"));
+  return patterns;
+}
 
-  if (std::any_of(
-          allowed_patterns.begin(), allowed_patterns.end(),
-          [&gurl](URLPattern pattern) { return pattern.MatchesURL(gurl); })) {
+const HostKeyedURLPatternSet& GetSafeBrowsingPatterns() {
+  static const base::NoDestructor<HostKeyedURLPatternSet> patterns(
+      BuildSafeBrowsingPatterns());
+  return *patterns;
+}
+
+}  // namespace
+
+const HostKeyedURLPatternSet& GetSafeBrowsingPatternsForTesting() {
+  return GetSafeBrowsingPatterns();
+}
+
+bool IsSafeBrowsingReportingURL(const GURL& gurl) {
+  const auto matches = GetSafeBrowsingPatterns().Match(gurl);
+  if (matches[kDownloadReportPattern] || matches[kCrxListInfoPattern])
     return false;
-  }
-  return std::any_of(
-      reporting_patterns.begin(), reporting_patterns.end(),
-      [&gurl](URLPattern pattern) { return pattern.MatchesURL(gurl); });
+  return matches[kSbSslClientReportPattern] || matches[kClientReportPattern] ||
+         matches[kReportPattern] || matches[kUploadsPattern];
 }
 
 int OnBeforeURLRequest_BlockSafeBrowsingReportingURLs(const GURL& request_url,
@@ -10,9 +10,13 @@ class GURL;
 
 namespace brave {
 
+class HostKeyedURLPatternSet;
+
 int OnBeforeURLRequest_BlockSafeBrowsingReportingURLs(const GURL& url,
                                                       GURL* new_url);
 
+const HostKeyedURLPatternSet& GetSafeBrowsingPatternsForTesting();
+
 }  // namespace brave
 
 #endif  // BRAVE_BROWSER_NET_BRAVE_BLOCK_SAFEBROWSING_URLS_H_
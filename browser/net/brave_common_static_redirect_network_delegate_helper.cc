@@ -8,8 +8,10 @@
 #include <memory>
 #include <string>
 
+#include "base/no_destructor.h"
 #include "base/strings/string_split.h"
 #include "base/strings/string_util.h"
+#include "brave/browser/net/host_keyed_url_pattern_set.h"
 #include "brave/components/constants/network_constants.h"
 #include "extensions/common/url_pattern.h"
 #include "net/base/net_errors.h"
@@ -18,6 +20,33 @@ namespace brave {
 
 namespace {
 
+enum CommonStaticRedirectPattern : size_t {
+  kChromeCastPattern,
+  kClients4Pattern,
+  kBugsChromiumPattern,
+};
+
+HostKeyedURLPatternSet BuildCommonStaticRedirectPatterns() {
+  constexpr int kHttpAndHttps =
+      URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS;
+
+  HostKeyedURLPatternSet patterns;
+  patterns.Add(kChromeCastPattern,
+               URLPattern(kHttpAndHttps, kChromeCastPrefix));
+  patterns.Add(kClients4Pattern, URLPattern(kHttpAndHttps, kClients4Prefix),
+               HostKeyedURLPatternSet::MatchType::kHost);
+  patterns.Add(kBugsChromiumPattern,
+               URLPattern(kHttpAndHttps,
+                          "*://bugs.chromium.org/p/chromium/issues/entry?*"));
+  return patterns;
+}
+
+const HostKeyedURLPatternSet& GetCommonStaticRedirectPatterns() {
+  static const base::NoDestructor<HostKeyedURLPatternSet> patterns(
+      BuildCommonStaticRedirectPatterns());
+  return *patterns;
+}
+
 bool RewriteBugReportingURL(const GURL& request_url, GURL* new_url) {
   GURL url("https://github.com/brave/brave-browser/issues/new");
   std::string query = "title=Crash%20Report&labels=crash";
@@ -61,30 +90,26 @@ int OnBeforeURLRequest_CommonStaticRedirectWorkForGURL(
     GURL* new_url) {
   DCHECK(new_url);
 
+  const auto matches = GetCommonStaticRedirectPatterns().Match(request_url);
+  if (matches.none())
+    return net::OK;
+
   GURL::Replacements replacements;
-  static URLPattern chromecast_pattern(
-      URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS, kChromeCastPrefix);
-  static URLPattern clients4_pattern(
-      URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS, kClients4Prefix);
-  static URLPattern bugsChromium_pattern(
-      URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS,
-      "*://bugs.chromium.org/p/chromium/issues/entry?*");
-
-  if (chromecast_pattern.MatchesURL(request_url)) {
+  if (matches[kChromeCastPattern]) {
     replacements.SetSchemeStr("https");
     replacements.SetHostStr(kBraveRedirectorProxy);
     *new_url = request_url.ReplaceComponents(replacements);
     return net::OK;
   }
 
-  if (clients4_pattern.MatchesHost(request_url)) {
+  if (matches[kClients4Pattern]) {
     replacements.SetSchemeStr("https");
     replacements.SetHostStr(kBraveClients4Proxy);
     *new_url = request_url.ReplaceComponents(replacements);
     return net::OK;
   }
 
-  if (bugsChromium_pattern.MatchesURL(request_url)) {
+  if (matches[kBugsChromiumPattern]) {
     if (RewriteBugReportingURL(request_url, new_url))
       return net::OK;
   }
@@ -92,5 +117,8 @@ int OnBeforeURLRequest_CommonStaticRedirectWorkForGURL(
   return net::OK;
 }
 
+const HostKeyedURLPatternSet& GetCommonStaticRedirectPatternsForTesting() {
+  return GetCommonStaticRedirectPatterns();
+}
 
 }  // namespace brave
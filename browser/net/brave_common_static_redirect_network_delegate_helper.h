@@ -14,6 +14,8 @@ class GURL;
 
 namespace brave {
 
+class HostKeyedURLPatternSet;
+
 int OnBeforeURLRequest_CommonStaticRedirectWork(
     const ResponseCallback& next_callback,
     std::shared_ptr<BraveRequestInfo> ctx);
@@ -22,6 +24,8 @@ int OnBeforeURLRequest_CommonStaticRedirectWorkForGURL(
     const GURL& url,
     GURL* new_url);
 
+const HostKeyedURLPatternSet& GetCommonStaticRedirectPatternsForTesting();
+
 }  // namespace brave
 
 #endif  // BRAVE_BROWSER_NET_BRAVE_COMMON_STATIC_REDIRECT_NETWORK_DELEGATE_HELPER_H_
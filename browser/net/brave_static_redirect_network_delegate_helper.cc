@@ -11,7 +11,9 @@
 #include <string_view>
 #include <vector>
 
+#include "base/no_destructor.h"
 #include "brave/browser/net/brave_geolocation_buildflags.h"
+#include "brave/browser/net/host_keyed_url_pattern_set.h"
 #include "brave/browser/safebrowsing/buildflags.h"
 #include "brave/components/constants/network_constants.h"
 #include "brave/components/widevine/static_buildflags.h"
@@ -26,6 +28,75 @@ namespace {
 
 bool g_safebrowsing_api_endpoint_for_testing_ = false;
 
+// To-Do (@jumde) - Update the naming for the patterns below
+// https://github.com/brave/brave-browser/issues/10314
+enum StaticRedirectPattern : size_t {
+  kGeoPattern,
+  kSafeBrowsingPattern,
+  kSafeBrowsingFileCheckPattern,
+  kSafeBrowsingCrxListPattern,
+  kCRLSetPattern1,
+  kCRLSetPattern2,
+  kCRLSetPattern3,
+  kCRLSetPattern4,
+  kCRXDownloadPattern,
+  kAutofillPattern,
+  kGvt1Pattern,
+  kGoogleDlPattern,
+  kWidevineGvt1Pattern,
+  kWidevineGoogleDlPattern,
+  kWidevineGoogleDlWinArm64Pattern,
+};
+
+HostKeyedURLPatternSet BuildStaticRedirectPatterns() {
+  constexpr int kHttpAndHttps =
+      URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS;
+  using MatchType = HostKeyedURLPatternSet::MatchType;
+
+  HostKeyedURLPatternSet patterns;
+  patterns.Add(kGeoPattern,
+               URLPattern(URLPattern::SCHEME_HTTPS, kGeoLocationsPattern));
+  patterns.Add(kSafeBrowsingPattern,
+               URLPattern(URLPattern::SCHEME_HTTPS, kSafeBrowsingPrefix),
+               MatchType::kHost);
+  patterns.Add(
+      kSafeBrowsingFileCheckPattern,
+      URLPattern(URLPattern::SCHEME_HTTPS, kSafeBrowsingFileCheckPrefix),
+      MatchType::kHost);
+  patterns.Add(kSafeBrowsingCrxListPattern,
+               URLPattern(URLPattern::SCHEME_HTTPS, kSafeBrowsingCrxListPrefix),
+               MatchType::kHost);
+  patterns.Add(kCRLSetPattern1, URLPattern(kHttpAndHttps, kCRLSetPrefix1));
+  patterns.Add(kCRLSetPattern2, URLPattern(kHttpAndHttps, kCRLSetPrefix2));
+  patterns.Add(kCRLSetPattern3, URLPattern(kHttpAndHttps, kCRLSetPrefix3));
+  patterns.Add(kCRLSetPattern4, URLPattern(kHttpAndHttps, kCRLSetPrefix4));
+  patterns.Add(kCRXDownloadPattern,
+               URLPattern(kHttpAndHttps, kCRXDownloadPrefix));
+  patterns.Add(kAutofillPattern,
+               URLPattern(URLPattern::SCHEME_HTTPS, kAutofillPrefix));
+  patterns.Add(kGvt1Pattern, URLPattern(kHttpAndHttps, "*://*.gvt1.com/*"));
+  patterns.Add(kGoogleDlPattern,
+               URLPattern(kHttpAndHttps, "*://dl.google.com/*"));
+  patterns.Add(kWidevineGvt1Pattern,
+               URLPattern(kHttpAndHttps, kWidevineGvt1Prefix));
+  patterns.Add(kWidevineGoogleDlPattern,
+               URLPattern(kHttpAndHttps, kWidevineGoogleDlPrefix));
+#if BUILDFLAG(WIDEVINE_ARM64_DLL_FIX)
+  patterns.Add(
+      kWidevineGoogleDlWinArm64Pattern,
+      URLPattern(URLPattern::SCHEME_HTTPS, kWidevineGoogleDlPrefixWinArm64));
+#endif  // BUILDFLAG(WIDEVINE_ARM64_DLL_FIX)
+  return patterns;
+}
+
+// Nearly every request matches none of these, which then costs a single
+// lookup instead of testing each pattern.
+const HostKeyedURLPatternSet& GetStaticRedirectPatterns() {
+  static const base::NoDestructor<HostKeyedURLPatternSet> patterns(
+      BuildStaticRedirectPatterns());
+  return *patterns;
+}
+
 std::string_view GetSafeBrowsingEndpoint() {
   if (g_safebrowsing_api_endpoint_for_testing_)
     return kSafeBrowsingTestingEndpoint;
@@ -38,6 +109,10 @@ void SetSafeBrowsingEndpointForTesting(bool testing) {
   g_safebrowsing_api_endpoint_for_testing_ = testing;
 }
 
+const HostKeyedURLPatternSet& GetStaticRedirectPatternsForTesting() {
+  return GetStaticRedirectPatterns();
+}
+
 int OnBeforeURLRequest_StaticRedirectWork(
     const ResponseCallback& next_callback,
     std::shared_ptr<BraveRequestInfo> ctx) {
@@ -53,127 +128,88 @@ int OnBeforeURLRequest_StaticRedirectWork(
 int OnBeforeURLRequest_StaticRedirectWorkForGURL(
     const GURL& request_url,
     GURL* new_url) {
-  GURL::Replacements replacements;
-  static URLPattern geo_pattern(URLPattern::SCHEME_HTTPS, kGeoLocationsPattern);
-  static URLPattern safeBrowsing_pattern(URLPattern::SCHEME_HTTPS,
-                                         kSafeBrowsingPrefix);
-  static URLPattern safebrowsingfilecheck_pattern(URLPattern::SCHEME_HTTPS,
-                                                  kSafeBrowsingFileCheckPrefix);
-  static URLPattern safebrowsingcrxlist_pattern(URLPattern::SCHEME_HTTPS,
-                                                kSafeBrowsingCrxListPrefix);
-
-  // To-Do (@jumde) - Update the naming for the variables below
-  // https://github.com/brave/brave-browser/issues/10314
-  static URLPattern crlSet_pattern1(
-      URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS, kCRLSetPrefix1);
-  static URLPattern crlSet_pattern2(
-      URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS, kCRLSetPrefix2);
-  static URLPattern crlSet_pattern3(
-      URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS, kCRLSetPrefix3);
-  static URLPattern crlSet_pattern4(
-      URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS, kCRLSetPrefix4);
-  static URLPattern crxDownload_pattern(
-      URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS, kCRXDownloadPrefix);
-  static URLPattern autofill_pattern(
-      URLPattern::SCHEME_HTTPS, kAutofillPrefix);
-  static URLPattern gvt1_pattern(
-      URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS, "*://*.gvt1.com/*");
-  static URLPattern googleDl_pattern(
-      URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS,
-      "*://dl.google.com/*");
-
-  static URLPattern widevine_gvt1_pattern(
-      URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS,
-      kWidevineGvt1Prefix);
-  static URLPattern widevine_google_dl_pattern(
-      URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS,
-      kWidevineGoogleDlPrefix);
-#if BUILDFLAG(WIDEVINE_ARM64_DLL_FIX)
-  static URLPattern widevine_google_dl_pattern_win_arm64(
-      URLPattern::SCHEME_HTTPS, kWidevineGoogleDlPrefixWinArm64);
-#endif  // BUILDFLAG(WIDEVINE_ARM64_DLL_FIX)
+  const auto matches = GetStaticRedirectPatterns().Match(request_url);
+  if (matches.none())
+    return net::OK;
 
-  if (geo_pattern.MatchesURL(request_url)) {
+  GURL::Replacements replacements;
+  if (matches[kGeoPattern]) {
     *new_url = GURL(BUILDFLAG(GOOGLEAPIS_URL));
     return net::OK;
   }
 
   auto safebrowsing_endpoint = GetSafeBrowsingEndpoint();
-  if (!safebrowsing_endpoint.empty() &&
-      safeBrowsing_pattern.MatchesHost(request_url)) {
+  if (!safebrowsing_endpoint.empty() && matches[kSafeBrowsingPattern]) {
     replacements.SetHostStr(safebrowsing_endpoint);
     *new_url = request_url.ReplaceComponents(replacements);
     return net::OK;
   }
 
   if (!safebrowsing_endpoint.empty() &&
-      safebrowsingfilecheck_pattern.MatchesHost(request_url)) {
+      matches[kSafeBrowsingFileCheckPattern]) {
     replacements.SetHostStr(kBraveSafeBrowsingSslProxy);
     *new_url = request_url.ReplaceComponents(replacements);
     return net::OK;
   }
 
   if (!safebrowsing_endpoint.empty() &&
-      safebrowsingcrxlist_pattern.MatchesHost(request_url)) {
+      matches[kSafeBrowsingCrxListPattern]) {
     replacements.SetHostStr(kBraveSafeBrowsing2Proxy);
     *new_url = request_url.ReplaceComponents(replacements);
     return net::OK;
   }
 
-  if (crxDownload_pattern.MatchesURL(request_url)) {
+  if (matches[kCRXDownloadPattern]) {
     replacements.SetSchemeStr("https");
     replacements.SetHostStr("crxdownload.brave.com");
     *new_url = request_url.ReplaceComponents(replacements);
     return net::OK;
   }
 
-  if (autofill_pattern.MatchesURL(request_url)) {
+  if (matches[kAutofillPattern]) {
     replacements.SetSchemeStr("https");
     replacements.SetHostStr(kBraveStaticProxy);
     *new_url = request_url.ReplaceComponents(replacements);
     return net::OK;
   }
 
-  if (crlSet_pattern1.MatchesURL(request_url)) {
+  if (matches[kCRLSetPattern1]) {
     replacements.SetSchemeStr("https");
     replacements.SetHostStr("redirector.brave.com");
     *new_url = request_url.ReplaceComponents(replacements);
     return net::OK;
   }
 
-  if (crlSet_pattern2.MatchesURL(request_url)) {
+  if (matches[kCRLSetPattern2]) {
     replacements.SetSchemeStr("https");
     replacements.SetHostStr("redirector.brave.com");
     *new_url = request_url.ReplaceComponents(replacements);
     return net::OK;
   }
 
-  if (crlSet_pattern3.MatchesURL(request_url)) {
+  if (matches[kCRLSetPattern3]) {
     replacements.SetSchemeStr("https");
     replacements.SetHostStr("redirector.brave.com");
     *new_url = request_url.ReplaceComponents(replacements);
     return net::OK;
   }
 
-  if (crlSet_pattern4.MatchesURL(request_url)) {
+  if (matches[kCRLSetPattern4]) {
     replacements.SetSchemeStr("https");
     replacements.SetHostStr("redirector.brave.com");
     *new_url = request_url.ReplaceComponents(replacements);
     return net::OK;
   }
-  if (gvt1_pattern.MatchesURL(request_url) &&
-      !widevine_gvt1_pattern.MatchesURL(request_url)) {
+  if (matches[kGvt1Pattern] && !matches[kWidevineGvt1Pattern]) {
     replacements.SetSchemeStr("https");
     replacements.SetHostStr(kBraveRedirectorProxy);
     *new_url = request_url.ReplaceComponents(replacements);
     return net::OK;
   }
 
-  if (googleDl_pattern.MatchesURL(request_url) &&
-#if BUILDFLAG(WIDEVINE_ARM64_DLL_FIX)
-      !widevine_google_dl_pattern_win_arm64.MatchesURL(request_url) &&
-#endif
-      !widevine_google_dl_pattern.MatchesURL(request_url)) {
+  if (matches[kGoogleDlPattern] &&
+      !matches[kWidevineGoogleDlWinArm64Pattern] &&
+      !matches[kWidevineGoogleDlPattern]) {
     replacements.SetSchemeStr("https");
     replacements.SetHostStr(kBraveRedirectorProxy);
     *new_url = request_url.ReplaceComponents(replacements);
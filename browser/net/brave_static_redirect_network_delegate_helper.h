@@ -15,6 +15,8 @@ struct BraveRequestInfo;
 
 namespace brave {
 
+class HostKeyedURLPatternSet;
+
 extern const char kSafeBrowsingTestingEndpoint[];
 
 int OnBeforeURLRequest_StaticRedirectWork(
@@ -27,6 +29,8 @@ int OnBeforeURLRequest_StaticRedirectWorkForGURL(
 
 void SetSafeBrowsingEndpointForTesting(bool testing);
 
+const HostKeyedURLPatternSet& GetStaticRedirectPatternsForTesting();
+
 }  // namespace brave
 
 #endif  // BRAVE_BROWSER_NET_BRAVE_STATIC_REDIRECT_NETWORK_DELEGATE_HELPER_H_
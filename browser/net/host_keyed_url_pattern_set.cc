@@ -0,0 +1,142 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/net/host_keyed_url_pattern_set.h"
+
+#include <utility>
+
+#include "base/check_op.h"
+#include "base/strings/string_util.h"
+#include "url/gurl.h"
+
+namespace brave {
+
+namespace {
+
+// Returns the last two labels of |host|, ignoring a trailing dot. Any host
+// matched by a pattern for "a.b.c" or "*.b.c" shares the key "b.c" with it.
+std::string_view GetHostKey(std::string_view host) {
+  if (base::EndsWith(host, "."))
+    host.remove_suffix(1);
+  size_t last_dot = host.rfind('.');
+  if (last_dot == std::string_view::npos || last_dot == 0)
+    return host;
+  size_t key_start = host.rfind('.', last_dot - 1);
+  if (key_start == std::string_view::npos)
+    return host;
+  return host.substr(key_start + 1);
+}
+
+// Returns the literal start of the pattern's path. The trailing slash is
+// dropped because "/foo/*" also matches "/foo".
+std::string GetPathPrefix(const URLPattern& pattern) {
+  std::string_view path = pattern.path();
+  path = path.substr(0, path.find_first_of("*\\"));
+  if (base::EndsWith(path, "/"))
+    path.remove_suffix(1);
+  return std::string(path);
+}
+
+}  // namespace
+
+HostKeyedURLPatternSet::Entry::Entry(size_t id,
+                                     const URLPattern& pattern,
+                                     MatchType match_type)
+    : id(id),
+      pattern(pattern),
+      match_type(match_type),
+      path_prefix(match_type == MatchType::kURL ? GetPathPrefix(pattern)
+                                                : std::string()) {}
+
+HostKeyedURLPatternSet::Entry::Entry(const Entry&) = default;
+HostKeyedURLPatternSet::Entry& HostKeyedURLPatternSet::Entry::operator=(
+    const Entry&) = default;
+HostKeyedURLPatternSet::Entry::~Entry() = default;
+
+HostKeyedURLPatternSet::HostKeyedURLPatternSet() = default;
+HostKeyedURLPatternSet::~HostKeyedURLPatternSet() = default;
+
+HostKeyedURLPatternSet::HostKeyedURLPatternSet(HostKeyedURLPatternSet&&) =
+    default;
+HostKeyedURLPatternSet& HostKeyedURLPatternSet::operator=(
+    HostKeyedURLPatternSet&&) = default;
+
+void HostKeyedURLPatternSet::Add(size_t id,
+                                 const URLPattern& pattern,
+                                 MatchType match_type) {
+  DCHECK_LT(id, kMaxPatterns);
+  DCHECK(!ids_[id]);
+  ids_.set(id);
+
+  Entry entry(id, pattern, match_type);
+  std::string_view host = pattern.host();
+  // A single label can't be keyed: "*.localhost" matches "a.localhost",
+  // whose key is "a.localhost".
+  if (pattern.match_all_urls() ||
+      host.find('.') == std::string_view::npos) {
+    unkeyed_entries_.push_back(std::move(entry));
+    return;
+  }
+  entries_by_host_key_[std::string(GetHostKey(host))].push_back(
+      std::move(entry));
+}
+
+HostKeyedURLPatternSet::Matches HostKeyedURLPatternSet::Match(
+    const GURL& url) const {
+  Matches matches;
+  for (const auto& entry : unkeyed_entries_) {
+    if (EntryMatches(entry, url))
+      matches.set(entry.id);
+  }
+  MatchHostKey(url.host_piece(), url, &matches);
+  // URLPattern looks at the inner URL of filesystem: URLs.
+  if (url.inner_url() && url.inner_url()->host_piece() != url.host_piece())
+    MatchHostKey(url.inner_url()->host_piece(), url, &matches);
+  return matches;
+}
+
+HostKeyedURLPatternSet::Matches HostKeyedURLPatternSet::MatchEachForTesting(
+    const GURL& url) const {
+  Matches matches;
+  auto match_each = [&url, &matches](const std::vector<Entry>& entries) {
+    for (const auto& entry : entries) {
+      if (entry.match_type == MatchType::kHost
+              ? entry.pattern.MatchesHost(url)
+              : entry.pattern.MatchesURL(url)) {
+        matches.set(entry.id);
+      }
+    }
+  };
+  match_each(unkeyed_entries_);
+  for (const auto& [key, entries] : entries_by_host_key_)
+    match_each(entries);
+  return matches;
+}
+
+// static
+bool HostKeyedURLPatternSet::EntryMatches(const Entry& entry,
+                                          const GURL& url) {
+  if (entry.match_type == MatchType::kHost)
+    return entry.pattern.MatchesHost(url);
+  if (!url.inner_url() &&
+      !base::StartsWith(url.PathForRequestPiece(), entry.path_prefix)) {
+    return false;
+  }
+  return entry.pattern.MatchesURL(url);
+}
+
+void HostKeyedURLPatternSet::MatchHostKey(std::string_view host,
+                                          const GURL& url,
+                                          Matches* matches) const {
+  auto it = entries_by_host_key_.find(GetHostKey(host));
+  if (it == entries_by_host_key_.end())
+    return;
+  for (const auto& entry : it->second) {
+    if (EntryMatches(entry, url))
+      matches->set(entry.id);
+  }
+}
+
+}  // namespace brave
@@ -0,0 +1,85 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_BROWSER_NET_HOST_KEYED_URL_PATTERN_SET_H_
+#define BRAVE_BROWSER_NET_HOST_KEYED_URL_PATTERN_SET_H_
+
+#include <bitset>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "base/containers/flat_map.h"
+#include "extensions/common/url_pattern.h"
+
+class GURL;
+
+namespace brave {
+
+// A fixed set of URLPatterns that tells which of them match a URL without
+// testing each one. Patterns are bucketed by the last two labels of their
+// host (the registrable domain for every host we redirect or block), so a
+// URL that no pattern can match costs a single lookup. Candidates in the
+// bucket are checked against their literal path prefix and then verified
+// with the pattern itself, which keeps results identical to URLPattern.
+class HostKeyedURLPatternSet {
+ public:
+  static constexpr size_t kMaxPatterns = 32;
+  using Matches = std::bitset<kMaxPatterns>;
+
+  enum class MatchType {
+    // URLPattern::MatchesURL().
+    kURL,
+    // URLPattern::MatchesHost(), ignoring scheme and path.
+    kHost,
+  };
+
+  HostKeyedURLPatternSet();
+  ~HostKeyedURLPatternSet();
+
+  HostKeyedURLPatternSet(HostKeyedURLPatternSet&&);
+  HostKeyedURLPatternSet& operator=(HostKeyedURLPatternSet&&);
+
+  // Adds |pattern| as |id|, which must be unique and below kMaxPatterns.
+  void Add(size_t id,
+           const URLPattern& pattern,
+           MatchType match_type = MatchType::kURL);
+
+  // Returns a bit set for the id of every pattern that matches |url|.
+  Matches Match(const GURL& url) const;
+
+  // Tests every pattern in turn, as a reference for Match().
+  Matches MatchEachForTesting(const GURL& url) const;
+
+ private:
+  struct Entry {
+    Entry(size_t id, const URLPattern& pattern, MatchType match_type);
+    Entry(const Entry&);
+    Entry& operator=(const Entry&);
+    ~Entry();
+
+    size_t id;
+    URLPattern pattern;
+    MatchType match_type;
+    // Every path a kURL pattern matches starts with this.
+    std::string path_prefix;
+  };
+
+  static bool EntryMatches(const Entry& entry, const GURL& url);
+  void MatchHostKey(std::string_view host,
+                    const GURL& url,
+                    Matches* matches) const;
+
+  base::flat_map<std::string, std::vector<Entry>, std::less<>>
+      entries_by_host_key_;
+  // Patterns whose host can't be keyed, e.g. "*://*/*". Always tested.
+  std::vector<Entry> unkeyed_entries_;
+  Matches ids_;
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_BROWSER_NET_HOST_KEYED_URL_PATTERN_SET_H_
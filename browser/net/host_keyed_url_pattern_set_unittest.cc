@@ -0,0 +1,175 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/net/host_keyed_url_pattern_set.h"
+
+#include <vector>
+
+#include "base/time/time.h"
+#include "brave/browser/net/brave_block_safebrowsing_urls.h"
+#include "brave/browser/net/brave_common_static_redirect_network_delegate_helper.h"
+#include "brave/browser/net/brave_static_redirect_network_delegate_helper.h"
+#include "extensions/common/url_pattern.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace brave {
+
+namespace {
+
+constexpr int kHttpAndHttps =
+    URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS;
+
+// Requests seen while browsing a few popular sites, plus the component and
+// safe browsing traffic the static helpers rewrite.
+std::vector<GURL> GetURLCorpus() {
+  return {
+      GURL("https://www.google.com/search?q=brave"),
+      GURL("https://www.gstatic.com/og/_/js/k=og.qtm.en_US.js"),
+      GURL("https://fonts.googleapis.com/css2?family=Roboto"),
+      GURL("https://www.googleapis.com/geolocation/v1/geolocate?key=2_3_5_7"),
+      GURL("https://www.googleapis.com/youtube/v3/videos?id=1"),
+      GURL("https://safebrowsing.googleapis.com/v4/threatListUpdates:fetch"),
+      GURL("https://safebrowsing.googleapis.com/v5/hashes:search"),
+      GURL("https://sb-ssl.google.com/safebrowsing/clientreport/download"),
+      GURL("https://sb-ssl.google.com/safebrowsing/clientreport/malware"),
+      GURL("https://safebrowsing.google.com/safebrowsing/clientreport/"
+           "crx-list-info"),
+      GURL("https://safebrowsing.google.com/safebrowsing/clientreport/x"),
+      GURL("https://safebrowsing.google.com/safebrowsing/report?a=1"),
+      GURL("https://safebrowsing.google.com/safebrowsing/reporting"),
+      GURL("https://safebrowsing.google.com/safebrowsing/uploads/chrome"),
+      GURL("https://safebrowsing.google.com/safebrowsing/uploads"),
+      GURL("https://dl.google.com/release2/chrome_component/"
+           "AJ4r388iQSJq_4819/4819_all_crl-set-5934829738003798040.data.crx3"),
+      GURL("http://dl.google.com/release2/chrome_component/"
+           "LLjIBPPmveI_4988/4988_all_crl-set-6296993568184466307.data.crx3"),
+      GURL("https://dl.google.com/widevine-cdm/4.10.2557.0-linux-x64.zip"),
+      GURL("https://dl.google.com/chrome/install/latest/chrome_installer.exe"),
+      GURL("https://dl.google.com"),
+      GURL("https://r2---sn-8xgp1vo-qxoe.gvt1.com/edgedl/release2/"
+           "chrome_component/AJ4r388iQSJq_4819/"
+           "4819_all_crl-set-5934829738003798040.data.crx3"),
+      GURL("https://redirector.gvt1.com/edgedl/widevine-cdm/"
+           "4.10.2557.0-win-x64.zip"),
+      GURL("http://www.gvt1.com/edgedl/chrome/dict/en-us-8-0.bdic"),
+      GURL("https://clients2.googleusercontent.com/crx/blobs/"
+           "QgAAAC6zw0qH2DJtnXe8Z7rUJP1RM6lAmg/extension_1_2_3.crx"),
+      GURL("https://clients2.google.com/service/update2/crx?response=redirect"),
+      GURL("https://clients4.google.com/chrome-sync/dev"),
+      GURL("https://content-autofill.googleapis.com/v1/pages/ChVDaHJvbWU"),
+      GURL("https://cast.google.com/chromecast/home"),
+      GURL("https://bugs.chromium.org/p/chromium/issues/"
+           "entry?template=Crash%20Report&comment=a&labels=Restrict-View"),
+      GURL("https://bugs.chromium.org/p/chromium/issues/list"),
+      GURL("https://github.com/brave/brave-browser/issues"),
+      GURL("https://www.youtube.com/watch?v=dQw4w9WgXcQ"),
+      GURL("https://i.ytimg.com/vi/dQw4w9WgXcQ/hqdefault.jpg"),
+      GURL("https://en.wikipedia.org/wiki/Main_Page"),
+      GURL("https://upload.wikimedia.org/wikipedia/commons/a/a9/Example.jpg"),
+      GURL("https://www.reddit.com/r/brave_browser/"),
+      GURL("https://www.redditstatic.com/desktop2x/img/favicon.png"),
+      GURL("https://abs.twimg.com/responsive-web/client-web/main.js"),
+      GURL("https://cdn.jsdelivr.net/npm/bootstrap@5.3.0/dist/css/b.css"),
+      GURL("https://ajax.cloudflare.com/cdn-cgi/scripts/rocket-loader.js"),
+      GURL("https://www.bbc.co.uk/news"),
+      GURL("https://static.files.bbci.co.uk/core/website/assets/a.js"),
+      GURL("https://bradhatesprimes.brave.com/composite_numbers_ftw"),
+      GURL("https://search.brave.com/search?q=ipfs"),
+      GURL("http://localhost:8080/api/v0/add"),
+      GURL("http://127.0.0.1:45001/json/version"),
+      GURL("https://[::1]/"),
+      GURL("https://dl.google.com./release2/chrome_component/x.crx3"),
+      GURL("wss://dl.google.com/socket"),
+      GURL("filesystem:https://dl.google.com/temporary/file"),
+      GURL("data:text/html,hello"),
+      GURL("about:blank"),
+  };
+}
+
+void ExpectParity(const HostKeyedURLPatternSet& patterns) {
+  for (const GURL& url : GetURLCorpus()) {
+    EXPECT_EQ(patterns.Match(url), patterns.MatchEachForTesting(url)) << url;
+  }
+}
+
+}  // namespace
+
+TEST(HostKeyedURLPatternSetTest, MatchesLikeURLPattern) {
+  const std::vector<URLPattern> url_patterns = {
+      URLPattern(kHttpAndHttps, "*://dl.google.com/*"),
+      URLPattern(kHttpAndHttps, "*://*.gvt1.com/*"),
+      URLPattern(kHttpAndHttps, "*://*.gvt1.com/edgedl/widevine-cdm/*"),
+      URLPattern(URLPattern::SCHEME_HTTPS,
+                 "https://safebrowsing.google.com/safebrowsing/uploads/*"),
+      URLPattern(kHttpAndHttps,
+                 "*://bugs.chromium.org/p/chromium/issues/entry?*"),
+      URLPattern(kHttpAndHttps, "*://*/*"),
+      URLPattern(URLPattern::SCHEME_ALL, "<all_urls>"),
+      URLPattern(kHttpAndHttps, "*://localhost/*"),
+      URLPattern(kHttpAndHttps, "*://127.0.0.1/*"),
+      URLPattern(kHttpAndHttps, "*://*.co.uk/*"),
+      URLPattern(kHttpAndHttps, "https://www.bbc.co.uk/news*"),
+  };
+  HostKeyedURLPatternSet patterns;
+  for (size_t i = 0; i < url_patterns.size(); ++i)
+    patterns.Add(i, url_patterns[i]);
+  const size_t host_id = url_patterns.size();
+  const URLPattern host_pattern(URLPattern::SCHEME_HTTPS,
+                                "https://*.google.com/*");
+  patterns.Add(host_id, host_pattern,
+               HostKeyedURLPatternSet::MatchType::kHost);
+
+  for (const GURL& url : GetURLCorpus()) {
+    HostKeyedURLPatternSet::Matches matches = patterns.Match(url);
+    for (size_t i = 0; i < url_patterns.size(); ++i)
+      EXPECT_EQ(matches[i], url_patterns[i].MatchesURL(url)) << i << url;
+    EXPECT_EQ(matches[host_id], host_pattern.MatchesHost(url)) << url;
+  }
+}
+
+TEST(HostKeyedURLPatternSetTest, StaticRedirectPatternsParity) {
+  ExpectParity(GetStaticRedirectPatternsForTesting());
+}
+
+TEST(HostKeyedURLPatternSetTest, CommonStaticRedirectPatternsParity) {
+  ExpectParity(GetCommonStaticRedirectPatternsForTesting());
+}
+
+TEST(HostKeyedURLPatternSetTest, SafeBrowsingPatternsParity) {
+  ExpectParity(GetSafeBrowsingPatternsForTesting());
+}
+
+TEST(HostKeyedURLPatternSetTest, Benchmark) {
+  constexpr int kIterations = 2000;
+  const std::vector<GURL> corpus = GetURLCorpus();
+  const HostKeyedURLPatternSet& patterns =
+      GetStaticRedirectPatternsForTesting();
+
+  size_t indexed_matches = 0;
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kIterations; ++i) {
+    for (const GURL& url : corpus)
+      indexed_matches += patterns.Match(url).count();
+  }
+  base::TimeDelta indexed = base::TimeTicks::Now() - start;
+
+  size_t linear_matches = 0;
+  start = base::TimeTicks::Now();
+  for (int i = 0; i < kIterations; ++i) {
+    for (const GURL& url : corpus)
+      linear_matches += patterns.MatchEachForTesting(url).count();
+  }
+  base::TimeDelta linear = base::TimeTicks::Now() - start;
+
+  const size_t lookups = kIterations * corpus.size();
+  LOG(INFO) << "Host keyed: " << indexed.InNanoseconds() / lookups
+            << " ns/url, each pattern: " << linear.InNanoseconds() / lookups
+            << " ns/url";
+  EXPECT_EQ(indexed_matches, linear_matches);
+  EXPECT_GT(indexed_matches, 0u);
+}
+
+}  // namespace brave
@@ -5,12 +5,13 @@
 
 #include "brave/browser/ui/webui/ai_chat/ai_chat_ui_page_handler.h"
 
-#include <algorithm>
 #include <utility>
 #include <vector>
 
+#include "base/functional/bind.h"
 #include "base/notreached.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/time/time.h"
 #include "brave/components/ai_chat/browser/constants.h"
 #include "brave/components/ai_chat/common/mojom/ai_chat.mojom-shared.h"
 #include "brave/components/ai_chat/common/mojom/ai_chat.mojom.h"
@@ -25,6 +26,7 @@
 
 namespace {
 constexpr uint32_t kDesiredFaviconSizePixels = 32;
+constexpr base::TimeDelta kHistoryUpdateInterval = base::Milliseconds(100);
 }  // namespace
 
 namespace ai_chat {
@@ -85,19 +87,16 @@ void AIChatUIPageHandler::GetConversationHistory(
     std::move(callback).Run({});
     return;
   }
-  std::vector<ConversationTurn> history =
+  const std::vector<ConversationTurn>& history =
       active_chat_tab_helper_->GetConversationHistory();
 
-  std::vector<ai_chat::mojom::ConversationTurnPtr> list;
-
   // Remove conversations that are meant to be hidden from the user
-  auto new_end_it = std::remove_if(
-      history.begin(), history.end(), [](const ConversationTurn& turn) {
-        return turn.visibility == ConversationTurnVisibility::HIDDEN;
-      });
-
-  std::transform(history.begin(), new_end_it, std::back_inserter(list),
-                 [](const ConversationTurn& turn) { return turn.Clone(); });
+  std::vector<ai_chat::mojom::ConversationTurnPtr> list;
+  for (const auto& turn : history) {
+    if (turn.visibility != ConversationTurnVisibility::HIDDEN) {
+      list.push_back(turn.Clone());
+    }
+  }
 
   std::move(callback).Run(std::move(list));
 }
@@ -186,12 +185,36 @@ void AIChatUIPageHandler::MarkAgreementAccepted() {
 }
 
 void AIChatUIPageHandler::OnHistoryUpdate() {
+  history_update_timer_.Stop();
   if (page_.is_bound()) {
     page_->OnConversationHistoryUpdate();
   }
 }
 
+void AIChatUIPageHandler::OnConversationTurnAdded(
+    size_t turn_id,
+    const mojom::ConversationTurn& turn) {
+  if (turn.visibility != ConversationTurnVisibility::HIDDEN) {
+    OnHistoryUpdate();
+  }
+}
+
+void AIChatUIPageHandler::OnConversationTurnReplaced(
+    size_t turn_id,
+    const mojom::ConversationTurn& turn) {
+  ScheduleHistoryUpdate();
+}
+
+void AIChatUIPageHandler::OnAssistantDelta(size_t turn_id,
+                                           const std::string& text_fragment) {
+  ScheduleHistoryUpdate();
+}
+
 void AIChatUIPageHandler::OnAPIRequestInProgress(bool in_progress) {
+  // Show the whole response before the request is marked as finished.
+  if (!in_progress && history_update_timer_.IsRunning()) {
+    OnHistoryUpdate();
+  }
   if (page_.is_bound()) {
     page_->OnAPIRequestInProgress(in_progress);
   }
@@ -281,6 +304,19 @@ absl::optional<mojom::SiteInfo> AIChatUIPageHandler::BuildSiteInfo() {
   return absl::nullopt;
 }
 
+// The page fetches the whole history on every update, so the chunks of a
+// streamed response are batched rather than each being sent on its own.
+void AIChatUIPageHandler::ScheduleHistoryUpdate() {
+  if (history_update_timer_.IsRunning()) {
+    return;
+  }
+
+  history_update_timer_.Start(
+      FROM_HERE, kHistoryUpdateInterval,
+      base::BindOnce(&AIChatUIPageHandler::OnHistoryUpdate,
+                     base::Unretained(this)));
+}
+
 void AIChatUIPageHandler::OnVisibilityChanged(content::Visibility visibility) {
   // WebUI visibility changed (not target tab)
   if (!active_chat_tab_helper_) {
@@ -15,6 +15,7 @@
 #include "base/memory/weak_ptr.h"
 #include "base/scoped_observation.h"
 #include "base/task/cancelable_task_tracker.h"
+#include "base/timer/timer.h"
 #include "brave/components/ai_chat/browser/ai_chat_tab_helper.h"
 #include "brave/components/ai_chat/common/mojom/ai_chat.mojom.h"
 #include "content/public/browser/web_contents_observer.h"
@@ -70,6 +71,12 @@ class AIChatUIPageHandler : public ai_chat::mojom::PageHandler,
  private:
   // ChatTabHelper::Observer
   void OnHistoryUpdate() override;
+  void OnConversationTurnAdded(size_t turn_id,
+                               const mojom::ConversationTurn& turn) override;
+  void OnConversationTurnReplaced(size_t turn_id,
+                                  const mojom::ConversationTurn& turn) override;
+  void OnAssistantDelta(size_t turn_id,
+                        const std::string& text_fragment) override;
   void OnAPIRequestInProgress(bool in_progress) override;
   void OnAPIResponseError(mojom::APIError error) override;
   void OnSuggestedQuestionsChanged(
@@ -81,6 +88,7 @@ class AIChatUIPageHandler : public ai_chat::mojom::PageHandler,
 
   void GetFaviconImageData(GetFaviconImageDataCallback callback) override;
   absl::optional<mojom::SiteInfo> BuildSiteInfo();
+  void ScheduleHistoryUpdate();
 
   mojo::Remote<ai_chat::mojom::ChatUIPage> page_;
 
@@ -90,6 +98,9 @@ class AIChatUIPageHandler : public ai_chat::mojom::PageHandler,
 
   base::CancelableTaskTracker favicon_task_tracker_;
 
+  // Coalesces the history refreshes of a streamed response.
+  base::OneShotTimer history_update_timer_;
+
   base::ScopedObservation<AIChatTabHelper, AIChatTabHelper::Observer>
       chat_tab_helper_observation_{this};
 
@@ -4,6 +4,8 @@
  * You can obtain one at https://mozilla.org/MPL/2.0/. */
 
 #include "brave/components/ai_chat/common/buildflags/buildflags.h"
+#include "brave/components/brave_ads/content/renderer/page_signal_extractor.h"
+#include "brave/components/brave_ads/content/renderer/search_result_ad_visibility_observer.h"
 #include "brave/components/content_settings/renderer/brave_content_settings_agent_impl.h"
 #include "chrome/common/chrome_isolated_world_ids.h"
 #include "components/feed/content/renderer/rss_link_reader.h"
@@ -20,6 +22,9 @@ void RenderFrameWithBinderRegistryCreated(
     content::RenderFrame* render_frame,
     service_manager::BinderRegistry* registry) {
   new feed::RssLinkReader(render_frame, registry);
+  new brave_ads::PageSignalExtractor(render_frame, registry);
+  new brave_ads::SearchResultAdVisibilityObserver(
+      render_frame, registry, ISOLATED_WORLD_ID_BRAVE_INTERNAL);
 #if BUILDFLAG(ENABLE_AI_CHAT)
   if (ai_chat::features::IsAIChatEnabled()) {
     new ai_chat::PageContentExtractor(render_frame, registry,
@@ -5,6 +5,8 @@
 
 #include "net/http/transport_security_state.h"
 
+#include <utility>
+
 #include "build/build_config.h"
 #include "net/base/network_anonymization_key.h"
 #include "net/base/registry_controlled_domains/registry_controlled_domain.h"
@@ -65,78 +67,6 @@ bool IsTopFrameOriginCryptographic(const IsolationInfo& isolation_info) {
              isolation_info.top_frame_origin()->scheme());
 }
 
-TransportSecurityState::HashedHost GetHSTSPartitionHash(
-    const NetworkAnonymizationKey& network_anonymization_key) {
-  DCHECK(base::FeatureList::IsEnabled(features::kBravePartitionHSTS));
-  // An empty top frame site cannot be used as a partition key, return an empty
-  // hash which will be treated as a non-persistable partition.
-  if (!network_anonymization_key.GetTopFrameSite().has_value()) {
-    return TransportSecurityState::HashedHost();
-  }
-
-  const std::string partition_domain =
-      HSTSPartitionHashHelper::GetPartitionDomain(
-          *network_anonymization_key.GetTopFrameSite());
-  if (partition_domain.empty()) {
-    return TransportSecurityState::HashedHost();
-  }
-
-  const std::vector<uint8_t> canonicalized_partition_domain =
-      CanonicalizeHost(partition_domain);
-  if (canonicalized_partition_domain.empty()) {
-    return TransportSecurityState::HashedHost();
-  }
-
-  return HashHost(canonicalized_partition_domain);
-}
-
-// Use only top frame site as a key for HSTS partitioning to not over-populate
-// HSTS state storage. Check top frame site for equality with site for cookies,
-// don't store HSTS if it differs. IsolationInfo is not available everywhere,
-// that's why we're using it only when parsing new HSTS state.
-absl::optional<TransportSecurityState::HashedHost>
-GetPartitionHashForAddingHSTS(const IsolationInfo& isolation_info) {
-  if (!base::FeatureList::IsEnabled(features::kBravePartitionHSTS)) {
-    return absl::nullopt;
-  }
-
-  // If the top frame scheme is secure and SiteForCookies doesn't match
-  // TopFrameSite, then we don't want to store this HSTS state at all. Return an
-  // empty hash in this case, which will be treated as a non-persistable
-  // partition.
-  if (IsTopFrameOriginCryptographic(isolation_info) &&
-      isolation_info.site_for_cookies().site() !=
-          *isolation_info.network_anonymization_key().GetTopFrameSite()) {
-    return TransportSecurityState::HashedHost();
-  }
-
-  return GetHSTSPartitionHash(isolation_info.network_anonymization_key());
-}
-
-// Use NetworkIsolationKey to create PartitionHash for accessing/storing data.
-absl::optional<TransportSecurityState::HashedHost> GetPartitionHashForHSTS(
-    const NetworkAnonymizationKey& network_anonymization_key) {
-  if (!base::FeatureList::IsEnabled(features::kBravePartitionHSTS)) {
-    return absl::nullopt;
-  }
-  return GetHSTSPartitionHash(network_anonymization_key);
-}
-
-// Use host-bound NetworkIsolationKey in cases when no NetworkIsolationKey is
-// available. Such cases may include net-internals page, PasswordManager.
-// All network::NetworkContext HSTS-related public methods will use this.
-absl::optional<TransportSecurityState::HashedHost>
-GetHostBoundPartitionHashForHSTS(const std::string& host) {
-  if (!base::FeatureList::IsEnabled(features::kBravePartitionHSTS)) {
-    return absl::nullopt;
-  }
-  SchemefulSite schemeful_site(url::Origin::Create(GURL("https://" + host)));
-  auto network_anonymization_key =
-      net::NetworkAnonymizationKey::CreateFromFrameSite(schemeful_site,
-                                                        schemeful_site);
-  return GetHSTSPartitionHash(network_anonymization_key);
-}
-
 }  // namespace
 
 bool TransportSecurityState::ShouldSSLErrorsBeFatal(
@@ -226,4 +156,104 @@ bool TransportSecurityState::DeleteDynamicDataForHost(const std::string& host) {
   return chromium_deleted || brave_deleted;
 }
 
+void TransportSecurityState::ClearDynamicData() {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  partition_hash_cache_.Clear();
+  TransportSecurityState_ChromiumImpl::ClearDynamicData();
+}
+
+void TransportSecurityState::DeleteAllDynamicDataBetween(
+    base::Time start_time,
+    base::Time end_time,
+    base::OnceClosure callback) {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  partition_hash_cache_.Clear();
+  TransportSecurityState_ChromiumImpl::DeleteAllDynamicDataBetween(
+      start_time, end_time, std::move(callback));
+}
+
+TransportSecurityState::HashedHost
+TransportSecurityState::GetHSTSPartitionHash(
+    const NetworkAnonymizationKey& network_anonymization_key) {
+  DCHECK(base::FeatureList::IsEnabled(features::kBravePartitionHSTS));
+  // An empty top frame site cannot be used as a partition key, return an empty
+  // hash which will be treated as a non-persistable partition.
+  const absl::optional<SchemefulSite>& top_frame_site =
+      network_anonymization_key.GetTopFrameSite();
+  if (!top_frame_site.has_value()) {
+    return HashedHost();
+  }
+
+  // The top frame site rarely changes between requests, so reuse the hash
+  // instead of doing eTLD+1 lookup, canonicalization and SHA-256 every time.
+  auto it = partition_hash_cache_.Get(*top_frame_site);
+  if (it != partition_hash_cache_.end()) {
+    return it->second;
+  }
+
+  HashedHost partition_hash;
+  const std::string partition_domain =
+      HSTSPartitionHashHelper::GetPartitionDomain(*top_frame_site);
+  if (!partition_domain.empty()) {
+    const std::vector<uint8_t> canonicalized_partition_domain =
+        CanonicalizeHost(partition_domain);
+    if (!canonicalized_partition_domain.empty()) {
+      partition_hash = HashHost(canonicalized_partition_domain);
+    }
+  }
+
+  partition_hash_cache_.Put(*top_frame_site, partition_hash);
+  return partition_hash;
+}
+
+// Use only top frame site as a key for HSTS partitioning to not over-populate
+// HSTS state storage. Check top frame site for equality with site for cookies,
+// don't store HSTS if it differs. IsolationInfo is not available everywhere,
+// that's why we're using it only when parsing new HSTS state.
+absl::optional<TransportSecurityState::HashedHost>
+TransportSecurityState::GetPartitionHashForAddingHSTS(
+    const IsolationInfo& isolation_info) {
+  if (!base::FeatureList::IsEnabled(features::kBravePartitionHSTS)) {
+    return absl::nullopt;
+  }
+
+  // If the top frame scheme is secure and SiteForCookies doesn't match
+  // TopFrameSite, then we don't want to store this HSTS state at all. Return an
+  // empty hash in this case, which will be treated as a non-persistable
+  // partition.
+  if (IsTopFrameOriginCryptographic(isolation_info) &&
+      isolation_info.site_for_cookies().site() !=
+          *isolation_info.network_anonymization_key().GetTopFrameSite()) {
+    return HashedHost();
+  }
+
+  return GetHSTSPartitionHash(isolation_info.network_anonymization_key());
+}
+
+// Use NetworkIsolationKey to create PartitionHash for accessing/storing data.
+absl::optional<TransportSecurityState::HashedHost>
+TransportSecurityState::GetPartitionHashForHSTS(
+    const NetworkAnonymizationKey& network_anonymization_key) {
+  if (!base::FeatureList::IsEnabled(features::kBravePartitionHSTS)) {
+    return absl::nullopt;
+  }
+  return GetHSTSPartitionHash(network_anonymization_key);
+}
+
+// Use host-bound NetworkIsolationKey in cases when no NetworkIsolationKey is
+// available. Such cases may include net-internals page, PasswordManager.
+// All network::NetworkContext HSTS-related public methods will use this.
+absl::optional<TransportSecurityState::HashedHost>
+TransportSecurityState::GetHostBoundPartitionHashForHSTS(
+    const std::string& host) {
+  if (!base::FeatureList::IsEnabled(features::kBravePartitionHSTS)) {
+    return absl::nullopt;
+  }
+  SchemefulSite schemeful_site(url::Origin::Create(GURL("https://" + host)));
+  auto network_anonymization_key =
+      net::NetworkAnonymizationKey::CreateFromFrameSite(schemeful_site,
+                                                        schemeful_site);
+  return GetHSTSPartitionHash(network_anonymization_key);
+}
+
 }  // namespace net
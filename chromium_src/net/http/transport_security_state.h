@@ -6,8 +6,12 @@
 #ifndef BRAVE_CHROMIUM_SRC_NET_HTTP_TRANSPORT_SECURITY_STATE_H_
 #define BRAVE_CHROMIUM_SRC_NET_HTTP_TRANSPORT_SECURITY_STATE_H_
 
+#include <string>
+
+#include "base/containers/lru_cache.h"
 #include "brave/net/http/partitioned_host_state_map.h"
 #include "net/base/isolation_info.h"
+#include "net/base/schemeful_site.h"
 
 namespace net {
 class TransportSecurityState;
@@ -55,6 +59,33 @@ class NET_EXPORT TransportSecurityState
                           const NetLogWithSource& net_log = NetLogWithSource());
   bool GetDynamicSTSState(const std::string& host, STSState* result);
   bool DeleteDynamicDataForHost(const std::string& host);
+
+  // These also drop memoized partition hashes.
+  void ClearDynamicData();
+  void DeleteAllDynamicDataBetween(base::Time start_time,
+                                   base::Time end_time,
+                                   base::OnceClosure callback);
+
+  size_t partition_hash_cache_size_for_testing() const {
+    return partition_hash_cache_.size();
+  }
+
+ private:
+  // Top frame sites rarely change between requests, a handful of entries is
+  // enough to avoid recalculating the hash on every HSTS check.
+  static constexpr size_t kPartitionHashCacheSize = 32;
+
+  HashedHost GetHSTSPartitionHash(
+      const NetworkAnonymizationKey& network_anonymization_key);
+  absl::optional<HashedHost> GetPartitionHashForAddingHSTS(
+      const IsolationInfo& isolation_info);
+  absl::optional<HashedHost> GetPartitionHashForHSTS(
+      const NetworkAnonymizationKey& network_anonymization_key);
+  absl::optional<HashedHost> GetHostBoundPartitionHashForHSTS(
+      const std::string& host);
+
+  base::LRUCache<SchemefulSite, HashedHost> partition_hash_cache_{
+      kPartitionHashCacheSize};
 };
 
 }  // namespace net
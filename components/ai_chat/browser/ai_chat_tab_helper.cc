@@ -112,17 +112,19 @@ void AIChatTabHelper::OnPermissionChangedAutoGenerateQuestions() {
 }
 
 void AIChatTabHelper::AddToConversationHistory(mojom::ConversationTurn turn) {
+  const CharacterType character_type = turn.character_type;
   chat_history_.push_back(std::move(turn));
 
   for (auto& obs : observers_) {
-    obs.OnHistoryUpdate();
+    obs.OnConversationTurnAdded(chat_history_.size() - 1,
+                                chat_history_.back());
   }
 
   if (ai_chat_metrics_ != nullptr) {
     if (chat_history_.size() == 1) {
       ai_chat_metrics_->RecordNewChat();
     }
-    if (turn.character_type == CharacterType::HUMAN) {
+    if (character_type == CharacterType::HUMAN) {
       ai_chat_metrics_->RecordNewPrompt();
     }
   }
@@ -136,13 +138,31 @@ void AIChatTabHelper::UpdateOrCreateLastAssistantEntry(
     AddToConversationHistory({CharacterType::ASSISTANT,
                               ConversationTurnVisibility::VISIBLE,
                               updated_text});
-  } else {
-    chat_history_.back().text = updated_text;
+    return;
   }
 
-  // Trigger an observer update to refresh the UI.
+  const size_t turn_id = chat_history_.size() - 1;
+  std::string& text = chat_history_.back().text;
+
+  // Engines stream the whole response so far, so usually only the new tail
+  // needs to reach the UI.
+  if (updated_text.size() >= text.size() &&
+      base::StartsWith(updated_text, text)) {
+    if (updated_text.size() == text.size()) {
+      return;
+    }
+
+    const std::string text_fragment = updated_text.substr(text.size());
+    text.append(text_fragment);
+    for (auto& obs : observers_) {
+      obs.OnAssistantDelta(turn_id, text_fragment);
+    }
+    return;
+  }
+
+  text = std::move(updated_text);
   for (auto& obs : observers_) {
-    obs.OnHistoryUpdate();
+    obs.OnConversationTurnReplaced(turn_id, chat_history_.back());
   }
 }
 
@@ -294,6 +314,11 @@ mojom::APIError AIChatTabHelper::GetCurrentAPIError() {
   return current_error_;
 }
 
+void AIChatTabHelper::SetEngineForTesting(
+    std::unique_ptr<EngineConsumer> engine_for_testing) {
+  engine_ = std::move(engine_for_testing);
+}
+
 void AIChatTabHelper::GenerateQuestions() {
   DVLOG(1) << __func__;
   // This function should not be presented in the UI if the user has not
@@ -408,6 +433,9 @@ void AIChatTabHelper::RetryAPIRequest() {
       auto turn = *std::make_move_iterator(rit);
       auto human_turn_iter = rit.base() - 1;
       chat_history_.erase(human_turn_iter, chat_history_.end());
+      for (auto& obs : observers_) {
+        obs.OnHistoryUpdate();
+      }
       MakeAPIRequestWithConversationHistoryUpdate(turn);
       break;
     }
@@ -44,7 +44,21 @@ class AIChatTabHelper : public content::WebContentsObserver,
    public:
     ~Observer() override {}
 
+    // The conversation history changed as a whole, e.g. it was cleared, and
+    // should be fetched again.
     virtual void OnHistoryUpdate() {}
+    // |turn| was appended to the history. |turn_id| is its index in
+    // |GetConversationHistory|.
+    virtual void OnConversationTurnAdded(size_t turn_id,
+                                         const mojom::ConversationTurn& turn) {}
+    // The text of the turn at |turn_id| was replaced.
+    virtual void OnConversationTurnReplaced(
+        size_t turn_id,
+        const mojom::ConversationTurn& turn) {}
+    // |text_fragment| was appended to the assistant turn at |turn_id| by a
+    // streamed response.
+    virtual void OnAssistantDelta(size_t turn_id,
+                                  const std::string& text_fragment) {}
     // We are on a page where we can read the content, so we can perform
     // page-specific actions.
     virtual void OnAPIRequestInProgress(bool in_progress) {}
@@ -86,6 +100,8 @@ class AIChatTabHelper : public content::WebContentsObserver,
   void ClearConversationHistory();
   mojom::APIError GetCurrentAPIError();
 
+  void SetEngineForTesting(std::unique_ptr<EngineConsumer> engine_for_testing);
+
  private:
   friend class content::WebContentsUserData<AIChatTabHelper>;
 
@@ -0,0 +1,189 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/ai_chat/browser/ai_chat_tab_helper.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/memory/raw_ptr.h"
+#include "base/strings/string_number_conversions.h"
+#include "brave/components/ai_chat/browser/engine/engine_consumer.h"
+#include "brave/components/ai_chat/common/mojom/ai_chat.mojom.h"
+#include "brave/components/ai_chat/common/pref_names.h"
+#include "components/favicon/content/content_favicon_driver.h"
+#include "components/prefs/testing_pref_service.h"
+#include "components/user_prefs/user_prefs.h"
+#include "content/public/test/test_renderer_host.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace ai_chat {
+
+namespace {
+
+constexpr size_t kDeltaCount = 2000;
+
+class FakeEngineConsumer : public EngineConsumer {
+ public:
+  void GenerateQuestionSuggestions(
+      const bool& is_video,
+      const std::string& page_content,
+      SuggestedQuestionsCallback callback) override {}
+
+  void GenerateAssistantResponse(
+      const bool& is_video,
+      const std::string& page_content,
+      const ConversationHistory& conversation_history,
+      const std::string& human_input,
+      GenerationDataCallback data_received_callback,
+      GenerationCompletedCallback completed_callback) override {
+    data_received_callback_ = std::move(data_received_callback);
+    completed_callback_ = std::move(completed_callback);
+  }
+
+  void SanitizeInput(std::string& input) override {}
+
+  void ClearAllQueries() override {}
+
+  // Engines pass the whole response received so far.
+  void SendData(const std::string& response) {
+    data_received_callback_.Run(response);
+  }
+
+  void Complete(const std::string& response) {
+    std::move(completed_callback_).Run(response);
+  }
+
+ private:
+  GenerationDataCallback data_received_callback_;
+  GenerationCompletedCallback completed_callback_;
+};
+
+class TestObserver : public AIChatTabHelper::Observer {
+ public:
+  void OnHistoryUpdate() override { history_updates_++; }
+
+  void OnConversationTurnAdded(size_t turn_id,
+                               const mojom::ConversationTurn& turn) override {
+    turns_added_++;
+    bytes_sent_ += turn.text.size();
+  }
+
+  void OnConversationTurnReplaced(
+      size_t turn_id,
+      const mojom::ConversationTurn& turn) override {
+    turns_replaced_++;
+    bytes_sent_ += turn.text.size();
+  }
+
+  void OnAssistantDelta(size_t turn_id,
+                        const std::string& text_fragment) override {
+    deltas_++;
+    bytes_sent_ += text_fragment.size();
+    last_delta_turn_id_ = turn_id;
+  }
+
+  size_t history_updates_ = 0;
+  size_t turns_added_ = 0;
+  size_t turns_replaced_ = 0;
+  size_t deltas_ = 0;
+  size_t bytes_sent_ = 0;
+  size_t last_delta_turn_id_ = 0;
+};
+
+}  // namespace
+
+class AIChatTabHelperUnitTest : public content::RenderViewHostTestHarness {
+ public:
+  void SetUp() override {
+    content::RenderViewHostTestHarness::SetUp();
+
+    prefs::RegisterProfilePrefs(pref_service_.registry());
+    pref_service_.SetBoolean(prefs::kBraveChatHasSeenDisclaimer, true);
+    user_prefs::UserPrefs::Set(browser_context(), &pref_service_);
+
+    favicon::ContentFaviconDriver::CreateForWebContents(web_contents(),
+                                                        nullptr);
+    AIChatTabHelper::CreateForWebContents(web_contents(), nullptr);
+    tab_helper_ = AIChatTabHelper::FromWebContents(web_contents());
+
+    auto engine = std::make_unique<FakeEngineConsumer>();
+    engine_ = engine.get();
+    tab_helper_->SetEngineForTesting(std::move(engine));
+
+    NavigateAndCommit(GURL("https://brave.com/"));
+    tab_helper_->OnConversationActiveChanged(true);
+    tab_helper_->AddObserver(&observer_);
+  }
+
+  void TearDown() override {
+    tab_helper_->RemoveObserver(&observer_);
+    engine_ = nullptr;
+    tab_helper_ = nullptr;
+    content::RenderViewHostTestHarness::TearDown();
+  }
+
+ protected:
+  TestingPrefServiceSimple pref_service_;
+  raw_ptr<AIChatTabHelper> tab_helper_ = nullptr;
+  raw_ptr<FakeEngineConsumer> engine_ = nullptr;
+  TestObserver observer_;
+};
+
+TEST_F(AIChatTabHelperUnitTest, StreamsAssistantResponseAsDeltas) {
+  tab_helper_->MakeAPIRequestWithConversationHistoryUpdate(
+      {mojom::CharacterType::HUMAN, mojom::ConversationTurnVisibility::VISIBLE,
+       "Tell me a long story"});
+  EXPECT_EQ(1u, observer_.turns_added_);
+
+  std::string response;
+  size_t full_history_bytes = 0;
+  for (size_t i = 0; i < kDeltaCount; ++i) {
+    response += "word" + base::NumberToString(i) + " ";
+    engine_->SendData(response);
+    full_history_bytes += response.size();
+  }
+  engine_->Complete("");
+
+  // The first chunk adds the assistant turn, every later one only sends what
+  // is new.
+  EXPECT_EQ(2u, observer_.turns_added_);
+  EXPECT_EQ(kDeltaCount - 1, observer_.deltas_);
+  EXPECT_EQ(1u, observer_.last_delta_turn_id_);
+  EXPECT_EQ(0u, observer_.turns_replaced_);
+
+  // No full history fetches were requested while streaming.
+  EXPECT_EQ(0u, observer_.history_updates_);
+
+  // Sending the whole response on each chunk would have cost
+  // |full_history_bytes|, quadratic in the response length.
+  const std::string human_text = "Tell me a long story";
+  EXPECT_EQ(human_text.size() + response.size(), observer_.bytes_sent_);
+  EXPECT_LT(observer_.bytes_sent_ * 100, full_history_bytes);
+
+  const auto& history = tab_helper_->GetConversationHistory();
+  ASSERT_EQ(2u, history.size());
+  EXPECT_EQ(response, history[1].text);
+}
+
+TEST_F(AIChatTabHelperUnitTest, ReplacesAssistantTurnWhenTextDiverges) {
+  tab_helper_->MakeAPIRequestWithConversationHistoryUpdate(
+      {mojom::CharacterType::HUMAN, mojom::ConversationTurnVisibility::VISIBLE,
+       "Hello"});
+  engine_->SendData("Hi there ");
+  engine_->SendData("Hi there friend ");
+
+  // The final response has its trailing whitespace trimmed.
+  engine_->Complete("Hi there friend");
+
+  EXPECT_EQ(1u, observer_.deltas_);
+  EXPECT_EQ(1u, observer_.turns_replaced_);
+  EXPECT_EQ("Hi there friend", tab_helper_->GetConversationHistory()[1].text);
+}
+
+}  // namespace ai_chat
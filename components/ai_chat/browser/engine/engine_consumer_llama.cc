@@ -5,6 +5,8 @@
 
 #include "brave/components/ai_chat/browser/engine/engine_consumer_llama.h"
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
 #include <string>
 #include <string_view>
@@ -15,6 +17,7 @@
 #include "base/containers/fixed_flat_set.h"
 #include "base/containers/flat_set.h"
 #include "base/functional/bind.h"
+#include "base/hash/hash.h"
 #include "base/i18n/time_formatting.h"
 #include "base/memory/raw_ptr.h"
 #include "base/memory/weak_ptr.h"
@@ -158,81 +161,97 @@ std::string BuildLlama2GenerateQuestionsPrompt(bool is_video,
           IDS_AI_CHAT_LLAMA2_SYSTEM_MESSAGE_GENERATE_QUESTIONS_RESPONSE_SEED));
 }
 
-std::string BuildLlama2Prompt(
-    const std::vector<ConversationTurn>& conversation_history,
-    std::string page_content,
-    const bool& is_video,
-    const std::string user_message) {
+std::string BuildLlama2SystemMessage(const std::string& date_and_time) {
   // Always use a generic system message
   std::string system_message =
       l10n_util::GetStringUTF8(IDS_AI_CHAT_LLAMA2_SYSTEM_MESSAGE_GENERIC);
-  std::string date_and_time_string =
-      base::UTF16ToUTF8(TimeFormatFriendlyDateAndTime(base::Time::Now()));
-  std::string today_system_message = base::ReplaceStringPlaceholders(
-      system_message, {date_and_time_string}, nullptr);
-
-  // Get the raw first user message, which is in the chat history if this is
-  // the first sequence.
-  std::string raw_first_user_message;
-  if (conversation_history.size() > 0) {
-    raw_first_user_message = conversation_history[0].text;
-  } else {
-    raw_first_user_message = user_message;
-  }
+  return base::ReplaceStringPlaceholders(system_message, {date_and_time},
+                                         nullptr);
+}
 
-  // Build first_user_message, the first complete message sent to the AI model,
-  // which may or may not include injected contents such as article text.
-  std::string first_user_message;
-  if (!page_content.empty()) {
-    std::string first_message_template;
-    if (is_video) {
-      first_message_template =
-          l10n_util::GetStringUTF8(IDS_AI_CHAT_VIDEO_PROMPT_SEGMENT_LLAMA2);
-    } else {
-      first_message_template =
-          l10n_util::GetStringUTF8(IDS_AI_CHAT_ARTICLE_PROMPT_SEGMENT_LLAMA2);
-    }
-    first_user_message = base::ReplaceStringPlaceholders(
-        first_message_template, {page_content, raw_first_user_message},
-        nullptr);
-  } else {
+// Builds the first complete message sent to the AI model, which may or may
+// not include injected contents such as article text.
+std::string BuildLlama2FirstUserMessage(
+    const std::string& page_content,
+    bool is_video,
+    const std::string& raw_first_user_message) {
+  if (page_content.empty()) {
     // If there's no article or video context, just use the raw first user
     // message.
-    first_user_message = raw_first_user_message;
+    return raw_first_user_message;
   }
 
-  // If there's no conversation history, then we just send a (partial)
-  // first sequence.
-  if (conversation_history.empty() || conversation_history.size() <= 1) {
-    return BuildLlama2FirstSequence(
-        today_system_message, first_user_message, absl::nullopt,
-        l10n_util::GetStringUTF8(IDS_AI_CHAT_LLAMA2_GENERAL_SEED));
+  std::string first_message_template;
+  if (is_video) {
+    first_message_template =
+        l10n_util::GetStringUTF8(IDS_AI_CHAT_VIDEO_PROMPT_SEGMENT_LLAMA2);
+  } else {
+    first_message_template =
+        l10n_util::GetStringUTF8(IDS_AI_CHAT_ARTICLE_PROMPT_SEGMENT_LLAMA2);
   }
+  return base::ReplaceStringPlaceholders(
+      first_message_template, {page_content, raw_first_user_message}, nullptr);
+}
 
-  // Use the first two messages to build the first sequence,
-  // which includes the system prompt.
-  std::string prompt =
-      BuildLlama2FirstSequence(today_system_message, first_user_message,
-                               conversation_history[1].text, absl::nullopt);
+// Strings which are removed from inputs, longest first so that the longest
+// match at a position wins.
+constexpr std::string_view kLlama2SanitizedStrings[] = {
+    kLlama2ESys, "</question>", "</article>", "</history>", "<question>",
+    "<article>", "<history>",   kLlama2BSys,  kLlama2EIns,  kLlama2BIns,
+    "<SYS>",     kLlama2Eos,    kLlama2Bos,
+};
+
+constexpr size_t GetMaxLlama2SanitizedStringSize() {
+  size_t max_size = 0;
+  for (const std::string_view sanitized : kLlama2SanitizedStrings) {
+    max_size = std::max(max_size, sanitized.size());
+  }
+  return max_size;
+}
 
-  // Loop through the rest of the history two at a time building subsequent
-  // sequences.
-  for (size_t i = 2; i + 1 < conversation_history.size(); i += 2) {
-    const std::string& prev_user_message = conversation_history[i].text;
-    const std::string& assistant_message = conversation_history[i + 1].text;
-    prompt += BuildLlama2SubsequentSequence(prev_user_message,
-                                            assistant_message, absl::nullopt);
+// Every sanitized string starts with one of these.
+constexpr char kLlama2SanitizedStringStarts[] = "<[\n";
+
+// Removes every sanitized string from |input| in a single scan. After a
+// removal the scan steps back over the few characters before it, so text
+// joined by the removal is checked as well and the result never contains a
+// sanitized string.
+void RemoveLlama2SanitizedStrings(std::string& input) {
+  if (input.find_first_of(kLlama2SanitizedStringStarts) == std::string::npos) {
+    return;
   }
 
-  // Build the final subsequent exchange using the current turn.
-  prompt += BuildLlama2SubsequentSequence(
-      user_message, absl::nullopt,
-      l10n_util::GetStringUTF8(IDS_AI_CHAT_LLAMA2_GENERAL_SEED));
+  // The text left to scan, reversed so that its next character is the last.
+  std::string unscanned(input.rbegin(), input.rend());
+  std::string output;
+  output.reserve(input.size());
+  while (!unscanned.empty()) {
+    size_t match_size = 0;
+    if (std::strchr(kLlama2SanitizedStringStarts, unscanned.back())) {
+      for (const std::string_view sanitized : kLlama2SanitizedStrings) {
+        if (sanitized.size() <= unscanned.size() &&
+            std::equal(sanitized.begin(), sanitized.end(),
+                       unscanned.rbegin())) {
+          match_size = sanitized.size();
+          break;
+        }
+      }
+    }
 
-  // Trimming recommended by Meta
-  // https://huggingface.co/meta-llama/Llama-2-13b-chat#intended-use
-  prompt = base::TrimWhitespaceASCII(prompt, base::TRIM_ALL);
-  return prompt;
+    if (!match_size) {
+      output.push_back(unscanned.back());
+      unscanned.pop_back();
+      continue;
+    }
+
+    unscanned.resize(unscanned.size() - match_size);
+    const size_t rescan_size =
+        std::min(output.size(), GetMaxLlama2SanitizedStringSize() - 1);
+    unscanned.append(output.rbegin(), output.rbegin() + rescan_size);
+    output.resize(output.size() - rescan_size);
+  }
+
+  input = std::move(output);
 }
 
 }  // namespace
@@ -256,6 +275,10 @@ EngineConsumerLlamaRemote::~EngineConsumerLlamaRemote() = default;
 
 void EngineConsumerLlamaRemote::ClearAllQueries() {
   api_->ClearAllQueries();
+  // A new conversation starts.
+  conversation_date_and_time_.clear();
+  subsequent_sequences_.clear();
+  subsequent_sequences_turn_count_ = 0;
 }
 
 void EngineConsumerLlamaRemote::GenerateQuestionSuggestions(
@@ -328,28 +351,105 @@ void EngineConsumerLlamaRemote::GenerateAssistantResponse(
     const std::string& human_input,
     GenerationDataCallback data_received_callback,
     GenerationCompletedCallback completed_callback) {
-  std::string prompt = BuildLlama2Prompt(conversation_history, page_content,
-                                         is_video, human_input);
+  std::string prompt =
+      BuildPrompt(conversation_history, page_content, is_video, human_input);
   DCHECK(api_);
   api_->QueryPrompt(prompt, {"</response>"}, std::move(completed_callback),
                     std::move(data_received_callback));
 }
 
 void EngineConsumerLlamaRemote::SanitizeInput(std::string& input) {
-  base::ReplaceSubstringsAfterOffset(&input, 0, kLlama2Bos, "");
-  base::ReplaceSubstringsAfterOffset(&input, 0, kLlama2Eos, "");
-  base::ReplaceSubstringsAfterOffset(&input, 0, kLlama2BIns, "");
-  base::ReplaceSubstringsAfterOffset(&input, 0, kLlama2EIns, "");
-  base::ReplaceSubstringsAfterOffset(&input, 0, kLlama2BSys, "");
-  base::ReplaceSubstringsAfterOffset(&input, 0, kLlama2ESys, "");
   // TODO(petemill): Case-sensitive?
-  base::ReplaceSubstringsAfterOffset(&input, 0, "<SYS>", "");
-  base::ReplaceSubstringsAfterOffset(&input, 0, "<article>", "");
-  base::ReplaceSubstringsAfterOffset(&input, 0, "</article>", "");
-  base::ReplaceSubstringsAfterOffset(&input, 0, "<history>", "");
-  base::ReplaceSubstringsAfterOffset(&input, 0, "</history>", "");
-  base::ReplaceSubstringsAfterOffset(&input, 0, "<question>", "");
-  base::ReplaceSubstringsAfterOffset(&input, 0, "</question>", "");
+  RemoveLlama2SanitizedStrings(input);
+}
+
+std::string EngineConsumerLlamaRemote::BuildPromptForTesting(
+    const ConversationHistory& conversation_history,
+    const std::string& page_content,
+    bool is_video,
+    const std::string& user_message) {
+  return BuildPrompt(conversation_history, page_content, is_video,
+                     user_message);
+}
+
+std::string EngineConsumerLlamaRemote::BuildPrompt(
+    const ConversationHistory& conversation_history,
+    const std::string& page_content,
+    bool is_video,
+    const std::string& user_message) {
+  // The date is part of the localized system message, so it comes before the
+  // page content. It is taken once per conversation, which keeps the prompt
+  // of every turn a prefix of the next one's.
+  if (conversation_date_and_time_.empty()) {
+    conversation_date_and_time_ =
+        base::UTF16ToUTF8(TimeFormatFriendlyDateAndTime(base::Time::Now()));
+  }
+  const std::string system_message =
+      BuildLlama2SystemMessage(conversation_date_and_time_);
+
+  // If there's no conversation history, then we just send a (partial)
+  // first sequence. The first user message is in the chat history if this
+  // is the first sequence.
+  if (conversation_history.size() <= 1) {
+    const std::string& raw_first_user_message =
+        conversation_history.empty() ? user_message
+                                     : conversation_history[0].text;
+    return BuildLlama2FirstSequence(
+        system_message,
+        BuildLlama2FirstUserMessage(page_content, is_video,
+                                    raw_first_user_message),
+        absl::nullopt,
+        l10n_util::GetStringUTF8(IDS_AI_CHAT_LLAMA2_GENERAL_SEED));
+  }
+
+  // Use the first two messages to build the first sequence,
+  // which includes the system prompt.
+  std::string prompt = BuildLlama2FirstSequence(
+      system_message,
+      BuildLlama2FirstUserMessage(page_content, is_video,
+                                  conversation_history[0].text),
+      conversation_history[1].text, absl::nullopt);
+
+  // Loop through the rest of the history two at a time building subsequent
+  // sequences. Those don't depend on the page, so the sequences
+  // of earlier requests are kept and only new exchanges are added.
+  if (!AreSubsequentSequencesValid(conversation_history)) {
+    subsequent_sequences_.clear();
+    subsequent_sequences_turn_count_ = 2;
+  }
+  for (size_t i = subsequent_sequences_turn_count_;
+       i + 1 < conversation_history.size(); i += 2) {
+    const std::string& prev_user_message = conversation_history[i].text;
+    const std::string& assistant_message = conversation_history[i + 1].text;
+    subsequent_sequences_ += BuildLlama2SubsequentSequence(
+        prev_user_message, assistant_message, absl::nullopt);
+    subsequent_sequences_turn_count_ = i + 2;
+    last_subsequent_turn_hash_ = base::FastHash(assistant_message);
+  }
+  prompt += subsequent_sequences_;
+
+  // Build the final subsequent exchange using the current turn.
+  prompt += BuildLlama2SubsequentSequence(
+      user_message, absl::nullopt,
+      l10n_util::GetStringUTF8(IDS_AI_CHAT_LLAMA2_GENERAL_SEED));
+
+  // Trimming recommended by Meta
+  // https://huggingface.co/meta-llama/Llama-2-13b-chat#intended-use
+  return std::string(base::TrimWhitespaceASCII(prompt, base::TRIM_ALL));
+}
+
+bool EngineConsumerLlamaRemote::AreSubsequentSequencesValid(
+    const ConversationHistory& conversation_history) const {
+  // Turns are only ever added to a conversation, and ClearAllQueries() is
+  // called when it starts over, so the turn count and the last covered turn
+  // are enough to tell that the history is the one the sequences are for.
+  if (subsequent_sequences_turn_count_ <= 2) {
+    return subsequent_sequences_turn_count_ == 2;
+  }
+  return subsequent_sequences_turn_count_ <= conversation_history.size() &&
+         base::FastHash(
+             conversation_history[subsequent_sequences_turn_count_ - 1]
+                 .text) == last_subsequent_turn_hash_;
 }
 
 }  // namespace ai_chat
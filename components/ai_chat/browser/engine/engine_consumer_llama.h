@@ -50,13 +50,38 @@ class EngineConsumerLlamaRemote : public EngineConsumer {
   void SanitizeInput(std::string& input) override;
   void ClearAllQueries() override;
 
+  std::string BuildPromptForTesting(
+      const ConversationHistory& conversation_history,
+      const std::string& page_content,
+      bool is_video,
+      const std::string& user_message);
+
  private:
+  std::string BuildPrompt(const ConversationHistory& conversation_history,
+                          const std::string& page_content,
+                          bool is_video,
+                          const std::string& user_message);
+  bool AreSubsequentSequencesValid(
+      const ConversationHistory& conversation_history) const;
+
   void OnGenerateQuestionSuggestionsResponse(
       SuggestedQuestionsCallback callback,
       GenerationResult result);
 
   std::unique_ptr<RemoteCompletionClient> api_ = nullptr;
 
+  // Date and time given to the model for the whole conversation.
+  std::string conversation_date_and_time_;
+
+  // The subsequent sequences of the conversation's completed exchanges,
+  // after the first one, which are extended as the conversation grows.
+  std::string subsequent_sequences_;
+  // Number of turns from the start of the history that are covered by
+  // |subsequent_sequences_|, 0 if there are none, and the hash of the last
+  // one.
+  size_t subsequent_sequences_turn_count_ = 0;
+  size_t last_subsequent_turn_hash_ = 0;
+
   base::WeakPtrFactory<EngineConsumerLlamaRemote> weak_ptr_factory_{this};
 };
 
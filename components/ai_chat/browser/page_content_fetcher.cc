@@ -6,11 +6,14 @@
 #include "brave/components/ai_chat/browser/page_content_fetcher.h"
 
 #include <memory>
+#include <string>
 #include <utility>
 
 #include "base/containers/contains.h"
 #include "base/containers/fixed_flat_set.h"
 #include "base/functional/bind.h"
+#include "base/memory/weak_ptr.h"
+#include "brave/components/ai_chat/browser/transcript_cache.h"
 #include "brave/components/ai_chat/common/mojom/page_content_extractor.mojom.h"
 #include "content/public/browser/browser_context.h"
 #include "content/public/browser/storage_partition.h"
@@ -59,8 +62,10 @@ class PageContentFetcher {
  public:
   void Start(mojo::Remote<mojom::PageContentExtractor> content_extractor,
              scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory,
+             base::WeakPtr<TranscriptCache> transcript_cache,
              FetchPageContentCallback callback) {
     url_loader_factory_ = url_loader_factory;
+    transcript_cache_ = std::move(transcript_cache);
     content_extractor_ = std::move(content_extractor);
     if (!content_extractor_) {
       DeleteSelf();
@@ -113,6 +118,20 @@ class PageContentFetcher {
       SendResultAndDeleteSelf(std::move(callback), "", true);
       return;
     }
+    const bool is_youtube =
+        data->type == ai_chat::mojom::PageContentType::VideoTranscriptYouTube;
+    if (is_youtube && transcript_cache_) {
+      transcript_cache_key_ = TranscriptCache::GetKey(content_url);
+      const std::string* transcript =
+          transcript_cache_key_.empty()
+              ? nullptr
+              : transcript_cache_->Get(transcript_cache_key_);
+      if (transcript) {
+        DVLOG(1) << "Using cached video transcript";
+        SendResultAndDeleteSelf(std::move(callback), *transcript, true);
+        return;
+      }
+    }
     DVLOG(1) << "Making video transcript fetch to " << content_url.spec();
     // Handle transcript url result - fetch content.
     auto request = std::make_unique<network::ResourceRequest>();
@@ -127,8 +146,6 @@ class PageContentFetcher {
                network::SimpleURLLoader::RetryMode::RETRY_ON_NETWORK_CHANGE);
     loader->SetAllowHttpErrorResults(true);
     auto* loader_ptr = loader.get();
-    bool is_youtube =
-        data->type == ai_chat::mojom::PageContentType::VideoTranscriptYouTube;
     auto on_response =
         base::BindOnce(&PageContentFetcher::OnTranscriptFetchResponse,
                        weak_ptr_factory_.GetWeakPtr(), std::move(callback),
@@ -152,8 +169,10 @@ class PageContentFetcher {
     //   see in a moment. And this  </text>
     // </transcript>
 
-    if (!data_decoder::IsXmlElementNamed(result.value(), "transcript")) {
+    if (!result.has_value() ||
+        !data_decoder::IsXmlElementNamed(result.value(), "transcript")) {
       VLOG(1) << "Could not find transcript element.";
+      SendResultAndDeleteSelf(std::move(callback), "", true);
       return;
     }
 
@@ -161,6 +180,7 @@ class PageContentFetcher {
     const base::Value::List* children =
         data_decoder::GetXmlElementChildren(result.value());
     if (!children) {
+      SendResultAndDeleteSelf(std::move(callback), "", true);
       return;
     }
 
@@ -182,6 +202,9 @@ class PageContentFetcher {
       transcript_text += text;
     }
 
+    if (transcript_cache_ && !transcript_cache_key_.empty()) {
+      transcript_cache_->Put(transcript_cache_key_, transcript_text);
+    }
     SendResultAndDeleteSelf(std::move(callback), transcript_text, true);
   }
 
@@ -224,6 +247,8 @@ class PageContentFetcher {
 
   scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory_;
   mojo::Remote<mojom::PageContentExtractor> content_extractor_;
+  base::WeakPtr<TranscriptCache> transcript_cache_;
+  std::string transcript_cache_key_;
   base::WeakPtrFactory<PageContentFetcher> weak_ptr_factory_{this};
 };
 
@@ -251,11 +276,13 @@ void FetchPageContent(content::WebContents* web_contents,
       extractor.BindNewPipeAndPassReceiver());
 
   auto* fetcher = new PageContentFetcher();
-  auto* loader = web_contents->GetBrowserContext()
-                     ->GetDefaultStoragePartition()
+  auto* browser_context = web_contents->GetBrowserContext();
+  auto* loader = browser_context->GetDefaultStoragePartition()
                      ->GetURLLoaderFactoryForBrowserProcess()
                      .get();
-  fetcher->Start(std::move(extractor), loader, std::move(callback));
+  fetcher->Start(std::move(extractor), loader,
+                 TranscriptCache::GetForBrowserContext(browser_context),
+                 std::move(callback));
 }
 
 }  // namespace ai_chat
@@ -0,0 +1,78 @@
+// Copyright (c) 2023 The Brave Authors. All rights reserved.
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "brave/components/ai_chat/browser/transcript_cache.h"
+
+#include <memory>
+#include <utility>
+
+#include "base/strings/strcat.h"
+#include "content/public/browser/browser_context.h"
+#include "net/base/url_util.h"
+#include "url/gurl.h"
+
+namespace ai_chat {
+
+namespace {
+
+constexpr char kTranscriptCacheUserDataKey[] = "ai_chat_transcript_cache";
+
+// Query parameters which identify a transcript track. The others sign the
+// url, and change with every page load.
+constexpr const char* kTranscriptTrackParams[] = {"v",    "lang", "tlang",
+                                                  "kind", "name", "fmt"};
+
+}  // namespace
+
+TranscriptCache::TranscriptCache() = default;
+
+TranscriptCache::~TranscriptCache() = default;
+
+// static
+base::WeakPtr<TranscriptCache> TranscriptCache::GetForBrowserContext(
+    content::BrowserContext* context) {
+  if (context->IsOffTheRecord()) {
+    return nullptr;
+  }
+
+  auto* cache = static_cast<TranscriptCache*>(
+      context->GetUserData(kTranscriptCacheUserDataKey));
+  if (!cache) {
+    auto new_cache = std::make_unique<TranscriptCache>();
+    cache = new_cache.get();
+    context->SetUserData(kTranscriptCacheUserDataKey, std::move(new_cache));
+  }
+  return cache->weak_ptr_factory_.GetWeakPtr();
+}
+
+// static
+std::string TranscriptCache::GetKey(const GURL& transcript_url) {
+  std::string video_id;
+  if (!net::GetValueForKeyInQuery(transcript_url, "v", &video_id) ||
+      video_id.empty()) {
+    return std::string();
+  }
+
+  std::string key;
+  for (const char* param : kTranscriptTrackParams) {
+    std::string value;
+    if (net::GetValueForKeyInQuery(transcript_url, param, &value)) {
+      base::StrAppend(&key, {param, "=", value, "&"});
+    }
+  }
+  return key;
+}
+
+const std::string* TranscriptCache::Get(const std::string& key) {
+  auto it = transcripts_.Get(key);
+  return it != transcripts_.end() ? &it->second : nullptr;
+}
+
+void TranscriptCache::Put(const std::string& key,
+                          const std::string& transcript) {
+  transcripts_.Put(key, transcript);
+}
+
+}  // namespace ai_chat
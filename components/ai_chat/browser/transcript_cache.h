@@ -0,0 +1,54 @@
+// Copyright (c) 2023 The Brave Authors. All rights reserved.
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef BRAVE_COMPONENTS_AI_CHAT_BROWSER_TRANSCRIPT_CACHE_H_
+#define BRAVE_COMPONENTS_AI_CHAT_BROWSER_TRANSCRIPT_CACHE_H_
+
+#include <string>
+
+#include "base/containers/lru_cache.h"
+#include "base/memory/weak_ptr.h"
+#include "base/supports_user_data.h"
+
+class GURL;
+
+namespace content {
+class BrowserContext;
+}  // namespace content
+
+namespace ai_chat {
+
+// Transcripts of the videos most recently asked about in a BrowserContext,
+// so that reopening the panel on a video doesn't fetch and parse its
+// transcript again.
+class TranscriptCache : public base::SupportsUserData::Data {
+ public:
+  static constexpr size_t kMaxEntries = 10;
+
+  TranscriptCache();
+  TranscriptCache(const TranscriptCache&) = delete;
+  TranscriptCache& operator=(const TranscriptCache&) = delete;
+  ~TranscriptCache() override;
+
+  // Returns null for off the record contexts, including Tor, where nothing
+  // is kept.
+  static base::WeakPtr<TranscriptCache> GetForBrowserContext(
+      content::BrowserContext* context);
+
+  // Returns the transcript track of |transcript_url|, or an empty string if
+  // it doesn't name a video.
+  static std::string GetKey(const GURL& transcript_url);
+
+  const std::string* Get(const std::string& key);
+  void Put(const std::string& key, const std::string& transcript);
+
+ private:
+  base::LRUCache<std::string, std::string> transcripts_{kMaxEntries};
+  base::WeakPtrFactory<TranscriptCache> weak_ptr_factory_{this};
+};
+
+}  // namespace ai_chat
+
+#endif  // BRAVE_COMPONENTS_AI_CHAT_BROWSER_TRANSCRIPT_CACHE_H_
@@ -0,0 +1,104 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/ai_chat/browser/transcript_cache.h"
+
+#include <set>
+#include <string>
+
+#include "base/memory/weak_ptr.h"
+#include "base/strings/string_number_conversions.h"
+#include "content/public/test/browser_task_environment.h"
+#include "content/public/test/test_browser_context.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace ai_chat {
+
+namespace {
+
+constexpr char kTranscriptUrl[] =
+    "https://www.youtube.com/api/timedtext?v=abc123&lang=en&kind=asr"
+    "&fmt=srv3&expire=1700000000&signature=AAAA";
+
+std::string GetKey(const std::string& url) {
+  return TranscriptCache::GetKey(GURL(url));
+}
+
+}  // namespace
+
+class TranscriptCacheTest : public testing::Test {
+ protected:
+  content::BrowserTaskEnvironment task_environment_;
+  content::TestBrowserContext browser_context_;
+};
+
+TEST_F(TranscriptCacheTest, KeyIgnoresSignatureParams) {
+  EXPECT_EQ(GetKey(kTranscriptUrl),
+            GetKey("https://www.youtube.com/api/timedtext?v=abc123&lang=en"
+                   "&kind=asr&fmt=srv3&expire=1700003600&signature=BBBB"));
+}
+
+TEST_F(TranscriptCacheTest, KeySeparatesTracksOfTheSameVideo) {
+  const std::string base_url = "https://www.youtube.com/api/timedtext?v=abc123";
+  const std::set<std::string> keys = {
+      GetKey(base_url),
+      GetKey(base_url + "&lang=en"),
+      GetKey(base_url + "&lang=de"),
+      GetKey(base_url + "&lang=en&tlang=fr"),
+      GetKey(base_url + "&lang=en&kind=asr"),
+      GetKey(base_url + "&lang=en&name=Director"),
+      GetKey(base_url + "&lang=en&fmt=srv3"),
+      GetKey(base_url + "&lang=en&fmt=json3"),
+  };
+  EXPECT_EQ(8u, keys.size());
+}
+
+TEST_F(TranscriptCacheTest, NoKeyWithoutVideoId) {
+  EXPECT_TRUE(GetKey("https://www.youtube.com/api/timedtext?lang=en").empty());
+  EXPECT_TRUE(GetKey("https://www.youtube.com/api/timedtext?v=&lang=en")
+                  .empty());
+}
+
+TEST_F(TranscriptCacheTest, SameCacheForBrowserContext) {
+  base::WeakPtr<TranscriptCache> cache =
+      TranscriptCache::GetForBrowserContext(&browser_context_);
+  ASSERT_TRUE(cache);
+  cache->Put(GetKey(kTranscriptUrl), "transcript");
+
+  base::WeakPtr<TranscriptCache> same_cache =
+      TranscriptCache::GetForBrowserContext(&browser_context_);
+  ASSERT_TRUE(same_cache);
+  const std::string* transcript = same_cache->Get(GetKey(kTranscriptUrl));
+  ASSERT_TRUE(transcript);
+  EXPECT_EQ("transcript", *transcript);
+}
+
+TEST_F(TranscriptCacheTest, NoCacheForOffTheRecordContext) {
+  content::TestBrowserContext off_the_record_context;
+  off_the_record_context.set_is_off_the_record(true);
+
+  EXPECT_FALSE(TranscriptCache::GetForBrowserContext(&off_the_record_context));
+}
+
+TEST_F(TranscriptCacheTest, EvictLeastRecentlyUsedTranscript) {
+  TranscriptCache cache;
+  for (size_t i = 0; i < TranscriptCache::kMaxEntries; ++i) {
+    cache.Put(base::NumberToString(i), "transcript");
+  }
+
+  // Using the first transcript makes the second the least recently used.
+  EXPECT_TRUE(cache.Get("0"));
+
+  cache.Put(base::NumberToString(TranscriptCache::kMaxEntries), "transcript");
+
+  EXPECT_TRUE(cache.Get("0"));
+  EXPECT_FALSE(cache.Get("1"));
+  for (size_t i = 2; i <= TranscriptCache::kMaxEntries; ++i) {
+    EXPECT_TRUE(cache.Get(base::NumberToString(i))) << i;
+  }
+}
+
+}  // namespace ai_chat
@@ -5,6 +5,7 @@
 
 #include "brave/components/brave_ads/browser/ads_service.h"
 
+#include "brave/components/brave_ads/core/public/prefs/catalog_pref_names.h"
 #include "brave/components/brave_ads/core/public/prefs/pref_names.h"
 #include "components/pref_registry/pref_registry_syncable.h"
 
@@ -51,6 +52,7 @@ void AdsService::RegisterProfilePrefs(
   registry->RegisterIntegerPref(prefs::kCatalogVersion, 0);
   registry->RegisterInt64Pref(prefs::kCatalogPing, 0);
   registry->RegisterTimePref(prefs::kCatalogLastUpdated, base::Time());
+  registry->RegisterDictionaryPref(prefs::kCatalogCampaignDigests);
 
   registry->RegisterIntegerPref(prefs::kIssuerPing, 7'200'000);
   registry->RegisterListPref(prefs::kIssuers);
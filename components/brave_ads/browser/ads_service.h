@@ -208,7 +208,7 @@ class AdsService : public KeyedService {
   // for analysis. |redirect_chain| containing a list of redirect URLs that
   // occurred on the way to the current page. The current page is the last one
   // in the list (so even when there's no redirect, there should be one entry in
-  // the list). |text| containing the page content as text.
+  // the list). |text| containing a size-capped sample of the page text.
   virtual void NotifyTabTextContentDidChange(
       int32_t tab_id,
       const std::vector<GURL>& redirect_chain,
@@ -218,7 +218,8 @@ class AdsService : public KeyedService {
   // for analysis. |redirect_chain| containing a list of redirect URLs that
   // occurred on the way to the current page. The current page is the last one
   // in the list (so even when there's no redirect, there should be one entry in
-  // the list). |html| containing the page content as HTML.
+  // the list). |html| containing a minimal document with the page's og:title
+  // meta tag and the elements verifiable conversion ids are parsed from.
   virtual void NotifyTabHtmlContentDidChange(
       int32_t tab_id,
       const std::vector<GURL>& redirect_chain,
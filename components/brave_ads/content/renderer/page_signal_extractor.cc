@@ -0,0 +1,172 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_ads/content/renderer/page_signal_extractor.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/functional/bind.h"
+#include "base/strings/string_util.h"
+#include "base/strings/utf_string_conversions.h"
+#include "content/public/renderer/render_frame.h"
+#include "third_party/blink/public/platform/web_string.h"
+#include "third_party/blink/public/web/web_document.h"
+#include "third_party/blink/public/web/web_element.h"
+#include "third_party/blink/public/web/web_frame_content_dumper.h"
+#include "third_party/blink/public/web/web_local_frame.h"
+#include "third_party/blink/public/web/web_node.h"
+
+namespace brave_ads {
+
+namespace {
+
+constexpr char kDisplayProperty[] = "display";
+constexpr char kVisibilityProperty[] = "visibility";
+
+// Elements whose text is never rendered.
+constexpr const char* kSkippedTags[] = {"script", "style", "noscript"};
+
+bool ShouldSkipElement(const blink::WebElement& element) {
+  for (const char* const tag : kSkippedTags) {
+    if (element.HasHTMLTagName(blink::WebString::FromASCII(tag))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Elements with "display: none" have no layout object, so neither they nor
+// their descendants are rendered.
+bool IsDisplayNone(blink::WebElement& element) {
+  return element.GetComputedValue(blink::WebString::FromASCII(
+             kDisplayProperty)) == blink::WebString::FromASCII("none");
+}
+
+bool IsVisibilityHidden(blink::WebElement& element) {
+  return element.GetComputedValue(blink::WebString::FromASCII(
+             kVisibilityProperty)) != blink::WebString::FromASCII("visible");
+}
+
+// Appends the whitespace collapsed |text| to |out|, separated by a space and
+// truncated once |out| reaches |max_length| bytes.
+void AppendText(const blink::WebString& text,
+                const size_t max_length,
+                std::string& out) {
+  if (out.size() >= max_length) {
+    return;
+  }
+
+  // A UTF-16 code unit never takes less than a byte in UTF-8.
+  const size_t remaining_length = max_length - out.size();
+  const std::u16string collapsed_text = base::CollapseWhitespace(
+      text.Utf16().substr(0, remaining_length),
+      /*trim_sequences_with_line_breaks=*/true);
+  if (collapsed_text.empty()) {
+    return;
+  }
+
+  if (!out.empty()) {
+    out += ' ';
+  }
+  out += base::UTF16ToUTF8(collapsed_text);
+  if (out.size() > max_length) {
+    base::TruncateUTF8ToByteSize(out, max_length, &out);
+  }
+}
+
+// Walks the text nodes below |root| in document order, leaving out text of
+// elements without a layout object or with hidden visibility. Computed style
+// is looked up once per element on the way down.
+std::string GetRenderedText(blink::WebElement& root, const size_t max_length) {
+  std::string text;
+
+  // Visibility is inherited but can be overridden by descendants, so it is
+  // tracked for every open element rather than pruning the subtree.
+  std::vector<bool> is_visibility_hidden = {IsVisibilityHidden(root)};
+
+  blink::WebNode node = root.FirstChild();
+  while (!node.IsNull() && text.size() < max_length) {
+    if (node.IsTextNode()) {
+      if (!is_visibility_hidden.back()) {
+        AppendText(node.NodeValue(), max_length, text);
+      }
+    } else if (node.IsElementNode() && !node.FirstChild().IsNull()) {
+      blink::WebElement element = node.To<blink::WebElement>();
+      if (!ShouldSkipElement(element) && !IsDisplayNone(element)) {
+        is_visibility_hidden.push_back(IsVisibilityHidden(element));
+        node = node.FirstChild();
+        continue;
+      }
+    }
+
+    while (node != root && node.NextSibling().IsNull()) {
+      node = node.ParentNode();
+      is_visibility_hidden.pop_back();
+    }
+    if (node == root) {
+      break;
+    }
+    node = node.NextSibling();
+  }
+
+  return text;
+}
+
+}  // namespace
+
+PageSignalExtractor::PageSignalExtractor(
+    content::RenderFrame* render_frame,
+    service_manager::BinderRegistry* registry)
+    : content::RenderFrameObserver(render_frame) {
+  CHECK(render_frame);
+  CHECK(registry);
+
+  if (!render_frame->IsMainFrame()) {
+    return;
+  }
+
+  // Unretained is safe because |registry| is scoped to the render frame, just
+  // like this observer.
+  registry->AddInterface(base::BindRepeating(
+      &PageSignalExtractor::BindReceiver, base::Unretained(this)));
+}
+
+PageSignalExtractor::~PageSignalExtractor() = default;
+
+void PageSignalExtractor::BindReceiver(
+    mojo::PendingReceiver<mojom::PageSignalExtractor> pending_receiver) {
+  receivers_.Add(this, std::move(pending_receiver));
+}
+
+void PageSignalExtractor::OnDestruct() {
+  delete this;
+}
+
+void PageSignalExtractor::ExtractPageSignals(
+    const uint32_t max_text_sample_length,
+    ExtractPageSignalsCallback callback) {
+  mojom::PageSignalsPtr page_signals = mojom::PageSignals::New();
+
+  const blink::WebDocument document =
+      render_frame()->GetWebFrame()->GetDocument();
+  if (document.IsNull()) {
+    return std::move(callback).Run(std::move(page_signals));
+  }
+
+  page_signals->html =
+      blink::WebFrameContentDumper::DumpAsMarkup(render_frame()->GetWebFrame())
+          .Utf8();
+
+  blink::WebElement body = document.Body();
+  if (!body.IsNull()) {
+    page_signals->text_sample = GetRenderedText(body, max_text_sample_length);
+  }
+
+  std::move(callback).Run(std::move(page_signals));
+}
+
+}  // namespace brave_ads
@@ -0,0 +1,52 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_ADS_CONTENT_RENDERER_PAGE_SIGNAL_EXTRACTOR_H_
+#define BRAVE_COMPONENTS_BRAVE_ADS_CONTENT_RENDERER_PAGE_SIGNAL_EXTRACTOR_H_
+
+#include <cstdint>
+
+#include "brave/components/brave_ads/content/common/page_signal_extractor.mojom.h"
+#include "content/public/renderer/render_frame_observer.h"
+#include "mojo/public/cpp/bindings/pending_receiver.h"
+#include "mojo/public/cpp/bindings/receiver_set.h"
+#include "services/service_manager/public/cpp/binder_registry.h"
+
+namespace brave_ads {
+
+// Extracts the page signals used by ads from the main frame DOM, so that the
+// browser doesn't have to run scripts in the page. The text sample is built
+// without a layout and leaves out text which isn't rendered.
+class PageSignalExtractor final : public mojom::PageSignalExtractor,
+                                  public content::RenderFrameObserver {
+ public:
+  PageSignalExtractor(content::RenderFrame* render_frame,
+                      service_manager::BinderRegistry* registry);
+
+  PageSignalExtractor(const PageSignalExtractor&) = delete;
+  PageSignalExtractor& operator=(const PageSignalExtractor&) = delete;
+
+  PageSignalExtractor(PageSignalExtractor&&) noexcept = delete;
+  PageSignalExtractor& operator=(PageSignalExtractor&&) noexcept = delete;
+
+  ~PageSignalExtractor() override;
+
+ private:
+  void BindReceiver(
+      mojo::PendingReceiver<mojom::PageSignalExtractor> pending_receiver);
+
+  // content::RenderFrameObserver:
+  void OnDestruct() override;
+
+  // mojom::PageSignalExtractor:
+  void ExtractPageSignals(uint32_t max_text_sample_length,
+                          ExtractPageSignalsCallback callback) override;
+
+  mojo::ReceiverSet<mojom::PageSignalExtractor> receivers_;
+};
+
+}  // namespace brave_ads
+
+#endif  // BRAVE_COMPONENTS_BRAVE_ADS_CONTENT_RENDERER_PAGE_SIGNAL_EXTRACTOR_H_
@@ -0,0 +1,192 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_ads/content/renderer/search_result_ad_visibility_observer.h"
+
+#include <iterator>
+#include <utility>
+
+#include "base/check.h"
+#include "base/functional/bind.h"
+#include "content/public/renderer/render_frame.h"
+#include "gin/converter.h"
+#include "gin/function_template.h"
+#include "third_party/blink/public/platform/web_string.h"
+#include "third_party/blink/public/web/blink.h"
+#include "third_party/blink/public/web/web_local_frame.h"
+#include "third_party/blink/public/web/web_script_source.h"
+#include "v8/include/v8-context.h"
+#include "v8/include/v8-function.h"
+#include "v8/include/v8-isolate.h"
+#include "v8/include/v8-local-handle.h"
+#include "v8/include/v8-primitive.h"
+
+namespace brave_ads {
+
+namespace {
+
+// Evaluates to a function which observes the ads of |placementIds| until they
+// become visible and calls |reportVisible| for each of them. Ads which are
+// added to the document later on are observed as well. Calling the function
+// again disconnects the observers of the previous call.
+constexpr char kObserveSearchResultAdsScript[] =
+    R"(
+        (function (placementIds, reportVisible) {
+          for (const observer of window.braveSearchResultAdObservers || []) {
+            observer.disconnect();
+          }
+
+          const pendingPlacementIds = new Set(placementIds);
+          const intersectionObserver = new IntersectionObserver((entries) => {
+            for (const entry of entries) {
+              if (!entry.isIntersecting) {
+                continue;
+              }
+              const element = entry.target;
+              if (window.getComputedStyle(element).visibility === 'hidden') {
+                continue;
+              }
+              intersectionObserver.unobserve(element);
+              const placementId = element.dataset.placementId;
+              if (!pendingPlacementIds.delete(placementId)) {
+                continue;
+              }
+              reportVisible(placementId);
+            }
+            if (pendingPlacementIds.size === 0) {
+              intersectionObserver.disconnect();
+              mutationObserver.disconnect();
+            }
+          });
+
+          const maybeObserve = (element) => {
+            if (element.matches('div[data-placement-id]') &&
+                pendingPlacementIds.has(element.dataset.placementId)) {
+              intersectionObserver.observe(element);
+            }
+          };
+          const observeSubtree = (root) => {
+            maybeObserve(root);
+            for (const element of
+                     root.querySelectorAll('div[data-placement-id]')) {
+              maybeObserve(element);
+            }
+          };
+
+          const mutationObserver = new MutationObserver((mutations) => {
+            for (const mutation of mutations) {
+              if (mutation.type === 'attributes') {
+                maybeObserve(mutation.target);
+                continue;
+              }
+              for (const node of mutation.addedNodes) {
+                if (node.nodeType === Node.ELEMENT_NODE) {
+                  observeSubtree(node);
+                }
+              }
+            }
+          });
+          mutationObserver.observe(document, {
+            childList: true,
+            subtree: true,
+            attributes: true,
+            attributeFilter: ['data-placement-id'],
+          });
+          window.braveSearchResultAdObservers =
+              [intersectionObserver, mutationObserver];
+
+          if (document.documentElement) {
+            observeSubtree(document.documentElement);
+          }
+        })
+    )";
+
+}  // namespace
+
+SearchResultAdVisibilityObserver::SearchResultAdVisibilityObserver(
+    content::RenderFrame* render_frame,
+    service_manager::BinderRegistry* registry,
+    const int32_t isolated_world_id)
+    : content::RenderFrameObserver(render_frame),
+      isolated_world_id_(isolated_world_id) {
+  CHECK(render_frame);
+  CHECK(registry);
+
+  if (!render_frame->IsMainFrame()) {
+    return;
+  }
+
+  // Unretained is safe because |registry| is scoped to the render frame, just
+  // like this observer.
+  registry->AddInterface(
+      base::BindRepeating(&SearchResultAdVisibilityObserver::BindReceiver,
+                          base::Unretained(this)));
+}
+
+SearchResultAdVisibilityObserver::~SearchResultAdVisibilityObserver() = default;
+
+void SearchResultAdVisibilityObserver::BindReceiver(
+    mojo::PendingReceiver<mojom::SearchResultAdVisibilityObserver>
+        pending_receiver) {
+  receivers_.Add(this, std::move(pending_receiver));
+}
+
+void SearchResultAdVisibilityObserver::OnSearchResultAdVisible(
+    const std::string& placement_id) {
+  if (reporter_.is_bound()) {
+    reporter_->ReportSearchResultAdVisible(placement_id);
+  }
+}
+
+void SearchResultAdVisibilityObserver::OnDestruct() {
+  delete this;
+}
+
+void SearchResultAdVisibilityObserver::ObserveSearchResultAds(
+    const std::vector<std::string>& placement_ids,
+    mojo::PendingRemote<mojom::SearchResultAdImpressionReporter> reporter) {
+  // The script disconnects the observers injected for a previous request, so
+  // only the ads of |placement_ids| are reported to the new reporter.
+  reporter_.reset();
+  reporter_.Bind(std::move(reporter));
+
+  blink::WebLocalFrame* web_frame = render_frame()->GetWebFrame();
+  v8::Isolate* isolate = blink::MainThreadIsolate();
+  v8::HandleScope handle_scope(isolate);
+
+  const v8::Local<v8::Value> observe_search_result_ads =
+      web_frame->ExecuteScriptInIsolatedWorldAndReturnValue(
+          isolated_world_id_,
+          blink::WebScriptSource(
+              blink::WebString::FromASCII(kObserveSearchResultAdsScript)),
+          blink::BackForwardCacheAware::kAllow);
+  if (observe_search_result_ads.IsEmpty() ||
+      !observe_search_result_ads->IsFunction()) {
+    return;
+  }
+
+  const v8::Local<v8::Context> context =
+      web_frame->GetScriptContextFromWorldId(isolate, isolated_world_id_);
+  v8::Context::Scope context_scope(context);
+
+  auto on_search_result_ad_visible = base::BindRepeating(
+      &SearchResultAdVisibilityObserver::OnSearchResultAdVisible,
+      weak_factory_.GetWeakPtr());
+  v8::Local<v8::Function> report_visible;
+  if (!gin::CreateFunctionTemplate(isolate,
+                                   std::move(on_search_result_ad_visible))
+           ->GetFunction(context)
+           .ToLocal(&report_visible)) {
+    return;
+  }
+
+  v8::Local<v8::Value> argv[] = {gin::ConvertToV8(isolate, placement_ids),
+                                 report_visible};
+  web_frame->CallFunctionEvenIfScriptDisabled(
+      observe_search_result_ads.As<v8::Function>(), v8::Undefined(isolate),
+      std::size(argv), argv);
+}
+
+}  // namespace brave_ads
@@ -0,0 +1,73 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_ADS_CONTENT_RENDERER_SEARCH_RESULT_AD_VISIBILITY_OBSERVER_H_
+#define BRAVE_COMPONENTS_BRAVE_ADS_CONTENT_RENDERER_SEARCH_RESULT_AD_VISIBILITY_OBSERVER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "base/memory/weak_ptr.h"
+#include "brave/components/brave_ads/content/common/search_result_ad_visibility_observer.mojom.h"
+#include "content/public/renderer/render_frame_observer.h"
+#include "mojo/public/cpp/bindings/pending_receiver.h"
+#include "mojo/public/cpp/bindings/pending_remote.h"
+#include "mojo/public/cpp/bindings/receiver_set.h"
+#include "mojo/public/cpp/bindings/remote.h"
+#include "services/service_manager/public/cpp/binder_registry.h"
+
+namespace brave_ads {
+
+// Observes the visibility of search result ads with a single
+// IntersectionObserver injected into an isolated world, and reports each ad to
+// the browser once it becomes visible.
+class SearchResultAdVisibilityObserver final
+    : public mojom::SearchResultAdVisibilityObserver,
+      public content::RenderFrameObserver {
+ public:
+  SearchResultAdVisibilityObserver(content::RenderFrame* render_frame,
+                                   service_manager::BinderRegistry* registry,
+                                   int32_t isolated_world_id);
+
+  SearchResultAdVisibilityObserver(const SearchResultAdVisibilityObserver&) =
+      delete;
+  SearchResultAdVisibilityObserver& operator=(
+      const SearchResultAdVisibilityObserver&) = delete;
+
+  SearchResultAdVisibilityObserver(
+      SearchResultAdVisibilityObserver&&) noexcept = delete;
+  SearchResultAdVisibilityObserver& operator=(
+      SearchResultAdVisibilityObserver&&) noexcept = delete;
+
+  ~SearchResultAdVisibilityObserver() override;
+
+ private:
+  void BindReceiver(
+      mojo::PendingReceiver<mojom::SearchResultAdVisibilityObserver>
+          pending_receiver);
+
+  void OnSearchResultAdVisible(const std::string& placement_id);
+
+  // content::RenderFrameObserver:
+  void OnDestruct() override;
+
+  // mojom::SearchResultAdVisibilityObserver:
+  void ObserveSearchResultAds(
+      const std::vector<std::string>& placement_ids,
+      mojo::PendingRemote<mojom::SearchResultAdImpressionReporter> reporter)
+      override;
+
+  const int32_t isolated_world_id_;
+
+  mojo::ReceiverSet<mojom::SearchResultAdVisibilityObserver> receivers_;
+  mojo::Remote<mojom::SearchResultAdImpressionReporter> reporter_;
+
+  base::WeakPtrFactory<SearchResultAdVisibilityObserver> weak_factory_{this};
+};
+
+}  // namespace brave_ads
+
+#endif  // BRAVE_COMPONENTS_BRAVE_ADS_CONTENT_RENDERER_SEARCH_RESULT_AD_VISIBILITY_OBSERVER_H_
@@ -5,13 +5,19 @@
 
 #include "brave/components/brave_ads/core/internal/catalog/catalog.h"
 
+#include <utility>
+
 #include "base/check.h"
+#include "base/functional/bind.h"
 #include "base/time/time.h"
 #include "brave/components/brave_ads/core/internal/catalog/catalog_info.h"
 #include "brave/components/brave_ads/core/internal/catalog/catalog_url_request.h"
 #include "brave/components/brave_ads/core/internal/catalog/catalog_util.h"
 #include "brave/components/brave_ads/core/internal/client/ads_client_helper.h"
 #include "brave/components/brave_ads/core/internal/common/logging_util.h"
+#include "brave/components/brave_ads/core/internal/creatives/creatives_builder.h"
+#include "brave/components/brave_ads/core/internal/creatives/creatives_diff_builder.h"
+#include "brave/components/brave_ads/core/internal/creatives/creatives_info.h"
 #include "brave/components/brave_ads/core/internal/database/database_manager.h"
 #include "brave/components/brave_ads/core/internal/settings/settings.h"
 #include "brave/components/brave_ads/core/public/ads_feature.h"
@@ -83,7 +89,7 @@ void Catalog::ShutdownCatalogUrlRequest() {
     catalog_url_request_.reset();
     BLOG(1, "Shutdown catalog URL request");
 
-    ResetCatalog();
+    Reset();
     BLOG(1, "Reset catalog");
   }
 }
@@ -94,6 +100,34 @@ void Catalog::MaybeFetchCatalog() const {
   }
 }
 
+void Catalog::Save(const CatalogInfo& catalog) {
+  const CreativesInfo creatives = BuildCreatives(catalog);
+  CampaignDigestMap campaign_digests = BuildCampaignDigests(creatives);
+
+  SaveCatalog(catalog, creatives, campaign_digests,
+              base::BindOnce(&Catalog::SaveCallback,
+                             weak_factory_.GetWeakPtr(),
+                             std::move(campaign_digests)));
+}
+
+void Catalog::SaveCallback(const CampaignDigestMap& campaign_digests,
+                           const bool success) {
+  if (!success) {
+    return BLOG(0, "Failed to save catalog");
+  }
+
+  BLOG(3, "Successfully saved catalog");
+
+  SetCatalogCampaignDigests(campaign_digests);
+}
+
+void Catalog::Reset() {
+  // Drop pending saves, their creatives are deleted by the reset.
+  weak_factory_.InvalidateWeakPtrs();
+
+  ResetCatalog();
+}
+
 void Catalog::NotifyDidUpdateCatalog(const CatalogInfo& catalog) const {
   for (CatalogObserver& observer : observers_) {
     observer.OnDidUpdateCatalog(catalog);
@@ -129,7 +163,7 @@ void Catalog::OnDidFetchCatalog(const CatalogInfo& catalog) {
     return BLOG(1, "Catalog id " << catalog.id << " is up to date");
   }
 
-  SaveCatalog(catalog);
+  Save(catalog);
 
   NotifyDidUpdateCatalog(catalog);
 }
@@ -140,7 +174,7 @@ void Catalog::OnFailedToFetchCatalog() {
 
 void Catalog::OnDidMigrateDatabase(const int /*from_version*/,
                                    const int /*to_version*/) {
-  ResetCatalog();
+  Reset();
 }
 
 }  // namespace brave_ads
@@ -9,9 +9,11 @@
 #include <memory>
 #include <string>
 
+#include "base/memory/weak_ptr.h"
 #include "base/observer_list.h"
 #include "brave/components/brave_ads/core/internal/catalog/catalog_observer.h"
 #include "brave/components/brave_ads/core/internal/catalog/catalog_url_request_delegate.h"
+#include "brave/components/brave_ads/core/internal/creatives/creatives_diff_info.h"
 #include "brave/components/brave_ads/core/internal/database/database_manager_observer.h"
 #include "brave/components/brave_ads/core/public/client/ads_client_notifier_observer.h"
 
@@ -46,6 +48,10 @@ class Catalog final : public AdsClientNotifierObserver,
 
   void MaybeFetchCatalog() const;
 
+  void Save(const CatalogInfo& catalog);
+  void SaveCallback(const CampaignDigestMap& campaign_digests, bool success);
+  void Reset();
+
   void NotifyDidUpdateCatalog(const CatalogInfo& catalog) const;
   void NotifyFailedToUpdateCatalog() const;
 
@@ -63,6 +69,8 @@ class Catalog final : public AdsClientNotifierObserver,
   base::ObserverList<CatalogObserver> observers_;
 
   std::unique_ptr<CatalogUrlRequest> catalog_url_request_;
+
+  base::WeakPtrFactory<Catalog> weak_factory_{this};
 };
 
 }  // namespace brave_ads
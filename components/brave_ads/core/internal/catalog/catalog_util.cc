@@ -5,14 +5,22 @@
 
 #include "brave/components/brave_ads/core/internal/catalog/catalog_util.h"
 
+#include <utility>
+
 #include "base/time/time.h"
+#include "base/values.h"
 #include "brave/components/brave_ads/core/internal/account/deposits/deposits_database_util.h"
 #include "brave/components/brave_ads/core/internal/catalog/catalog_info.h"
 #include "brave/components/brave_ads/core/internal/client/ads_client_helper.h"
+#include "brave/components/brave_ads/core/internal/common/database/database_transaction_util.h"
+#include "brave/components/brave_ads/core/internal/common/logging_util.h"
 #include "brave/components/brave_ads/core/internal/creatives/campaigns_database_util.h"
+#include "brave/components/brave_ads/core/internal/creatives/conversions/creative_set_conversion_database_table.h"
 #include "brave/components/brave_ads/core/internal/creatives/conversions/creative_set_conversion_database_table_util.h"
 #include "brave/components/brave_ads/core/internal/creatives/creative_ads_database_util.h"
-#include "brave/components/brave_ads/core/internal/creatives/creatives_builder.h"
+#include "brave/components/brave_ads/core/internal/creatives/creatives_database_util.h"
+#include "brave/components/brave_ads/core/internal/creatives/creatives_diff_builder.h"
+#include "brave/components/brave_ads/core/internal/creatives/creatives_diff_info.h"
 #include "brave/components/brave_ads/core/internal/creatives/creatives_info.h"
 #include "brave/components/brave_ads/core/internal/creatives/dayparts_database_util.h"
 #include "brave/components/brave_ads/core/internal/creatives/geo_targets_database_util.h"
@@ -21,7 +29,10 @@
 #include "brave/components/brave_ads/core/internal/creatives/notification_ads/creative_notification_ads_database_util.h"
 #include "brave/components/brave_ads/core/internal/creatives/promoted_content_ads/creative_promoted_content_ads_database_util.h"
 #include "brave/components/brave_ads/core/internal/creatives/segments_database_util.h"
+#include "brave/components/brave_ads/core/mojom/brave_ads.mojom.h"
+#include "brave/components/brave_ads/core/public/prefs/catalog_pref_names.h"
 #include "brave/components/brave_ads/core/public/prefs/pref_names.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
 
 namespace brave_ads {
 
@@ -49,21 +60,38 @@ void PurgeExpired() {
 
 }  // namespace
 
-void SaveCatalog(const CatalogInfo& catalog) {
-  Delete();
-
+void SaveCatalog(const CatalogInfo& catalog,
+                 const CreativesInfo& creatives,
+                 const CampaignDigestMap& campaign_digests,
+                 ResultCallback callback) {
   PurgeExpired();
 
   SetCatalogId(catalog.id);
   SetCatalogVersion(catalog.version);
   SetCatalogPing(catalog.ping);
 
-  const CreativesInfo creatives = BuildCreatives(catalog);
-  database::SaveCreativeNotificationAds(creatives.notification_ads);
-  database::SaveCreativeInlineContentAds(creatives.inline_content_ads);
-  database::SaveCreativeNewTabPageAds(creatives.new_tab_page_ads);
-  database::SaveCreativePromotedContentAds(creatives.promoted_content_ads);
-  database::SaveCreativeSetConversions(creatives.conversions);
+  // Until the transaction is committed the saved creatives are unknown, so a
+  // catalog which is saved in the meantime, or after a crash, replaces all
+  // creatives.
+  const CampaignDigestMap last_campaign_digests = GetCatalogCampaignDigests();
+  AdsClientHelper::GetInstance()->ClearPref(prefs::kCatalogCampaignDigests);
+
+  mojom::DBTransactionInfoPtr transaction = mojom::DBTransactionInfo::New();
+
+  if (last_campaign_digests.empty()) {
+    database::ReplaceCreatives(&*transaction, creatives);
+  } else {
+    const CreativesDiffInfo creatives_diff = BuildCreativesDiff(
+        last_campaign_digests, campaign_digests, creatives);
+    BLOG(1, "Deleting " << creatives_diff.campaign_ids.size()
+                        << " changed or removed campaigns");
+    database::ApplyCreativesDiff(&*transaction, creatives_diff);
+  }
+
+  database::table::CreativeSetConversions creative_set_conversions_table;
+  creative_set_conversions_table.Save(&*transaction, creatives.conversions);
+
+  database::RunTransaction(std::move(transaction), std::move(callback));
 }
 
 void ResetCatalog() {
@@ -71,6 +99,7 @@ void ResetCatalog() {
   AdsClientHelper::GetInstance()->ClearPref(prefs::kCatalogVersion);
   AdsClientHelper::GetInstance()->ClearPref(prefs::kCatalogPing);
   AdsClientHelper::GetInstance()->ClearPref(prefs::kCatalogLastUpdated);
+  AdsClientHelper::GetInstance()->ClearPref(prefs::kCatalogCampaignDigests);
 
   Delete();
 }
@@ -102,6 +131,34 @@ void SetCatalogPing(const base::TimeDelta ping) {
                                                ping.InMilliseconds());
 }
 
+CampaignDigestMap GetCatalogCampaignDigests() {
+  const absl::optional<base::Value::Dict> dict =
+      AdsClientHelper::GetInstance()->GetDictPref(
+          prefs::kCatalogCampaignDigests);
+  if (!dict) {
+    return {};
+  }
+
+  CampaignDigestMap campaign_digests;
+  for (const auto [campaign_id, value] : *dict) {
+    if (const std::string* const digest = value.GetIfString()) {
+      campaign_digests.emplace(campaign_id, *digest);
+    }
+  }
+
+  return campaign_digests;
+}
+
+void SetCatalogCampaignDigests(const CampaignDigestMap& campaign_digests) {
+  base::Value::Dict dict;
+  for (const auto& [campaign_id, digest] : campaign_digests) {
+    dict.Set(campaign_id, digest);
+  }
+
+  AdsClientHelper::GetInstance()->SetDictPref(prefs::kCatalogCampaignDigests,
+                                              std::move(dict));
+}
+
 base::Time GetCatalogLastUpdated() {
   return AdsClientHelper::GetInstance()->GetTimePref(
       prefs::kCatalogLastUpdated);
@@ -8,6 +8,9 @@
 
 #include <string>
 
+#include "brave/components/brave_ads/core/internal/creatives/creatives_diff_info.h"
+#include "brave/components/brave_ads/core/public/client/ads_client_callback.h"
+
 namespace base {
 class Time;
 class TimeDelta;
@@ -16,8 +19,17 @@ class TimeDelta;
 namespace brave_ads {
 
 struct CatalogInfo;
-
-void SaveCatalog(const CatalogInfo& catalog);
+struct CreativesInfo;
+
+// Saves |catalog| along with its |creatives| and creative set conversions in a
+// single transaction, so the previous catalog stays visible until the new one
+// is committed. If the campaign digests of the last saved catalog are known,
+// only campaigns whose digest differs from |campaign_digests| are written. The
+// caller should set |campaign_digests| once the save succeeded.
+void SaveCatalog(const CatalogInfo& catalog,
+                 const CreativesInfo& creatives,
+                 const CampaignDigestMap& campaign_digests,
+                 ResultCallback callback);
 void ResetCatalog();
 
 std::string GetCatalogId();
@@ -29,6 +41,9 @@ void SetCatalogVersion(int version);
 base::TimeDelta GetCatalogPing();
 void SetCatalogPing(base::TimeDelta ping);
 
+CampaignDigestMap GetCatalogCampaignDigests();
+void SetCatalogCampaignDigests(const CampaignDigestMap& campaign_digests);
+
 base::Time GetCatalogLastUpdated();
 void SetCatalogLastUpdated(base::Time last_updated_at);
 
@@ -0,0 +1,125 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_ads/core/internal/conversions/conversion_ad_events_database_table.h"
+
+#include <cinttypes>
+#include <utility>
+
+#include "base/check.h"
+#include "base/functional/bind.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "brave/components/brave_ads/core/internal/client/ads_client_helper.h"
+#include "brave/components/brave_ads/core/internal/common/database/database_bind_util.h"
+#include "brave/components/brave_ads/core/internal/common/database/database_column_util.h"
+#include "brave/components/brave_ads/core/internal/common/logging_util.h"
+#include "brave/components/brave_ads/core/mojom/brave_ads.mojom.h"
+#include "brave/components/brave_ads/core/public/account/confirmations/confirmation_type.h"
+#include "brave/components/brave_ads/core/public/units/ad_type.h"
+
+namespace brave_ads::database::table {
+
+namespace {
+
+void BindRecords(mojom::DBCommandInfo* command) {
+  CHECK(command);
+
+  command->record_bindings = {
+      mojom::DBCommandInfo::RecordBindingType::STRING_TYPE,  // placement_id
+      mojom::DBCommandInfo::RecordBindingType::STRING_TYPE,  // type
+      mojom::DBCommandInfo::RecordBindingType::
+          STRING_TYPE,  // confirmation_type
+      mojom::DBCommandInfo::RecordBindingType::STRING_TYPE,  // campaign_id
+      mojom::DBCommandInfo::RecordBindingType::STRING_TYPE,  // creative_set_id
+      mojom::DBCommandInfo::RecordBindingType::
+          STRING_TYPE,  // creative_instance_id
+      mojom::DBCommandInfo::RecordBindingType::STRING_TYPE,  // advertiser_id
+      mojom::DBCommandInfo::RecordBindingType::STRING_TYPE,  // segment
+      mojom::DBCommandInfo::RecordBindingType::INT64_TYPE    // created_at
+  };
+}
+
+AdEventInfo GetFromRecord(mojom::DBRecordInfo* record) {
+  CHECK(record);
+
+  AdEventInfo ad_event;
+
+  ad_event.placement_id = ColumnString(record, 0);
+  ad_event.type = AdType(ColumnString(record, 1));
+  ad_event.confirmation_type = ConfirmationType(ColumnString(record, 2));
+  ad_event.campaign_id = ColumnString(record, 3);
+  ad_event.creative_set_id = ColumnString(record, 4);
+  ad_event.creative_instance_id = ColumnString(record, 5);
+  ad_event.advertiser_id = ColumnString(record, 6);
+  ad_event.segment = ColumnString(record, 7);
+  ad_event.created_at = base::Time::FromDeltaSinceWindowsEpoch(
+      base::Microseconds(ColumnInt64(record, 8)));
+
+  return ad_event;
+}
+
+void GetForCreativeSetsCallback(
+    GetConversionAdEventsCallback callback,
+    mojom::DBCommandResponseInfoPtr command_response) {
+  if (!command_response ||
+      command_response->status !=
+          mojom::DBCommandResponseInfo::StatusType::RESPONSE_OK) {
+    BLOG(0, "Failed to get ad events for creative sets");
+    return std::move(callback).Run(/*success*/ false, /*ad_events*/ {});
+  }
+
+  CHECK(command_response->result);
+
+  AdEventList ad_events;
+
+  for (const auto& record : command_response->result->get_records()) {
+    const AdEventInfo ad_event = GetFromRecord(&*record);
+    ad_events.push_back(ad_event);
+  }
+
+  std::move(callback).Run(/*success*/ true, ad_events);
+}
+
+}  // namespace
+
+void ConversionAdEvents::GetForCreativeSets(
+    const std::vector<std::string>& creative_set_ids,
+    const base::TimeDelta observation_window,
+    GetConversionAdEventsCallback callback) const {
+  if (creative_set_ids.empty()) {
+    return std::move(callback).Run(/*success*/ true, /*ad_events*/ {});
+  }
+
+  mojom::DBTransactionInfoPtr transaction = mojom::DBTransactionInfo::New();
+  mojom::DBCommandInfoPtr command = mojom::DBCommandInfo::New();
+  command->type = mojom::DBCommandInfo::Type::READ;
+  command->sql = base::StringPrintf(
+      "SELECT ae.placement_id, ae.type, ae.confirmation_type, ae.campaign_id, "
+      "ae.creative_set_id, ae.creative_instance_id, ae.advertiser_id, "
+      "ae.segment, ae.created_at FROM ad_events AS ae WHERE "
+      "ae.creative_set_id IN %s AND (ae.created_at >= %" PRId64
+      " OR ae.confirmation_type = ?) ORDER BY created_at DESC;",
+      BuildBindingParameterPlaceholder(creative_set_ids.size()).c_str(),
+      (base::Time::Now() - observation_window)
+          .ToDeltaSinceWindowsEpoch()
+          .InMicroseconds());
+  BindRecords(&*command);
+
+  int index = 0;
+  for (const auto& creative_set_id : creative_set_ids) {
+    BindString(&*command, index++, creative_set_id);
+  }
+  BindString(&*command, index++,
+             ConfirmationType(ConfirmationType::kConversion).ToString());
+
+  transaction->commands.push_back(std::move(command));
+
+  AdsClientHelper::GetInstance()->RunDBTransaction(
+      std::move(transaction),
+      base::BindOnce(&GetForCreativeSetsCallback, std::move(callback)));
+}
+
+}  // namespace brave_ads::database::table
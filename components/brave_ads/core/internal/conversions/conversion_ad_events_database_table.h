@@ -0,0 +1,39 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_ADS_CORE_INTERNAL_CONVERSIONS_CONVERSION_AD_EVENTS_DATABASE_TABLE_H_
+#define BRAVE_COMPONENTS_BRAVE_ADS_CORE_INTERNAL_CONVERSIONS_CONVERSION_AD_EVENTS_DATABASE_TABLE_H_
+
+#include <string>
+#include <vector>
+
+#include "base/functional/callback_forward.h"
+#include "brave/components/brave_ads/core/internal/user/user_interaction/ad_events/ad_event_info.h"
+
+namespace base {
+class TimeDelta;
+}  // namespace base
+
+namespace brave_ads::database::table {
+
+using GetConversionAdEventsCallback =
+    base::OnceCallback<void(bool success, const AdEventList& ad_events)>;
+
+// Reads the ad events which can convert from the |ad_events| table, which is
+// owned by |AdEvents|, without loading the whole table.
+class ConversionAdEvents final {
+ public:
+  // Gets the ad events for |creative_set_ids| which were created within
+  // |observation_window|, ordered in descending order by |created_at|.
+  // Conversion events are returned regardless of when they were created, so
+  // that a creative set is never converted twice.
+  void GetForCreativeSets(const std::vector<std::string>& creative_set_ids,
+                          base::TimeDelta observation_window,
+                          GetConversionAdEventsCallback callback) const;
+};
+
+}  // namespace brave_ads::database::table
+
+#endif  // BRAVE_COMPONENTS_BRAVE_ADS_CORE_INTERNAL_CONVERSIONS_CONVERSION_AD_EVENTS_DATABASE_TABLE_H_
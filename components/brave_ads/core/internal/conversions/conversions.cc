@@ -5,14 +5,20 @@
 
 #include "brave/components/brave_ads/core/internal/conversions/conversions.h"
 
+#include <algorithm>
+
 #include "base/check.h"
+#include "base/containers/contains.h"
 #include "base/functional/bind.h"
+#include "base/time/time.h"
+#include "brave/components/brave_ads/core/internal/catalog/catalog_util.h"
 #include "brave/components/brave_ads/core/internal/common/logging_util.h"
 #include "brave/components/brave_ads/core/internal/common/time/time_formatting_util.h"
 #include "brave/components/brave_ads/core/internal/conversions/actions/conversion_action_types_util.h"
 #include "brave/components/brave_ads/core/internal/conversions/conversion/conversion_builder.h"
 #include "brave/components/brave_ads/core/internal/conversions/conversion/conversion_info.h"
 #include "brave/components/brave_ads/core/internal/conversions/conversion/conversion_util.h"
+#include "brave/components/brave_ads/core/internal/conversions/conversion_ad_events_database_table.h"
 #include "brave/components/brave_ads/core/internal/conversions/conversions_observer.h"
 #include "brave/components/brave_ads/core/internal/conversions/conversions_util.h"
 #include "brave/components/brave_ads/core/internal/conversions/resource/conversion_resource_id_pattern_info.h"
@@ -25,7 +31,6 @@
 #include "brave/components/brave_ads/core/internal/tabs/tab_manager.h"
 #include "brave/components/brave_ads/core/internal/user/user_interaction/ad_events/ad_event_builder.h"
 #include "brave/components/brave_ads/core/internal/user/user_interaction/ad_events/ad_events.h"
-#include "brave/components/brave_ads/core/internal/user/user_interaction/ad_events/ad_events_database_table.h"
 #include "brave/components/brave_ads/core/public/account/confirmations/confirmation_type.h"
 #include "url/gurl.h"
 
@@ -58,7 +63,12 @@ void Conversions::MaybeConvert(const std::vector<GURL>& redirect_chain,
 
   BLOG(1, "Checking for conversions");
 
-  GetCreativeSetConversions(redirect_chain, html);
+  if (!creative_set_conversion_index_ ||
+      creative_set_conversion_index_catalog_id_ != GetCatalogId()) {
+    return GetCreativeSetConversions(redirect_chain, html);
+  }
+
+  MaybeConvertMatchingCreativeSetConversions(redirect_chain, html);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -67,12 +77,13 @@ void Conversions::GetCreativeSetConversions(
     const std::vector<GURL>& redirect_chain,
     const std::string& html) {
   const database::table::CreativeSetConversions database_table;
-  database_table.GetAll(
-      base::BindOnce(&Conversions::GetCreativeSetConversionsCallback,
-                     weak_factory_.GetWeakPtr(), redirect_chain, html));
+  database_table.GetAll(base::BindOnce(
+      &Conversions::GetCreativeSetConversionsCallback,
+      weak_factory_.GetWeakPtr(), GetCatalogId(), redirect_chain, html));
 }
 
 void Conversions::GetCreativeSetConversionsCallback(
+    const std::string& catalog_id,
     const std::vector<GURL>& redirect_chain,
     const std::string& html,
     const bool success,
@@ -81,10 +92,29 @@ void Conversions::GetCreativeSetConversionsCallback(
     return BLOG(1, "Failed to get creative set conversions");
   }
 
-  if (creative_set_conversions.empty()) {
+  creative_set_conversion_index_.emplace(creative_set_conversions);
+  creative_set_conversion_index_catalog_id_ = catalog_id;
+
+  MaybeConvertMatchingCreativeSetConversions(redirect_chain, html);
+}
+
+void Conversions::MaybeConvertMatchingCreativeSetConversions(
+    const std::vector<GURL>& redirect_chain,
+    const std::string& html) {
+  CHECK(creative_set_conversion_index_);
+
+  if (creative_set_conversion_index_->empty()) {
     return BLOG(1, "There are no creative set conversions");
   }
 
+  // Most pages don't match any conversion, so reject them before reading ad
+  // events from the database.
+  const CreativeSetConversionList creative_set_conversions =
+      creative_set_conversion_index_->FindMatching(redirect_chain);
+  if (creative_set_conversions.empty()) {
+    return BLOG(1, "There are no matching creative set conversions");
+  }
+
   GetAdEvents(redirect_chain, html, creative_set_conversions);
 }
 
@@ -92,10 +122,26 @@ void Conversions::GetAdEvents(
     const std::vector<GURL>& redirect_chain,
     const std::string& html,
     const CreativeSetConversionList& creative_set_conversions) {
-  const database::table::AdEvents database_table;
-  database_table.GetAll(base::BindOnce(
-      &Conversions::GetAdEventsCallback, weak_factory_.GetWeakPtr(),
-      redirect_chain, html, creative_set_conversions));
+  // Only read the ad events which could convert for the matching creative set
+  // conversions, i.e. for their creative sets and within the longest
+  // observation window.
+  std::vector<std::string> creative_set_ids;
+  base::TimeDelta observation_window;
+  for (const auto& creative_set_conversion : creative_set_conversions) {
+    if (!base::Contains(creative_set_ids, creative_set_conversion.id)) {
+      creative_set_ids.push_back(creative_set_conversion.id);
+    }
+
+    observation_window = std::max(observation_window,
+                                  creative_set_conversion.observation_window);
+  }
+
+  const database::table::ConversionAdEvents database_table;
+  database_table.GetForCreativeSets(
+      creative_set_ids, observation_window,
+      base::BindOnce(&Conversions::GetAdEventsCallback,
+                     weak_factory_.GetWeakPtr(), redirect_chain, html,
+                     creative_set_conversions));
 }
 
 void Conversions::GetAdEventsCallback(
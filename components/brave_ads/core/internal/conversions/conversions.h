@@ -16,6 +16,7 @@
 #include "brave/components/brave_ads/core/internal/conversions/queue/conversion_queue_delegate.h"
 #include "brave/components/brave_ads/core/internal/conversions/resource/conversion_resource.h"
 #include "brave/components/brave_ads/core/internal/creatives/conversions/creative_set_conversion_info.h"
+#include "brave/components/brave_ads/core/internal/creatives/conversions/creative_set_conversion_url_pattern_index.h"
 #include "brave/components/brave_ads/core/internal/tabs/tab_manager_observer.h"
 #include "brave/components/brave_ads/core/internal/user/user_interaction/ad_events/ad_event_info.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
@@ -53,11 +54,16 @@ class Conversions final : public ConversionQueueDelegate,
   void GetCreativeSetConversions(const std::vector<GURL>& redirect_chain,
                                  const std::string& html);
   void GetCreativeSetConversionsCallback(
+      const std::string& catalog_id,
       const std::vector<GURL>& redirect_chain,
       const std::string& html,
       bool success,
       const CreativeSetConversionList& creative_set_conversions);
 
+  void MaybeConvertMatchingCreativeSetConversions(
+      const std::vector<GURL>& redirect_chain,
+      const std::string& html);
+
   void GetAdEvents(const std::vector<GURL>& redirect_chain,
                    const std::string& html,
                    const CreativeSetConversionList& creative_set_conversions);
@@ -104,6 +110,14 @@ class Conversions final : public ConversionQueueDelegate,
 
   ConversionResource resource_;
 
+  // Creative set conversions are only saved together with a new catalog, and
+  // the catalog id is cleared when the database is migrated, so the index is
+  // reloaded once the catalog id changes. Expired conversions are skipped by
+  // the index itself, so purging them doesn't make it stale.
+  absl::optional<CreativeSetConversionUrlPatternIndex>
+      creative_set_conversion_index_;
+  std::string creative_set_conversion_index_catalog_id_;
+
   ConversionQueue queue_;
 
   base::WeakPtrFactory<Conversions> weak_factory_{this};
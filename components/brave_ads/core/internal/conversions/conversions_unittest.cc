@@ -8,6 +8,8 @@
 #include <memory>
 
 #include "base/time/time.h"
+#include "brave/components/brave_ads/core/internal/catalog/catalog_unittest_constants.h"
+#include "brave/components/brave_ads/core/internal/catalog/catalog_util.h"
 #include "brave/components/brave_ads/core/internal/common/resources/country_components_unittest_constants.h"
 #include "brave/components/brave_ads/core/internal/common/unittest/unittest_base.h"
 #include "brave/components/brave_ads/core/internal/common/unittest/unittest_container_util.h"
@@ -1089,4 +1091,32 @@ TEST_F(BraveAdsConversionsTest,
   EXPECT_EQ(expected_actioned_conversions, actioned_conversions_);
 }
 
+TEST_F(BraveAdsConversionsTest,
+       ConvertAdIfCreativeSetConversionIsSavedWithNewCatalog) {
+  // Arrange
+  const AdInfo ad = BuildAdForTesting(AdType::kNotificationAd,
+                                      /*should_use_random_uuids*/ true);
+
+  MaybeConvert(BuildRedirectChain(), kHtml);
+
+  BuildAndSaveCreativeSetConversionForTesting(
+      ad.creative_set_id, kMatchingUrlPattern,
+      /*observation_window*/ base::Days(3));
+  SetCatalogId(kCatalogId);
+
+  FireAdEventsAdvancingTheClockAfterEach(
+      ad, {ConfirmationType::kServed, ConfirmationType::kViewed});
+
+  // Act
+  MaybeConvert(BuildRedirectChain(), kHtml);
+
+  // Assert
+  ConversionList expected_actioned_conversions;
+  expected_actioned_conversions.push_back(
+      BuildConversion(BuildAdEvent(ad, ConfirmationType::kViewed,
+                                   /*created_at*/ Now()),
+                      /*verifiable_conversion*/ absl::nullopt));
+  EXPECT_EQ(expected_actioned_conversions, actioned_conversions_);
+}
+
 }  // namespace brave_ads
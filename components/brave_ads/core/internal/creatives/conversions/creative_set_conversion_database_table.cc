@@ -249,6 +249,12 @@ void CreativeSetConversions::Save(
   RunTransaction(std::move(transaction), std::move(callback));
 }
 
+void CreativeSetConversions::Save(
+    mojom::DBTransactionInfo* transaction,
+    const CreativeSetConversionList& creative_set_conversions) {
+  InsertOrUpdate(transaction, creative_set_conversions);
+}
+
 void CreativeSetConversions::GetAll(GetConversionsCallback callback) const {
   mojom::DBTransactionInfoPtr transaction = mojom::DBTransactionInfo::New();
   mojom::DBCommandInfoPtr command = mojom::DBCommandInfo::New();
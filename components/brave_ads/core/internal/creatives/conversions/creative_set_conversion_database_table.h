@@ -25,6 +25,11 @@ class CreativeSetConversions final : public TableInterface {
   void Save(const CreativeSetConversionList& creative_set_conversions,
             ResultCallback callback);
 
+  // Adds the commands which save |creative_set_conversions| to |transaction|,
+  // so that they can be committed together with other changes.
+  void Save(mojom::DBTransactionInfo* transaction,
+            const CreativeSetConversionList& creative_set_conversions);
+
   void GetAll(GetConversionsCallback callback) const;
 
   void PurgeExpired(ResultCallback callback) const;
@@ -0,0 +1,115 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_ads/core/internal/creatives/conversions/creative_set_conversion_url_pattern_index.h"
+
+#include <set>
+#include <string_view>
+
+#include "base/time/time.h"
+#include "brave/components/brave_ads/core/internal/common/url/url_util.h"
+#include "url/gurl.h"
+
+namespace brave_ads {
+
+namespace {
+
+constexpr std::string_view kSchemeSeparator = "://";
+
+// Characters with a special meaning for |base::MatchPattern|.
+constexpr char kWildcardCharacters[] = "*?\\";
+
+// Returns |spec| up to and including the first slash after the host, or an
+// empty string if |spec| ends before that slash.
+std::string_view GetOrigin(const std::string_view spec) {
+  const size_t scheme_separator_pos = spec.find(kSchemeSeparator);
+  if (scheme_separator_pos == std::string_view::npos) {
+    return {};
+  }
+
+  const size_t path_pos =
+      spec.find('/', scheme_separator_pos + kSchemeSeparator.size());
+  if (path_pos == std::string_view::npos) {
+    return {};
+  }
+
+  return spec.substr(0, path_pos + 1);
+}
+
+}  // namespace
+
+CreativeSetConversionUrlPatternIndex::CreativeSetConversionUrlPatternIndex() =
+    default;
+
+CreativeSetConversionUrlPatternIndex::CreativeSetConversionUrlPatternIndex(
+    const CreativeSetConversionList& creative_set_conversions)
+    : creative_set_conversions_(creative_set_conversions) {
+  for (size_t i = 0; i < creative_set_conversions_.size(); ++i) {
+    const std::string_view url_pattern =
+        creative_set_conversions_[i].url_pattern;
+
+    const std::string_view literal_prefix =
+        url_pattern.substr(0, url_pattern.find_first_of(kWildcardCharacters));
+    const std::string_view origin = GetOrigin(literal_prefix);
+    if (origin.empty()) {
+      indices_with_wildcard_origin_.push_back(i);
+      continue;
+    }
+
+    indices_by_origin_[std::string(origin)].push_back(i);
+  }
+}
+
+CreativeSetConversionUrlPatternIndex::CreativeSetConversionUrlPatternIndex(
+    CreativeSetConversionUrlPatternIndex&&) noexcept = default;
+
+CreativeSetConversionUrlPatternIndex&
+CreativeSetConversionUrlPatternIndex::operator=(
+    CreativeSetConversionUrlPatternIndex&&) noexcept = default;
+
+CreativeSetConversionUrlPatternIndex::~CreativeSetConversionUrlPatternIndex() =
+    default;
+
+CreativeSetConversionList CreativeSetConversionUrlPatternIndex::FindMatching(
+    const std::vector<GURL>& redirect_chain) const {
+  std::set<size_t> matching_indices;
+
+  const auto match = [this, &matching_indices](
+                         const GURL& url, const std::vector<size_t>& indices) {
+    for (const size_t index : indices) {
+      if (MatchUrlPattern(url, creative_set_conversions_[index].url_pattern)) {
+        matching_indices.insert(index);
+      }
+    }
+  };
+
+  for (const auto& url : redirect_chain) {
+    if (!url.is_valid()) {
+      continue;
+    }
+
+    const auto iter = indices_by_origin_.find(GetOrigin(url.spec()));
+    if (iter != indices_by_origin_.cend()) {
+      match(url, iter->second);
+    }
+
+    match(url, indices_with_wildcard_origin_);
+  }
+
+  const base::Time now = base::Time::Now();
+
+  CreativeSetConversionList matching_creative_set_conversions;
+  for (const size_t index : matching_indices) {
+    const CreativeSetConversionInfo& creative_set_conversion =
+        creative_set_conversions_[index];
+    if (now < creative_set_conversion.expire_at) {
+      matching_creative_set_conversions.push_back(creative_set_conversion);
+    }
+  }
+
+  return matching_creative_set_conversions;
+}
+
+}  // namespace brave_ads
@@ -0,0 +1,64 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_ADS_CORE_INTERNAL_CREATIVES_CONVERSIONS_CREATIVE_SET_CONVERSION_URL_PATTERN_INDEX_H_
+#define BRAVE_COMPONENTS_BRAVE_ADS_CORE_INTERNAL_CREATIVES_CONVERSIONS_CREATIVE_SET_CONVERSION_URL_PATTERN_INDEX_H_
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "brave/components/brave_ads/core/internal/creatives/conversions/creative_set_conversion_info.h"
+
+class GURL;
+
+namespace brave_ads {
+
+// In-memory index of creative set conversions by URL pattern. Patterns which
+// spell out the scheme and host before the first wildcard are bucketed by
+// them, so matching a URL only tests the patterns for its own origin plus the
+// few patterns with a wildcard in the scheme or host.
+class CreativeSetConversionUrlPatternIndex final {
+ public:
+  CreativeSetConversionUrlPatternIndex();
+  explicit CreativeSetConversionUrlPatternIndex(
+      const CreativeSetConversionList& creative_set_conversions);
+
+  CreativeSetConversionUrlPatternIndex(
+      const CreativeSetConversionUrlPatternIndex&) = delete;
+  CreativeSetConversionUrlPatternIndex& operator=(
+      const CreativeSetConversionUrlPatternIndex&) = delete;
+
+  CreativeSetConversionUrlPatternIndex(
+      CreativeSetConversionUrlPatternIndex&&) noexcept;
+  CreativeSetConversionUrlPatternIndex& operator=(
+      CreativeSetConversionUrlPatternIndex&&) noexcept;
+
+  ~CreativeSetConversionUrlPatternIndex();
+
+  bool empty() const { return creative_set_conversions_.empty(); }
+  size_t size() const { return creative_set_conversions_.size(); }
+
+  // Returns the non-expired creative set conversions with a URL pattern
+  // matching any URL of |redirect_chain|, in the order they were indexed.
+  CreativeSetConversionList FindMatching(
+      const std::vector<GURL>& redirect_chain) const;
+
+ private:
+  CreativeSetConversionList creative_set_conversions_;
+
+  // Indices into |creative_set_conversions_|.
+  std::map</*scheme_host_and_port*/ std::string,
+           std::vector<size_t>,
+           std::less<>>
+      indices_by_origin_;
+  std::vector<size_t> indices_with_wildcard_origin_;
+};
+
+}  // namespace brave_ads
+
+#endif  // BRAVE_COMPONENTS_BRAVE_ADS_CORE_INTERNAL_CREATIVES_CONVERSIONS_CREATIVE_SET_CONVERSION_URL_PATTERN_INDEX_H_
@@ -0,0 +1,192 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_ads/core/internal/creatives/conversions/creative_set_conversion_url_pattern_index.h"
+
+#include <string>
+
+#include "base/functional/bind.h"
+#include "base/time/time.h"
+#include "brave/components/brave_ads/core/internal/common/unittest/unittest_base.h"
+#include "brave/components/brave_ads/core/internal/common/unittest/unittest_time_util.h"
+#include "brave/components/brave_ads/core/internal/conversions/conversion_ad_events_database_table.h"
+#include "brave/components/brave_ads/core/internal/creatives/conversions/creative_set_conversion_unittest_util.h"
+#include "brave/components/brave_ads/core/internal/units/ad_unittest_util.h"
+#include "brave/components/brave_ads/core/internal/user/user_interaction/ad_events/ad_event_builder.h"
+#include "brave/components/brave_ads/core/internal/user/user_interaction/ad_events/ad_event_unittest_util.h"
+#include "brave/components/brave_ads/core/public/account/confirmations/confirmation_type.h"
+#include "brave/components/brave_ads/core/public/units/ad_info.h"
+#include "url/gurl.h"
+
+// npm run test -- brave_unit_tests --filter=BraveAds*
+
+namespace brave_ads {
+
+namespace {
+
+CreativeSetConversionList BuildCreativeSetConversions() {
+  return {BuildCreativeSetConversionForTesting(
+              "creative_set_id_1", /*url_pattern*/ "https://foo.com/*",
+              /*observation_window*/ base::Days(3)),
+          BuildCreativeSetConversionForTesting(
+              "creative_set_id_2", /*url_pattern*/ "https://qux.com/*/corge",
+              /*observation_window*/ base::Days(3)),
+          BuildCreativeSetConversionForTesting(
+              "creative_set_id_3", /*url_pattern*/ "https://*.bar.com/*",
+              /*observation_window*/ base::Days(3)),
+          BuildCreativeSetConversionForTesting(
+              "creative_set_id_4", /*url_pattern*/ "https://www.baz.com",
+              /*observation_window*/ base::Days(3)),
+          BuildCreativeSetConversionForTesting(
+              "creative_set_id_5", /*url_pattern*/ "https://fred.com/waldo",
+              /*observation_window*/ base::Days(7))};
+}
+
+void FireAdEventForCreativeSet(const std::string& creative_set_id,
+                               const ConfirmationType& confirmation_type) {
+  AdInfo ad = BuildAdForTesting(AdType::kNotificationAd,
+                                /*should_use_random_uuids*/ true);
+  ad.creative_set_id = creative_set_id;
+  FireAdEventForTesting(BuildAdEvent(ad, confirmation_type,
+                                     /*created_at*/ Now()));
+}
+
+}  // namespace
+
+class BraveAdsCreativeSetConversionUrlPatternIndexTest : public UnitTestBase {};
+
+TEST_F(BraveAdsCreativeSetConversionUrlPatternIndexTest, FindMatching) {
+  // Arrange
+  const CreativeSetConversionUrlPatternIndex index(
+      BuildCreativeSetConversions());
+
+  // Act
+  const CreativeSetConversionList creative_set_conversions =
+      index.FindMatching({GURL("https://foo.com/bar"),
+                          GURL("https://www.baz.com"),
+                          GURL("https://qux.com/quux/corge")});
+
+  // Assert
+  ASSERT_EQ(2U, creative_set_conversions.size());
+  EXPECT_EQ("creative_set_id_1", creative_set_conversions[0].id);
+  EXPECT_EQ("creative_set_id_2", creative_set_conversions[1].id);
+}
+
+TEST_F(BraveAdsCreativeSetConversionUrlPatternIndexTest,
+       FindMatchingPatternWithWildcardHost) {
+  // Arrange
+  const CreativeSetConversionUrlPatternIndex index(
+      BuildCreativeSetConversions());
+
+  // Act
+  const CreativeSetConversionList creative_set_conversions =
+      index.FindMatching({GURL("https://www.bar.com/quux")});
+
+  // Assert
+  ASSERT_EQ(1U, creative_set_conversions.size());
+  EXPECT_EQ("creative_set_id_3", creative_set_conversions[0].id);
+}
+
+TEST_F(BraveAdsCreativeSetConversionUrlPatternIndexTest,
+       FindMatchingOnceForMultipleMatchingUrls) {
+  // Arrange
+  const CreativeSetConversionUrlPatternIndex index(
+      BuildCreativeSetConversions());
+
+  // Act
+  const CreativeSetConversionList creative_set_conversions =
+      index.FindMatching({GURL("https://foo.com/bar"),
+                          GURL("https://foo.com/baz")});
+
+  // Assert
+  ASSERT_EQ(1U, creative_set_conversions.size());
+  EXPECT_EQ("creative_set_id_1", creative_set_conversions[0].id);
+}
+
+TEST_F(BraveAdsCreativeSetConversionUrlPatternIndexTest, DoNotFindNonMatching) {
+  // Arrange
+  const CreativeSetConversionUrlPatternIndex index(
+      BuildCreativeSetConversions());
+
+  // Act
+
+  // Assert
+  EXPECT_TRUE(index.FindMatching({GURL("https://www.baz.com"),
+                                  GURL("https://fred.com/waldo/"),
+                                  GURL("https://grault.com/foo.com/")})
+                  .empty());
+}
+
+TEST_F(BraveAdsCreativeSetConversionUrlPatternIndexTest, DoNotFindExpired) {
+  // Arrange
+  const CreativeSetConversionUrlPatternIndex index(
+      BuildCreativeSetConversions());
+
+  AdvanceClockBy(base::Days(3));
+
+  // Act
+  const CreativeSetConversionList creative_set_conversions =
+      index.FindMatching({GURL("https://foo.com/bar"),
+                          GURL("https://fred.com/waldo")});
+
+  // Assert
+  ASSERT_EQ(1U, creative_set_conversions.size());
+  EXPECT_EQ("creative_set_id_5", creative_set_conversions[0].id);
+}
+
+TEST_F(BraveAdsCreativeSetConversionUrlPatternIndexTest, EmptyIndex) {
+  // Arrange
+  const CreativeSetConversionUrlPatternIndex index;
+
+  // Act
+
+  // Assert
+  EXPECT_TRUE(index.empty());
+  EXPECT_TRUE(index.FindMatching({GURL("https://foo.com/bar")}).empty());
+}
+
+TEST_F(BraveAdsCreativeSetConversionUrlPatternIndexTest,
+       GetAdEventsForMatchingCreativeSets) {
+  // Arrange
+  FireAdEventForCreativeSet("creative_set_id_1", ConfirmationType::kViewed);
+  FireAdEventForCreativeSet("creative_set_id_2", ConfirmationType::kConversion);
+
+  AdvanceClockBy(base::Days(4));
+
+  const CreativeSetConversionUrlPatternIndex index(
+      BuildCreativeSetConversions());
+
+  FireAdEventForCreativeSet("creative_set_id_1", ConfirmationType::kViewed);
+  AdvanceClockBy(base::Milliseconds(1));
+  FireAdEventForCreativeSet("creative_set_id_4", ConfirmationType::kViewed);
+  AdvanceClockBy(base::Milliseconds(1));
+  FireAdEventForCreativeSet("creative_set_id_2", ConfirmationType::kClicked);
+
+  const CreativeSetConversionList creative_set_conversions =
+      index.FindMatching({GURL("https://foo.com/bar"),
+                          GURL("https://qux.com/quux/corge")});
+  ASSERT_EQ(2U, creative_set_conversions.size());
+
+  // Act
+  const database::table::ConversionAdEvents database_table;
+  database_table.GetForCreativeSets(
+      {creative_set_conversions[0].id, creative_set_conversions[1].id},
+      /*observation_window*/ base::Days(3),
+      base::BindOnce([](const bool success, const AdEventList& ad_events) {
+        // Assert
+        ASSERT_TRUE(success);
+        ASSERT_EQ(3U, ad_events.size());
+        EXPECT_EQ("creative_set_id_2", ad_events[0].creative_set_id);
+        EXPECT_EQ(ConfirmationType::kClicked, ad_events[0].confirmation_type);
+        EXPECT_EQ("creative_set_id_1", ad_events[1].creative_set_id);
+        EXPECT_EQ(ConfirmationType::kViewed, ad_events[1].confirmation_type);
+        EXPECT_EQ(Now() - base::Milliseconds(2), ad_events[1].created_at);
+        EXPECT_EQ("creative_set_id_2", ad_events[2].creative_set_id);
+        EXPECT_EQ(ConfirmationType::kConversion,
+                  ad_events[2].confirmation_type);
+      }));
+}
+
+}  // namespace brave_ads
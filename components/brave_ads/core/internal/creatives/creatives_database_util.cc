@@ -0,0 +1,180 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_ads/core/internal/creatives/creatives_database_util.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/check.h"
+#include "base/strings/string_util.h"
+#include "brave/components/brave_ads/core/internal/common/containers/container_util.h"
+#include "brave/components/brave_ads/core/internal/common/database/database_bind_util.h"
+#include "brave/components/brave_ads/core/internal/common/database/database_table_util.h"
+#include "brave/components/brave_ads/core/internal/creatives/campaigns_database_table.h"
+#include "brave/components/brave_ads/core/internal/creatives/creative_ads_database_table.h"
+#include "brave/components/brave_ads/core/internal/creatives/creatives_diff_info.h"
+#include "brave/components/brave_ads/core/internal/creatives/creatives_info.h"
+#include "brave/components/brave_ads/core/internal/creatives/dayparts_database_table.h"
+#include "brave/components/brave_ads/core/internal/creatives/embeddings_database_table.h"
+#include "brave/components/brave_ads/core/internal/creatives/geo_targets_database_table.h"
+#include "brave/components/brave_ads/core/internal/creatives/inline_content_ads/creative_inline_content_ads_database_table.h"
+#include "brave/components/brave_ads/core/internal/creatives/new_tab_page_ads/creative_new_tab_page_ad_wallpapers_database_table.h"
+#include "brave/components/brave_ads/core/internal/creatives/new_tab_page_ads/creative_new_tab_page_ads_database_table.h"
+#include "brave/components/brave_ads/core/internal/creatives/notification_ads/creative_notification_ads_database_table.h"
+#include "brave/components/brave_ads/core/internal/creatives/promoted_content_ads/creative_promoted_content_ads_database_table.h"
+#include "brave/components/brave_ads/core/internal/creatives/segments_database_table.h"
+#include "brave/components/brave_ads/core/mojom/brave_ads.mojom.h"
+
+namespace brave_ads::database {
+
+namespace {
+
+constexpr char kCampaignIdColumn[] = "campaign_id";
+constexpr char kCreativeSetIdColumn[] = "creative_set_id";
+constexpr char kCreativeInstanceIdColumn[] = "creative_instance_id";
+
+constexpr int kBatchSize = 50;
+
+// Tables which store a row for each creative instance along with its creative
+// set and campaign.
+std::vector<std::string> GetCreativeAdTableNames() {
+  return {table::CreativeNotificationAds().GetTableName(),
+          table::CreativeInlineContentAds().GetTableName(),
+          table::CreativeNewTabPageAds().GetTableName(),
+          table::CreativePromotedContentAds().GetTableName()};
+}
+
+void BindCampaignIds(mojom::DBCommandInfo* command,
+                     const std::vector<std::string>& campaign_ids) {
+  CHECK(command);
+
+  int index = 0;
+  for (const auto& campaign_id : campaign_ids) {
+    BindString(command, index++, campaign_id);
+  }
+}
+
+// Deletes rows of |table_name| which belong to |campaign_ids|.
+void DeleteRows(mojom::DBTransactionInfo* transaction,
+                const std::string& table_name,
+                const std::vector<std::string>& campaign_ids) {
+  CHECK(transaction);
+
+  mojom::DBCommandInfoPtr command = mojom::DBCommandInfo::New();
+  command->type = mojom::DBCommandInfo::Type::RUN;
+  command->sql = base::ReplaceStringPlaceholders(
+      "DELETE FROM $1 WHERE $2 IN $3;",
+      {table_name, kCampaignIdColumn,
+       BuildBindingParameterPlaceholder(campaign_ids.size())},
+      nullptr);
+  BindCampaignIds(&*command, campaign_ids);
+
+  transaction->commands.push_back(std::move(command));
+}
+
+// Deletes rows of |table_name| whose |column_name| matches the creative ads of
+// |campaign_ids|. Must run before the creative ads themselves are deleted.
+void DeleteCreativeAdRows(mojom::DBTransactionInfo* transaction,
+                          const std::string& table_name,
+                          const std::string& column_name,
+                          const std::vector<std::string>& campaign_ids) {
+  CHECK(transaction);
+
+  for (const auto& creative_ad_table_name : GetCreativeAdTableNames()) {
+    mojom::DBCommandInfoPtr command = mojom::DBCommandInfo::New();
+    command->type = mojom::DBCommandInfo::Type::RUN;
+    command->sql = base::ReplaceStringPlaceholders(
+        "DELETE FROM $1 WHERE $2 IN (SELECT $2 FROM $3 WHERE $4 IN $5);",
+        {table_name, column_name, creative_ad_table_name, kCampaignIdColumn,
+         BuildBindingParameterPlaceholder(campaign_ids.size())},
+        nullptr);
+    BindCampaignIds(&*command, campaign_ids);
+
+    transaction->commands.push_back(std::move(command));
+  }
+}
+
+void DeleteCampaigns(mojom::DBTransactionInfo* transaction,
+                     const std::vector<std::string>& campaign_ids) {
+  CHECK(transaction);
+
+  DeleteCreativeAdRows(transaction, table::Segments().GetTableName(),
+                       kCreativeSetIdColumn, campaign_ids);
+  DeleteCreativeAdRows(transaction, table::Embeddings().GetTableName(),
+                       kCreativeSetIdColumn, campaign_ids);
+  DeleteCreativeAdRows(transaction,
+                       table::CreativeNewTabPageAdWallpapers().GetTableName(),
+                       kCreativeInstanceIdColumn, campaign_ids);
+  DeleteCreativeAdRows(transaction, table::CreativeAds().GetTableName(),
+                       kCreativeInstanceIdColumn, campaign_ids);
+
+  for (const auto& creative_ad_table_name : GetCreativeAdTableNames()) {
+    DeleteRows(transaction, creative_ad_table_name, campaign_ids);
+  }
+
+  DeleteRows(transaction, table::Campaigns().GetTableName(), campaign_ids);
+  DeleteRows(transaction, table::GeoTargets().GetTableName(), campaign_ids);
+  DeleteRows(transaction, table::Dayparts().GetTableName(), campaign_ids);
+}
+
+}  // namespace
+
+void SaveCreatives(mojom::DBTransactionInfo* transaction,
+                   const CreativesInfo& creatives) {
+  CHECK(transaction);
+
+  table::CreativeNotificationAds creative_notification_ads_database_table;
+  creative_notification_ads_database_table.Save(transaction,
+                                                creatives.notification_ads);
+
+  table::CreativeInlineContentAds creative_inline_content_ads_database_table;
+  creative_inline_content_ads_database_table.Save(
+      transaction, creatives.inline_content_ads);
+
+  table::CreativeNewTabPageAds creative_new_tab_page_ads_database_table;
+  creative_new_tab_page_ads_database_table.Save(transaction,
+                                                creatives.new_tab_page_ads);
+
+  table::CreativePromotedContentAds
+      creative_promoted_content_ads_database_table;
+  creative_promoted_content_ads_database_table.Save(
+      transaction, creatives.promoted_content_ads);
+}
+
+void ReplaceCreatives(mojom::DBTransactionInfo* transaction,
+                      const CreativesInfo& creatives) {
+  CHECK(transaction);
+
+  DeleteTable(transaction, table::Campaigns().GetTableName());
+  DeleteTable(transaction, table::CreativeNotificationAds().GetTableName());
+  DeleteTable(transaction, table::CreativeInlineContentAds().GetTableName());
+  DeleteTable(transaction, table::CreativeNewTabPageAds().GetTableName());
+  DeleteTable(transaction,
+              table::CreativeNewTabPageAdWallpapers().GetTableName());
+  DeleteTable(transaction, table::CreativePromotedContentAds().GetTableName());
+  DeleteTable(transaction, table::CreativeAds().GetTableName());
+  DeleteTable(transaction, table::Segments().GetTableName());
+  DeleteTable(transaction, table::Embeddings().GetTableName());
+  DeleteTable(transaction, table::GeoTargets().GetTableName());
+  DeleteTable(transaction, table::Dayparts().GetTableName());
+
+  SaveCreatives(transaction, creatives);
+}
+
+void ApplyCreativesDiff(mojom::DBTransactionInfo* transaction,
+                        const CreativesDiffInfo& creatives_diff) {
+  CHECK(transaction);
+
+  for (const auto& batch :
+       SplitVector(creatives_diff.campaign_ids, kBatchSize)) {
+    DeleteCampaigns(transaction, batch);
+  }
+
+  SaveCreatives(transaction, creatives_diff.creatives);
+}
+
+}  // namespace brave_ads::database
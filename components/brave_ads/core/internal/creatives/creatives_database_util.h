@@ -0,0 +1,37 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_ADS_CORE_INTERNAL_CREATIVES_CREATIVES_DATABASE_UTIL_H_
+#define BRAVE_COMPONENTS_BRAVE_ADS_CORE_INTERNAL_CREATIVES_CREATIVES_DATABASE_UTIL_H_
+
+#include "brave/components/brave_ads/core/mojom/brave_ads.mojom-forward.h"
+
+namespace brave_ads {
+
+struct CreativesDiffInfo;
+struct CreativesInfo;
+
+namespace database {
+
+// Adds the commands which save |creatives| to |transaction|.
+void SaveCreatives(mojom::DBTransactionInfo* transaction,
+                   const CreativesInfo& creatives);
+
+// Adds the commands which replace all creatives with |creatives| to
+// |transaction|.
+void ReplaceCreatives(mojom::DBTransactionInfo* transaction,
+                      const CreativesInfo& creatives);
+
+// Adds the commands which delete all rows of removed or changed campaigns and
+// save the creatives of added or changed campaigns to |transaction|. Rows are
+// deleted from the same tables as ReplaceCreatives.
+void ApplyCreativesDiff(mojom::DBTransactionInfo* transaction,
+                        const CreativesDiffInfo& creatives_diff);
+
+}  // namespace database
+
+}  // namespace brave_ads
+
+#endif  // BRAVE_COMPONENTS_BRAVE_ADS_CORE_INTERNAL_CREATIVES_CREATIVES_DATABASE_UTIL_H_
@@ -0,0 +1,153 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_ads/core/internal/creatives/creatives_diff_builder.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "base/base64.h"
+#include "base/check.h"
+#include "base/containers/contains.h"
+#include "base/ranges/algorithm.h"
+#include "brave/components/brave_ads/core/internal/creatives/creatives_database_util.h"
+#include "brave/components/brave_ads/core/internal/creatives/creatives_info.h"
+#include "brave/components/brave_ads/core/mojom/brave_ads.mojom.h"
+#include "crypto/sha2.h"
+
+namespace brave_ads {
+
+namespace {
+
+using CampaignCreativesMap =
+    std::map</*campaign_id*/ std::string, CreativesInfo>;
+
+// Creatives are built once per segment, so sort them to digest campaigns
+// regardless of their order in the catalog.
+template <typename T>
+void SortCreativeAds(std::vector<T>* creative_ads) {
+  CHECK(creative_ads);
+
+  base::ranges::sort(*creative_ads, [](const T& lhs, const T& rhs) {
+    return std::tie(lhs.creative_instance_id, lhs.segment) <
+           std::tie(rhs.creative_instance_id, rhs.segment);
+  });
+}
+
+template <typename T>
+void AppendCreativeAds(const std::vector<T>& creative_ads,
+                       std::vector<T>* to_creative_ads) {
+  CHECK(to_creative_ads);
+
+  to_creative_ads->insert(to_creative_ads->cend(), creative_ads.cbegin(),
+                          creative_ads.cend());
+}
+
+CampaignCreativesMap GroupByCampaign(const CreativesInfo& creatives) {
+  CampaignCreativesMap campaigns;
+
+  for (const auto& creative_ad : creatives.notification_ads) {
+    campaigns[creative_ad.campaign_id].notification_ads.push_back(creative_ad);
+  }
+
+  for (const auto& creative_ad : creatives.inline_content_ads) {
+    campaigns[creative_ad.campaign_id].inline_content_ads.push_back(
+        creative_ad);
+  }
+
+  for (const auto& creative_ad : creatives.new_tab_page_ads) {
+    campaigns[creative_ad.campaign_id].new_tab_page_ads.push_back(creative_ad);
+  }
+
+  for (const auto& creative_ad : creatives.promoted_content_ads) {
+    campaigns[creative_ad.campaign_id].promoted_content_ads.push_back(
+        creative_ad);
+  }
+
+  for (auto& [_, campaign_creatives] : campaigns) {
+    SortCreativeAds(&campaign_creatives.notification_ads);
+    SortCreativeAds(&campaign_creatives.inline_content_ads);
+    SortCreativeAds(&campaign_creatives.new_tab_page_ads);
+    SortCreativeAds(&campaign_creatives.promoted_content_ads);
+  }
+
+  return campaigns;
+}
+
+// Digests the commands which save |creatives|, so that any field which is
+// written to the database is part of the digest.
+std::string BuildDigest(const CreativesInfo& creatives) {
+  mojom::DBTransactionInfoPtr transaction = mojom::DBTransactionInfo::New();
+  database::SaveCreatives(&*transaction, creatives);
+
+  const std::vector<uint8_t> bytes =
+      mojom::DBTransactionInfo::Serialize(&transaction);
+  return base::Base64Encode(crypto::SHA256Hash(bytes));
+}
+
+void AppendCreatives(const CreativesInfo& creatives,
+                     CreativesInfo* to_creatives) {
+  CHECK(to_creatives);
+
+  AppendCreativeAds(creatives.notification_ads,
+                    &to_creatives->notification_ads);
+  AppendCreativeAds(creatives.inline_content_ads,
+                    &to_creatives->inline_content_ads);
+  AppendCreativeAds(creatives.new_tab_page_ads,
+                    &to_creatives->new_tab_page_ads);
+  AppendCreativeAds(creatives.promoted_content_ads,
+                    &to_creatives->promoted_content_ads);
+}
+
+}  // namespace
+
+CampaignDigestMap BuildCampaignDigests(const CreativesInfo& creatives) {
+  CampaignDigestMap campaign_digests;
+
+  for (const auto& [campaign_id, campaign_creatives] :
+       GroupByCampaign(creatives)) {
+    campaign_digests.emplace(campaign_id, BuildDigest(campaign_creatives));
+  }
+
+  return campaign_digests;
+}
+
+CreativesDiffInfo BuildCreativesDiff(
+    const CampaignDigestMap& last_campaign_digests,
+    const CampaignDigestMap& campaign_digests,
+    const CreativesInfo& creatives) {
+  CreativesDiffInfo creatives_diff;
+
+  for (const auto& [campaign_id, campaign_creatives] :
+       GroupByCampaign(creatives)) {
+    const auto last_iter = last_campaign_digests.find(campaign_id);
+    const auto iter = campaign_digests.find(campaign_id);
+    CHECK(iter != campaign_digests.cend());
+
+    if (last_iter != last_campaign_digests.cend() &&
+        last_iter->second == iter->second) {
+      continue;
+    }
+
+    AppendCreatives(campaign_creatives, &creatives_diff.creatives);
+
+    if (last_iter != last_campaign_digests.cend()) {
+      creatives_diff.campaign_ids.push_back(campaign_id);
+    }
+  }
+
+  for (const auto& [campaign_id, _] : last_campaign_digests) {
+    if (!base::Contains(campaign_digests, campaign_id)) {
+      creatives_diff.campaign_ids.push_back(campaign_id);
+    }
+  }
+
+  return creatives_diff;
+}
+
+}  // namespace brave_ads
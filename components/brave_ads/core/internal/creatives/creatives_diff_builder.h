@@ -0,0 +1,31 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_ADS_CORE_INTERNAL_CREATIVES_CREATIVES_DIFF_BUILDER_H_
+#define BRAVE_COMPONENTS_BRAVE_ADS_CORE_INTERNAL_CREATIVES_CREATIVES_DIFF_BUILDER_H_
+
+#include "brave/components/brave_ads/core/internal/creatives/creatives_diff_info.h"
+
+namespace brave_ads {
+
+struct CreativesInfo;
+
+// Returns a digest of the rows which the creatives of each campaign write to
+// the database. Campaigns are digested as a whole, because campaign and
+// creative set fields are stored once for all of their creatives. Creative set
+// conversions are not part of the digest.
+CampaignDigestMap BuildCampaignDigests(const CreativesInfo& creatives);
+
+// Returns the creatives of campaigns whose digest is not in
+// |last_campaign_digests| and the ids of campaigns which were changed or
+// removed.
+CreativesDiffInfo BuildCreativesDiff(
+    const CampaignDigestMap& last_campaign_digests,
+    const CampaignDigestMap& campaign_digests,
+    const CreativesInfo& creatives);
+
+}  // namespace brave_ads
+
+#endif  // BRAVE_COMPONENTS_BRAVE_ADS_CORE_INTERNAL_CREATIVES_CREATIVES_DIFF_BUILDER_H_
@@ -0,0 +1,164 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_ads/core/internal/creatives/creatives_diff_builder.h"
+
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "base/ranges/algorithm.h"
+#include "brave/components/brave_ads/core/internal/common/unittest/unittest_base.h"
+#include "brave/components/brave_ads/core/internal/creatives/creatives_info.h"
+#include "brave/components/brave_ads/core/internal/creatives/notification_ads/creative_notification_ad_unittest_util.h"
+
+// npm run test -- brave_unit_tests --filter=BraveAds*
+
+namespace brave_ads {
+
+namespace {
+
+constexpr int kCreativeAdCount = 5'000;
+
+// Together 1% of |kCreativeAdCount|.
+constexpr int kChangedCreativeAdCount = 25;
+constexpr int kRemovedCreativeAdCount = 15;
+constexpr int kAddedCreativeAdCount = 10;
+
+CreativesDiffInfo BuildCreativesDiffForTesting(
+    const CreativesInfo& last_creatives,
+    const CreativesInfo& creatives) {
+  return BuildCreativesDiff(BuildCampaignDigests(last_creatives),
+                            BuildCampaignDigests(creatives), creatives);
+}
+
+}  // namespace
+
+class BraveAdsCreativesDiffBuilderTest : public UnitTestBase {};
+
+TEST_F(BraveAdsCreativesDiffBuilderTest,
+       BuildSameDigestsForReorderedCreatives) {
+  // Arrange
+  CreativesInfo creatives;
+  creatives.notification_ads = BuildCreativeNotificationAdsForTesting(
+      /*count*/ 2);
+
+  CreativesInfo reordered_creatives;
+  reordered_creatives.notification_ads = {creatives.notification_ads[1],
+                                          creatives.notification_ads[0]};
+
+  // Act & Assert
+  EXPECT_EQ(BuildCampaignDigests(creatives),
+            BuildCampaignDigests(reordered_creatives));
+}
+
+TEST_F(BraveAdsCreativesDiffBuilderTest, BuildEmptyDiffForSameCreatives) {
+  // Arrange
+  CreativesInfo creatives;
+  creatives.notification_ads = BuildCreativeNotificationAdsForTesting(
+      /*count*/ 2);
+
+  // Act
+  const CreativesDiffInfo creatives_diff =
+      BuildCreativesDiffForTesting(creatives, creatives);
+
+  // Assert
+  EXPECT_TRUE(creatives_diff.creatives.notification_ads.empty());
+  EXPECT_TRUE(creatives_diff.campaign_ids.empty());
+}
+
+TEST_F(BraveAdsCreativesDiffBuilderTest, BuildDiffForAddedCampaign) {
+  // Arrange
+  const CreativesInfo last_creatives;
+
+  CreativesInfo creatives;
+  creatives.notification_ads = BuildCreativeNotificationAdsForTesting(
+      /*count*/ 1);
+
+  // Act
+  const CreativesDiffInfo creatives_diff =
+      BuildCreativesDiffForTesting(last_creatives, creatives);
+
+  // Assert
+  EXPECT_EQ(creatives.notification_ads,
+            creatives_diff.creatives.notification_ads);
+  EXPECT_TRUE(creatives_diff.campaign_ids.empty());
+}
+
+TEST_F(BraveAdsCreativesDiffBuilderTest, BuildDiffForRemovedCampaign) {
+  // Arrange
+  CreativesInfo last_creatives;
+  last_creatives.notification_ads = BuildCreativeNotificationAdsForTesting(
+      /*count*/ 1);
+
+  const CreativesInfo creatives;
+
+  // Act
+  const CreativesDiffInfo creatives_diff =
+      BuildCreativesDiffForTesting(last_creatives, creatives);
+
+  // Assert
+  EXPECT_TRUE(creatives_diff.creatives.notification_ads.empty());
+  EXPECT_EQ(std::vector<std::string>{
+                last_creatives.notification_ads.front().campaign_id},
+            creatives_diff.campaign_ids);
+}
+
+TEST_F(BraveAdsCreativesDiffBuilderTest, RewriteCampaignIfCreativeChanged) {
+  // Arrange
+  CreativeNotificationAdInfo creative_ad_1 =
+      BuildCreativeNotificationAdForTesting(/*should_use_random_uuids*/ true);
+  CreativeNotificationAdInfo creative_ad_2 =
+      BuildCreativeNotificationAdForTesting(/*should_use_random_uuids*/ true);
+  creative_ad_2.campaign_id = creative_ad_1.campaign_id;
+
+  CreativesInfo last_creatives;
+  last_creatives.notification_ads = {creative_ad_1, creative_ad_2};
+
+  CreativesInfo creatives = last_creatives;
+  creatives.notification_ads[1].title = "Changed Ad Title";
+
+  // Act
+  const CreativesDiffInfo creatives_diff =
+      BuildCreativesDiffForTesting(last_creatives, creatives);
+
+  // Assert
+  EXPECT_EQ(2U, creatives_diff.creatives.notification_ads.size());
+  EXPECT_EQ(std::vector<std::string>{creative_ad_1.campaign_id},
+            creatives_diff.campaign_ids);
+}
+
+TEST_F(BraveAdsCreativesDiffBuilderTest,
+       OnlyRewriteChangedCampaignsForLargeCatalog) {
+  // Arrange
+  CreativesInfo last_creatives;
+  last_creatives.notification_ads =
+      BuildCreativeNotificationAdsForTesting(kCreativeAdCount);
+
+  CreativesInfo creatives = last_creatives;
+  for (int i = 0; i < kChangedCreativeAdCount; ++i) {
+    creatives.notification_ads[i].title = "Changed Ad Title";
+  }
+  creatives.notification_ads.erase(
+      creatives.notification_ads.cend() - kRemovedCreativeAdCount,
+      creatives.notification_ads.cend());
+  base::ranges::copy(
+      BuildCreativeNotificationAdsForTesting(kAddedCreativeAdCount),
+      std::back_inserter(creatives.notification_ads));
+
+  // Act
+  const CreativesDiffInfo creatives_diff =
+      BuildCreativesDiffForTesting(last_creatives, creatives);
+
+  // Assert
+  EXPECT_EQ(static_cast<size_t>(kChangedCreativeAdCount +
+                                kAddedCreativeAdCount),
+            creatives_diff.creatives.notification_ads.size());
+  EXPECT_EQ(static_cast<size_t>(kChangedCreativeAdCount +
+                                kRemovedCreativeAdCount),
+            creatives_diff.campaign_ids.size());
+}
+
+}  // namespace brave_ads
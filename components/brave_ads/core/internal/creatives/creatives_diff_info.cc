@@ -0,0 +1,25 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_ads/core/internal/creatives/creatives_diff_info.h"
+
+namespace brave_ads {
+
+CreativesDiffInfo::CreativesDiffInfo() = default;
+
+CreativesDiffInfo::CreativesDiffInfo(const CreativesDiffInfo& other) = default;
+
+CreativesDiffInfo& CreativesDiffInfo::operator=(
+    const CreativesDiffInfo& other) = default;
+
+CreativesDiffInfo::CreativesDiffInfo(CreativesDiffInfo&& other) noexcept =
+    default;
+
+CreativesDiffInfo& CreativesDiffInfo::operator=(
+    CreativesDiffInfo&& other) noexcept = default;
+
+CreativesDiffInfo::~CreativesDiffInfo() = default;
+
+}  // namespace brave_ads
@@ -0,0 +1,41 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_ADS_CORE_INTERNAL_CREATIVES_CREATIVES_DIFF_INFO_H_
+#define BRAVE_COMPONENTS_BRAVE_ADS_CORE_INTERNAL_CREATIVES_CREATIVES_DIFF_INFO_H_
+
+#include <string>
+#include <vector>
+
+#include "base/containers/flat_map.h"
+#include "brave/components/brave_ads/core/internal/creatives/creatives_info.h"
+
+namespace brave_ads {
+
+using CampaignDigestMap =
+    base::flat_map</*campaign_id*/ std::string, /*digest*/ std::string>;
+
+struct CreativesDiffInfo final {
+  CreativesDiffInfo();
+
+  CreativesDiffInfo(const CreativesDiffInfo&);
+  CreativesDiffInfo& operator=(const CreativesDiffInfo&);
+
+  CreativesDiffInfo(CreativesDiffInfo&&) noexcept;
+  CreativesDiffInfo& operator=(CreativesDiffInfo&&) noexcept;
+
+  ~CreativesDiffInfo();
+
+  // Creatives of campaigns which were added or changed.
+  CreativesInfo creatives;
+
+  // Campaigns which were removed or changed. Their rows are deleted before
+  // |creatives| are saved.
+  std::vector<std::string> campaign_ids;
+};
+
+}  // namespace brave_ads
+
+#endif  // BRAVE_COMPONENTS_BRAVE_ADS_CORE_INTERNAL_CREATIVES_CREATIVES_DIFF_INFO_H_
@@ -54,6 +54,11 @@ class CreativeInlineContentAds final : public TableInterface {
   void Save(const CreativeInlineContentAdList& creative_ads,
             ResultCallback callback);
 
+  // Adds the commands which save |creative_ads| to |transaction|, so that they
+  // can be committed together with other changes.
+  void Save(mojom::DBTransactionInfo* transaction,
+            const CreativeInlineContentAdList& creative_ads);
+
   void Delete(ResultCallback callback) const;
 
   void GetForCreativeInstanceId(
@@ -281,26 +281,36 @@ void CreativeNewTabPageAds::Save(const CreativeNewTabPageAdList& creative_ads,
 
   mojom::DBTransactionInfoPtr transaction = mojom::DBTransactionInfo::New();
 
+  Save(&*transaction, creative_ads);
+
+  RunTransaction(std::move(transaction), std::move(callback));
+}
+
+void CreativeNewTabPageAds::Save(mojom::DBTransactionInfo* transaction,
+                                 const CreativeNewTabPageAdList& creative_ads) {
+  CHECK(transaction);
+
+  if (creative_ads.empty()) {
+    return;
+  }
+
   const std::vector<CreativeNewTabPageAdList> batches =
       SplitVector(creative_ads, batch_size_);
 
   for (const auto& batch : batches) {
-    InsertOrUpdate(&*transaction, batch);
+    InsertOrUpdate(transaction, batch);
 
     const CreativeAdList creative_ads_batch(batch.cbegin(), batch.cend());
-    campaigns_database_table_.InsertOrUpdate(&*transaction, creative_ads_batch);
-    creative_ads_database_table_.InsertOrUpdate(&*transaction,
+    campaigns_database_table_.InsertOrUpdate(transaction, creative_ads_batch);
+    creative_ads_database_table_.InsertOrUpdate(transaction,
                                                 creative_ads_batch);
     creative_new_tab_page_ad_wallpapers_database_table_.InsertOrUpdate(
-        &*transaction, batch);
-    dayparts_database_table_.InsertOrUpdate(&*transaction, creative_ads_batch);
-    deposits_database_table_.InsertOrUpdate(&*transaction, creative_ads_batch);
-    geo_targets_database_table_.InsertOrUpdate(&*transaction,
-                                               creative_ads_batch);
-    segments_database_table_.InsertOrUpdate(&*transaction, creative_ads_batch);
+        transaction, batch);
+    dayparts_database_table_.InsertOrUpdate(transaction, creative_ads_batch);
+    deposits_database_table_.InsertOrUpdate(transaction, creative_ads_batch);
+    geo_targets_database_table_.InsertOrUpdate(transaction, creative_ads_batch);
+    segments_database_table_.InsertOrUpdate(transaction, creative_ads_batch);
   }
-
-  RunTransaction(std::move(transaction), std::move(callback));
 }
 
 void CreativeNewTabPageAds::Delete(ResultCallback callback) const {
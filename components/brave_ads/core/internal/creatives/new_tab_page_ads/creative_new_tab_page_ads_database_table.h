@@ -51,6 +51,11 @@ class CreativeNewTabPageAds final : public TableInterface {
   void Save(const CreativeNewTabPageAdList& creative_ads,
             ResultCallback callback);
 
+  // Adds the commands which save |creative_ads| to |transaction|, so that they
+  // can be committed together with other changes.
+  void Save(mojom::DBTransactionInfo* transaction,
+            const CreativeNewTabPageAdList& creative_ads);
+
   void Delete(ResultCallback callback) const;
 
   void GetForCreativeInstanceId(const std::string& creative_instance_id,
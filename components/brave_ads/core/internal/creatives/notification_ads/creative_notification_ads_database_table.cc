@@ -239,26 +239,36 @@ void CreativeNotificationAds::Save(
 
   mojom::DBTransactionInfoPtr transaction = mojom::DBTransactionInfo::New();
 
+  Save(&*transaction, creative_ads);
+
+  RunTransaction(std::move(transaction), std::move(callback));
+}
+
+void CreativeNotificationAds::Save(
+    mojom::DBTransactionInfo* transaction,
+    const CreativeNotificationAdList& creative_ads) {
+  CHECK(transaction);
+
+  if (creative_ads.empty()) {
+    return;
+  }
+
   const std::vector<CreativeNotificationAdList> batches =
       SplitVector(creative_ads, batch_size_);
 
   for (const auto& batch : batches) {
-    InsertOrUpdate(&*transaction, batch);
+    InsertOrUpdate(transaction, batch);
 
     const CreativeAdList creative_ads_batch(batch.cbegin(), batch.cend());
-    campaigns_database_table_.InsertOrUpdate(&*transaction, creative_ads_batch);
-    creative_ads_database_table_.InsertOrUpdate(&*transaction,
+    campaigns_database_table_.InsertOrUpdate(transaction, creative_ads_batch);
+    creative_ads_database_table_.InsertOrUpdate(transaction,
                                                 creative_ads_batch);
-    dayparts_database_table_.InsertOrUpdate(&*transaction, creative_ads_batch);
-    deposits_database_table_.InsertOrUpdate(&*transaction, creative_ads_batch);
-    embeddings_database_table_.InsertOrUpdate(&*transaction,
-                                              creative_ads_batch);
-    geo_targets_database_table_.InsertOrUpdate(&*transaction,
-                                               creative_ads_batch);
-    segments_database_table_.InsertOrUpdate(&*transaction, creative_ads_batch);
+    dayparts_database_table_.InsertOrUpdate(transaction, creative_ads_batch);
+    deposits_database_table_.InsertOrUpdate(transaction, creative_ads_batch);
+    embeddings_database_table_.InsertOrUpdate(transaction, creative_ads_batch);
+    geo_targets_database_table_.InsertOrUpdate(transaction, creative_ads_batch);
+    segments_database_table_.InsertOrUpdate(transaction, creative_ads_batch);
   }
-
-  RunTransaction(std::move(transaction), std::move(callback));
 }
 
 void CreativeNotificationAds::Delete(ResultCallback callback) const {
@@ -46,6 +46,11 @@ class CreativeNotificationAds final : public TableInterface {
   void Save(const CreativeNotificationAdList& creative_ads,
             ResultCallback callback);
 
+  // Adds the commands which save |creative_ads| to |transaction|, so that they
+  // can be committed together with other changes.
+  void Save(mojom::DBTransactionInfo* transaction,
+            const CreativeNotificationAdList& creative_ads);
+
   void Delete(ResultCallback callback) const;
 
   void GetForSegments(const SegmentList& segments,
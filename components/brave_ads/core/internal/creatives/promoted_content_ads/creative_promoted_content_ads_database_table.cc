@@ -259,24 +259,35 @@ void CreativePromotedContentAds::Save(
 
   mojom::DBTransactionInfoPtr transaction = mojom::DBTransactionInfo::New();
 
+  Save(&*transaction, creative_ads);
+
+  RunTransaction(std::move(transaction), std::move(callback));
+}
+
+void CreativePromotedContentAds::Save(
+    mojom::DBTransactionInfo* transaction,
+    const CreativePromotedContentAdList& creative_ads) {
+  CHECK(transaction);
+
+  if (creative_ads.empty()) {
+    return;
+  }
+
   const std::vector<CreativePromotedContentAdList> batches =
       SplitVector(creative_ads, batch_size_);
 
   for (const auto& batch : batches) {
-    InsertOrUpdate(&*transaction, batch);
+    InsertOrUpdate(transaction, batch);
 
     const CreativeAdList creative_ads_batch(batch.cbegin(), batch.cend());
-    campaigns_database_table_.InsertOrUpdate(&*transaction, creative_ads_batch);
-    creative_ads_database_table_.InsertOrUpdate(&*transaction,
+    campaigns_database_table_.InsertOrUpdate(transaction, creative_ads_batch);
+    creative_ads_database_table_.InsertOrUpdate(transaction,
                                                 creative_ads_batch);
-    dayparts_database_table_.InsertOrUpdate(&*transaction, creative_ads_batch);
-    deposits_database_table_.InsertOrUpdate(&*transaction, creative_ads_batch);
-    geo_targets_database_table_.InsertOrUpdate(&*transaction,
-                                               creative_ads_batch);
-    segments_database_table_.InsertOrUpdate(&*transaction, creative_ads_batch);
+    dayparts_database_table_.InsertOrUpdate(transaction, creative_ads_batch);
+    deposits_database_table_.InsertOrUpdate(transaction, creative_ads_batch);
+    geo_targets_database_table_.InsertOrUpdate(transaction, creative_ads_batch);
+    segments_database_table_.InsertOrUpdate(transaction, creative_ads_batch);
   }
-
-  RunTransaction(std::move(transaction), std::move(callback));
 }
 
 void CreativePromotedContentAds::Delete(ResultCallback callback) const {
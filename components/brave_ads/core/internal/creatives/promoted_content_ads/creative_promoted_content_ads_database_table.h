@@ -52,6 +52,11 @@ class CreativePromotedContentAds final : public TableInterface {
   void Save(const CreativePromotedContentAdList& creative_ads,
             ResultCallback callback);
 
+  // Adds the commands which save |creative_ads| to |transaction|, so that they
+  // can be committed together with other changes.
+  void Save(mojom::DBTransactionInfo* transaction,
+            const CreativePromotedContentAdList& creative_ads);
+
   void Delete(ResultCallback callback) const;
 
   void GetForCreativeInstanceId(
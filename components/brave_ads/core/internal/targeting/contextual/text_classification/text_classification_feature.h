@@ -22,6 +22,11 @@ constexpr base::FeatureParam<int>
     kTextClassificationPageProbabilitiesHistorySize{
         &kTextClassificationFeature, "page_probabilities_history_size", 5};
 
+// Longer text is truncated before it is classified, as the leading part of a
+// page is enough to pick its top segments.
+constexpr base::FeatureParam<int> kTextClassificationMaxTextLength{
+    &kTextClassificationFeature, "max_text_length", 10'000};
+
 // V2 without exploration; 5 page history; Legacy text classifier.
 
 // V2 with exploration; 25 page history; Legacy text classifier.
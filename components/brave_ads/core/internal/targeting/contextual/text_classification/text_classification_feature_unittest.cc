@@ -102,4 +102,27 @@ TEST(BraveAdsTextClassificationFeatureTest,
   EXPECT_EQ(5, kTextClassificationPageProbabilitiesHistorySize.Get());
 }
 
+TEST(BraveAdsTextClassificationFeatureTest,
+     GetTextClassificationMaxTextLength) {
+  // Arrange
+  base::test::ScopedFeatureList scoped_feature_list;
+  scoped_feature_list.InitAndEnableFeatureWithParameters(
+      kTextClassificationFeature, {{"max_text_length", "1000"}});
+
+  // Act
+
+  // Assert
+  EXPECT_EQ(1'000, kTextClassificationMaxTextLength.Get());
+}
+
+TEST(BraveAdsTextClassificationFeatureTest,
+     DefaultTextClassificationMaxTextLength) {
+  // Arrange
+
+  // Act
+
+  // Assert
+  EXPECT_EQ(10'000, kTextClassificationMaxTextLength.Get());
+}
+
 }  // namespace brave_ads
@@ -5,8 +5,18 @@
 
 #include "brave/components/brave_ads/core/internal/targeting/contextual/text_classification/text_classification_processor.h"
 
+#include <utility>
+
+#include "base/base64.h"
 #include "base/check.h"
+#include "base/containers/contains.h"
+#include "base/functional/bind.h"
+#include "base/location.h"
 #include "base/ranges/algorithm.h"
+#include "base/strings/string_util.h"
+#include "base/task/thread_pool.h"
+#include "brave/components/brave_ads/core/internal/client/ads_client_helper.h"
+#include "brave/components/brave_ads/core/internal/common/crypto/crypto_util.h"
 #include "brave/components/brave_ads/core/internal/common/logging_util.h"
 #include "brave/components/brave_ads/core/internal/common/search_engine/search_engine_results_page_util.h"
 #include "brave/components/brave_ads/core/internal/common/search_engine/search_engine_util.h"
@@ -14,6 +24,7 @@
 #include "brave/components/brave_ads/core/internal/ml/pipeline/text_processing/text_processing.h"
 #include "brave/components/brave_ads/core/internal/tabs/tab_manager.h"
 #include "brave/components/brave_ads/core/internal/targeting/contextual/text_classification/resource/text_classification_resource.h"
+#include "brave/components/brave_ads/core/internal/targeting/contextual/text_classification/text_classification_feature.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
 #include "url/gurl.h"
 
@@ -21,6 +32,8 @@ namespace brave_ads {
 
 namespace {
 
+constexpr size_t kProbabilitiesCacheSize = 25;
+
 std::string GetTopSegmentFromPageProbabilities(
     const TextClassificationProbabilityMap& probabilities) {
   CHECK(!probabilities.empty());
@@ -35,27 +48,101 @@ std::string GetTopSegmentFromPageProbabilities(
 
 }  // namespace
 
+struct TextClassificationProcessor::PreparedText {
+  // Truncated to |kTextClassificationMaxTextLength|.
+  std::string text;
+  std::string text_hash;
+};
+
 TextClassificationProcessor::TextClassificationProcessor(
     TextClassificationResource& resource)
-    : resource_(resource) {
+    : resource_(resource), probabilities_cache_(kProbabilitiesCacheSize) {
+  AdsClientHelper::AddObserver(this);
   TabManager::GetInstance().AddObserver(this);
 }
 
 TextClassificationProcessor::~TextClassificationProcessor() {
+  AdsClientHelper::RemoveObserver(this);
   TabManager::GetInstance().RemoveObserver(this);
 }
 
 void TextClassificationProcessor::Process(const std::string& text) {
-  if (!resource_->IsInitialized()) {
+  Classify(PrepareText(text));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// static
+TextClassificationProcessor::PreparedText
+TextClassificationProcessor::PrepareText(std::string text) {
+  PreparedText prepared_text;
+  base::TruncateUTF8ToByteSize(
+      text, static_cast<size_t>(kTextClassificationMaxTextLength.Get()),
+      &prepared_text.text);
+  prepared_text.text_hash =
+      base::Base64Encode(crypto::Sha256(prepared_text.text));
+  return prepared_text;
+}
+
+void TextClassificationProcessor::PrepareNextTextForTab(const int32_t tab_id) {
+  const auto iter = pending_text_.find(tab_id);
+  if (iter == pending_text_.cend()) {
+    preparing_tab_ids_.erase(tab_id);
+    return;
+  }
+
+  std::string text = std::move(iter->second);
+  pending_text_.erase(iter);
+  preparing_tab_ids_.insert(tab_id);
+
+  base::ThreadPool::PostTaskAndReplyWithResult(
+      FROM_HERE, {base::TaskPriority::BEST_EFFORT},
+      base::BindOnce(&TextClassificationProcessor::PrepareText,
+                     std::move(text)),
+      base::BindOnce(&TextClassificationProcessor::OnDidPrepareTextForTab,
+                     weak_factory_.GetWeakPtr(), tab_id));
+}
+
+void TextClassificationProcessor::OnDidPrepareTextForTab(
+    const int32_t tab_id,
+    PreparedText prepared_text) {
+  if (!base::Contains(preparing_tab_ids_, tab_id)) {
+    // The tab was closed.
     return;
   }
 
-  const absl::optional<ml::pipeline::TextProcessing>& text_processing =
-      resource_->get();
-  CHECK(text_processing);
+  if (base::Contains(pending_text_, tab_id)) {
+    // The tab changed content again, so only its latest text is classified.
+    return PrepareNextTextForTab(tab_id);
+  }
+
+  preparing_tab_ids_.erase(tab_id);
+
+  Classify(prepared_text);
+}
 
-  const absl::optional<TextClassificationProbabilityMap> probabilities =
-      text_processing->ClassifyPage(text);
+void TextClassificationProcessor::Classify(const PreparedText& prepared_text) {
+  if (!resource_->IsInitialized()) {
+    return;
+  }
+
+  absl::optional<TextClassificationProbabilityMap> probabilities;
+
+  const auto iter = probabilities_cache_.Get(prepared_text.text_hash);
+  if (iter != probabilities_cache_.end()) {
+    BLOG(1, "Text classification probabilities found in cache");
+    probabilities = iter->second;
+  } else {
+    const absl::optional<ml::pipeline::TextProcessing>& text_processing =
+        resource_->get();
+    CHECK(text_processing);
+
+    BLOG(1, "Classifying text");
+    probabilities = text_processing->ClassifyPage(prepared_text.text);
+    if (probabilities) {
+      probabilities_cache_.Put(prepared_text.text_hash, *probabilities);
+    }
+  }
 
   if (!probabilities) {
     return BLOG(0, "Text classification failed due to an invalid model");
@@ -74,10 +161,15 @@ void TextClassificationProcessor::Process(const std::string& text) {
       .AppendTextClassificationProbabilitiesToHistory(*probabilities);
 }
 
-///////////////////////////////////////////////////////////////////////////////
+void TextClassificationProcessor::OnNotifyDidUpdateResourceComponent(
+    const std::string& /*manifest_version*/,
+    const std::string& /*id*/) {
+  // Cached probabilities might have been classified by an outdated model.
+  probabilities_cache_.Clear();
+}
 
 void TextClassificationProcessor::OnTextContentDidChange(
-    const int32_t /*tab_id*/,
+    const int32_t tab_id,
     const std::vector<GURL>& redirect_chain,
     const std::string& text) {
   if (redirect_chain.empty()) {
@@ -98,7 +190,17 @@ void TextClassificationProcessor::OnTextContentDidChange(
                 "text content");
   }
 
-  Process(text);
+  // Truncate and hash the text on a background sequence. If the tab changes
+  // content again meanwhile, only the latest text is classified.
+  pending_text_[tab_id] = text;
+  if (!base::Contains(preparing_tab_ids_, tab_id)) {
+    PrepareNextTextForTab(tab_id);
+  }
+}
+
+void TextClassificationProcessor::OnDidCloseTab(const int32_t tab_id) {
+  pending_text_.erase(tab_id);
+  preparing_tab_ids_.erase(tab_id);
 }
 
 }  // namespace brave_ads
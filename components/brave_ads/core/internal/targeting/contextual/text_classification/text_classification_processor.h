@@ -7,11 +7,17 @@
 #define BRAVE_COMPONENTS_BRAVE_ADS_CORE_INTERNAL_TARGETING_CONTEXTUAL_TEXT_CLASSIFICATION_TEXT_CLASSIFICATION_PROCESSOR_H_
 
 #include <cstdint>
+#include <map>
+#include <set>
 #include <string>
 #include <vector>
 
+#include "base/containers/lru_cache.h"
 #include "base/memory/raw_ref.h"
+#include "base/memory/weak_ptr.h"
 #include "brave/components/brave_ads/core/internal/tabs/tab_manager_observer.h"
+#include "brave/components/brave_ads/core/internal/targeting/contextual/text_classification/model/text_classification_alias.h"
+#include "brave/components/brave_ads/core/public/client/ads_client_notifier_observer.h"
 
 class GURL;
 
@@ -19,7 +25,8 @@ namespace brave_ads {
 
 class TextClassificationResource;
 
-class TextClassificationProcessor final : public TabManagerObserver {
+class TextClassificationProcessor final : public AdsClientNotifierObserver,
+                                          public TabManagerObserver {
  public:
   explicit TextClassificationProcessor(TextClassificationResource& resource);
 
@@ -36,12 +43,39 @@ class TextClassificationProcessor final : public TabManagerObserver {
   void Process(const std::string& text);
 
  private:
+  struct PreparedText;
+
+  static PreparedText PrepareText(std::string text);
+
+  void PrepareNextTextForTab(int32_t tab_id);
+  void OnDidPrepareTextForTab(int32_t tab_id, PreparedText prepared_text);
+  void Classify(const PreparedText& prepared_text);
+
+  // AdsClientNotifierObserver:
+  void OnNotifyDidUpdateResourceComponent(const std::string& manifest_version,
+                                          const std::string& id) override;
+
   // TabManagerObserver:
   void OnTextContentDidChange(int32_t tab_id,
                               const std::vector<GURL>& redirect_chain,
                               const std::string& text) override;
+  void OnDidCloseTab(int32_t tab_id) override;
 
   const raw_ref<TextClassificationResource> resource_;
+
+  // Classification results for recently classified text, keyed by the hash of
+  // the text, so revisiting or reloading a page doesn't run the model again.
+  base::LRUCache</*text_hash*/ std::string, TextClassificationProbabilityMap>
+      probabilities_cache_;
+
+  // Text which is waiting to be prepared. Only the latest text of each tab
+  // is classified.
+  std::map</*tab_id*/ int32_t, std::string> pending_text_;
+
+  // Tabs with text being truncated and hashed on a background sequence.
+  std::set</*tab_id*/ int32_t> preparing_tab_ids_;
+
+  base::WeakPtrFactory<TextClassificationProcessor> weak_factory_{this};
 };
 
 }  // namespace brave_ads
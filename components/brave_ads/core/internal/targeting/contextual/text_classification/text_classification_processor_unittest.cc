@@ -7,17 +7,22 @@
 
 #include <memory>
 
+#include "base/test/scoped_feature_list.h"
 #include "brave/components/brave_ads/core/internal/common/resources/language_components_unittest_constants.h"
 #include "brave/components/brave_ads/core/internal/common/unittest/unittest_base.h"
 #include "brave/components/brave_ads/core/internal/deprecated/client/client_state_manager.h"
 #include "brave/components/brave_ads/core/internal/targeting/contextual/text_classification/model/text_classification_alias.h"
 #include "brave/components/brave_ads/core/internal/targeting/contextual/text_classification/model/text_classification_model.h"
 #include "brave/components/brave_ads/core/internal/targeting/contextual/text_classification/resource/text_classification_resource.h"
+#include "brave/components/brave_ads/core/internal/targeting/contextual/text_classification/text_classification_feature.h"
+#include "url/gurl.h"
 
 // npm run test -- brave_unit_tests --filter=BraveAds*
 
 namespace brave_ads {
 
+using ::testing::_;
+
 class BraveAdsTextClassificationProcessorTest : public UnitTestBase {
  protected:
   void SetUp() override {
@@ -115,4 +120,134 @@ TEST_F(BraveAdsTextClassificationProcessorTest, ProcessMultipleText) {
   EXPECT_EQ(3U, list.size());
 }
 
+TEST_F(BraveAdsTextClassificationProcessorTest, ProcessCachedText) {
+  // Arrange
+  ASSERT_TRUE(LoadResource());
+
+  TextClassificationProcessor processor(*resource_);
+  processor.Process(/*text*/ "Some content about technology & computing");
+
+  // Assert
+  EXPECT_CALL(ads_client_mock_, Log).Times(::testing::AnyNumber());
+  EXPECT_CALL(ads_client_mock_, Log(_, _, _, "Classifying text")).Times(0);
+
+  // Act
+  processor.Process(/*text*/ "Some content about technology & computing");
+
+  // Assert
+  const TextClassificationProbabilityList& list =
+      ClientStateManager::GetInstance()
+          .GetTextClassificationProbabilitiesHistory();
+
+  ASSERT_EQ(2U, list.size());
+  EXPECT_EQ(list.front(), list.back());
+}
+
+TEST_F(BraveAdsTextClassificationProcessorTest, TruncateTextBeforeProcessing) {
+  // Arrange
+  base::test::ScopedFeatureList scoped_feature_list;
+  scoped_feature_list.InitAndEnableFeatureWithParameters(
+      kTextClassificationFeature, {{"max_text_length", "41"}});
+
+  ASSERT_TRUE(LoadResource());
+
+  TextClassificationProcessor processor(*resource_);
+  processor.Process(/*text*/ "Some content about technology & computing");
+
+  // Assert
+  EXPECT_CALL(ads_client_mock_, Log).Times(::testing::AnyNumber());
+  EXPECT_CALL(ads_client_mock_, Log(_, _, _, "Classifying text")).Times(0);
+
+  // Act
+  processor.Process(
+      /*text*/ "Some content about technology & computing and cooking food");
+
+  // Assert
+  const TextClassificationProbabilityList& list =
+      ClientStateManager::GetInstance()
+          .GetTextClassificationProbabilitiesHistory();
+
+  ASSERT_EQ(2U, list.size());
+  EXPECT_EQ(list.front(), list.back());
+}
+
+TEST_F(BraveAdsTextClassificationProcessorTest, ProcessTextContentForTab) {
+  // Arrange
+  ASSERT_TRUE(LoadResource());
+
+  TextClassificationProcessor processor(*resource_);
+
+  NotifyTabDidChange(
+      /*id*/ 1, /*redirect_chain*/ {GURL("https://brave.com")},
+      /*is_active*/ true);
+
+  // Act
+  NotifyTabTextContentDidChange(
+      /*id*/ 1, /*redirect_chain*/ {GURL("https://brave.com")},
+      /*text*/ "Some content about technology & computing");
+  task_environment_.RunUntilIdle();
+
+  // Assert
+  const TextClassificationProbabilityList& list =
+      ClientStateManager::GetInstance()
+          .GetTextClassificationProbabilitiesHistory();
+
+  EXPECT_EQ(1U, list.size());
+}
+
+TEST_F(BraveAdsTextClassificationProcessorTest,
+       OnlyProcessLatestTextContentForTab) {
+  // Arrange
+  ASSERT_TRUE(LoadResource());
+
+  TextClassificationProcessor processor(*resource_);
+
+  NotifyTabDidChange(
+      /*id*/ 1, /*redirect_chain*/ {GURL("https://brave.com")},
+      /*is_active*/ true);
+
+  // Act
+  NotifyTabTextContentDidChange(
+      /*id*/ 1, /*redirect_chain*/ {GURL("https://brave.com")},
+      /*text*/ "Some content about cooking food");
+  NotifyTabTextContentDidChange(
+      /*id*/ 1, /*redirect_chain*/ {GURL("https://brave.com")},
+      /*text*/ "Some content about technology & computing");
+  task_environment_.RunUntilIdle();
+
+  // Assert
+  const TextClassificationProbabilityList& list =
+      ClientStateManager::GetInstance()
+          .GetTextClassificationProbabilitiesHistory();
+
+  EXPECT_EQ(1U, list.size());
+}
+
+TEST_F(BraveAdsTextClassificationProcessorTest,
+       DoNotProcessTextContentForClosedTab) {
+  // Arrange
+  ASSERT_TRUE(LoadResource());
+
+  TextClassificationProcessor processor(*resource_);
+
+  NotifyTabDidChange(
+      /*id*/ 1, /*redirect_chain*/ {GURL("https://brave.com")},
+      /*is_active*/ true);
+
+  NotifyTabTextContentDidChange(
+      /*id*/ 1, /*redirect_chain*/ {GURL("https://brave.com")},
+      /*text*/ "Some content about technology & computing");
+
+  // Act
+  NotifyDidCloseTab(/*id*/ 1);
+  task_environment_.RunUntilIdle();
+
+  // Assert
+  const TextClassificationProbabilityList& list =
+      ClientStateManager::GetInstance()
+          .GetTextClassificationProbabilitiesHistory();
+
+  EXPECT_TRUE(list.empty());
+}
+
 }  // namespace brave_ads
@@ -8,6 +8,7 @@
 
 #include "base/feature_list.h"
 #include "base/metrics/field_trial_params.h"
+#include "base/time/time.h"
 
 namespace brave_ads {
 
@@ -21,6 +22,17 @@ constexpr base::FeatureParam<int> kTextEmbeddingResourceVersion{
 constexpr base::FeatureParam<int> kTextEmbeddingHistorySize{
     &kTextEmbeddingFeature, "history_size", 10};
 
+// Text embedding HTML events are buffered and logged once this many events are
+// buffered or |kTextEmbeddingHtmlEventsFlushAfter| has elapsed since the first
+// buffered event, whichever comes first.
+constexpr base::FeatureParam<int> kTextEmbeddingHtmlEventsFlushThreshold{
+    &kTextEmbeddingFeature, "html_events_flush_threshold", 5};
+
+constexpr base::FeatureParam<base::TimeDelta>
+    kTextEmbeddingHtmlEventsFlushAfter{&kTextEmbeddingFeature,
+                                       "html_events_flush_after",
+                                       base::Seconds(30)};
+
 }  // namespace brave_ads
 
 #endif  // BRAVE_COMPONENTS_BRAVE_ADS_CORE_INTERNAL_TARGETING_CONTEXTUAL_TEXT_EMBEDDING_TEXT_EMBEDDING_FEATURE_H_
@@ -98,4 +98,48 @@ TEST(BraveAdsTextClassificationFeatureTest,
   EXPECT_EQ(10, kTextEmbeddingHistorySize.Get());
 }
 
+TEST(BraveAdsTextEmbeddingFeatureTest, TextEmbeddingHtmlEventsFlushThreshold) {
+  // Arrange
+  base::test::ScopedFeatureList scoped_feature_list;
+  scoped_feature_list.InitAndEnableFeatureWithParameters(
+      kTextEmbeddingFeature, {{"html_events_flush_threshold", "7"}});
+
+  // Act
+
+  // Assert
+  EXPECT_EQ(7, kTextEmbeddingHtmlEventsFlushThreshold.Get());
+}
+
+TEST(BraveAdsTextEmbeddingFeatureTest,
+     DefaultTextEmbeddingHtmlEventsFlushThreshold) {
+  // Arrange
+
+  // Act
+
+  // Assert
+  EXPECT_EQ(5, kTextEmbeddingHtmlEventsFlushThreshold.Get());
+}
+
+TEST(BraveAdsTextEmbeddingFeatureTest, TextEmbeddingHtmlEventsFlushAfter) {
+  // Arrange
+  base::test::ScopedFeatureList scoped_feature_list;
+  scoped_feature_list.InitAndEnableFeatureWithParameters(
+      kTextEmbeddingFeature, {{"html_events_flush_after", "1m"}});
+
+  // Act
+
+  // Assert
+  EXPECT_EQ(base::Minutes(1), kTextEmbeddingHtmlEventsFlushAfter.Get());
+}
+
+TEST(BraveAdsTextEmbeddingFeatureTest,
+     DefaultTextEmbeddingHtmlEventsFlushAfter) {
+  // Arrange
+
+  // Act
+
+  // Assert
+  EXPECT_EQ(base::Seconds(30), kTextEmbeddingHtmlEventsFlushAfter.Get());
+}
+
 }  // namespace brave_ads
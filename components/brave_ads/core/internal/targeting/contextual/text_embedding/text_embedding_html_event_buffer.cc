@@ -0,0 +1,63 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_ads/core/internal/targeting/contextual/text_embedding/text_embedding_html_event_buffer.h"
+
+#include <utility>
+
+#include "base/functional/bind.h"
+#include "brave/components/brave_ads/core/internal/common/logging_util.h"
+#include "brave/components/brave_ads/core/internal/targeting/contextual/text_embedding/text_embedding_feature.h"
+#include "brave/components/brave_ads/core/internal/targeting/contextual/text_embedding/text_embedding_html_events.h"
+
+namespace brave_ads {
+
+TextEmbeddingHtmlEventBuffer::TextEmbeddingHtmlEventBuffer() = default;
+
+TextEmbeddingHtmlEventBuffer::~TextEmbeddingHtmlEventBuffer() {
+  Flush();
+}
+
+void TextEmbeddingHtmlEventBuffer::Add(
+    const TextEmbeddingHtmlEventInfo& text_embedding_html_event) {
+  text_embedding_html_events_.push_back(text_embedding_html_event);
+
+  if (static_cast<int>(text_embedding_html_events_.size()) >=
+      kTextEmbeddingHtmlEventsFlushThreshold.Get()) {
+    return Flush();
+  }
+
+  if (!flush_timer_.IsRunning()) {
+    flush_timer_.Start(FROM_HERE, kTextEmbeddingHtmlEventsFlushAfter.Get(),
+                       base::BindOnce(&TextEmbeddingHtmlEventBuffer::Flush,
+                                      base::Unretained(this)));
+  }
+}
+
+void TextEmbeddingHtmlEventBuffer::Flush() {
+  flush_timer_.Stop();
+
+  if (text_embedding_html_events_.empty()) {
+    return;
+  }
+
+  const TextEmbeddingHtmlEventList text_embedding_html_events =
+      std::exchange(text_embedding_html_events_, {});
+
+  LogTextEmbeddingHtmlEvents(
+      text_embedding_html_events,
+      base::BindOnce(
+          [](const size_t count, const bool success) {
+            if (!success) {
+              return BLOG(1, "Failed to log text embedding HTML events");
+            }
+
+            BLOG(3, "Successfully logged " << count
+                                           << " text embedding HTML events");
+          },
+          text_embedding_html_events.size()));
+}
+
+}  // namespace brave_ads
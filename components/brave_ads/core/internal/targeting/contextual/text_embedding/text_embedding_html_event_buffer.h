@@ -0,0 +1,51 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_ADS_CORE_INTERNAL_TARGETING_CONTEXTUAL_TEXT_EMBEDDING_TEXT_EMBEDDING_HTML_EVENT_BUFFER_H_
+#define BRAVE_COMPONENTS_BRAVE_ADS_CORE_INTERNAL_TARGETING_CONTEXTUAL_TEXT_EMBEDDING_TEXT_EMBEDDING_HTML_EVENT_BUFFER_H_
+
+#include <cstddef>
+
+#include "base/timer/timer.h"
+#include "brave/components/brave_ads/core/internal/targeting/contextual/text_embedding/text_embedding_html_event_info.h"
+
+namespace brave_ads {
+
+// Buffers text embedding HTML events so that they are logged, and stale events
+// are purged, in a single transaction per batch rather than per page view.
+// Buffered events are flushed once |kTextEmbeddingHtmlEventsFlushThreshold|
+// events are buffered, |kTextEmbeddingHtmlEventsFlushAfter| after the first
+// buffered event, or on destruction, so at most that many events, or events
+// buffered within that time, are lost on a crash.
+class TextEmbeddingHtmlEventBuffer final {
+ public:
+  TextEmbeddingHtmlEventBuffer();
+
+  TextEmbeddingHtmlEventBuffer(const TextEmbeddingHtmlEventBuffer&) = delete;
+  TextEmbeddingHtmlEventBuffer& operator=(const TextEmbeddingHtmlEventBuffer&) =
+      delete;
+
+  TextEmbeddingHtmlEventBuffer(TextEmbeddingHtmlEventBuffer&&) noexcept =
+      delete;
+  TextEmbeddingHtmlEventBuffer& operator=(
+      TextEmbeddingHtmlEventBuffer&&) noexcept = delete;
+
+  ~TextEmbeddingHtmlEventBuffer();
+
+  void Add(const TextEmbeddingHtmlEventInfo& text_embedding_html_event);
+
+  void Flush();
+
+  size_t size() const { return text_embedding_html_events_.size(); }
+
+ private:
+  TextEmbeddingHtmlEventList text_embedding_html_events_;
+
+  base::OneShotTimer flush_timer_;
+};
+
+}  // namespace brave_ads
+
+#endif  // BRAVE_COMPONENTS_BRAVE_ADS_CORE_INTERNAL_TARGETING_CONTEXTUAL_TEXT_EMBEDDING_TEXT_EMBEDDING_HTML_EVENT_BUFFER_H_
@@ -0,0 +1,187 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_ads/core/internal/targeting/contextual/text_embedding/text_embedding_html_event_buffer.h"
+
+#include <memory>
+#include <string>
+
+#include "base/functional/bind.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/test/scoped_feature_list.h"
+#include "brave/components/brave_ads/core/internal/common/unittest/unittest_base.h"
+#include "brave/components/brave_ads/core/internal/ml/pipeline/text_processing/embedding_info.h"
+#include "brave/components/brave_ads/core/internal/targeting/contextual/text_embedding/text_embedding_feature.h"
+#include "brave/components/brave_ads/core/internal/targeting/contextual/text_embedding/text_embedding_html_event_info.h"
+#include "brave/components/brave_ads/core/internal/targeting/contextual/text_embedding/text_embedding_html_event_unittest_util.h"
+#include "brave/components/brave_ads/core/internal/targeting/contextual/text_embedding/text_embedding_html_events.h"
+#include "brave/components/brave_ads/core/mojom/brave_ads.mojom.h"
+
+// npm run test -- brave_unit_tests --filter=BraveAds*
+
+namespace brave_ads {
+
+using ::testing::_;
+using ::testing::Field;
+using ::testing::Pointee;
+using ::testing::SizeIs;
+
+namespace {
+
+constexpr int kPageViews = 1'000;
+
+TextEmbeddingHtmlEventInfo BuildTextEmbeddingHtmlEventForTesting(
+    const int index) {
+  ml::pipeline::TextEmbeddingInfo text_embedding =
+      ml::pipeline::BuildTextEmbeddingForTesting();
+  text_embedding.hashed_text_base64 = base::NumberToString(index);
+  return BuildTextEmbeddingHtmlEvent(text_embedding);
+}
+
+void ExpectTextEmbeddingHtmlEventCountEquals(const size_t expected_count) {
+  GetTextEmbeddingHtmlEventsFromDatabase(base::BindOnce(
+      [](const size_t expected_count, const bool success,
+         const TextEmbeddingHtmlEventList& text_embedding_html_events) {
+        ASSERT_TRUE(success);
+        EXPECT_EQ(expected_count, text_embedding_html_events.size());
+      },
+      expected_count));
+}
+
+}  // namespace
+
+class BraveAdsTextEmbeddingHtmlEventBufferTest : public UnitTestBase {
+ protected:
+  void SetUp() override {
+    UnitTestBase::SetUp();
+
+    scoped_feature_list_.InitAndEnableFeatureWithParameters(
+        kTextEmbeddingFeature, {{"history_size", "10"},
+                                {"html_events_flush_threshold", "5"},
+                                {"html_events_flush_after", "30s"}});
+  }
+
+  base::test::ScopedFeatureList scoped_feature_list_;
+};
+
+TEST_F(BraveAdsTextEmbeddingHtmlEventBufferTest, FlushWhenThresholdIsReached) {
+  // Arrange
+  TextEmbeddingHtmlEventBuffer buffer;
+
+  for (int i = 0; i < kTextEmbeddingHtmlEventsFlushThreshold.Get() - 1; i++) {
+    buffer.Add(BuildTextEmbeddingHtmlEventForTesting(i));
+  }
+  ExpectTextEmbeddingHtmlEventCountEquals(0);
+
+  // Act
+  buffer.Add(BuildTextEmbeddingHtmlEventForTesting(
+      kTextEmbeddingHtmlEventsFlushThreshold.Get() - 1));
+
+  // Assert
+  EXPECT_EQ(0U, buffer.size());
+  ExpectTextEmbeddingHtmlEventCountEquals(
+      kTextEmbeddingHtmlEventsFlushThreshold.Get());
+}
+
+TEST_F(BraveAdsTextEmbeddingHtmlEventBufferTest, FlushAfterDelay) {
+  // Arrange
+  TextEmbeddingHtmlEventBuffer buffer;
+  buffer.Add(BuildTextEmbeddingHtmlEventForTesting(0));
+
+  FastForwardClockBy(kTextEmbeddingHtmlEventsFlushAfter.Get() -
+                     base::Milliseconds(1));
+  ExpectTextEmbeddingHtmlEventCountEquals(0);
+
+  // Act
+  FastForwardClockBy(base::Milliseconds(1));
+
+  // Assert
+  EXPECT_EQ(0U, buffer.size());
+  ExpectTextEmbeddingHtmlEventCountEquals(1);
+}
+
+TEST_F(BraveAdsTextEmbeddingHtmlEventBufferTest, FlushOnDestruction) {
+  // Arrange
+  auto buffer = std::make_unique<TextEmbeddingHtmlEventBuffer>();
+  buffer->Add(BuildTextEmbeddingHtmlEventForTesting(0));
+  buffer->Add(BuildTextEmbeddingHtmlEventForTesting(1));
+
+  // Act
+  buffer.reset();
+
+  // Assert
+  ExpectTextEmbeddingHtmlEventCountEquals(2);
+}
+
+TEST_F(BraveAdsTextEmbeddingHtmlEventBufferTest, FlushEventsInOrder) {
+  // Arrange
+  TextEmbeddingHtmlEventBuffer buffer;
+
+  TextEmbeddingHtmlEventList expected_text_embedding_html_events;
+  for (int i = 0; i < kTextEmbeddingHistorySize.Get() + 3; i++) {
+    const TextEmbeddingHtmlEventInfo text_embedding_html_event =
+        BuildTextEmbeddingHtmlEventForTesting(i);
+    buffer.Add(text_embedding_html_event);
+    expected_text_embedding_html_events.insert(
+        expected_text_embedding_html_events.cbegin(),
+        text_embedding_html_event);
+
+    AdvanceClockBy(base::Seconds(1));
+  }
+
+  // Act
+  buffer.Flush();
+
+  // Assert
+  expected_text_embedding_html_events.resize(kTextEmbeddingHistorySize.Get());
+  GetTextEmbeddingHtmlEventsFromDatabase(base::BindOnce(
+      [](const TextEmbeddingHtmlEventList& expected_text_embedding_html_events,
+         const bool success,
+         const TextEmbeddingHtmlEventList& text_embedding_html_events) {
+        ASSERT_TRUE(success);
+        EXPECT_EQ(expected_text_embedding_html_events,
+                  text_embedding_html_events);
+      },
+      expected_text_embedding_html_events));
+}
+
+TEST_F(BraveAdsTextEmbeddingHtmlEventBufferTest, BoundEventsLostOnCrash) {
+  // Arrange
+  TextEmbeddingHtmlEventBuffer buffer;
+
+  // Act
+  for (int i = 0; i < kPageViews; i++) {
+    buffer.Add(BuildTextEmbeddingHtmlEventForTesting(i));
+
+    // Assert
+    EXPECT_LT(static_cast<int>(buffer.size()),
+              kTextEmbeddingHtmlEventsFlushThreshold.Get());
+  }
+}
+
+TEST_F(BraveAdsTextEmbeddingHtmlEventBufferTest,
+       LogAndPurgeEventsInOneTransactionPerFlush) {
+  // Arrange
+  TextEmbeddingHtmlEventBuffer buffer;
+
+  // Logging each page view used to run an insert and a purge transaction,
+  // i.e. 2,000 statements in 2,000 transactions for 1,000 page views. Each
+  // flush now runs a single multi-row insert and a single purge.
+  EXPECT_CALL(
+      ads_client_mock_,
+      RunDBTransaction(
+          Pointee(Field(&mojom::DBTransactionInfo::commands, SizeIs(2))), _))
+      .Times(kPageViews / kTextEmbeddingHtmlEventsFlushThreshold.Get());
+
+  // Act
+  for (int i = 0; i < kPageViews; i++) {
+    buffer.Add(BuildTextEmbeddingHtmlEventForTesting(i));
+  }
+
+  // Assert
+  EXPECT_EQ(0U, buffer.size());
+}
+
+}  // namespace brave_ads
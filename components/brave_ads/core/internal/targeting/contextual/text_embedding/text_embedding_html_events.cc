@@ -57,6 +57,19 @@ void LogTextEmbeddingHtmlEvent(
           std::move(callback)));
 }
 
+void LogTextEmbeddingHtmlEvents(
+    const TextEmbeddingHtmlEventList& text_embedding_html_events,
+    LogTextEmbeddingHtmlEventCallback callback) {
+  database::table::TextEmbeddingHtmlEvents database_table;
+  database_table.LogEvents(
+      text_embedding_html_events,
+      base::BindOnce(
+          [](LogTextEmbeddingHtmlEventCallback callback, const bool success) {
+            std::move(callback).Run(success);
+          },
+          std::move(callback)));
+}
+
 void PurgeStaleTextEmbeddingHtmlEvents(
     LogTextEmbeddingHtmlEventCallback callback) {
   const database::table::TextEmbeddingHtmlEvents database_table;
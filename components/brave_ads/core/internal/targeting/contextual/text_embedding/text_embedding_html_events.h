@@ -24,6 +24,12 @@ void LogTextEmbeddingHtmlEvent(
     const TextEmbeddingHtmlEventInfo& text_embedding_html_event,
     LogTextEmbeddingHtmlEventCallback callback);
 
+// Logs |text_embedding_html_events| and purges stale events in a single
+// transaction.
+void LogTextEmbeddingHtmlEvents(
+    const TextEmbeddingHtmlEventList& text_embedding_html_events,
+    LogTextEmbeddingHtmlEventCallback callback);
+
 void PurgeStaleTextEmbeddingHtmlEvents(
     LogTextEmbeddingHtmlEventCallback callback);
 
@@ -102,6 +102,21 @@ void GetAllCallback(GetTextEmbeddingHtmlEventsCallback callback,
   std::move(callback).Run(/* success */ true, text_embedding_html_events);
 }
 
+// Purging after each batch keeps the table at |kTextEmbeddingHistorySize| rows
+// plus one batch, so ordering by |created_at| does not need an index.
+void PurgeStaleEvents(mojom::DBTransactionInfo* transaction,
+                      const std::string& table_name) {
+  CHECK(transaction);
+
+  mojom::DBCommandInfoPtr command = mojom::DBCommandInfo::New();
+  command->type = mojom::DBCommandInfo::Type::EXECUTE;
+  command->sql = base::StringPrintf(
+      "DELETE FROM %s WHERE id NOT IN (SELECT id from %s ORDER BY created_at "
+      "DESC LIMIT %d);",
+      table_name.c_str(), table_name.c_str(), kTextEmbeddingHistorySize.Get());
+  transaction->commands.push_back(std::move(command));
+}
+
 void MigrateToV25(mojom::DBTransactionInfo* transaction) {
   CHECK(transaction);
 
@@ -138,6 +153,21 @@ void TextEmbeddingHtmlEvents::LogEvent(
   RunTransaction(std::move(transaction), std::move(callback));
 }
 
+void TextEmbeddingHtmlEvents::LogEvents(
+    const TextEmbeddingHtmlEventList& text_embedding_html_events,
+    ResultCallback callback) {
+  if (text_embedding_html_events.empty()) {
+    return std::move(callback).Run(/*success*/ true);
+  }
+
+  mojom::DBTransactionInfoPtr transaction = mojom::DBTransactionInfo::New();
+
+  InsertOrUpdate(&*transaction, text_embedding_html_events);
+  PurgeStaleEvents(&*transaction, GetTableName());
+
+  RunTransaction(std::move(transaction), std::move(callback));
+}
+
 void TextEmbeddingHtmlEvents::GetAll(
     GetTextEmbeddingHtmlEventsCallback callback) const {
   mojom::DBTransactionInfoPtr transaction = mojom::DBTransactionInfo::New();
@@ -157,14 +187,8 @@ void TextEmbeddingHtmlEvents::GetAll(
 
 void TextEmbeddingHtmlEvents::PurgeStale(ResultCallback callback) const {
   mojom::DBTransactionInfoPtr transaction = mojom::DBTransactionInfo::New();
-  mojom::DBCommandInfoPtr command = mojom::DBCommandInfo::New();
-  command->type = mojom::DBCommandInfo::Type::EXECUTE;
-  command->sql = base::StringPrintf(
-      "DELETE FROM %s WHERE id NOT IN (SELECT id from %s ORDER BY created_at "
-      "DESC LIMIT %d);",
-      GetTableName().c_str(), GetTableName().c_str(),
-      kTextEmbeddingHistorySize.Get());
-  transaction->commands.push_back(std::move(command));
+
+  PurgeStaleEvents(&*transaction, GetTableName());
 
   RunTransaction(std::move(transaction), std::move(callback));
 }
@@ -25,6 +25,11 @@ class TextEmbeddingHtmlEvents final : public TableInterface {
   void LogEvent(const TextEmbeddingHtmlEventInfo& text_embedding_html_event,
                 ResultCallback callback);
 
+  // Logs |text_embedding_html_events| and purges stale events in a single
+  // transaction.
+  void LogEvents(const TextEmbeddingHtmlEventList& text_embedding_html_events,
+                 ResultCallback callback);
+
   void GetAll(GetTextEmbeddingHtmlEventsCallback callback) const;
 
   void PurgeStale(ResultCallback callback) const;
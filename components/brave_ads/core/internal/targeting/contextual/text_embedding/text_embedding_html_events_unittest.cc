@@ -6,6 +6,7 @@
 #include "brave/components/brave_ads/core/internal/targeting/contextual/text_embedding/text_embedding_html_events.h"
 
 #include "base/functional/bind.h"
+#include "base/strings/string_number_conversions.h"
 #include "brave/components/brave_ads/core/internal/common/unittest/unittest_base.h"
 #include "brave/components/brave_ads/core/internal/ml/pipeline/text_processing/embedding_info.h"
 #include "brave/components/brave_ads/core/internal/targeting/contextual/text_embedding/text_embedding_feature.h"
@@ -58,6 +59,38 @@ TEST_F(BraveAdsTextEmbeddingHtmlEventsTest, LogEvent) {
       text_embedding));
 }
 
+TEST_F(BraveAdsTextEmbeddingHtmlEventsTest, LogEventsAndPurgeStaleEvents) {
+  // Arrange
+  TextEmbeddingHtmlEventList text_embedding_html_events;
+  for (int i = 0; i < kTextEmbeddingHistorySize.Get() + 4; i++) {
+    ml::pipeline::TextEmbeddingInfo text_embedding =
+        ml::pipeline::BuildTextEmbeddingForTesting();
+    text_embedding.hashed_text_base64 = base::NumberToString(i);
+    text_embedding_html_events.push_back(
+        BuildTextEmbeddingHtmlEvent(text_embedding));
+
+    AdvanceClockBy(base::Seconds(1));
+  }
+
+  // Act
+  LogTextEmbeddingHtmlEvents(
+      text_embedding_html_events,
+      base::BindOnce([](const bool success) { ASSERT_TRUE(success); }));
+
+  // Assert
+  GetTextEmbeddingHtmlEventsFromDatabase(base::BindOnce(
+      [](const bool success,
+         const TextEmbeddingHtmlEventList& text_embedding_html_events) {
+        ASSERT_TRUE(success);
+        ASSERT_EQ(kTextEmbeddingHistorySize.Get(),
+                  static_cast<int>(text_embedding_html_events.size()));
+
+        EXPECT_EQ(base::NumberToString(kTextEmbeddingHistorySize.Get() + 3),
+                  text_embedding_html_events.front().hashed_text_base64);
+        EXPECT_EQ("4", text_embedding_html_events.back().hashed_text_base64);
+      }));
+}
+
 TEST_F(BraveAdsTextEmbeddingHtmlEventsTest, PurgeEvents) {
   // Arrange
   for (int i = 0; i < kTextEmbeddingHistorySize.Get() + 4; i++) {
@@ -64,23 +64,8 @@ void TextEmbeddingProcessor::Process(const std::string& html) {
     return BLOG(1, "Not enough words to embed text");
   }
 
-  LogTextEmbeddingHtmlEvent(
-      BuildTextEmbeddingHtmlEvent(text_embedding),
-      base::BindOnce([](const bool success) {
-        if (!success) {
-          return BLOG(1, "Failed to log text embedding HTML event");
-        }
-
-        PurgeStaleTextEmbeddingHtmlEvents(
-            base::BindOnce([](const bool success) {
-              if (!success) {
-                return BLOG(1,
-                            "Failed to purge stale text embedding HTML events");
-              }
-
-              BLOG(3, "Successfully purged stale text embedding HTML events");
-            }));
-      }));
+  text_embedding_html_event_buffer_.Add(
+      BuildTextEmbeddingHtmlEvent(text_embedding));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
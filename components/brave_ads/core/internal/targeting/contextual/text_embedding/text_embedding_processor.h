@@ -12,6 +12,7 @@
 
 #include "base/memory/raw_ref.h"
 #include "brave/components/brave_ads/core/internal/tabs/tab_manager_observer.h"
+#include "brave/components/brave_ads/core/internal/targeting/contextual/text_embedding/text_embedding_html_event_buffer.h"
 
 class GURL;
 
@@ -34,12 +35,16 @@ class TextEmbeddingProcessor final : public TabManagerObserver {
   void Process(const std::string& html);
 
  private:
+  friend class TextEmbeddingHelperForTesting;
+
   // TabManagerObserver:
   void OnHtmlContentDidChange(int32_t tab_id,
                               const std::vector<GURL>& redirect_chain,
                               const std::string& html) override;
 
   const raw_ref<TextEmbeddingResource> resource_;
+
+  TextEmbeddingHtmlEventBuffer text_embedding_html_event_buffer_;
 };
 
 }  // namespace brave_ads
@@ -20,6 +20,7 @@ void TextEmbeddingHelperForTesting::Mock() {
   processor_.Process(
       /*html*/
       R"(<meta property="og:title" content="This simple unittest mock checks for embedding accuracy." />)");
+  processor_.text_embedding_html_event_buffer_.Flush();
 }
 
 // static
@@ -0,0 +1,18 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_ADS_CORE_PUBLIC_PREFS_CATALOG_PREF_NAMES_H_
+#define BRAVE_COMPONENTS_BRAVE_ADS_CORE_PUBLIC_PREFS_CATALOG_PREF_NAMES_H_
+
+namespace brave_ads::prefs {
+
+// Digests of the creatives of each campaign in the last saved catalog, keyed
+// by campaign id.
+inline constexpr char kCatalogCampaignDigests[] =
+    "brave.brave_ads.catalog_campaign_digests";
+
+}  // namespace brave_ads::prefs
+
+#endif  // BRAVE_COMPONENTS_BRAVE_ADS_CORE_PUBLIC_PREFS_CATALOG_PREF_NAMES_H_
@@ -45,7 +45,7 @@ DirectFeedController::FindFeedRequest::~FindFeedRequest() = default;
 DirectFeedController::DirectFeedController(
     PrefService* prefs,
     scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory)
-    : prefs_(prefs), fetcher_(url_loader_factory) {}
+    : prefs_(prefs), fetcher_(prefs, url_loader_factory) {}
 
 DirectFeedController::~DirectFeedController() = default;
 
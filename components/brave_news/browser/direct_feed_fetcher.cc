@@ -16,8 +16,12 @@
 #include "base/task/thread_pool.h"
 #include "brave/components/brave_news/browser/network.h"
 #include "brave/components/brave_news/common/brave_news.mojom.h"
+#include "brave/components/brave_news/common/pref_names.h"
 #include "brave/components/brave_news/rust/lib.rs.h"
+#include "components/prefs/scoped_user_pref_update.h"
+#include "crypto/sha2.h"
 #include "net/base/load_flags.h"
+#include "net/http/http_status_code.h"
 #include "services/network/public/cpp/resource_request.h"
 #include "services/network/public/cpp/simple_url_loader.h"
 #include "services/network/public/mojom/url_response_head.mojom.h"
@@ -37,6 +41,13 @@ std::string GetResponseCharset(network::SimpleURLLoader* loader) {
   return response_info->charset.empty() ? "utf-8" : response_info->charset;
 }
 
+// Get language-specific relative time
+std::string GetRelativeTimeDescription(base::TimeDelta relative_time_delta) {
+  return base::UTF16ToUTF8(ui::TimeFormat::Simple(
+      ui::TimeFormat::Format::FORMAT_ELAPSED,
+      ui::TimeFormat::Length::LENGTH_LONG, relative_time_delta));
+}
+
 mojom::ArticlePtr RustFeedItemToArticle(const FeedItem& rust_feed_item,
                                         const std::string& publisher_id) {
   // We don't include description since there does not exist a
@@ -50,13 +61,10 @@ mojom::ArticlePtr RustFeedItemToArticle(const FeedItem& rust_feed_item,
       GURL(static_cast<std::string>(rust_feed_item.destination_url));
   metadata->publish_time =
       base::Time::FromJsTime(rust_feed_item.published_timestamp * 1000);
-  // Get language-specific relative time
   base::TimeDelta relative_time_delta =
       base::Time::Now() - metadata->publish_time;
   metadata->relative_time_description =
-      base::UTF16ToUTF8(ui::TimeFormat::Simple(
-          ui::TimeFormat::Format::FORMAT_ELAPSED,
-          ui::TimeFormat::Length::LENGTH_LONG, relative_time_delta));
+      GetRelativeTimeDescription(relative_time_delta);
   auto article = mojom::Article::New();
   article->data = std::move(metadata);
   // Calculate score same method as brave news aggregator
@@ -65,42 +73,72 @@ mojom::ArticlePtr RustFeedItemToArticle(const FeedItem& rust_feed_item,
   return article;
 }
 
-using ParseFeedCallback =
-    base::OnceCallback<void(absl::variant<DirectFeedResult, DirectFeedError>)>;
-void ParseFeedDataOffMainThread(const GURL& feed_url,
-                                std::string publisher_id,
-                                std::string body_content,
-                                ParseFeedCallback callback) {
-  // TODO(sko) Maybe we should have a thread traits so that app can be shutdown
-  // while the worker threads are still working.
-  base::ThreadPool::PostTaskAndReplyWithResult(
-      FROM_HERE,
-      base::BindOnce(
-          [](const GURL& feed_url, std::string publisher_id,
-             std::string body_content)
-              -> absl::variant<DirectFeedResult, DirectFeedError> {
-            brave_news::FeedData data;
-            if (!parse_feed_bytes(::rust::Slice<const uint8_t>(
-                                      (const uint8_t*)body_content.data(),
-                                      body_content.size()),
-                                  data)) {
-              VLOG(1) << feed_url.spec() << " not a valid feed.";
-              VLOG(2) << "Response body was:";
-              VLOG(2) << body_content;
-              DirectFeedError error;
-              error.body_content = std::move(body_content);
-              return error;
-            }
+absl::variant<DirectFeedResult, DirectFeedError> ParseFeedData(
+    const GURL& feed_url,
+    std::string publisher_id,
+    std::string body_content) {
+  brave_news::FeedData data;
+  if (!parse_feed_bytes(
+          ::rust::Slice<const uint8_t>((const uint8_t*)body_content.data(),
+                                       body_content.size()),
+          data)) {
+    VLOG(1) << feed_url.spec() << " not a valid feed.";
+    VLOG(2) << "Response body was:";
+    VLOG(2) << body_content;
+    DirectFeedError error;
+    error.body_content = std::move(body_content);
+    return error;
+  }
 
-            DirectFeedResult result;
-            result.id = publisher_id;
-            result.title = (std::string)data.title;
-            ConvertFeedDataToArticles(result.articles, std::move(data),
-                                      result.id);
-            return result;
-          },
-          feed_url, std::move(publisher_id), std::move(body_content)),
-      std::move(callback));
+  DirectFeedResult result;
+  result.id = publisher_id;
+  result.title = (std::string)data.title;
+  ConvertFeedDataToArticles(result.articles, std::move(data), result.id);
+  return result;
+}
+
+// Copies a cached response, with the relative times of its articles brought
+// up to date.
+DirectFeedResponse CloneResponse(const DirectFeedResponse& response) {
+  DirectFeedResponse clone;
+  clone.url = response.url;
+  clone.final_url = response.final_url;
+  clone.mime_type = response.mime_type;
+  clone.charset = response.charset;
+
+  const auto& feed = absl::get<DirectFeedResult>(response.result);
+  DirectFeedResult result;
+  result.id = feed.id;
+  result.title = feed.title;
+  const base::Time now = base::Time::Now();
+  for (const auto& article : feed.articles) {
+    auto article_clone = article.Clone();
+    article_clone->data->relative_time_description =
+        GetRelativeTimeDescription(now - article_clone->data->publish_time);
+    result.articles.push_back(std::move(article_clone));
+  }
+  clone.result = std::move(result);
+  return clone;
+}
+
+std::string GetResponseHeader(network::SimpleURLLoader* loader,
+                              const std::string& name) {
+  std::string value;
+  auto* response_info = loader->ResponseInfo();
+  if (response_info && response_info->headers) {
+    response_info->headers->GetNormalizedHeader(name, &value);
+  }
+  return value;
+}
+
+void SetOrRemove(base::Value::Dict& dict,
+                 const std::string& key,
+                 const std::string& value) {
+  if (value.empty()) {
+    dict.Remove(key);
+  } else {
+    dict.Set(key, value);
+  }
 }
 
 }  // namespace
@@ -143,20 +181,81 @@ DirectFeedResponse::DirectFeedResponse() = default;
 DirectFeedResponse::~DirectFeedResponse() = default;
 DirectFeedResponse::DirectFeedResponse(DirectFeedResponse&&) = default;
 
+DirectFeedFetcher::PendingDownload::PendingDownload(
+    const GURL& url,
+    std::string publisher_id,
+    DownloadFeedCallback callback)
+    : url(url),
+      publisher_id(std::move(publisher_id)),
+      callback(std::move(callback)) {}
+DirectFeedFetcher::PendingDownload::PendingDownload(PendingDownload&&) =
+    default;
+DirectFeedFetcher::PendingDownload&
+DirectFeedFetcher::PendingDownload::operator=(PendingDownload&&) = default;
+DirectFeedFetcher::PendingDownload::~PendingDownload() = default;
+
+DirectFeedFetcher::CachedFeed::CachedFeed() = default;
+DirectFeedFetcher::CachedFeed::CachedFeed(CachedFeed&&) = default;
+DirectFeedFetcher::CachedFeed& DirectFeedFetcher::CachedFeed::operator=(
+    CachedFeed&&) = default;
+DirectFeedFetcher::CachedFeed::~CachedFeed() = default;
+
+struct DirectFeedFetcher::ParsedFeed {
+  // Empty if the body wasn't hashed.
+  std::string body_hash;
+  // Unset if the body is the same as the cached one, so wasn't parsed again.
+  absl::optional<absl::variant<DirectFeedResult, DirectFeedError>> data;
+};
+
 DirectFeedFetcher::DirectFeedFetcher(
+    PrefService* prefs,
     scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory)
-    : url_loader_factory_(url_loader_factory) {}
+    : prefs_(prefs), url_loader_factory_(url_loader_factory) {}
 DirectFeedFetcher::~DirectFeedFetcher() = default;
 
 void DirectFeedFetcher::DownloadFeed(const GURL& url,
                                      std::string publisher_id,
-                                     DownloadFeedCallback callback) {
+                                     DownloadFeedCallback callback,
+                                     Priority priority) {
+  pending_downloads_[static_cast<size_t>(priority)].emplace_back(
+      url, std::move(publisher_id), std::move(callback));
+  StartNextDownloads();
+}
+
+void DirectFeedFetcher::StartNextDownloads() {
+  for (auto& pending_downloads : pending_downloads_) {
+    while (!pending_downloads.empty() &&
+           url_loaders_.size() < kMaxInFlightDownloads) {
+      PendingDownload download = std::move(pending_downloads.front());
+      pending_downloads.pop_front();
+      StartDownload(std::move(download));
+    }
+  }
+}
+
+void DirectFeedFetcher::StartDownload(PendingDownload download) {
   // Make request
   auto request = std::make_unique<network::ResourceRequest>();
-  request->url = url;
+  request->url = download.url;
   request->load_flags = net::LOAD_DO_NOT_SAVE_COOKIES;
   request->credentials_mode = network::mojom::CredentialsMode::kOmit;
   request->method = net::HttpRequestHeaders::kGetMethod;
+  // Only ask for the feed if it changed since we last parsed it.
+  const auto* subscription =
+      download.conditional
+          ? GetSubscription(download.url, download.publisher_id)
+          : nullptr;
+  if (subscription) {
+    if (const auto* etag =
+            subscription->FindString(prefs::kBraveNewsDirectFeedsKeyETag)) {
+      request->headers.SetHeader(net::HttpRequestHeaders::kIfNoneMatch, *etag);
+    }
+    if (const auto* last_modified = subscription->FindString(
+            prefs::kBraveNewsDirectFeedsKeyLastModified)) {
+      request->headers.SetHeader(net::HttpRequestHeaders::kIfModifiedSince,
+                                 *last_modified);
+    }
+  }
   auto url_loader = network::SimpleURLLoader::Create(
       std::move(request), GetNetworkTrafficAnnotationTag());
   url_loader->SetRetryOptions(
@@ -168,16 +267,81 @@ void DirectFeedFetcher::DownloadFeed(const GURL& url,
       url_loader_factory_.get(),
       // Handle response
       base::BindOnce(&DirectFeedFetcher::OnFeedDownloaded,
-                     weak_ptr_factory_.GetWeakPtr(), iter, std::move(callback),
-                     url, std::move(publisher_id)),
+                     weak_ptr_factory_.GetWeakPtr(), iter,
+                     std::move(download.callback), download.url,
+                     std::move(download.publisher_id), download.conditional),
       5 * 1024 * 1024);
 }
 
+DirectFeedFetcher::CachedFeed* DirectFeedFetcher::GetCachedFeed(
+    const GURL& url,
+    const std::string& publisher_id) {
+  if (publisher_id.empty()) {
+    return nullptr;
+  }
+
+  auto it = cached_feeds_.Get(url);
+  if (it == cached_feeds_.end() ||
+      absl::get<DirectFeedResult>(it->second.response.result).id !=
+          publisher_id) {
+    return nullptr;
+  }
+  return &it->second;
+}
+
+const base::Value::Dict* DirectFeedFetcher::GetSubscription(
+    const GURL& url,
+    const std::string& publisher_id) {
+  if (publisher_id.empty()) {
+    return nullptr;
+  }
+
+  const auto* subscription =
+      prefs_->GetDict(prefs::kBraveNewsDirectFeeds).FindDict(publisher_id);
+  if (!subscription) {
+    return nullptr;
+  }
+  const auto* source =
+      subscription->FindString(prefs::kBraveNewsDirectFeedsKeySource);
+  if (!source || GURL(*source) != url) {
+    return nullptr;
+  }
+  return subscription;
+}
+
+void DirectFeedFetcher::SaveValidators(const GURL& url,
+                                       const std::string& publisher_id,
+                                       const std::string& etag,
+                                       const std::string& last_modified) {
+  // The user may have unsubscribed while the feed was downloading.
+  const auto* subscription = GetSubscription(url, publisher_id);
+  if (!subscription) {
+    return;
+  }
+
+  const auto* saved_etag =
+      subscription->FindString(prefs::kBraveNewsDirectFeedsKeyETag);
+  const auto* saved_last_modified =
+      subscription->FindString(prefs::kBraveNewsDirectFeedsKeyLastModified);
+  if ((saved_etag ? *saved_etag : std::string()) == etag &&
+      (saved_last_modified ? *saved_last_modified : std::string()) ==
+          last_modified) {
+    return;
+  }
+
+  ScopedDictPrefUpdate update(prefs_, prefs::kBraveNewsDirectFeeds);
+  auto* entry = update->FindDict(publisher_id);
+  SetOrRemove(*entry, prefs::kBraveNewsDirectFeedsKeyETag, etag);
+  SetOrRemove(*entry, prefs::kBraveNewsDirectFeedsKeyLastModified,
+              last_modified);
+}
+
 void DirectFeedFetcher::OnFeedDownloaded(
     SimpleURLLoaderList::iterator iter,
     DownloadFeedCallback callback,
     const GURL& feed_url,
     std::string publisher_id,
+    bool conditional,
     std::unique_ptr<std::string> response_body) {
   auto* loader = iter->get();
   auto response_code = -1;
@@ -195,8 +359,33 @@ void DirectFeedFetcher::OnFeedDownloaded(
     }
   }
 
+  std::string etag = GetResponseHeader(loader, "ETag");
+  std::string last_modified = GetResponseHeader(loader, "Last-Modified");
+
   url_loaders_.erase(iter);
 
+  auto* cached_feed = GetCachedFeed(feed_url, publisher_id);
+  if (response_code == net::HTTP_NOT_MODIFIED && conditional &&
+      !cached_feed) {
+    // The articles of the last download were evicted, or went away with the
+    // last session, so ask for the whole feed again. This takes the slot of
+    // the download that just finished.
+    VLOG(2) << feed_url.spec() << " not modified, but not cached";
+    PendingDownload download(feed_url, std::move(publisher_id),
+                             std::move(callback));
+    download.conditional = false;
+    StartDownload(std::move(download));
+    return;
+  }
+
+  StartNextDownloads();
+
+  if (response_code == net::HTTP_NOT_MODIFIED && cached_feed) {
+    VLOG(2) << feed_url.spec() << " not modified";
+    std::move(callback).Run(CloneResponse(cached_feed->response));
+    return;
+  }
+
   std::string body_content = response_body ? *response_body : "";
 
   if (response_code < 200 || response_code >= 300 || body_content.empty()) {
@@ -208,18 +397,78 @@ void DirectFeedFetcher::OnFeedDownloaded(
     return;
   }
 
-  ParseFeedDataOffMainThread(
-      feed_url, std::move(publisher_id), std::move(body_content),
+  // Speculative downloads aren't cached, so their body isn't hashed.
+  const bool hash_body = !publisher_id.empty();
+  std::string previous_body_hash =
+      cached_feed ? cached_feed->body_hash : std::string();
+  // TODO(sko) Maybe we should have a thread traits so that app can be shutdown
+  // while the worker threads are still working.
+  base::ThreadPool::PostTaskAndReplyWithResult(
+      FROM_HERE,
+      base::BindOnce(
+          [](const GURL& feed_url, std::string publisher_id,
+             std::string body_content, bool hash_body,
+             std::string previous_body_hash) {
+            ParsedFeed parsed;
+            if (hash_body) {
+              parsed.body_hash = crypto::SHA256HashString(body_content);
+              if (parsed.body_hash == previous_body_hash) {
+                return parsed;
+              }
+            }
+            parsed.data = ParseFeedData(feed_url, std::move(publisher_id),
+                                        std::move(body_content));
+            return parsed;
+          },
+          feed_url, publisher_id, std::move(body_content), hash_body,
+          std::move(previous_body_hash)),
       base::BindOnce(&DirectFeedFetcher::OnParsedFeedData,
                      weak_ptr_factory_.GetWeakPtr(), std::move(callback),
-                     std::move(result)));
+                     std::move(result), std::move(publisher_id),
+                     std::move(etag), std::move(last_modified)));
 }
 
-void DirectFeedFetcher::OnParsedFeedData(
-    DownloadFeedCallback callback,
-    DirectFeedResponse result,
-    absl::variant<DirectFeedResult, DirectFeedError> data) {
-  result.result = std::move(data);
+void DirectFeedFetcher::OnParsedFeedData(DownloadFeedCallback callback,
+                                         DirectFeedResponse result,
+                                         std::string publisher_id,
+                                         std::string etag,
+                                         std::string last_modified,
+                                         ParsedFeed parsed) {
+  if (!parsed.data) {
+    // The server didn't validate the request, but sent the same feed.
+    auto it = cached_feeds_.Get(result.url);
+    if (it != cached_feeds_.end() && it->second.body_hash == parsed.body_hash) {
+      VLOG(2) << result.url.spec() << " unchanged";
+      SaveValidators(result.url, publisher_id, etag, last_modified);
+      std::move(callback).Run(CloneResponse(it->second.response));
+      return;
+    }
+    // The cached feed went away while hashing, so there's nothing to answer
+    // with. This is as rare as concurrent downloads of the feed failing, and
+    // is handled the same way.
+    result.result = DirectFeedError();
+    std::move(callback).Run(std::move(result));
+    return;
+  }
+
+  result.result = std::move(*parsed.data);
+
+  if (!parsed.body_hash.empty()) {
+    if (absl::holds_alternative<DirectFeedResult>(result.result)) {
+      SaveValidators(result.url, publisher_id, etag, last_modified);
+      CachedFeed cached_feed;
+      cached_feed.body_hash = std::move(parsed.body_hash);
+      cached_feed.response = CloneResponse(result);
+      cached_feeds_.Put(result.url, std::move(cached_feed));
+    } else {
+      SaveValidators(result.url, publisher_id, std::string(), std::string());
+      auto it = cached_feeds_.Peek(result.url);
+      if (it != cached_feeds_.end()) {
+        cached_feeds_.Erase(it);
+      }
+    }
+  }
+
   std::move(callback).Run(std::move(result));
 }
 
@@ -6,14 +6,20 @@
 #ifndef BRAVE_COMPONENTS_BRAVE_NEWS_BROWSER_DIRECT_FEED_FETCHER_H_
 #define BRAVE_COMPONENTS_BRAVE_NEWS_BROWSER_DIRECT_FEED_FETCHER_H_
 
+#include <array>
 #include <list>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "base/containers/circular_deque.h"
+#include "base/containers/lru_cache.h"
 #include "base/functional/callback_forward.h"
+#include "base/memory/raw_ptr.h"
 #include "base/memory/weak_ptr.h"
+#include "base/values.h"
 #include "brave/components/brave_news/common/brave_news.mojom-forward.h"
+#include "components/prefs/pref_service.h"
 #include "services/network/public/cpp/shared_url_loader_factory.h"
 #include "services/network/public/cpp/simple_url_loader.h"
 #include "url/gurl.h"
@@ -66,32 +72,101 @@ void ConvertFeedDataToArticles(std::vector<mojom::ArticlePtr>& articles,
 
 class DirectFeedFetcher {
  public:
-  explicit DirectFeedFetcher(
+  // Downloads the user is waiting on, e.g. looking for the feeds of a site,
+  // start ahead of those refreshing the feeds they're subscribed to.
+  enum class Priority {
+    kUserVisible,
+    kBestEffort,
+  };
+
+  static constexpr size_t kMaxInFlightDownloads = 6;
+
+  DirectFeedFetcher(
+      PrefService* prefs,
       scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory);
   DirectFeedFetcher(const DirectFeedFetcher&) = delete;
   DirectFeedFetcher& operator=(const DirectFeedFetcher&) = delete;
   ~DirectFeedFetcher();
 
   // |publisher_id| can be empty, if one we're speculatively downloading a feed.
-  // This |publisher_id| will be used for any returned articles.
+  // This |publisher_id| will be used for any returned articles. Feeds with a
+  // |publisher_id| are only downloaded and parsed again once they changed, as
+  // told by the validators stored with the subscription.
   void DownloadFeed(const GURL& url,
                     std::string publisher_id,
-                    DownloadFeedCallback callback);
+                    DownloadFeedCallback callback,
+                    Priority priority = Priority::kUserVisible);
+
+  size_t in_flight_downloads_for_testing() const {
+    return url_loaders_.size();
+  }
 
  private:
+  struct PendingDownload {
+    PendingDownload(const GURL& url,
+                    std::string publisher_id,
+                    DownloadFeedCallback callback);
+    PendingDownload(PendingDownload&&);
+    PendingDownload& operator=(PendingDownload&&);
+    ~PendingDownload();
+
+    GURL url;
+    std::string publisher_id;
+    DownloadFeedCallback callback;
+    // Whether to send the validators of the last download.
+    bool conditional = true;
+  };
+
+  // The last download of a subscribed feed. Its validators are persisted with
+  // the subscription instead, so they outlive this cache.
+  struct CachedFeed {
+    CachedFeed();
+    CachedFeed(CachedFeed&&);
+    CachedFeed& operator=(CachedFeed&&);
+    ~CachedFeed();
+
+    std::string body_hash;
+    DirectFeedResponse response;
+  };
+
+  struct ParsedFeed;
+
+  static constexpr size_t kMaxCachedFeeds = 100;
+
   using SimpleURLLoaderList =
       std::list<std::unique_ptr<network::SimpleURLLoader>>;
+  void StartNextDownloads();
+  void StartDownload(PendingDownload download);
+  // Returns the cached download of |url| if it was for |publisher_id|.
+  CachedFeed* GetCachedFeed(const GURL& url, const std::string& publisher_id);
+  // Returns the pref entry of |publisher_id|, if it's subscribed to |url|.
+  const base::Value::Dict* GetSubscription(const GURL& url,
+                                           const std::string& publisher_id);
+  // Stores the validators of the last download of |url| with its
+  // subscription. Empty validators are removed.
+  void SaveValidators(const GURL& url,
+                      const std::string& publisher_id,
+                      const std::string& etag,
+                      const std::string& last_modified);
   void OnFeedDownloaded(SimpleURLLoaderList::iterator iter,
                         DownloadFeedCallback callback,
                         const GURL& feed_url,
                         std::string publisher_id,
+                        bool conditional,
                         const std::unique_ptr<std::string> response_body);
   void OnParsedFeedData(DownloadFeedCallback callback,
                         DirectFeedResponse result,
-                        absl::variant<DirectFeedResult, DirectFeedError> data);
+                        std::string publisher_id,
+                        std::string etag,
+                        std::string last_modified,
+                        ParsedFeed parsed);
 
   SimpleURLLoaderList url_loaders_;
+  // Downloads waiting for one in flight to finish, by |Priority|.
+  std::array<base::circular_deque<PendingDownload>, 2> pending_downloads_;
+  base::LRUCache<GURL, CachedFeed> cached_feeds_{kMaxCachedFeeds};
 
+  raw_ptr<PrefService> prefs_;
   scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory_;
   base::WeakPtrFactory<DirectFeedFetcher> weak_ptr_factory_{this};
 };
@@ -5,12 +5,30 @@
 
 #include "brave/components/brave_news/browser/direct_feed_fetcher.h"
 
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "base/functional/bind.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/synchronization/lock.h"
+#include "base/test/bind.h"
+#include "base/test/task_environment.h"
+#include "base/test/test_future.h"
+#include "base/thread_annotations.h"
+#include "brave/components/brave_news/browser/brave_news_controller.h"
 #include "brave/components/brave_news/common/brave_news.mojom.h"
+#include "brave/components/brave_news/common/pref_names.h"
 #include "brave/components/brave_news/rust/lib.rs.h"
+#include "components/prefs/scoped_user_pref_update.h"
+#include "components/prefs/testing_pref_service.h"
+#include "net/http/http_request_headers.h"
+#include "net/http/http_status_code.h"
+#include "net/test/embedded_test_server/embedded_test_server.h"
+#include "net/test/embedded_test_server/http_request.h"
+#include "net/test/embedded_test_server/http_response.h"
+#include "services/network/test/test_shared_url_loader_factory.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace brave_news {
@@ -309,4 +327,224 @@ TEST(BraveNewsDirectFeed, ParseOnlyAllowsHTTPLinks) {
   EXPECT_EQ(articles.size(), 0u);
 }
 
+namespace {
+
+constexpr char kFeedETag[] = "\"feed-1\"";
+constexpr size_t kDownloadCount = 20;
+
+}  // namespace
+
+// Serves a feed on /feed, counting the bytes it sends. The user is
+// subscribed to it as "Id1".
+class BraveNewsDirectFeedFetcherTest : public testing::Test {
+ public:
+  BraveNewsDirectFeedFetcherTest()
+      : url_loader_factory_(
+            base::MakeRefCounted<network::TestSharedURLLoaderFactory>()),
+        fetcher_(&prefs_, url_loader_factory_) {
+    BraveNewsController::RegisterProfilePrefs(prefs_.registry());
+  }
+
+  void SetUp() override {
+    feed_ = GetFeedJson();
+    test_server_.RegisterRequestHandler(
+        base::BindRepeating(&BraveNewsDirectFeedFetcherTest::HandleRequest,
+                            base::Unretained(this)));
+    ASSERT_TRUE(test_server_.Start());
+
+    ScopedDictPrefUpdate update(&prefs_, prefs::kBraveNewsDirectFeeds);
+    base::Value::Dict subscription;
+    subscription.Set(prefs::kBraveNewsDirectFeedsKeySource,
+                     test_server_.GetURL("/feed").spec());
+    subscription.Set(prefs::kBraveNewsDirectFeedsKeyTitle, "Feed");
+    update->Set("Id1", std::move(subscription));
+  }
+
+  DirectFeedResponse Download(const std::string& publisher_id) {
+    return Download(fetcher_, publisher_id);
+  }
+
+  DirectFeedResponse Download(DirectFeedFetcher& fetcher,
+                              const std::string& publisher_id) {
+    base::test::TestFuture<DirectFeedResponse> future;
+    fetcher.DownloadFeed(test_server_.GetURL("/feed"), publisher_id,
+                         future.GetCallback());
+    return future.Take();
+  }
+
+  const base::Value::Dict& GetSubscription() {
+    return *prefs_.GetDict(prefs::kBraveNewsDirectFeeds).FindDict("Id1");
+  }
+
+  void SetFeed(std::string feed, bool send_validators) {
+    base::AutoLock lock(lock_);
+    feed_ = std::move(feed);
+    send_validators_ = send_validators;
+  }
+
+  size_t bytes_sent() {
+    base::AutoLock lock(lock_);
+    return bytes_sent_;
+  }
+
+  size_t not_modified_count() {
+    base::AutoLock lock(lock_);
+    return not_modified_count_;
+  }
+
+ protected:
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::MainThreadType::IO};
+  TestingPrefServiceSimple prefs_;
+  net::EmbeddedTestServer test_server_;
+  scoped_refptr<network::TestSharedURLLoaderFactory> url_loader_factory_;
+  DirectFeedFetcher fetcher_;
+
+ private:
+  std::unique_ptr<net::test_server::HttpResponse> HandleRequest(
+      const net::test_server::HttpRequest& request) {
+    if (request.relative_url != "/feed") {
+      return nullptr;
+    }
+
+    base::AutoLock lock(lock_);
+    auto response = std::make_unique<net::test_server::BasicHttpResponse>();
+    if (send_validators_) {
+      response->AddCustomHeader("ETag", kFeedETag);
+      auto it = request.headers.find(net::HttpRequestHeaders::kIfNoneMatch);
+      if (it != request.headers.end() && it->second == kFeedETag) {
+        ++not_modified_count_;
+        response->set_code(net::HTTP_NOT_MODIFIED);
+        return response;
+      }
+    }
+    response->set_code(net::HTTP_OK);
+    response->set_content_type("application/rss+xml");
+    response->set_content(feed_);
+    bytes_sent_ += feed_.size();
+    return response;
+  }
+
+  base::Lock lock_;
+  std::string feed_ GUARDED_BY(lock_);
+  bool send_validators_ GUARDED_BY(lock_) = true;
+  size_t bytes_sent_ GUARDED_BY(lock_) = 0;
+  size_t not_modified_count_ GUARDED_BY(lock_) = 0;
+};
+
+TEST_F(BraveNewsDirectFeedFetcherTest, SkipsFeedNotModified) {
+  auto first = Download("Id1");
+  auto second = Download("Id1");
+
+  // The second download was answered with a 304, so only one feed was sent.
+  EXPECT_EQ(1u, not_modified_count());
+  EXPECT_EQ(GetFeedJson().size(), bytes_sent());
+
+  auto& first_feed = absl::get<DirectFeedResult>(first.result);
+  auto& second_feed = absl::get<DirectFeedResult>(second.result);
+  EXPECT_EQ("Id1", second_feed.id);
+  EXPECT_EQ(first_feed.title, second_feed.title);
+  ASSERT_EQ(3u, second_feed.articles.size());
+  for (size_t i = 0; i < first_feed.articles.size(); ++i) {
+    EXPECT_EQ(first_feed.articles[i]->data->url,
+              second_feed.articles[i]->data->url);
+    EXPECT_EQ("Id1", second_feed.articles[i]->data->publisher_id);
+  }
+}
+
+TEST_F(BraveNewsDirectFeedFetcherTest, PersistsValidators) {
+  Download("Id1");
+  EXPECT_EQ(kFeedETag,
+            *GetSubscription().FindString(prefs::kBraveNewsDirectFeedsKeyETag));
+
+  // A feed which stops sending validators is downloaded unconditionally.
+  SetFeed(GetFeedJson(), /*send_validators=*/false);
+  Download("Id1");
+  EXPECT_FALSE(
+      GetSubscription().FindString(prefs::kBraveNewsDirectFeedsKeyETag));
+  Download("Id1");
+  EXPECT_EQ(0u, not_modified_count());
+  EXPECT_EQ(3 * GetFeedJson().size(), bytes_sent());
+}
+
+TEST_F(BraveNewsDirectFeedFetcherTest, RetriesNotModifiedFeedWithoutArticles) {
+  Download("Id1");
+
+  // A new fetcher, as after a restart, has the validators but not the
+  // articles, so it asks for the whole feed once the server answers with a
+  // 304.
+  DirectFeedFetcher fetcher(&prefs_, url_loader_factory_);
+  auto response = Download(fetcher, "Id1");
+  EXPECT_EQ(1u, not_modified_count());
+  EXPECT_EQ(2 * GetFeedJson().size(), bytes_sent());
+  EXPECT_EQ(3u, absl::get<DirectFeedResult>(response.result).articles.size());
+
+  // From then on, it answers 304s itself.
+  Download(fetcher, "Id1");
+  EXPECT_EQ(2u, not_modified_count());
+  EXPECT_EQ(2 * GetFeedJson().size(), bytes_sent());
+}
+
+TEST_F(BraveNewsDirectFeedFetcherTest, ReusesIdenticalFeed) {
+  SetFeed(GetFeedJson(), /*send_validators=*/false);
+
+  Download("Id1");
+  auto second = Download("Id1");
+
+  // Without validators the feed is sent again, and answered from the cache.
+  EXPECT_EQ(0u, not_modified_count());
+  EXPECT_EQ(2 * GetFeedJson().size(), bytes_sent());
+  EXPECT_EQ(3u, absl::get<DirectFeedResult>(second.result).articles.size());
+}
+
+TEST_F(BraveNewsDirectFeedFetcherTest, ParsesChangedFeed) {
+  SetFeed(GetFeedJson(), /*send_validators=*/false);
+  Download("Id1");
+
+  SetFeed(PartialDirective(), /*send_validators=*/false);
+  auto second = Download("Id1");
+
+  EXPECT_EQ(1u, absl::get<DirectFeedResult>(second.result).articles.size());
+}
+
+TEST_F(BraveNewsDirectFeedFetcherTest, ParsesSpeculativeDownloads) {
+  Download("");
+  Download("");
+
+  // Feeds which aren't subscribed to aren't cached.
+  EXPECT_EQ(0u, not_modified_count());
+  EXPECT_FALSE(
+      GetSubscription().FindString(prefs::kBraveNewsDirectFeedsKeyETag));
+
+  // Nor does a subscribed feed reuse them.
+  auto response = Download("Id1");
+  EXPECT_EQ(0u, not_modified_count());
+  EXPECT_EQ(3 * GetFeedJson().size(), bytes_sent());
+  EXPECT_EQ(3u, absl::get<DirectFeedResult>(response.result).articles.size());
+}
+
+TEST_F(BraveNewsDirectFeedFetcherTest, LimitsInFlightDownloads) {
+  base::test::TestFuture<void> all_done;
+  size_t done_count = 0;
+  for (size_t i = 0; i < kDownloadCount; ++i) {
+    fetcher_.DownloadFeed(
+        test_server_.GetURL("/feed"), "Id" + base::NumberToString(i),
+        base::BindLambdaForTesting([&](DirectFeedResponse response) {
+          EXPECT_TRUE(absl::holds_alternative<DirectFeedResult>(
+              response.result));
+          EXPECT_LE(fetcher_.in_flight_downloads_for_testing(),
+                    DirectFeedFetcher::kMaxInFlightDownloads);
+          if (++done_count == kDownloadCount) {
+            all_done.SetValue();
+          }
+        }),
+        DirectFeedFetcher::Priority::kBestEffort);
+    EXPECT_LE(fetcher_.in_flight_downloads_for_testing(),
+              DirectFeedFetcher::kMaxInFlightDownloads);
+  }
+
+  EXPECT_TRUE(all_done.Wait());
+  EXPECT_EQ(0u, fetcher_.in_flight_downloads_for_testing());
+}
+
 }  // namespace brave_news
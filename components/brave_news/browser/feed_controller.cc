@@ -53,6 +53,7 @@ FeedController::FeedController(
       history_service_(history_service),
       feed_fetcher_(*publishers_controller,
                     *channels_controller,
+                    *prefs,
                     url_loader_factory),
       on_current_update_complete_(new base::OneShotEvent()) {
   publishers_observation_.Observe(publishers_controller);
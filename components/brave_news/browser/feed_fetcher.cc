@@ -58,11 +58,12 @@ FeedFetcher::FeedSourceResult::FeedSourceResult(
 FeedFetcher::FeedFetcher(
     PublishersController& publishers_controller,
     ChannelsController& channels_controller,
+    PrefService& prefs,
     scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory)
     : publishers_controller_(publishers_controller),
       channels_controller_(channels_controller),
       api_request_helper_(GetNetworkTrafficAnnotationTag(), url_loader_factory),
-      direct_feed_fetcher_(url_loader_factory) {}
+      direct_feed_fetcher_(&prefs, url_loader_factory) {}
 
 FeedFetcher::~FeedFetcher() = default;
 
@@ -127,7 +128,8 @@ void FeedFetcher::OnFetchFeedFetchedPublishers(FetchFeedCallback callback,
               }
               cb.Run(std::move(result));
             },
-            downloaded_callback, direct_publisher->publisher_id));
+            downloaded_callback, direct_publisher->publisher_id),
+        DirectFeedFetcher::Priority::kBestEffort);
   }
 }
 
@@ -18,6 +18,7 @@
 #include "brave/components/brave_news/browser/direct_feed_fetcher.h"
 #include "brave/components/brave_news/browser/publishers_controller.h"
 #include "brave/components/brave_news/common/brave_news.mojom.h"
+#include "components/prefs/pref_service.h"
 
 namespace brave_news {
 
@@ -31,6 +32,7 @@ class FeedFetcher {
   FeedFetcher(
       PublishersController& publishers_controller,
       ChannelsController& channels_controller,
+      PrefService& prefs,
       scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory);
   ~FeedFetcher();
   FeedFetcher(const FeedFetcher&) = delete;
@@ -373,7 +373,10 @@ FeedV2Builder::FeedV2Builder(
       channels_controller_(channels_controller),
       suggestions_controller_(suggestions_controller),
       prefs_(prefs),
-      fetcher_(publishers_controller, channels_controller, url_loader_factory),
+      fetcher_(publishers_controller,
+               channels_controller,
+               prefs,
+               url_loader_factory),
       signal_calculator_(publishers_controller,
                          channels_controller,
                          prefs,
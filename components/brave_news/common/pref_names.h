@@ -42,6 +42,8 @@ constexpr char kBraveNewsWasEverEnabled[] = "brave.today.p3a_was_ever_enabled";
 // Dictionary value keys
 constexpr char kBraveNewsDirectFeedsKeyTitle[] = "title";
 constexpr char kBraveNewsDirectFeedsKeySource[] = "source";
+constexpr char kBraveNewsDirectFeedsKeyETag[] = "etag";
+constexpr char kBraveNewsDirectFeedsKeyLastModified[] = "last_modified";
 
 }  // namespace prefs
 
@@ -8,8 +8,10 @@
 #include <memory>
 #include <utility>
 
+#include "base/files/file.h"
 #include "base/files/file_util.h"
 #include "base/i18n/time_formatting.h"
+#include "base/strings/string_piece.h"
 #include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/task/thread_pool.h"
@@ -19,6 +21,11 @@ namespace {
 const int64_t kChunkSize = 1024;
 const size_t kDividerLength = 80;
 
+// Buffered entries are written once they reach this size, or after this delay
+// since the first of them was buffered.
+const size_t kFlushThreshold = 64 * 1024;
+constexpr base::TimeDelta kFlushDelay = base::Seconds(1);
+
 std::string FormatTime(const base::Time& time) {
   return base::UTF16ToUTF8(
       base::TimeFormatWithPattern(time, "MMM dd, YYYY h::mm::ss.S a"));
@@ -47,41 +54,22 @@ std::string GetLogVerboseLevelName(int verbose_level) {
   return verbose_level_name;
 }
 
-bool Create(const base::FilePath& file_path, base::File* file) {
-  DCHECK(file);
-
-  file->Initialize(file_path, base::File::FLAG_CREATE_ALWAYS |
-                                  base::File::FLAG_READ |
-                                  base::File::FLAG_WRITE);
-
-  return file->IsValid();
-}
-
 bool Open(const base::FilePath& file_path, base::File* file) {
   DCHECK(file);
 
-  file->Initialize(file_path, base::File::FLAG_OPEN | base::File::FLAG_READ |
-                                  base::File::FLAG_WRITE);
+  file->Initialize(file_path, base::File::FLAG_OPEN | base::File::FLAG_READ);
 
   return file->IsValid();
 }
 
-bool CreateOrOpen(const base::FilePath& file_path, base::File* file) {
+// Returns the offset of the last |num_lines| lines of |file|, and the number
+// of lines found in |line_count|. The offset is 0 if the file holds fewer
+// lines.
+int64_t SeekFromEnd(base::File* file, int num_lines, int* line_count) {
   DCHECK(file);
+  DCHECK(line_count);
 
-  if (!base::PathExists(file_path)) {
-    return Create(file_path, file);
-  }
-
-  if (!Open(file_path, file)) {
-    return false;
-  }
-
-  return file->IsValid();
-}
-
-int64_t SeekFromEnd(base::File* file, int num_lines) {
-  DCHECK(file);
+  *line_count = 0;
 
   if (!file->IsValid()) {
     return 0;
@@ -100,8 +88,6 @@ int64_t SeekFromEnd(base::File* file, int num_lines) {
     return 0;
   }
 
-  int line_count = 0;
-
   char chunk[kChunkSize];
   int64_t chunk_size = kChunkSize;
   int64_t last_chunk_size = 0;
@@ -126,10 +112,10 @@ int64_t SeekFromEnd(base::File* file, int num_lines) {
 
     for (int i = chunk_size - 1; i >= 0; i--) {
       if (chunk[i] == '\n') {
-        line_count++;
-        if (line_count == num_lines + 1) {
+        if (*line_count == num_lines) {
           return length;
         }
+        (*line_count)++;
       }
 
       length--;
@@ -141,78 +127,15 @@ int64_t SeekFromEnd(base::File* file, int num_lines) {
   return length;
 }
 
-bool TrimBeginningOfFile(base::File* file, int keep_num_lines) {
-  DCHECK(file);
+// Reads the last |num_lines| lines of |file_path|, or all of it if
+// |num_lines| is -1. |line_count| is set to the number of lines read.
+std::string ReadLastNLinesOfFile(const base::FilePath& file_path,
+                                 int num_lines,
+                                 int* line_count) {
+  DCHECK(line_count);
 
-  if (file->GetLength() == 0) {
-    return true;
-  }
-
-  const int64_t offset = SeekFromEnd(file, keep_num_lines);
-  if (offset == -1) {
-    return false;
-  }
-
-  if (offset == 0) {
-    return true;
-  }
-
-  if (file->Seek(base::File::FROM_BEGIN, offset) == -1) {
-    return false;
-  }
+  *line_count = 0;
 
-  const int64_t size = file->GetLength() - offset;
-  std::unique_ptr<char[]> buffer = std::make_unique<char[]>(size + 1);
-
-  if (file->ReadAtCurrentPos(buffer.get(), size) == -1) {
-    return false;
-  }
-
-  if (file->Seek(base::File::FROM_BEGIN, 0) == -1) {
-    return false;
-  }
-
-  const std::string data = std::string(buffer.get());
-  const int64_t new_size = data.size();
-
-  if (file->WriteAtCurrentPos(data.c_str(), new_size) == -1) {
-    return false;
-  }
-
-  if (!file->SetLength(new_size)) {
-    return false;
-  }
-
-  return true;
-}
-
-bool MaybeTrimBeginningOfFile(base::File* file,
-                              int64_t max_file_size,
-                              int keep_num_lines,
-                              bool first_write) {
-  DCHECK(file);
-
-  const int64_t length = file->GetLength();
-  if (length == -1) {
-    return false;
-  }
-
-  // We do not trim the log on first run so that if the browser
-  // crashes and we investigate the log with the user they are able to
-  // re-run the browser without losing past logs.
-  if (!first_write && length <= max_file_size) {
-    return true;
-  }
-
-  if (!TrimBeginningOfFile(file, keep_num_lines)) {
-    return false;
-  }
-
-  return true;
-}
-
-std::string ReadLastNLinesOnFileTaskRunner(const base::FilePath& file_path,
-                                           int num_lines) {
   base::File file;
   if (!Open(file_path, &file)) {
     return "";
@@ -222,15 +145,9 @@ std::string ReadLastNLinesOnFileTaskRunner(const base::FilePath& file_path,
     return "";
   }
 
-  int64_t offset;
-
-  if (num_lines == -1) {
-    offset = 0;
-  } else {
-    offset = SeekFromEnd(&file, num_lines);
-    if (offset == -1) {
-      return "";
-    }
+  int64_t offset = SeekFromEnd(&file, num_lines, line_count);
+  if (offset == -1) {
+    return "";
   }
 
   if (file.Seek(base::File::FROM_BEGIN, offset) == -1) {
@@ -247,75 +164,178 @@ std::string ReadLastNLinesOnFileTaskRunner(const base::FilePath& file_path,
   return std::string(buffer.get());
 }
 
-bool WriteOnFileTaskRunner(const base::FilePath& file_path,
-                           const std::string& log_entry,
-                           int64_t max_file_size,
-                           int keep_num_lines,
-                           bool first_write) {
-  base::File file;
-  if (!CreateOrOpen(file_path, &file)) {
-    return false;
-  }
+}  // namespace
+
+namespace brave_rewards {
+
+// Owns the log files on the file task runner. The current segment is kept
+// open between writes.
+class DiagnosticLog::LogFile {
+ public:
+  LogFile(const base::FilePath& file_path, int64_t max_segment_size)
+      : file_path_(file_path),
+        previous_file_path_(file_path.AddExtensionASCII("1")),
+        max_segment_size_(max_segment_size) {}
+  LogFile(const LogFile&) = delete;
+  LogFile& operator=(const LogFile&) = delete;
+  ~LogFile() = default;
+
+  bool Write(const std::string& entries) {
+    if (!file_.IsValid() && !OpenSegment()) {
+      return false;
+    }
+
+    base::StringPiece data(entries);
+    while (!data.empty()) {
+      // Fill the current segment with as many whole lines as fit.
+      const int64_t space = max_segment_size_ - segment_size_;
+      size_t size = 0;
+      if (static_cast<int64_t>(data.size()) <= space) {
+        size = data.size();
+      } else if (space > 0) {
+        const size_t end = data.rfind('\n', space - 1);
+        if (end != base::StringPiece::npos) {
+          size = end + 1;
+        }
+      }
 
-  if (file.Seek(base::File::FROM_END, 0) == -1) {
-    return false;
+      if (size == 0) {
+        if (segment_size_ > 0) {
+          if (!Rotate()) {
+            return false;
+          }
+          continue;
+        }
+
+        // A line longer than a segment gets a segment of its own.
+        const size_t end = data.find('\n');
+        size = end == base::StringPiece::npos ? data.size() : end + 1;
+      }
+
+      if (file_.WriteAtCurrentPos(data.data(), size) == -1) {
+        file_.Close();
+        return false;
+      }
+
+      segment_size_ += size;
+      data.remove_prefix(size);
+    }
+
+    return true;
   }
 
-  if (first_write) {
-    const std::string divider = std::string(kDividerLength, '-') + "\n";
-    file.WriteAtCurrentPos(divider.c_str(), divider.length());
+  std::string ReadLastNLines(int num_lines) {
+    int line_count = 0;
+    std::string data =
+        ReadLastNLinesOfFile(file_path_, num_lines, &line_count);
+    if (num_lines != -1 && line_count >= num_lines) {
+      return data;
+    }
+
+    const int previous_num_lines =
+        num_lines == -1 ? -1 : num_lines - line_count;
+    return ReadLastNLinesOfFile(previous_file_path_, previous_num_lines,
+                                &line_count) +
+           data;
   }
 
-  if (file.WriteAtCurrentPos(log_entry.c_str(), log_entry.length()) == -1) {
-    return false;
+  bool Delete() {
+    file_.Close();
+    segment_size_ = 0;
+    const bool deleted = base::DeleteFile(file_path_);
+    return base::DeleteFile(previous_file_path_) && deleted;
   }
 
-  return MaybeTrimBeginningOfFile(&file, max_file_size, keep_num_lines,
-                                  first_write);
-}
+ private:
+  bool OpenSegment() {
+    file_.Initialize(file_path_, base::File::FLAG_OPEN_ALWAYS |
+                                     base::File::FLAG_READ |
+                                     base::File::FLAG_APPEND);
+    if (!file_.IsValid()) {
+      return false;
+    }
 
-bool DeleteOnFileTaskRunner(const base::FilePath& file_path) {
-  return base::DeleteFile(file_path);
-}
+    segment_size_ = file_.GetLength();
+    if (segment_size_ == -1) {
+      file_.Close();
+      return false;
+    }
 
-}  // namespace
+    // A crash can leave a partially written last line behind, which the
+    // next entry must not be appended to.
+    char last_char = '\n';
+    if (segment_size_ > 0 &&
+        file_.Read(segment_size_ - 1, &last_char, 1) == 1 &&
+        last_char != '\n') {
+      if (file_.WriteAtCurrentPos("\n", 1) == -1) {
+        file_.Close();
+        return false;
+      }
+      segment_size_++;
+    }
 
-namespace brave_rewards {
+    return true;
+  }
+
+  bool Rotate() {
+    file_.Close();
+    if (!base::ReplaceFile(file_path_, previous_file_path_, nullptr)) {
+      return false;
+    }
+
+    return OpenSegment();
+  }
+
+  const base::FilePath file_path_;
+  const base::FilePath previous_file_path_;
+  const int64_t max_segment_size_;
+  base::File file_;
+  int64_t segment_size_ = 0;
+};
 
 DiagnosticLog::DiagnosticLog(const base::FilePath& file_path,
-                             int64_t max_file_size,
-                             int keep_num_lines)
-    : file_task_runner_(base::ThreadPool::CreateSequencedTaskRunner(
-          {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
-           base::TaskShutdownBehavior::BLOCK_SHUTDOWN})),
-      file_path_(file_path),
-      max_file_size_(max_file_size),
-      keep_num_lines_(keep_num_lines),
+                             int64_t max_file_size)
+    : log_file_(base::ThreadPool::CreateSequencedTaskRunner(
+                    {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+                     base::TaskShutdownBehavior::BLOCK_SHUTDOWN}),
+                file_path,
+                max_file_size / 2),
       first_write_(true) {}
 
 DiagnosticLog::~DiagnosticLog() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  Flush();
 }
 
 void DiagnosticLog::ReadLastNLines(int num_lines, ReadCallback callback) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  file_task_runner_->PostTaskAndReplyWithResult(
-      FROM_HERE,
-      base::BindOnce(&ReadLastNLinesOnFileTaskRunner, file_path_, num_lines),
-      base::BindOnce(&DiagnosticLog::OnReadLastNLines, AsWeakPtr(),
-                     std::move(callback)));
+  Flush();
+  log_file_.AsyncCall(&LogFile::ReadLastNLines)
+      .WithArgs(num_lines)
+      .Then(base::BindOnce(&DiagnosticLog::OnReadLastNLines, AsWeakPtr(),
+                           std::move(callback)));
 }
 
 void DiagnosticLog::Write(const std::string& log_entry,
                           StatusCallback callback) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  file_task_runner_->PostTaskAndReplyWithResult(
-      FROM_HERE,
-      base::BindOnce(&WriteOnFileTaskRunner, file_path_, log_entry,
-                     max_file_size_, keep_num_lines_, first_write_),
-      base::BindOnce(&DiagnosticLog::OnWrite, AsWeakPtr(),
-                     std::move(callback)));
-  first_write_ = false;
+  if (first_write_) {
+    buffer_ += std::string(kDividerLength, '-') + "\n";
+    first_write_ = false;
+  }
+
+  buffer_ += log_entry;
+  buffered_callbacks_.push_back(std::move(callback));
+
+  if (buffer_.size() >= kFlushThreshold) {
+    Flush();
+    return;
+  }
+
+  if (!flush_timer_.IsRunning()) {
+    flush_timer_.Start(FROM_HERE, kFlushDelay,
+                       base::BindOnce(&DiagnosticLog::Flush, AsWeakPtr()));
+  }
 }
 
 void DiagnosticLog::Write(const std::string& log_entry,
@@ -341,10 +361,25 @@ void DiagnosticLog::Write(const std::string& log_entry,
 
 void DiagnosticLog::Delete(StatusCallback callback) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  file_task_runner_->PostTaskAndReplyWithResult(
-      FROM_HERE, base::BindOnce(&DeleteOnFileTaskRunner, file_path_),
-      base::BindOnce(&DiagnosticLog::OnDelete, AsWeakPtr(),
-                     std::move(callback)));
+  Flush();
+  log_file_.AsyncCall(&LogFile::Delete)
+      .Then(base::BindOnce(&DiagnosticLog::OnDelete, AsWeakPtr(),
+                           std::move(callback)));
+}
+
+void DiagnosticLog::Flush() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  flush_timer_.Stop();
+  if (buffer_.empty()) {
+    return;
+  }
+
+  log_file_.AsyncCall(&LogFile::Write)
+      .WithArgs(std::move(buffer_))
+      .Then(base::BindOnce(&DiagnosticLog::OnWrite, AsWeakPtr(),
+                           std::move(buffered_callbacks_)));
+  buffer_.clear();
+  buffered_callbacks_.clear();
 }
 
 void DiagnosticLog::OnReadLastNLines(ReadCallback callback,
@@ -353,9 +388,12 @@ void DiagnosticLog::OnReadLastNLines(ReadCallback callback,
   std::move(callback).Run(data);
 }
 
-void DiagnosticLog::OnWrite(StatusCallback callback, bool result) {
+void DiagnosticLog::OnWrite(std::vector<StatusCallback> callbacks,
+                            bool result) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  std::move(callback).Run(result);
+  for (auto& callback : callbacks) {
+    std::move(callback).Run(result);
+  }
 }
 
 void DiagnosticLog::OnDelete(StatusCallback callback, bool result) {
@@ -0,0 +1,188 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_rewards/browser/diagnostic_log.h"
+
+#include <memory>
+#include <string>
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/functional/callback_helpers.h"
+#include "base/run_loop.h"
+#include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/bind.h"
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter="*DiagnosticLogTest*"
+
+namespace brave_rewards {
+
+namespace {
+
+constexpr int64_t kMaxFileSize = 1000;
+
+std::string Divider() {
+  return std::string(80, '-') + "\n";
+}
+
+// 50 bytes, so that 10 lines fill a segment.
+std::string Line(int index) {
+  return base::StringPrintf("%049d\n", index);
+}
+
+std::string Lines(int from, int to) {
+  std::string lines;
+  for (int i = from; i < to; i++) {
+    lines += Line(i);
+  }
+  return lines;
+}
+
+}  // namespace
+
+class DiagnosticLogTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    log_path_ = temp_dir_.GetPath().AppendASCII("Rewards.log");
+  }
+
+  std::unique_ptr<DiagnosticLog> CreateLog(int64_t max_file_size) {
+    return std::make_unique<DiagnosticLog>(log_path_, max_file_size);
+  }
+
+  std::string ReadLastNLines(DiagnosticLog* log, int num_lines) {
+    std::string result;
+    base::RunLoop run_loop;
+    log->ReadLastNLines(
+        num_lines, base::BindLambdaForTesting([&](const std::string& data) {
+          result = data;
+          run_loop.Quit();
+        }));
+    run_loop.Run();
+    return result;
+  }
+
+  int64_t GetFileSize(const base::FilePath& path) {
+    int64_t size = -1;
+    base::GetFileSize(path, &size);
+    return size;
+  }
+
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+  base::ScopedTempDir temp_dir_;
+  base::FilePath log_path_;
+};
+
+TEST_F(DiagnosticLogTest, ReadLastNLines) {
+  auto log = CreateLog(kMaxFileSize);
+  for (int i = 0; i < 3; i++) {
+    log->Write(Line(i), base::DoNothing());
+  }
+
+  EXPECT_EQ(Divider() + Lines(0, 3), ReadLastNLines(log.get(), -1));
+  EXPECT_EQ(Lines(1, 3), ReadLastNLines(log.get(), 2));
+}
+
+TEST_F(DiagnosticLogTest, BuffersWritesUntilFlush) {
+  auto log = CreateLog(kMaxFileSize);
+  bool written = false;
+  log->Write(Line(0), base::BindLambdaForTesting([&written](bool result) {
+               EXPECT_TRUE(result);
+               written = true;
+             }));
+
+  task_environment_.RunUntilIdle();
+  EXPECT_FALSE(written);
+  EXPECT_FALSE(base::PathExists(log_path_));
+
+  task_environment_.FastForwardBy(base::Seconds(1));
+  EXPECT_TRUE(written);
+  std::string data;
+  ASSERT_TRUE(base::ReadFileToString(log_path_, &data));
+  EXPECT_EQ(Divider() + Line(0), data);
+}
+
+TEST_F(DiagnosticLogTest, FlushesWhenBufferIsFull) {
+  auto log = CreateLog(10 * 1024 * 1024);
+  for (int i = 0; i < 2000; i++) {
+    log->Write(Line(i), base::DoNothing());
+  }
+
+  // Without the clock advancing, only full buffers are written.
+  task_environment_.RunUntilIdle();
+  EXPECT_GE(GetFileSize(log_path_), 64 * 1024);
+  EXPECT_LT(GetFileSize(log_path_), 100 * 1024);
+}
+
+TEST_F(DiagnosticLogTest, RotatesSegments) {
+  auto log = CreateLog(kMaxFileSize);
+  for (int i = 0; i < 100; i++) {
+    log->Write(Line(i), base::DoNothing());
+  }
+
+  EXPECT_EQ(Lines(90, 100), ReadLastNLines(log.get(), 10));
+
+  const std::string data = ReadLastNLines(log.get(), -1);
+  EXPECT_LE(static_cast<int64_t>(data.size()), kMaxFileSize);
+  EXPECT_TRUE(base::EndsWith(data, Lines(90, 100)));
+
+  const base::FilePath previous_log_path = log_path_.AddExtensionASCII("1");
+  EXPECT_LE(GetFileSize(log_path_), kMaxFileSize / 2);
+  EXPECT_LE(GetFileSize(previous_log_path), kMaxFileSize / 2);
+
+  base::RunLoop run_loop;
+  log->Delete(base::BindLambdaForTesting([&run_loop](bool result) {
+    EXPECT_TRUE(result);
+    run_loop.Quit();
+  }));
+  run_loop.Run();
+  EXPECT_FALSE(base::PathExists(log_path_));
+  EXPECT_FALSE(base::PathExists(previous_log_path));
+}
+
+TEST_F(DiagnosticLogTest, KeepsLogOfPreviousRun) {
+  auto log = CreateLog(kMaxFileSize);
+  log->Write(Line(0), base::DoNothing());
+  log.reset();
+  task_environment_.RunUntilIdle();
+
+  log = CreateLog(kMaxFileSize);
+  log->Write(Line(1), base::DoNothing());
+  EXPECT_EQ(Divider() + Line(0) + Divider() + Line(1),
+            ReadLastNLines(log.get(), -1));
+}
+
+TEST_F(DiagnosticLogTest, TerminatesLineTruncatedByCrash) {
+  ASSERT_TRUE(base::WriteFile(log_path_, "complete\npartial"));
+
+  auto log = CreateLog(kMaxFileSize);
+  log->Write(Line(0), base::DoNothing());
+  EXPECT_EQ("complete\npartial\n" + Divider() + Line(0),
+            ReadLastNLines(log.get(), -1));
+}
+
+TEST_F(DiagnosticLogTest, WriteManyLinesAtSizeCap) {
+  constexpr int kLines = 100'000;
+  constexpr int64_t kMaxLogSize = 1024 * 1024;
+
+  // Once the log reaches its size cap, each write used to rewrite the whole
+  // file to trim it.
+  auto log = CreateLog(kMaxLogSize);
+  for (int i = 0; i < kLines; i++) {
+    log->Write(Line(i), base::DoNothing());
+  }
+
+  EXPECT_EQ(Lines(kLines - 3, kLines), ReadLastNLines(log.get(), 3));
+  EXPECT_LE(GetFileSize(log_path_) +
+                GetFileSize(log_path_.AddExtensionASCII("1")),
+            kMaxLogSize);
+}
+
+}  // namespace brave_rewards
@@ -89,7 +89,6 @@ static const unsigned int kRetriesCountOnNetworkChange = 1;
 namespace {
 
 constexpr int kDiagnosticLogMaxVerboseLevel = 6;
-constexpr int kDiagnosticLogKeepNumLines = 20000;
 constexpr int kDiagnosticLogMaxFileSize = 10 * (1024 * 1024);
 constexpr char pref_prefix[] = "brave.rewards";
 constexpr base::TimeDelta kP3AMonthlyReportingPeriod = base::Days(30);
@@ -306,8 +305,7 @@ RewardsServiceImpl::RewardsServiceImpl(Profile* profile)
       publisher_list_path_(profile->GetPath().Append(kPublishers_list)),
       diagnostic_log_(
           new DiagnosticLog(profile_->GetPath().Append(kDiagnosticLogPath),
-                            kDiagnosticLogMaxFileSize,
-                            kDiagnosticLogKeepNumLines)),
+                            kDiagnosticLogMaxFileSize)),
       notification_service_(new RewardsNotificationServiceImpl(profile)) {
   // Set up the rewards data source
   content::URLDataSource::Add(profile_,
@@ -3,6 +3,7 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this file,
  * You can obtain one at https://mozilla.org/MPL/2.0/. */
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 
@@ -15,6 +16,7 @@
 #include "brave/components/brave_rewards/core/database/database.h"
 #include "brave/components/brave_rewards/core/rewards_engine_impl.h"
 #include "brave_base/random.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
 
 using std::placeholders::_1;
 using std::placeholders::_2;
@@ -24,29 +26,40 @@ namespace brave_rewards::internal::contribution {
 
 namespace {
 
-// Allocates one "vote" to a publisher. |dart| is a uniform random
-// double in [0,1] "thrown" into the list of publishers to choose a
-// winner. This function encapsulates the deterministic portion of
-// choosing a winning publisher, separated out into a separate
-// function for testing purposes.
-std::string GetStatisticalVotingWinner(
-    double dart,
+// Returns the upper bounds of the publishers' shares of |amount|, in list
+// order. A "dart" thrown into the list falls to the first publisher whose
+// bound it doesn't exceed.
+std::vector<double> GetVotingUpperBounds(
     double amount,
     const std::vector<mojom::ContributionPublisherPtr>& publisher_list) {
-  std::string publisher_key;
+  std::vector<double> upper_bounds;
+  upper_bounds.reserve(publisher_list.size());
 
   double upper = 0.0;
   for (const auto& item : publisher_list) {
     upper += item->total_amount / amount;
-    if (upper < dart) {
-      continue;
-    }
+    upper_bounds.push_back(upper);
+  }
 
-    publisher_key = item->publisher_key;
-    break;
+  return upper_bounds;
+}
+
+// Allocates one "vote" to a publisher. |dart| is a uniform random
+// double in [0,1] "thrown" into the list of publishers to choose a
+// winner. Returns the index of the winning publisher, or nullopt if the
+// dart lands past the last bound. This function encapsulates the
+// deterministic portion of choosing a winning publisher, separated out
+// into a separate function for testing purposes.
+absl::optional<size_t> GetStatisticalVotingWinner(
+    double dart,
+    const std::vector<double>& upper_bounds) {
+  const auto iter =
+      std::lower_bound(upper_bounds.cbegin(), upper_bounds.cend(), dart);
+  if (iter == upper_bounds.cend()) {
+    return absl::nullopt;
   }
 
-  return publisher_key;
+  return static_cast<size_t>(iter - upper_bounds.cbegin());
 }
 
 // Allocates "votes" to a list of publishers based on attention.
@@ -64,30 +77,26 @@ void GetStatisticalVotingWinners(
     return;
   }
 
-  // Initialize all potential winners to 0, as it's possible that one
-  // or more publishers may receive no votes at all
-  for (const auto& item : publisher_list) {
-    winners->emplace(item->publisher_key, 0);
-  }
+  const std::vector<double> upper_bounds =
+      GetVotingUpperBounds(amount, publisher_list);
+  std::vector<uint32_t> votes(publisher_list.size(), 0);
 
   while (total_votes > 0) {
     const double dart = brave_base::random::Uniform_01();
-    const std::string publisher_key =
-        GetStatisticalVotingWinner(dart, amount, publisher_list);
-    if (publisher_key.empty()) {
+    const auto index = GetStatisticalVotingWinner(dart, upper_bounds);
+    if (!index || publisher_list[*index]->publisher_key.empty()) {
       continue;
     }
 
-    auto iter = winners->find(publisher_key);
-    if (iter != winners->end()) {
-      const uint32_t current_value = winners->at(publisher_key);
-      winners->at(publisher_key) = current_value + 1;
-    } else {
-      winners->emplace(publisher_key, 1);
-    }
-
+    ++votes[*index];
     --total_votes;
   }
+
+  // All potential winners are included, as it's possible that one or more
+  // publishers may receive no votes at all
+  for (size_t i = 0; i < publisher_list.size(); ++i) {
+    (*winners)[publisher_list[i]->publisher_key] += votes[i];
+  }
 }
 
 }  // namespace
@@ -411,6 +420,14 @@ void Unblinded::OnProcessTokens(
       token_list.push_back(item);
     }
 
+    if (token_list.empty()) {
+      // Earlier publishers used up the reserved tokens, so there is nothing
+      // left to redeem for this or any later publisher
+      BLOG(0, "No tokens left for the remaining publishers");
+      callback(mojom::Result::OK);
+      return;
+    }
+
     auto redeem_callback = std::bind(
         &Unblinded::TokenProcessed, this, _1, contribution->contribution_id,
         (*publisher)->publisher_key, final_publisher, callback);
@@ -561,7 +578,18 @@ std::string Unblinded::GetStatisticalVotingWinnerForTesting(
     double dart,
     double amount,
     const std::vector<mojom::ContributionPublisherPtr>& publisher_list) {
-  return GetStatisticalVotingWinner(dart, amount, publisher_list);
+  const auto index = GetStatisticalVotingWinner(
+      dart, GetVotingUpperBounds(amount, publisher_list));
+  return index ? publisher_list[*index]->publisher_key : std::string();
+}
+
+StatisticalVotingWinners Unblinded::GetStatisticalVotingWinnersForTesting(
+    uint32_t total_votes,
+    double amount,
+    const std::vector<mojom::ContributionPublisherPtr>& publisher_list) {
+  StatisticalVotingWinners winners;
+  GetStatisticalVotingWinners(total_votes, amount, publisher_list, &winners);
+  return winners;
 }
 
 }  // namespace brave_rewards::internal::contribution
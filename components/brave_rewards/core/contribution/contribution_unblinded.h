@@ -45,6 +45,8 @@ class Unblinded {
 
  private:
   FRIEND_TEST_ALL_PREFIXES(UnblindedTest, GetStatisticalVotingWinner);
+  FRIEND_TEST_ALL_PREFIXES(UnblindedTest, GetStatisticalVotingWinners);
+  FRIEND_TEST_ALL_PREFIXES(UnblindedTest, NoTokensLeftForPublisher);
 
   void GetContributionInfoAndUnblindedTokens(
       const std::vector<mojom::CredsBatchType>& types,
@@ -134,6 +136,11 @@ class Unblinded {
       double amount,
       const std::vector<mojom::ContributionPublisherPtr>& publisher_list);
 
+  StatisticalVotingWinners GetStatisticalVotingWinnersForTesting(
+      uint32_t total_votes,
+      double amount,
+      const std::vector<mojom::ContributionPublisherPtr>& publisher_list);
+
   const raw_ref<RewardsEngineImpl> engine_;
   credential::CredentialsPromotion credentials_promotion_;
   credential::CredentialsSKU credentials_sku_;
@@ -3,8 +3,10 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this file,
  * You can obtain one at https://mozilla.org/MPL/2.0/. */
 
+#include <cmath>
 #include <utility>
 
+#include "base/strings/string_number_conversions.h"
 #include "base/test/task_environment.h"
 #include "brave/components/brave_rewards/core/contribution/contribution_unblinded.h"
 #include "brave/components/brave_rewards/core/database/database_contribution_info.h"
@@ -18,6 +20,8 @@ using ::testing::MockFunction;
 
 namespace {
 const char contribution_id[] = "60770beb-3cfb-4550-a5db-deccafb5c790";
+constexpr uint32_t kTokenCount = 5000;
+constexpr size_t kPublisherCount = 500;
 }  // namespace
 
 namespace brave_rewards::internal {
@@ -117,5 +121,75 @@ TEST_F(UnblindedTest, GetStatisticalVotingWinner) {
   task_environment_.RunUntilIdle();
 }
 
+TEST_F(UnblindedTest, GetStatisticalVotingWinners) {
+  // Publisher i has (i + 1) shares out of kPublisherCount * 100.
+  std::vector<mojom::ContributionPublisherPtr> publisher_list;
+  double amount = 0.0;
+  for (size_t i = 0; i < kPublisherCount; ++i) {
+    auto publisher = mojom::ContributionPublisher::New();
+    publisher->publisher_key = "publisher" + base::NumberToString(i);
+    publisher->total_amount = static_cast<double>(i + 1);
+    amount += publisher->total_amount;
+    publisher_list.push_back(std::move(publisher));
+  }
+
+  const StatisticalVotingWinners winners =
+      unblinded_.GetStatisticalVotingWinnersForTesting(kTokenCount, amount,
+                                                       publisher_list);
+  ASSERT_EQ(kPublisherCount, winners.size());
+
+  // Compare the votes of each fifth of the list with its expected share,
+  // allowing for five standard deviations.
+  constexpr size_t kBuckets = 5;
+  constexpr size_t kBucketSize = kPublisherCount / kBuckets;
+  uint32_t total_votes = 0;
+  for (size_t bucket = 0; bucket < kBuckets; ++bucket) {
+    double share = 0.0;
+    uint32_t votes = 0;
+    for (size_t i = bucket * kBucketSize; i < (bucket + 1) * kBucketSize;
+         ++i) {
+      share += publisher_list[i]->total_amount / amount;
+      votes += winners.at(publisher_list[i]->publisher_key);
+    }
+
+    const double expected = share * kTokenCount;
+    const double deviation = std::sqrt(expected * (1.0 - share));
+    EXPECT_NEAR(expected, votes, 5.0 * deviation);
+    total_votes += votes;
+  }
+
+  EXPECT_EQ(kTokenCount, total_votes);
+}
+
+TEST_F(UnblindedTest, NoTokensLeftForPublisher) {
+  auto contribution = mojom::ContributionInfo::New();
+  contribution->contribution_id = contribution_id;
+  contribution->type = mojom::RewardsType::AUTO_CONTRIBUTE;
+  contribution->processor = mojom::ContributionProcessor::BRAVE_TOKENS;
+
+  // The first publisher was contributed to in an earlier round and used up
+  // the reserved tokens.
+  auto publisher1 = mojom::ContributionPublisher::New();
+  publisher1->contribution_id = contribution_id;
+  publisher1->publisher_key = "publisher1";
+  publisher1->total_amount = 2.5;
+  publisher1->contributed_amount = 2.5;
+  contribution->publishers.push_back(std::move(publisher1));
+
+  auto publisher2 = mojom::ContributionPublisher::New();
+  publisher2->contribution_id = contribution_id;
+  publisher2->publisher_key = "publisher2";
+  publisher2->total_amount = 2.5;
+  contribution->publishers.push_back(std::move(publisher2));
+
+  // The contribution completes without redeeming an empty token list.
+  MockFunction<LegacyResultCallback> callback;
+  EXPECT_CALL(callback, Call(mojom::Result::OK)).Times(1);
+  unblinded_.OnProcessTokens(std::move(contribution), {},
+                             callback.AsStdFunction());
+
+  task_environment_.RunUntilIdle();
+}
+
 }  // namespace contribution
 }  // namespace brave_rewards::internal
@@ -5,8 +5,31 @@
 
 #include "brave/components/brave_rewards/core/legacy/media/helper.h"
 
+#include <utility>
+
+#include "base/containers/queue.h"
+
 namespace brave_rewards::internal {
 
+namespace {
+
+std::string ExtractFrom(base::StringPiece data,
+                        size_t start_pos,
+                        const std::string& match_until) {
+  if (match_until.empty()) {
+    return std::string(data.substr(start_pos));
+  }
+
+  const size_t end_pos = data.find(match_until, start_pos);
+  if (end_pos == base::StringPiece::npos) {
+    return std::string(data.substr(start_pos));
+  }
+
+  return std::string(data.substr(start_pos, end_pos - start_pos));
+}
+
+}  // namespace
+
 std::string GetMediaKey(const std::string& mediaId, const std::string& type) {
   if (mediaId.empty() || type.empty()) {
     return std::string();
@@ -46,4 +69,102 @@ std::string ExtractData(const std::string& data,
   return match;
 }
 
+DataExtractor::State::State() = default;
+DataExtractor::State::State(State&&) = default;
+DataExtractor::State& DataExtractor::State::operator=(State&&) = default;
+DataExtractor::State::~State() = default;
+
+DataExtractor::DataExtractor(std::vector<Needle> needles)
+    : needles_(std::move(needles)) {
+  states_.emplace_back();
+
+  for (size_t i = 0; i < needles_.size(); i++) {
+    size_t state = 0;
+    for (const char c : needles_[i].match_after) {
+      auto iter = states_[state].next.find(c);
+      if (iter != states_[state].next.end()) {
+        state = iter->second;
+        continue;
+      }
+
+      const size_t next_state = states_.size();
+      states_[state].next[c] = next_state;
+      states_.emplace_back();
+      state = next_state;
+    }
+
+    // Needles without |match_after| match at the beginning of the data.
+    if (state != 0) {
+      states_[state].needles.push_back(i);
+    }
+  }
+
+  base::queue<size_t> queue;
+  for (const auto& [c, state] : states_[0].next) {
+    queue.push(state);
+  }
+
+  while (!queue.empty()) {
+    const size_t state = queue.front();
+    queue.pop();
+
+    for (const auto& [c, next_state] : states_[state].next) {
+      size_t fail = states_[state].fail;
+      while (fail != 0 && !states_[fail].next.contains(c)) {
+        fail = states_[fail].fail;
+      }
+
+      auto iter = states_[fail].next.find(c);
+      if (iter != states_[fail].next.end() && iter->second != next_state) {
+        fail = iter->second;
+      }
+
+      states_[next_state].fail = fail;
+      states_[next_state].needles.insert(states_[next_state].needles.end(),
+                                         states_[fail].needles.begin(),
+                                         states_[fail].needles.end());
+      queue.push(next_state);
+    }
+  }
+}
+
+DataExtractor::~DataExtractor() = default;
+
+std::vector<std::string> DataExtractor::Extract(base::StringPiece data) const {
+  std::vector<std::string> values(needles_.size());
+  std::vector<bool> found(needles_.size(), false);
+  size_t remaining = needles_.size();
+
+  for (size_t i = 0; i < needles_.size(); i++) {
+    if (needles_[i].match_after.empty()) {
+      values[i] = ExtractFrom(data, 0, needles_[i].match_until);
+      found[i] = true;
+      remaining--;
+    }
+  }
+
+  size_t state = 0;
+  for (size_t pos = 0; pos < data.size() && remaining > 0; pos++) {
+    const char c = data[pos];
+    auto iter = states_[state].next.find(c);
+    while (state != 0 && iter == states_[state].next.end()) {
+      state = states_[state].fail;
+      iter = states_[state].next.find(c);
+    }
+    state = iter == states_[state].next.end() ? 0 : iter->second;
+
+    for (const size_t needle : states_[state].needles) {
+      if (found[needle]) {
+        continue;
+      }
+
+      values[needle] = ExtractFrom(data, pos + 1, needles_[needle].match_until);
+      found[needle] = true;
+      remaining--;
+    }
+  }
+
+  return values;
+}
+
 }  // namespace brave_rewards::internal
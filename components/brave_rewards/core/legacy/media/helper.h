@@ -7,6 +7,10 @@
 #define BRAVE_COMPONENTS_BRAVE_REWARDS_CORE_LEGACY_MEDIA_HELPER_H_
 
 #include <string>
+#include <vector>
+
+#include "base/containers/flat_map.h"
+#include "base/strings/string_piece.h"
 
 namespace brave_rewards::internal {
 
@@ -16,6 +20,42 @@ std::string ExtractData(const std::string& data,
                         const std::string& match_after,
                         const std::string& match_until);
 
+// Extracts data for several needles like |ExtractData| does for one, in a
+// single pass over the data. The needles are matched with an Aho-Corasick
+// automaton, and the scan stops once each of them was found.
+class DataExtractor {
+ public:
+  struct Needle {
+    std::string match_after;
+    std::string match_until;
+  };
+
+  explicit DataExtractor(std::vector<Needle> needles);
+  DataExtractor(const DataExtractor&) = delete;
+  DataExtractor& operator=(const DataExtractor&) = delete;
+  ~DataExtractor();
+
+  // Returns the data following the first match of each needle, in the order
+  // the needles were given.
+  std::vector<std::string> Extract(base::StringPiece data) const;
+
+ private:
+  struct State {
+    State();
+    State(State&&);
+    State& operator=(State&&);
+    ~State();
+
+    base::flat_map<char, size_t> next;
+    size_t fail = 0;
+    // Needles ending at this state, including the ones of its failure states.
+    std::vector<size_t> needles;
+  };
+
+  std::vector<Needle> needles_;
+  std::vector<State> states_;
+};
+
 }  // namespace brave_rewards::internal
 
 #endif  // BRAVE_COMPONENTS_BRAVE_REWARDS_CORE_LEGACY_MEDIA_HELPER_H_
@@ -4,6 +4,7 @@
  * You can obtain one at https://mozilla.org/MPL/2.0/. */
 
 #include <string>
+#include <vector>
 
 #include "brave/components/brave_rewards/core/legacy/media/helper.h"
 #include "brave/components/brave_rewards/core/rewards_callbacks.h"
@@ -47,4 +48,23 @@ TEST(MediaHelperTest, ExtractData) {
   ASSERT_EQ(result, "find/me");
 }
 
+TEST(MediaHelperTest, DataExtractor) {
+  // Needles sharing prefixes and suffixes.
+  const std::vector<DataExtractor::Needle> needles = {
+      {"/", "!"},  {"find", "/"}, {"ind/", "!"}, {"me", ""},
+      {"", "/"},   {"xyz", "!"}, {"/find/", "?"}};
+  const DataExtractor extractor(needles);
+
+  for (const std::string data :
+       {"", "st/find/me!", "find/find/me!me", "st/fin/ind/me!", "/find/"}) {
+    const std::vector<std::string> values = extractor.Extract(data);
+    ASSERT_EQ(values.size(), needles.size());
+    for (size_t i = 0; i < needles.size(); i++) {
+      EXPECT_EQ(values[i], ExtractData(data, needles[i].match_after,
+                                       needles[i].match_until))
+          << data << " " << needles[i].match_after;
+    }
+  }
+}
+
 }  // namespace brave_rewards::internal
@@ -7,8 +7,11 @@
 #include <utility>
 #include <vector>
 
+#include "base/containers/cxx20_erase.h"
+#include "base/no_destructor.h"
 #include "base/strings/escape.h"
 #include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
 #include "brave/components/brave_rewards/core/database/database.h"
 #include "brave/components/brave_rewards/core/legacy/bat_helper.h"
 #include "brave/components/brave_rewards/core/legacy/media/helper.h"
@@ -25,10 +28,87 @@ using std::placeholders::_3;
 
 namespace brave_rewards::internal {
 
+namespace {
+
+constexpr base::TimeDelta kPublisherKeyCacheTTL = base::Hours(1);
+constexpr size_t kMaxPublisherKeyCacheSize = 1000;
+
+// Needles scraped from YouTube pages, see |GetPageExtractor|.
+enum PageNeedle {
+  kAvatarFavIcon,
+  kThumbnailFavIcon,
+  kUcid,
+  kHeaderChannelId,
+  kCanonicalChannelId,
+  kBrowseEndpointId,
+  kAuthor,
+  kChannelTitle,
+  kBrowseIdParam
+};
+
+const DataExtractor& GetPageExtractor() {
+  static const base::NoDestructor<DataExtractor> extractor(
+      std::vector<DataExtractor::Needle>{
+          {"\"avatar\":{\"thumbnails\":[{\"url\":\"", "\""},
+          {"\"width\":88,\"height\":88},{\"url\":\"", "\""},
+          {"\"ucid\":\"", "\""},
+          {"HeaderRenderer\":{\"channelId\":\"", "\""},
+          {"<link rel=\"canonical\" href=\"https://www.youtube.com/channel/",
+           "\">"},
+          {"browseEndpoint\":{\"browseId\":\"", "\""},
+          {"\"author\":\"", "\""},
+          {"channelMetadataRenderer\":{\"title\":\"", "\""},
+          {"{\"key\":\"browse_id\",\"value\":\"", "\""}});
+  return *extractor;
+}
+
+// Returns the value of the first of |needles| found, in order of preference.
+std::string GetFirstValue(const std::vector<std::string>& values,
+                          const std::vector<PageNeedle>& needles) {
+  for (const auto needle : needles) {
+    if (!values[needle].empty()) {
+      return values[needle];
+    }
+  }
+  return std::string();
+}
+
+std::string DecodeJSONString(const std::string& value) {
+  std::string decoded;
+  const std::string json = "{\"brave_publisher\":\"" + value + "\"}";
+  // scraped data could come in with JSON code points added.
+  // Make to JSON object above so we can decode.
+  getJSONValue("brave_publisher", json, &decoded);
+  return decoded;
+}
+
+}  // namespace
+
+YouTube::PageInfo::PageInfo() = default;
+YouTube::PageInfo::PageInfo(const PageInfo&) = default;
+YouTube::PageInfo& YouTube::PageInfo::operator=(const PageInfo&) = default;
+YouTube::PageInfo::~PageInfo() = default;
+
 YouTube::YouTube(RewardsEngineImpl& engine) : engine_(engine) {}
 
 YouTube::~YouTube() = default;
 
+// static
+YouTube::PageInfo YouTube::ScanPage(const std::string& data) {
+  const std::vector<std::string> values = GetPageExtractor().Extract(data);
+
+  PageInfo page_info;
+  page_info.fav_icon_url =
+      GetFirstValue(values, {kAvatarFavIcon, kThumbnailFavIcon});
+  page_info.channel_id =
+      GetFirstValue(values, {kUcid, kHeaderChannelId, kCanonicalChannelId,
+                             kBrowseEndpointId});
+  page_info.publisher_name = DecodeJSONString(values[kAuthor]);
+  page_info.channel_name = DecodeJSONString(values[kChannelTitle]);
+  page_info.custom_path_channel_id = values[kBrowseIdParam];
+  return page_info;
+}
+
 // static
 std::string YouTube::GetMediaIdFromParts(
     const base::flat_map<std::string, std::string>& parts) {
@@ -92,47 +172,17 @@ std::string YouTube::GetChannelUrl(const std::string& publisher_key) {
 
 // static
 std::string YouTube::GetFavIconUrl(const std::string& data) {
-  std::string favicon_url =
-      ExtractData(data, "\"avatar\":{\"thumbnails\":[{\"url\":\"", "\"");
-
-  if (favicon_url.empty()) {
-    favicon_url =
-        ExtractData(data, "\"width\":88,\"height\":88},{\"url\":\"", "\"");
-  }
-
-  return favicon_url;
+  return ScanPage(data).fav_icon_url;
 }
 
 // static
 std::string YouTube::GetChannelId(const std::string& data) {
-  std::string id = ExtractData(data, "\"ucid\":\"", "\"");
-  if (id.empty()) {
-    id = ExtractData(data, "HeaderRenderer\":{\"channelId\":\"", "\"");
-  }
-
-  if (id.empty()) {
-    id = ExtractData(
-        data, "<link rel=\"canonical\" href=\"https://www.youtube.com/channel/",
-        "\">");
-  }
-
-  if (id.empty()) {
-    id = ExtractData(data, "browseEndpoint\":{\"browseId\":\"", "\"");
-  }
-
-  return id;
+  return ScanPage(data).channel_id;
 }
 
 // static
 std::string YouTube::GetPublisherName(const std::string& data) {
-  std::string publisher_name;
-  std::string publisher_json_name = ExtractData(data, "\"author\":\"", "\"");
-  std::string publisher_json =
-      "{\"brave_publisher\":\"" + publisher_json_name + "\"}";
-  // scraped data could come in with JSON code points added.
-  // Make to JSON object above so we can decode.
-  getJSONValue("brave_publisher", publisher_json, &publisher_name);
-  return publisher_name;
+  return ScanPage(data).publisher_name;
 }
 
 // static
@@ -180,15 +230,7 @@ std::string YouTube::GetMediaIdFromUrl(const std::string& url) {
 
 // static
 std::string YouTube::GetNameFromChannel(const std::string& data) {
-  std::string publisher_name;
-  const std::string publisher_json_name =
-      ExtractData(data, "channelMetadataRenderer\":{\"title\":\"", "\"");
-  const std::string publisher_json =
-      "{\"brave_publisher\":\"" + publisher_json_name + "\"}";
-  // scraped data could come in with JSON code points added.
-  // Make to JSON object above so we can decode.
-  getJSONValue("brave_publisher", publisher_json, &publisher_name);
-  return publisher_name;
+  return ScanPage(data).channel_name;
 }
 
 // static
@@ -211,7 +253,7 @@ std::string YouTube::GetPublisherKeyFromUrl(const std::string& path) {
 
 // static
 std::string YouTube::GetChannelIdFromCustomPathPage(const std::string& data) {
-  return ExtractData(data, "{\"key\":\"browse_id\",\"value\":\"", "\"");
+  return ScanPage(data).custom_path_channel_id;
 }
 
 // static
@@ -269,6 +311,48 @@ std::string YouTube::GetUserFromUrl(const std::string& path) {
   return params[0];
 }
 
+// static
+std::string YouTube::GetCustomPathMediaKey(const std::string& path) {
+  std::string custom_path = path.substr(0, path.find('?'));
+  base::TrimString(custom_path, "/", &custom_path);
+  return (std::string)YOUTUBE_MEDIA_TYPE + "_custom_" + custom_path;
+}
+
+std::string YouTube::GetCachedPublisherKey(const std::string& media_key) {
+  auto iter = publisher_key_cache_.find(media_key);
+  if (iter == publisher_key_cache_.end()) {
+    return std::string();
+  }
+
+  if (iter->second.expires_at <= base::Time::Now()) {
+    publisher_key_cache_.erase(iter);
+    return std::string();
+  }
+
+  return iter->second.publisher_key;
+}
+
+void YouTube::CachePublisherKey(const std::string& media_key,
+                                const std::string& publisher_key) {
+  if (media_key.empty() || publisher_key.empty()) {
+    return;
+  }
+
+  const base::Time now = base::Time::Now();
+  if (publisher_key_cache_.size() >= kMaxPublisherKeyCacheSize) {
+    base::EraseIf(publisher_key_cache_, [now](const auto& entry) {
+      return entry.second.expires_at <= now;
+    });
+  }
+
+  if (publisher_key_cache_.size() >= kMaxPublisherKeyCacheSize) {
+    publisher_key_cache_.clear();
+  }
+
+  publisher_key_cache_[media_key] = {publisher_key,
+                                     now + kPublisherKeyCacheTTL};
+}
+
 void YouTube::OnMediaActivityError(const mojom::VisitData& visit_data,
                                    uint64_t window_id) {
   std::string url = YOUTUBE_DOMAIN;
@@ -322,8 +406,7 @@ void YouTube::ProcessActivityFromUrl(uint64_t window_id,
   }
 
   if (!IsPredefinedPath(visit_data.path)) {
-    OnPublisherPanleInfo(window_id, visit_data, std::string(), true,
-                         mojom::Result::NOT_FOUND, nullptr);
+    CustomPath(window_id, visit_data);
     return;
   }
 
@@ -410,19 +493,19 @@ void YouTube::OnPublisherPage(const uint64_t duration,
   }
 
   if (response->status_code == net::HTTP_OK) {
-    std::string fav_icon = GetFavIconUrl(response->body);
-    std::string channel_id = GetChannelId(response->body);
+    const PageInfo page_info = ScanPage(response->body);
 
     if (publisher_name.empty()) {
-      publisher_name = GetPublisherName(response->body);
+      publisher_name = page_info.publisher_name;
     }
 
     if (publisher_url.empty()) {
-      publisher_url = GetChannelUrl(channel_id);
+      publisher_url = GetChannelUrl(page_info.channel_id);
     }
 
     SavePublisherInfo(duration, media_key, publisher_url, publisher_name,
-                      visit_data, window_id, fav_icon, channel_id);
+                      visit_data, window_id, page_info.fav_icon_url,
+                      page_info.channel_id);
   }
 }
 
@@ -464,6 +547,7 @@ void YouTube::SavePublisherInfo(const uint64_t duration,
   if (!media_key.empty()) {
     engine_->database()->SaveMediaPublisherInfo(media_key, publisher_id,
                                                 [](const mojom::Result) {});
+    CachePublisherKey(media_key, publisher_id);
   }
 }
 
@@ -481,6 +565,12 @@ void YouTube::WatchPath(uint64_t window_id,
   std::string media_key = GetMediaKey(media_id, YOUTUBE_MEDIA_TYPE);
 
   if (!media_key.empty() || !media_id.empty()) {
+    const std::string publisher_key = GetCachedPublisherKey(media_key);
+    if (!publisher_key.empty()) {
+      GetPublisherPanleInfo(window_id, visit_data, publisher_key, false);
+      return;
+    }
+
     engine_->database()->GetMediaPublisherInfo(
         media_key, std::bind(&YouTube::OnMediaPublisherActivity, this, _1, _2,
                              window_id, visit_data, media_key, media_id));
@@ -504,6 +594,7 @@ void YouTube::OnMediaPublisherActivity(mojom::Result result,
     OnMediaPublisherInfo(media_id, media_key, 0, visit_data, window_id, result,
                          std::move(info));
   } else {
+    CachePublisherKey(media_key, info->id);
     GetPublisherPanleInfo(window_id, visit_data, info->id, false);
   }
 }
@@ -548,21 +639,25 @@ void YouTube::GetChannelHeadlineVideo(uint64_t window_id,
   }
 
   if (visit_data.path.find("/channel/") != std::string::npos) {
-    std::string title = GetNameFromChannel(response->body);
-    std::string favicon = GetFavIconUrl(response->body);
+    const PageInfo page_info = ScanPage(response->body);
     std::string channel_id = GetPublisherKeyFromUrl(visit_data.path);
 
-    SavePublisherInfo(0, std::string(), visit_data.url, title, visit_data,
-                      window_id, favicon, channel_id);
+    SavePublisherInfo(0, std::string(), visit_data.url, page_info.channel_name,
+                      visit_data, window_id, page_info.fav_icon_url,
+                      channel_id);
 
   } else if (is_custom_path) {
-    std::string title = GetNameFromChannel(response->body);
-    std::string favicon = GetFavIconUrl(response->body);
-    std::string channel_id = GetChannelIdFromCustomPathPage(response->body);
-    mojom::VisitData new_visit_data;
-    new_visit_data.path = "/channel/" + channel_id;
-    GetPublisherPanleInfo(window_id, new_visit_data,
-                          GetPublisherKey(channel_id), true);
+    const std::string channel_id =
+        ScanPage(response->body).custom_path_channel_id;
+    const std::string publisher_key = GetPublisherKey(channel_id);
+    if (!channel_id.empty()) {
+      const std::string media_key = GetCustomPathMediaKey(visit_data.path);
+      engine_->database()->SaveMediaPublisherInfo(media_key, publisher_key,
+                                                  [](const mojom::Result) {});
+      CachePublisherKey(media_key, publisher_key);
+    }
+
+    GetCustomPathPanelInfo(window_id, publisher_key);
   } else {
     OnMediaActivityError(visit_data, window_id);
   }
@@ -588,6 +683,12 @@ void YouTube::UserPath(uint64_t window_id, const mojom::VisitData& visit_data) {
   }
 
   std::string media_key = (std::string)YOUTUBE_MEDIA_TYPE + "_user_" + user;
+  const std::string publisher_key = GetCachedPublisherKey(media_key);
+  if (!publisher_key.empty()) {
+    GetPublisherPanleInfo(window_id, visit_data, publisher_key, false);
+    return;
+  }
+
   engine_->database()->GetMediaPublisherInfo(
       media_key, std::bind(&YouTube::OnUserActivity, this, window_id,
                            visit_data, media_key, _1, _2));
@@ -609,6 +710,7 @@ void YouTube::OnUserActivity(uint64_t window_id,
                                visit_data, media_key, _1));
 
   } else {
+    CachePublisherKey(media_key, info->id);
     GetPublisherPanleInfo(window_id, visit_data, info->id, false);
   }
 }
@@ -626,6 +728,7 @@ void YouTube::OnChannelIdForUser(uint64_t window_id,
 
     engine_->database()->SaveMediaPublisherInfo(media_key, publisher_key,
                                                 [](const mojom::Result) {});
+    CachePublisherKey(media_key, publisher_key);
 
     mojom::VisitData new_visit_data;
     new_visit_data.path = path;
@@ -639,4 +742,47 @@ void YouTube::OnChannelIdForUser(uint64_t window_id,
   }
 }
 
+void YouTube::CustomPath(uint64_t window_id,
+                         const mojom::VisitData& visit_data) {
+  const std::string media_key = GetCustomPathMediaKey(visit_data.path);
+  const std::string publisher_key = GetCachedPublisherKey(media_key);
+  if (!publisher_key.empty()) {
+    GetCustomPathPanelInfo(window_id, publisher_key);
+    return;
+  }
+
+  engine_->database()->GetMediaPublisherInfo(
+      media_key, std::bind(&YouTube::OnCustomPathActivity, this, window_id,
+                           visit_data, media_key, _1, _2));
+}
+
+void YouTube::OnCustomPathActivity(uint64_t window_id,
+                                   const mojom::VisitData& visit_data,
+                                   const std::string& media_key,
+                                   mojom::Result result,
+                                   mojom::PublisherInfoPtr info) {
+  if (!info || result != mojom::Result::OK) {
+    // The channel of this custom path is only known from its page.
+    OnPublisherPanleInfo(window_id, visit_data, std::string(), true,
+                         mojom::Result::NOT_FOUND, nullptr);
+    return;
+  }
+
+  CachePublisherKey(media_key, info->id);
+  GetCustomPathPanelInfo(window_id, info->id);
+}
+
+void YouTube::GetCustomPathPanelInfo(uint64_t window_id,
+                                     const std::string& publisher_key) {
+  std::string channel_id = publisher_key;
+  const std::string prefix = GetPublisherKey(std::string());
+  if (base::StartsWith(channel_id, prefix)) {
+    channel_id.erase(0, prefix.size());
+  }
+
+  mojom::VisitData new_visit_data;
+  new_visit_data.path = "/channel/" + channel_id;
+  GetPublisherPanleInfo(window_id, new_visit_data, publisher_key, true);
+}
+
 }  // namespace brave_rewards::internal
@@ -6,12 +6,14 @@
 #ifndef BRAVE_COMPONENTS_BRAVE_REWARDS_CORE_LEGACY_MEDIA_YOUTUBE_H_
 #define BRAVE_COMPONENTS_BRAVE_REWARDS_CORE_LEGACY_MEDIA_YOUTUBE_H_
 
+#include <map>
 #include <memory>
 #include <string>
 
 #include "base/containers/flat_map.h"
 #include "base/gtest_prod_util.h"
 #include "base/memory/raw_ref.h"
+#include "base/time/time.h"
 #include "brave/components/brave_rewards/core/legacy/media/helper.h"
 #include "brave/components/brave_rewards/core/rewards_callbacks.h"
 
@@ -34,6 +36,28 @@ class YouTube {
                               const mojom::VisitData& visit_data);
 
  private:
+  // Publisher data scraped from a YouTube page.
+  struct PageInfo {
+    PageInfo();
+    PageInfo(const PageInfo&);
+    PageInfo& operator=(const PageInfo&);
+    ~PageInfo();
+
+    std::string fav_icon_url;
+    std::string channel_id;
+    std::string publisher_name;
+    std::string channel_name;
+    std::string custom_path_channel_id;
+  };
+
+  struct CachedPublisherKey {
+    std::string publisher_key;
+    base::Time expires_at;
+  };
+
+  // Scrapes every field of |PageInfo| in a single pass over |data|.
+  static PageInfo ScanPage(const std::string& data);
+
   static std::string GetMediaIdFromParts(
       const base::flat_map<std::string, std::string>& parts);
 
@@ -67,6 +91,14 @@ class YouTube {
 
   static std::string GetUserFromUrl(const std::string& path);
 
+  static std::string GetCustomPathMediaKey(const std::string& path);
+
+  // Returns the publisher key recently resolved for |media_key|, if any.
+  std::string GetCachedPublisherKey(const std::string& media_key);
+
+  void CachePublisherKey(const std::string& media_key,
+                         const std::string& publisher_key);
+
   void OnMediaActivityError(const mojom::VisitData& visit_data,
                             uint64_t window_id);
 
@@ -145,8 +177,24 @@ class YouTube {
                           const std::string& media_key,
                           mojom::UrlResponsePtr response);
 
+  void CustomPath(uint64_t window_id, const mojom::VisitData& visit_data);
+
+  void OnCustomPathActivity(uint64_t window_id,
+                            const mojom::VisitData& visit_data,
+                            const std::string& media_key,
+                            mojom::Result result,
+                            mojom::PublisherInfoPtr info);
+
+  void GetCustomPathPanelInfo(uint64_t window_id,
+                              const std::string& publisher_key);
+
   const raw_ref<RewardsEngineImpl> engine_;
 
+  // Media ids, users and custom paths resolved to publisher keys. The
+  // database keeps these too, this spares the lookups for pages which are
+  // opened again and again.
+  std::map<std::string, CachedPublisherKey> publisher_key_cache_;
+
   // For testing purposes
   friend class MediaYouTubeTest;
   FRIEND_TEST_ALL_PREFIXES(MediaYouTubeTest, GetMediaIdFromUrl);
@@ -164,6 +212,8 @@ class YouTube {
   FRIEND_TEST_ALL_PREFIXES(MediaYouTubeTest, GetChannelIdFromCustomPathPage);
   FRIEND_TEST_ALL_PREFIXES(MediaYouTubeTest, IsPredefinedPath);
   FRIEND_TEST_ALL_PREFIXES(MediaYouTubeTest, GetPublisherKey);
+  FRIEND_TEST_ALL_PREFIXES(MediaYouTubeTest, ScanPage);
+  FRIEND_TEST_ALL_PREFIXES(MediaYouTubeTest, GetCustomPathMediaKey);
 };
 
 }  // namespace brave_rewards::internal
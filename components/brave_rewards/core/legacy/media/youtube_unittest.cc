@@ -3,10 +3,13 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this file,
  * You can obtain one at https://mozilla.org/MPL/2.0/. */
 
+#include <string>
 #include <utility>
 
 #include "base/containers/flat_map.h"
+#include "base/strings/strcat.h"
 #include "brave/components/brave_rewards/core/constants.h"
+#include "brave/components/brave_rewards/core/legacy/media/helper.h"
 #include "brave/components/brave_rewards/core/legacy/media/youtube.h"
 #include "brave/components/brave_rewards/core/legacy/static_values.h"
 #include "brave/components/brave_rewards/core/rewards_callbacks.h"
@@ -544,6 +547,61 @@ TEST(MediaYouTubeTest, GetChannelIdFromCustomPathPage) {
   EXPECT_EQ(channel_id, expected_channel_id);
 }
 
+TEST(MediaYouTubeTest, ScanPage) {
+  // null case
+  YouTube::PageInfo page_info = YouTube::ScanPage(std::string());
+  EXPECT_TRUE(page_info.fav_icon_url.empty());
+  EXPECT_TRUE(page_info.channel_id.empty());
+  EXPECT_TRUE(page_info.publisher_name.empty());
+  EXPECT_TRUE(page_info.channel_name.empty());
+  EXPECT_TRUE(page_info.custom_path_channel_id.empty());
+
+  // Watch pages are over a megabyte, with the fields spread across it.
+  std::string filler;
+  for (int i = 0; i < 10'000; i++) {
+    filler +=
+        "{\"videoRenderer\":{\"videoId\":\"xyz\",\"thumbnail\":{\"thum"
+        "bnails\":[{\"url\":\"https://i.ytimg.com/vi/xyz/hq.jpg\"}]}}},";
+  }
+  const std::string data = base::StrCat(
+      {"<html><head><link rel=\"canonical\" href=\"https://www.youtube.com/"
+       "watch?v=xyz\"></head><body><script>var ytInitialPlayerResponse = {"
+       "\"videoDetails\":{\"videoId\":\"xyz\",\"author\":\"Brave "
+       "\\u0026 Friends\",",
+       filler,
+       "\"channelId\":\"UCFNTTISby1c_H-rm5Ww5rZg\"}};</script><script>"
+       "var ytInitialData = {\"videoOwnerRenderer\":{\"thumbnail\":{"
+       "\"thumbnails\":[{\"url\":\"https://yt3.ggpht.com/a/small\","
+       "\"width\":48,\"height\":48},{\"url\":\"https://yt3.ggpht.com/"
+       "a/large\",\"width\":88,\"height\":88},{\"url\":\"https://"
+       "yt3.ggpht.com/a/huge\",\"width\":176,\"height\":176}]},"
+       "\"navigationEndpoint\":{\"browseEndpoint\":{\"browseId\":"
+       "\"UCFNTTISby1c_H-rm5Ww5rZg\"}}}};",
+       filler, "\"ucid\":\"UCFNTTISby1c_H-rm5Ww5rZg\"</script></body>"});
+
+  page_info = YouTube::ScanPage(data);
+  EXPECT_EQ(page_info.fav_icon_url, "https://yt3.ggpht.com/a/huge");
+  EXPECT_EQ(page_info.channel_id, "UCFNTTISby1c_H-rm5Ww5rZg");
+  EXPECT_EQ(page_info.publisher_name, "Brave & Friends");
+  EXPECT_TRUE(page_info.channel_name.empty());
+  EXPECT_TRUE(page_info.custom_path_channel_id.empty());
+
+  // The single pass finds the same data as searching for each field.
+  EXPECT_EQ(page_info.fav_icon_url,
+            ExtractData(data, "\"width\":88,\"height\":88},{\"url\":\"",
+                        "\""));
+  EXPECT_EQ(page_info.channel_id,
+            ExtractData(data, "\"ucid\":\"", "\""));
+}
+
+TEST(MediaYouTubeTest, GetCustomPathMediaKey) {
+  EXPECT_EQ(YouTube::GetCustomPathMediaKey("/@brave"), "youtube_custom_@brave");
+  EXPECT_EQ(YouTube::GetCustomPathMediaKey("/@brave/?view=0"),
+            "youtube_custom_@brave");
+  EXPECT_EQ(YouTube::GetCustomPathMediaKey("/c/Brave/videos"),
+            "youtube_custom_c/Brave/videos");
+}
+
 TEST(MediaYouTubeTest, IsPredefinedPath) {
   // null case
   std::string path;
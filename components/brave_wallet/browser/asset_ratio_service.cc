@@ -10,10 +10,12 @@
 #include <utility>
 
 #include "base/base64.h"
+#include "base/containers/cxx20_erase.h"
 #include "base/environment.h"
 #include "base/json/json_writer.h"
 #include "base/no_destructor.h"
 #include "base/strings/stringprintf.h"
+#include "base/task/sequenced_task_runner.h"
 #include "brave/components/api_request_helper/api_request_helper.h"
 #include "brave/components/brave_wallet/browser/brave_wallet_constants.h"
 #include "brave/components/brave_wallet/browser/json_rpc_requests_helper.h"
@@ -26,6 +28,9 @@
 
 namespace {
 
+// Prices requested within this time are served from the price table.
+constexpr base::TimeDelta kPriceTableTTL = base::Seconds(60);
+
 net::NetworkTrafficAnnotationTag GetNetworkTrafficAnnotationTag() {
   return net::DefineNetworkTrafficAnnotation("asset_ratio_service", R"(
       semantics {
@@ -351,21 +356,139 @@ void AssetRatioService::GetSellUrl(mojom::OffRampProvider provider,
   }
 }
 
+AssetRatioService::PriceEntry::PriceEntry() = default;
+AssetRatioService::PriceEntry::PriceEntry(mojom::AssetPricePtr price,
+                                          base::Time fetched_at)
+    : price(std::move(price)), fetched_at(fetched_at) {}
+AssetRatioService::PriceEntry::~PriceEntry() = default;
+AssetRatioService::PriceEntry::PriceEntry(PriceEntry&&) = default;
+AssetRatioService::PriceEntry& AssetRatioService::PriceEntry::operator=(
+    PriceEntry&&) = default;
+
+AssetRatioService::PriceRequest::PriceRequest() = default;
+AssetRatioService::PriceRequest::PriceRequest(
+    std::vector<std::string> from_assets,
+    std::vector<std::string> to_assets,
+    brave_wallet::mojom::AssetPriceTimeframe timeframe,
+    GetPriceCallback callback)
+    : from_assets(std::move(from_assets)),
+      to_assets(std::move(to_assets)),
+      timeframe(timeframe),
+      callback(std::move(callback)) {}
+AssetRatioService::PriceRequest::~PriceRequest() = default;
+AssetRatioService::PriceRequest::PriceRequest(PriceRequest&&) = default;
+AssetRatioService::PriceRequest& AssetRatioService::PriceRequest::operator=(
+    PriceRequest&&) = default;
+
 void AssetRatioService::GetPrice(
     const std::vector<std::string>& from_assets,
     const std::vector<std::string>& to_assets,
     brave_wallet::mojom::AssetPriceTimeframe timeframe,
     GetPriceCallback callback) {
-  std::vector<std::string> from_assets_lower = VectorToLowerCase(from_assets);
-  std::vector<std::string> to_assets_lower = VectorToLowerCase(to_assets);
-  auto internal_callback = base::BindOnce(
-      &AssetRatioService::OnGetPrice, weak_ptr_factory_.GetWeakPtr(),
-      from_assets_lower, to_assets_lower, std::move(callback));
+  PriceRequest request(VectorToLowerCase(from_assets),
+                       VectorToLowerCase(to_assets), timeframe,
+                       std::move(callback));
+  if (MaybeRunPriceRequest(request)) {
+    return;
+  }
 
-  api_request_helper_->Request(
-      "GET", GetPriceURL(from_assets_lower, to_assets_lower, timeframe), "", "",
-      std::move(internal_callback), MakeBraveServicesKeyHeader(),
-      {.auto_retry_on_network_change = true, .enable_cache = true});
+  // Requests made before the posted task runs share upstream requests.
+  pending_price_requests_.push_back(std::move(request));
+  if (!fetch_prices_scheduled_) {
+    fetch_prices_scheduled_ = true;
+    base::SequencedTaskRunner::GetCurrentDefault()->PostTask(
+        FROM_HERE, base::BindOnce(&AssetRatioService::FetchPrices,
+                                  weak_ptr_factory_.GetWeakPtr()));
+  }
+}
+
+bool AssetRatioService::IsFreshPrice(const PriceKey& key) const {
+  auto it = price_table_.find(key);
+  return it != price_table_.end() &&
+         base::Time::Now() - it->second.fetched_at < kPriceTableTTL;
+}
+
+bool AssetRatioService::MaybeRunPriceRequest(PriceRequest& request) {
+  bool all_fresh = true;
+  for (const auto& from_asset : request.from_assets) {
+    for (const auto& to_asset : request.to_assets) {
+      const PriceKey key(from_asset, to_asset, request.timeframe);
+      if (prices_in_flight_.contains(key)) {
+        return false;
+      }
+      all_fresh = all_fresh && IsFreshPrice(key);
+    }
+  }
+
+  if (!all_fresh && !request.fetch_started) {
+    return false;
+  }
+
+  std::vector<brave_wallet::mojom::AssetPricePtr> prices;
+  if (all_fresh) {
+    for (const auto& from_asset : request.from_assets) {
+      for (const auto& to_asset : request.to_assets) {
+        prices.push_back(
+            price_table_[PriceKey(from_asset, to_asset, request.timeframe)]
+                .price.Clone());
+      }
+    }
+  }
+  std::move(request.callback).Run(all_fresh, std::move(prices));
+  return true;
+}
+
+void AssetRatioService::FetchPrices() {
+  fetch_prices_scheduled_ = false;
+
+  // A single upstream request per timeframe covers the assets missing from
+  // the table.
+  std::map<brave_wallet::mojom::AssetPriceTimeframe,
+           std::pair<std::set<std::string>, std::set<std::string>>>
+      missing_assets;
+  for (auto& request : pending_price_requests_) {
+    if (request.fetch_started) {
+      continue;
+    }
+    request.fetch_started = true;
+    for (const auto& from_asset : request.from_assets) {
+      for (const auto& to_asset : request.to_assets) {
+        const PriceKey key(from_asset, to_asset, request.timeframe);
+        if (IsFreshPrice(key) || prices_in_flight_.contains(key)) {
+          continue;
+        }
+        auto& [from_assets, to_assets] = missing_assets[request.timeframe];
+        from_assets.insert(from_asset);
+        to_assets.insert(to_asset);
+      }
+    }
+  }
+
+  for (const auto& [timeframe, assets] : missing_assets) {
+    std::vector<std::string> from_assets(assets.first.begin(),
+                                         assets.first.end());
+    std::vector<std::string> to_assets(assets.second.begin(),
+                                       assets.second.end());
+    for (const auto& from_asset : from_assets) {
+      for (const auto& to_asset : to_assets) {
+        prices_in_flight_.insert(PriceKey(from_asset, to_asset, timeframe));
+      }
+    }
+
+    const GURL url = GetPriceURL(from_assets, to_assets, timeframe);
+    auto internal_callback = base::BindOnce(
+        &AssetRatioService::OnGetPrice, weak_ptr_factory_.GetWeakPtr(),
+        std::move(from_assets), std::move(to_assets), timeframe);
+    api_request_helper_->Request(
+        "GET", url, "", "", std::move(internal_callback),
+        MakeBraveServicesKeyHeader(),
+        {.auto_retry_on_network_change = true, .enable_cache = true});
+  }
+
+  // Requests whose prices turned out to be all in the table already.
+  base::EraseIf(pending_price_requests_, [this](PriceRequest& request) {
+    return MaybeRunPriceRequest(request);
+  });
 }
 
 void AssetRatioService::OnGetSardineAuthToken(
@@ -447,22 +570,40 @@ void AssetRatioService::OnGetStripeBuyURL(GetBuyUrlV1Callback callback,
   std::move(callback).Run(*url, absl::nullopt);
 }
 
-void AssetRatioService::OnGetPrice(std::vector<std::string> from_assets,
-                                   std::vector<std::string> to_assets,
-                                   GetPriceCallback callback,
-                                   APIRequestResult api_request_result) {
-  std::vector<brave_wallet::mojom::AssetPricePtr> prices;
-  if (!api_request_result.Is2XXResponseCode()) {
-    std::move(callback).Run(false, std::move(prices));
-    return;
-  }
-  if (!ParseAssetPrice(api_request_result.value_body(), from_assets, to_assets,
-                       &prices)) {
-    std::move(callback).Run(false, std::move(prices));
-    return;
+void AssetRatioService::OnGetPrice(
+    std::vector<std::string> from_assets,
+    std::vector<std::string> to_assets,
+    brave_wallet::mojom::AssetPriceTimeframe timeframe,
+    APIRequestResult api_request_result) {
+  const base::Time now = base::Time::Now();
+  base::EraseIf(price_table_, [now](const auto& entry) {
+    return now - entry.second.fetched_at >= kPriceTableTTL;
+  });
+
+  for (const auto& from_asset : from_assets) {
+    for (const auto& to_asset : to_assets) {
+      const PriceKey key(from_asset, to_asset, timeframe);
+      prices_in_flight_.erase(key);
+      if (!api_request_result.Is2XXResponseCode()) {
+        continue;
+      }
+
+      // Prices are parsed one by one, so that an asset unknown upstream only
+      // fails the requests which asked for it.
+      std::vector<brave_wallet::mojom::AssetPricePtr> prices;
+      if (!ParseAssetPrice(api_request_result.value_body(), {from_asset},
+                           {to_asset}, &prices) ||
+          prices.size() != 1u) {
+        continue;
+      }
+      price_table_.insert_or_assign(key,
+                                    PriceEntry(std::move(prices[0]), now));
+    }
   }
 
-  std::move(callback).Run(true, std::move(prices));
+  base::EraseIf(pending_price_requests_, [this](PriceRequest& request) {
+    return MaybeRunPriceRequest(request);
+  });
 }
 
 void AssetRatioService::GetPriceHistory(
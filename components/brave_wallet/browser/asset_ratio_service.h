@@ -6,8 +6,11 @@
 #ifndef BRAVE_COMPONENTS_BRAVE_WALLET_BROWSER_ASSET_RATIO_SERVICE_H_
 #define BRAVE_COMPONENTS_BRAVE_WALLET_BROWSER_ASSET_RATIO_SERVICE_H_
 
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include "base/containers/flat_map.h"
@@ -123,9 +126,48 @@ class AssetRatioService : public KeyedService, public mojom::AssetRatioService {
   void OnGetStripeBuyURL(GetBuyUrlV1Callback callback,
                          APIRequestResult api_request_result);
 
+  // <from_asset, to_asset, timeframe>
+  using PriceKey = std::tuple<std::string,
+                              std::string,
+                              brave_wallet::mojom::AssetPriceTimeframe>;
+
+  struct PriceEntry {
+    PriceEntry();
+    PriceEntry(mojom::AssetPricePtr price, base::Time fetched_at);
+    ~PriceEntry();
+    PriceEntry(PriceEntry&&);
+    PriceEntry& operator=(PriceEntry&&);
+
+    mojom::AssetPricePtr price;
+    base::Time fetched_at;
+  };
+
+  struct PriceRequest {
+    PriceRequest();
+    PriceRequest(std::vector<std::string> from_assets,
+                 std::vector<std::string> to_assets,
+                 brave_wallet::mojom::AssetPriceTimeframe timeframe,
+                 GetPriceCallback callback);
+    ~PriceRequest();
+    PriceRequest(PriceRequest&&);
+    PriceRequest& operator=(PriceRequest&&);
+
+    std::vector<std::string> from_assets;
+    std::vector<std::string> to_assets;
+    brave_wallet::mojom::AssetPriceTimeframe timeframe;
+    GetPriceCallback callback;
+    // Whether the prices missing from the table were requested.
+    bool fetch_started = false;
+  };
+
+  // Answers |request| from the price table once none of its prices are being
+  // fetched anymore. Returns false if it has to wait.
+  bool MaybeRunPriceRequest(PriceRequest& request);
+  bool IsFreshPrice(const PriceKey& key) const;
+  void FetchPrices();
   void OnGetPrice(std::vector<std::string> from_assets,
                   std::vector<std::string> to_assets,
-                  GetPriceCallback callback,
+                  brave_wallet::mojom::AssetPriceTimeframe timeframe,
                   APIRequestResult api_request_result);
   void OnGetPriceHistory(GetPriceHistoryCallback callback,
                          APIRequestResult api_request_result);
@@ -138,6 +180,14 @@ class AssetRatioService : public KeyedService, public mojom::AssetRatioService {
 
   mojo::ReceiverSet<mojom::AssetRatioService> receivers_;
 
+  // Prices of recent GetPrice calls, shared by all callers.
+  std::map<PriceKey, PriceEntry> price_table_;
+  // Prices requested upstream and not received yet.
+  std::set<PriceKey> prices_in_flight_;
+  // GetPrice calls waiting for prices which are not in the table.
+  std::vector<PriceRequest> pending_price_requests_;
+  bool fetch_prices_scheduled_ = false;
+
   static GURL base_url_for_test_;
   std::unique_ptr<api_request_helper::APIRequestHelper> api_request_helper_;
   base::WeakPtrFactory<AssetRatioService> weak_ptr_factory_;
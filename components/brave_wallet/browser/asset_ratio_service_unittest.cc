@@ -4,8 +4,12 @@
  * You can obtain one at https://mozilla.org/MPL/2.0/. */
 
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
+#include "base/json/json_writer.h"
+#include "base/strings/string_split.h"
 #include "base/test/bind.h"
 #include "base/test/task_environment.h"
 #include "brave/components/brave_wallet/browser/asset_ratio_service.h"
@@ -90,6 +94,61 @@ class AssetRatioServiceUnitTest : public testing::Test {
         }));
   }
 
+  // Records price requests, and answers them with prices for whichever
+  // assets they ask for unless |answer| is false.
+  void SetPriceInterceptor(bool answer = true) {
+    price_requests_.clear();
+    url_loader_factory_.SetInterceptor(base::BindLambdaForTesting(
+        [&, answer](const network::ResourceRequest& request) {
+          url_loader_factory_.ClearResponses();
+          price_requests_.push_back(request.url);
+          if (answer) {
+            AnswerPriceRequest(request.url);
+          }
+        }));
+  }
+
+  void AnswerPriceRequest(const GURL& url) {
+    // /v2/relative/provider/coingecko/<from>/<to>/<timeframe>
+    const std::vector<std::string> path =
+        base::SplitString(url.path(), "/", base::KEEP_WHITESPACE,
+                          base::SPLIT_WANT_NONEMPTY);
+    ASSERT_EQ(path.size(), 7u);
+    base::Value::Dict payload;
+    for (const auto& from_asset :
+         base::SplitString(path[4], ",", base::KEEP_WHITESPACE,
+                           base::SPLIT_WANT_NONEMPTY)) {
+      base::Value::Dict prices;
+      for (const auto& to_asset :
+           base::SplitString(path[5], ",", base::KEEP_WHITESPACE,
+                             base::SPLIT_WANT_NONEMPTY)) {
+        prices.Set(to_asset, 1.5);
+        prices.Set(to_asset + "_timeframe_change", 0.5);
+      }
+      payload.Set(from_asset, std::move(prices));
+    }
+    base::Value::Dict response;
+    response.Set("payload", std::move(payload));
+    std::string content;
+    base::JSONWriter::Write(response, &content);
+    url_loader_factory_.AddResponse(url.spec(), content);
+  }
+
+  // Runs GetPrice and returns the number of prices it answered with, or
+  // nothing on failure. The callback is expected to run once |run_loop| runs.
+  void GetPrice(const std::vector<std::string>& from_assets,
+                const std::vector<std::string>& to_assets,
+                absl::optional<size_t>* result) {
+    asset_ratio_service_->GetPrice(
+        from_assets, to_assets, mojom::AssetPriceTimeframe::OneDay,
+        base::BindLambdaForTesting(
+            [result](bool success,
+                     std::vector<mojom::AssetPricePtr> values) {
+              *result = success ? absl::make_optional(values.size())
+                                : absl::nullopt;
+            }));
+  }
+
   void GetTokenInfo(const std::string& contract_address,
                     mojom::BlockchainTokenPtr expected_token) {
     base::RunLoop run_loop;
@@ -146,6 +205,7 @@ class AssetRatioServiceUnitTest : public testing::Test {
 
  protected:
   std::unique_ptr<AssetRatioService> asset_ratio_service_;
+  std::vector<GURL> price_requests_;
 
  private:
   base::test::TaskEnvironment task_environment_;
@@ -319,6 +379,63 @@ TEST_F(AssetRatioServiceUnitTest, GetPriceUnexpectedResponse) {
   EXPECT_TRUE(callback_run);
 }
 
+TEST_F(AssetRatioServiceUnitTest, GetPriceCoalescesRequests) {
+  SetPriceInterceptor();
+
+  // Every panel asking for the prices of its assets at once is served by a
+  // single upstream request.
+  constexpr size_t kCallers = 50;
+  std::vector<absl::optional<size_t>> results(kCallers);
+  for (size_t i = 0; i < kCallers; ++i) {
+    GetPrice({"bat", i % 2 ? "eth" : "link"}, {"usd", "btc"}, &results[i]);
+  }
+  base::RunLoop().RunUntilIdle();
+  for (const auto& result : results) {
+    EXPECT_EQ(result, 4u);
+  }
+  ASSERT_EQ(price_requests_.size(), 1u);
+  EXPECT_EQ(price_requests_[0].path(),
+            "/v2/relative/provider/coingecko/bat,eth,link/btc,usd/1d");
+
+  // Fresh prices are answered from the table.
+  absl::optional<size_t> result;
+  GetPrice({"BAT", "eth"}, {"usd"}, &result);
+  EXPECT_EQ(result, 2u);
+  EXPECT_EQ(price_requests_.size(), 1u);
+
+  // Only the missing prices are requested.
+  result.reset();
+  GetPrice({"bat", "sol"}, {"usd"}, &result);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(result, 2u);
+  ASSERT_EQ(price_requests_.size(), 2u);
+  EXPECT_EQ(price_requests_[1].path(),
+            "/v2/relative/provider/coingecko/sol/usd/1d");
+}
+
+TEST_F(AssetRatioServiceUnitTest, GetPriceJoinsRequestInFlight) {
+  SetPriceInterceptor(/*answer=*/false);
+
+  absl::optional<size_t> first_result;
+  GetPrice({"bat"}, {"usd"}, &first_result);
+  base::RunLoop().RunUntilIdle();
+  ASSERT_EQ(price_requests_.size(), 1u);
+
+  // Waits for the request in flight instead of sending another one.
+  absl::optional<size_t> second_result;
+  GetPrice({"bat"}, {"usd"}, &second_result);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(price_requests_.size(), 1u);
+  EXPECT_FALSE(first_result);
+  EXPECT_FALSE(second_result);
+
+  AnswerPriceRequest(price_requests_[0]);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(first_result, 1u);
+  EXPECT_EQ(second_result, 1u);
+  EXPECT_EQ(price_requests_.size(), 1u);
+}
+
 TEST_F(AssetRatioServiceUnitTest, GetPriceHistory) {
   SetInterceptor(R"({
       "payload": {
@@ -49,6 +49,29 @@ absl::optional<std::vector<uint8_t>> BitcoinKeyring::SignMessage(
   return hd_key->SignDer(message);
 }
 
+absl::optional<std::vector<std::vector<uint8_t>>> BitcoinKeyring::SignMessages(
+    const mojom::BitcoinKeyId& key_id,
+    const std::vector<SHA256HashArray>& messages) {
+  auto hd_key_base = DeriveKey(key_id);
+  if (!hd_key_base) {
+    return absl::nullopt;
+  }
+
+  auto* hd_key = static_cast<HDKey*>(hd_key_base.get());
+
+  std::vector<std::vector<uint8_t>> signatures;
+  signatures.reserve(messages.size());
+  for (const auto& message : messages) {
+    auto signature = hd_key->SignDer(message);
+    if (!signature) {
+      return absl::nullopt;
+    }
+    signatures.push_back(std::move(*signature));
+  }
+
+  return signatures;
+}
+
 std::string BitcoinKeyring::GetAddressInternal(HDKeyBase* hd_key_base) const {
   if (!hd_key_base) {
     return std::string();
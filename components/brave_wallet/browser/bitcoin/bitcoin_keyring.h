@@ -12,6 +12,7 @@
 
 #include "brave/components/brave_wallet/browser/hd_keyring.h"
 #include "brave/components/brave_wallet/common/brave_wallet.mojom.h"
+#include "brave/components/brave_wallet/common/hash_utils.h"
 
 namespace brave_wallet {
 
@@ -31,6 +32,11 @@ class BitcoinKeyring : public HDKeyring {
       const mojom::BitcoinKeyId& key_id,
       base::span<const uint8_t, 32> message);
 
+  // Same as SignMessage, but derives the key only once for all |messages|.
+  absl::optional<std::vector<std::vector<uint8_t>>> SignMessages(
+      const mojom::BitcoinKeyId& key_id,
+      const std::vector<SHA256HashArray>& messages);
+
  private:
   std::string GetAddressInternal(HDKeyBase* hd_key_base) const override;
   std::unique_ptr<HDKeyBase> DeriveAccount(uint32_t index) const override;
@@ -7,6 +7,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "base/strings/string_number_conversions.h"
 #include "brave/components/brave_wallet/browser/brave_wallet_utils.h"
@@ -137,4 +138,25 @@ TEST(BitcoinKeyringUnitTest, SignBitcoinMessage) {
   // TODO(apaymyshev): make test
 }
 
+TEST(BitcoinKeyringUnitTest, SignMessages) {
+  BitcoinKeyring keyring(false);
+  keyring.ConstructRootHDKey(*MnemonicToSeed(kBip84TestMnemonic, ""),
+                             "m/84'/0'");
+
+  std::vector<SHA256HashArray> messages(3);
+  messages[0].fill(0x01);
+  messages[1].fill(0x02);
+  messages[2].fill(0x03);
+
+  auto signatures = keyring.SignMessages(BitcoinKeyId(0, 1, 2), messages);
+  ASSERT_TRUE(signatures);
+  ASSERT_EQ(signatures->size(), messages.size());
+  for (size_t i = 0; i < messages.size(); ++i) {
+    EXPECT_EQ((*signatures)[i],
+              *keyring.SignMessage(BitcoinKeyId(0, 1, 2), messages[i]));
+  }
+
+  EXPECT_EQ(keyring.SignMessages(BitcoinKeyId(0, 1, 2), {})->size(), 0u);
+}
+
 }  // namespace brave_wallet
@@ -184,9 +184,27 @@ void BitcoinSerializerStream::PushBytesReversed(
   to().insert(to().end(), bytes.rbegin(), bytes.rend());
 }
 
+// static
+BitcoinSigHashMidstate BitcoinSerializer::ComputeSigHashMidstate(
+    const BitcoinTransaction& tx) {
+  BitcoinSigHashMidstate midstate;
+  midstate.hash_prevouts = HashPrevouts(tx);
+  midstate.hash_sequence = HashSequence(tx);
+  midstate.hash_outputs = HashOutputs(tx);
+  return midstate;
+}
+
+// static
+absl::optional<SHA256HashArray> BitcoinSerializer::SerializeInputForSign(
+    const BitcoinTransaction& tx,
+    size_t input_index) {
+  return SerializeInputForSign(tx, ComputeSigHashMidstate(tx), input_index);
+}
+
 // static
 absl::optional<SHA256HashArray> BitcoinSerializer::SerializeInputForSign(
     const BitcoinTransaction& tx,
+    const BitcoinSigHashMidstate& midstate,
     size_t input_index) {
   CHECK_LT(input_index, tx.inputs().size());
   auto& input = tx.inputs()[input_index];
@@ -198,18 +216,19 @@ absl::optional<SHA256HashArray> BitcoinSerializer::SerializeInputForSign(
   std::vector<uint8_t> data;
   BitcoinSerializerStream stream(data);
   // https://github.com/bitcoin/bips/blob/master/bip-0143.mediawiki#specification
-  stream.Push32AsLE(2);                // 1.
-  stream.PushBytes(HashPrevouts(tx));  // 2.
-  stream.PushBytes(HashSequence(tx));  // 3.
+  stream.Push32AsLE(2);                      // 1.
+  stream.PushBytes(midstate.hash_prevouts);  // 2.
+  stream.PushBytes(midstate.hash_sequence);  // 3.
 
   PushOutpoint(input.utxo_outpoint, stream);            // 4
   PushScriptCodeForSigninig(*decoded_address, stream);  // 5.
   stream.Push64AsLE(input.utxo_value);                  // 6.
   stream.Push32AsLE(input.n_sequence());                // 7.
 
-  stream.PushBytes(HashOutputs(tx));     // 8.
-  stream.Push32AsLE(tx.locktime());      // 9.
-  stream.Push32AsLE(tx.sighash_type());  // 10.  1 byte but serialized as 4 LE.
+  stream.PushBytes(midstate.hash_outputs);  // 8.
+  stream.Push32AsLE(tx.locktime());         // 9.
+  // 10. 1 byte but serialized as 4 LE.
+  stream.Push32AsLE(tx.sighash_type());
 
   return DoubleSHA256Hash(data);
 }
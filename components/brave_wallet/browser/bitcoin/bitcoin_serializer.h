@@ -35,11 +35,28 @@ class BitcoinSerializerStream {
   raw_ref<std::vector<uint8_t>> to_;
 };
 
+// Parts of the BIP143 signature hash preimage which are the same for every
+// input of a transaction.
+struct BitcoinSigHashMidstate {
+  SHA256HashArray hash_prevouts = {};
+  SHA256HashArray hash_sequence = {};
+  SHA256HashArray hash_outputs = {};
+};
+
 // TODO(apaymyshev): test with reference test vectors.
 class BitcoinSerializer {
  public:
+  // Computing the midstate once per transaction keeps signing all inputs
+  // linear in the number of inputs.
+  static BitcoinSigHashMidstate ComputeSigHashMidstate(
+      const BitcoinTransaction& tx);
+
+  static absl::optional<SHA256HashArray> SerializeInputForSign(
+      const BitcoinTransaction& tx,
+      size_t input_index);
   static absl::optional<SHA256HashArray> SerializeInputForSign(
       const BitcoinTransaction& tx,
+      const BitcoinSigHashMidstate& midstate,
       size_t input_index);
 
   static std::vector<uint8_t> SerializeWitness(
@@ -21,6 +21,35 @@ const char kTxid2[] =
 const char kAddress1[] = "tb1qya3rarek59486w345v45tv6nra4fy2xxgky26x";
 const char kAddress2[] = "tb1qva8clyftt2fstawn5dy0nvrfmygpzulf3lwulm";
 
+// Inputs of the native P2WPKH example of
+// https://github.com/bitcoin/bips/blob/master/bip-0143.mediawiki#example
+const char kBip143Txid1[] =
+    "9f96ade4b41d5433f4eda31e1738ec2b36f6e7d1420d94a6af99801a88f7f7ff";
+const char kBip143Txid2[] =
+    "8ac60eb9575db5b2d987e29f301b5b819ea83a5c6579d282d189cc04b8e151ef";
+
+BitcoinTransaction MakeTransaction(size_t inputs_count) {
+  BitcoinTransaction tx;
+  for (size_t i = 0; i < inputs_count; ++i) {
+    auto& input = tx.inputs().emplace_back();
+    input.utxo_address = i % 2 ? kAddress2 : kAddress1;
+    input.utxo_outpoint.index = i;
+    base::HexStringToSpan(i % 2 ? kTxid2 : kTxid1, input.utxo_outpoint.txid);
+    input.utxo_value = 1000 + i;
+  }
+
+  auto& output1 = tx.outputs().emplace_back();
+  output1.address = kAddress1;
+  output1.amount = 5;
+
+  auto& output2 = tx.outputs().emplace_back();
+  output2.address = kAddress2;
+  output2.amount = 50;
+
+  tx.set_locktime(777);
+  return tx;
+}
+
 }  // namespace
 
 TEST(BitcoinSerializerStream, Push8AsLE) {
@@ -171,6 +200,46 @@ TEST(BitcoinSerializer, SerializeInputForSign) {
   EXPECT_FALSE(BitcoinSerializer::SerializeInputForSign(tx, 0));
 }
 
+TEST(BitcoinSerializer, ComputeSigHashMidstate) {
+  BitcoinTransaction tx;
+
+  auto& input1 = tx.inputs().emplace_back();
+  input1.utxo_address = kAddress1;
+  input1.utxo_outpoint.index = 0;
+  base::HexStringToSpan(kBip143Txid1, input1.utxo_outpoint.txid);
+
+  auto& input2 = tx.inputs().emplace_back();
+  input2.utxo_address = kAddress2;
+  input2.utxo_outpoint.index = 1;
+  base::HexStringToSpan(kBip143Txid2, input2.utxo_outpoint.txid);
+
+  auto& output = tx.outputs().emplace_back();
+  output.address = kAddress1;
+  output.amount = 5;
+
+  // Only hashPrevouts of the BIP143 example can be checked, as the example
+  // uses sequence numbers and P2PKH outputs which are not supported here.
+  EXPECT_EQ(
+      base::HexEncode(
+          BitcoinSerializer::ComputeSigHashMidstate(tx).hash_prevouts),
+      "96B827C8483D4E9B96712B6713A7B68D6E8003A781FEBA36C31143470B4EFD37");
+}
+
+TEST(BitcoinSerializer, SerializeInputForSignWithMidstate) {
+  auto tx = MakeTransaction(500);
+
+  const auto midstate = BitcoinSerializer::ComputeSigHashMidstate(tx);
+  for (size_t i = 0; i < tx.inputs().size(); ++i) {
+    auto hash = BitcoinSerializer::SerializeInputForSign(tx, midstate, i);
+    ASSERT_TRUE(hash);
+    EXPECT_EQ(*hash, *BitcoinSerializer::SerializeInputForSign(tx, i));
+  }
+
+  // Inputs sharing the midstate still get their own hashes.
+  EXPECT_NE(*BitcoinSerializer::SerializeInputForSign(tx, midstate, 0),
+            *BitcoinSerializer::SerializeInputForSign(tx, midstate, 2));
+}
+
 TEST(BitcoinSerializer, SerializeWitness) {
   std::vector<uint8_t> signature = {0, 1, 2, 3};
   std::vector<uint8_t> pubkey = {0xaa, 0xbb, 0xcc, 0xdd};
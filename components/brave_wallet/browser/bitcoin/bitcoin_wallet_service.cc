@@ -6,9 +6,12 @@
 #include "brave/components/brave_wallet/browser/bitcoin/bitcoin_wallet_service.h"
 
 #include <stdint.h>
+#include <algorithm>
 #include <deque>
 #include <map>
 #include <set>
+#include <string>
+#include <vector>
 
 #include "base/check.h"
 #include "base/functional/bind.h"
@@ -27,6 +30,10 @@ namespace brave_wallet {
 
 namespace {
 
+// Caches are kept per chain. Gap addresses of every account are queried on
+// each refresh, so the number of cached addresses is bounded.
+constexpr size_t kMaxCachedAddresses = 1000;
+
 bool OutputAddressSupported(const std::string& address, bool is_testnet) {
   auto decoded_address = DecodeBitcoinAddress(address);
   if (!decoded_address) {
@@ -54,24 +61,61 @@ uint64_t GetChainBalance(const bitcoin_rpc::AddressChainStats& chain_stats) {
   return base::ClampSub(funded, spent);
 }
 
+uint64_t GetTxCount(const bitcoin_rpc::AddressChainStats& chain_stats) {
+  uint64_t tx_count = 0;
+  if (!base::StringToUint64(chain_stats.tx_count, &tx_count)) {
+    return 0;
+  }
+  return tx_count;
+}
+
+bool IsAddressUsed(const bitcoin_rpc::AddressStats& stats) {
+  return GetTxCount(stats.chain_stats) || GetTxCount(stats.mempool_stats);
+}
+
+// Addresses which have never received more than they have spent have no
+// outputs to list.
+bool MayHaveUnspentOutputs(const bitcoin_rpc::AddressStats& stats) {
+  uint64_t funded = 0;
+  uint64_t spent = 0;
+  for (const auto* chain_stats : {&stats.chain_stats, &stats.mempool_stats}) {
+    uint64_t value = 0;
+    if (!base::StringToUint64(chain_stats->funded_txo_sum, &value)) {
+      return true;
+    }
+    funded += value;
+    if (!base::StringToUint64(chain_stats->spent_txo_sum, &value)) {
+      return true;
+    }
+    spent += value;
+  }
+  return funded > spent;
+}
+
+bool HaveSameTransactions(const bitcoin_rpc::AddressStats& stats1,
+                          const bitcoin_rpc::AddressStats& stats2) {
+  return stats1.chain_stats.tx_count == stats2.chain_stats.tx_count &&
+         stats1.mempool_stats.tx_count == stats2.mempool_stats.tx_count;
+}
+
 }  // namespace
 
-class GetBalanceContext : public base::RefCountedThreadSafe<GetBalanceContext> {
+class UpdateAddressStatsContext
+    : public base::RefCountedThreadSafe<UpdateAddressStatsContext> {
  public:
-  using GetBalanceCallback = mojom::BitcoinWalletService::GetBalanceCallback;
-
-  std::set<std::string> addresses;
-  std::map<std::string, uint64_t> balances;
+  std::string chain_id;
+  mojom::AccountIdPtr account_id;
+  absl::optional<uint32_t> chain_height;
+  std::set<std::string> pending_addresses;
+  BitcoinWalletService::AddressStatsMap address_stats;
   absl::optional<std::string> error;
-  GetBalanceCallback callback;
-
-  bool ShouldRespond() { return callback && (error || addresses.empty()); }
+  BitcoinWalletService::UpdateAddressStatsCallback callback;
 
   void SetError(const std::string& error_string) { error = error_string; }
 
  protected:
-  friend class base::RefCountedThreadSafe<GetBalanceContext>;
-  virtual ~GetBalanceContext() = default;
+  friend class base::RefCountedThreadSafe<UpdateAddressStatsContext>;
+  virtual ~UpdateAddressStatsContext() = default;
 };
 
 class GetUtxosContext : public base::RefCountedThreadSafe<GetUtxosContext> {
@@ -303,7 +347,10 @@ BitcoinWalletService::BitcoinWalletService(
     : keyring_service_(keyring_service),
       bitcoin_rpc_(
           std::make_unique<bitcoin_rpc::BitcoinRpc>(prefs,
-                                                    url_loader_factory)) {}
+                                                    url_loader_factory)) {
+  keyring_service_->AddObserver(
+      keyring_observer_receiver_.BindNewPipeAndPassRemote());
+}
 
 BitcoinWalletService::~BitcoinWalletService() = default;
 
@@ -319,6 +366,19 @@ void BitcoinWalletService::Bind(
   receivers_.Add(this, std::move(receiver));
 }
 
+void BitcoinWalletService::KeyringReset() {
+  ClearCaches();
+}
+
+void BitcoinWalletService::Locked() {
+  ClearCaches();
+}
+
+void BitcoinWalletService::ClearCaches() {
+  address_stats_cache_.clear();
+  utxos_cache_.clear();
+}
+
 void BitcoinWalletService::GetBalance(const std::string& chain_id,
                                       mojom::AccountIdPtr account_id,
                                       GetBalanceCallback callback) {
@@ -328,24 +388,10 @@ void BitcoinWalletService::GetBalance(const std::string& chain_id,
     return;
   }
 
-  const auto& addresses = keyring_service_->GetBitcoinAddresses(*account_id);
-  if (!addresses) {
-    std::move(callback).Run(nullptr, "Couldn't get balance");
-    return;
-  }
-
-  auto context = base::MakeRefCounted<GetBalanceContext>();
-  context->callback = std::move(callback);
-  for (const auto& address : addresses.value()) {
-    context->addresses.insert(address.first);
-  }
-
-  for (const auto& address : addresses.value()) {
-    bitcoin_rpc_->GetAddressStats(
-        chain_id, address.first,
-        base::BindOnce(&BitcoinWalletService::OnGetAddressStatsForBalance,
-                       weak_ptr_factory_.GetWeakPtr(), context, address.first));
-  }
+  UpdateAddressStats(
+      chain_id, std::move(account_id),
+      base::BindOnce(&BitcoinWalletService::OnUpdateAddressStatsForBalance,
+                     weak_ptr_factory_.GetWeakPtr(), std::move(callback)));
 }
 
 void BitcoinWalletService::GetBitcoinAccountInfo(
@@ -400,82 +446,258 @@ void BitcoinWalletService::SendTo(const std::string& chain_id,
   std::move(callback).Run("", "Not implemented");
 }
 
-void BitcoinWalletService::OnGetAddressStatsForBalance(
-    scoped_refptr<GetBalanceContext> context,
+void BitcoinWalletService::UpdateAddressStats(
+    const std::string& chain_id,
+    mojom::AccountIdPtr account_id,
+    UpdateAddressStatsCallback callback) {
+  auto context = base::MakeRefCounted<UpdateAddressStatsContext>();
+  context->chain_id = chain_id;
+  context->account_id = std::move(account_id);
+  context->callback = std::move(callback);
+
+  bitcoin_rpc_->GetChainHeight(
+      chain_id,
+      base::BindOnce(&BitcoinWalletService::OnGetChainHeightForAddressStats,
+                     weak_ptr_factory_.GetWeakPtr(), std::move(context)));
+}
+
+void BitcoinWalletService::OnGetChainHeightForAddressStats(
+    scoped_refptr<UpdateAddressStatsContext> context,
+    base::expected<uint32_t, std::string> chain_height) {
+  if (!chain_height.has_value()) {
+    context->SetError(chain_height.error());
+    WorkOnUpdateAddressStats(std::move(context));
+    return;
+  }
+
+  context->chain_height = chain_height.value();
+  WorkOnUpdateAddressStats(std::move(context));
+}
+
+void BitcoinWalletService::OnGetAddressStats(
+    scoped_refptr<UpdateAddressStatsContext> context,
     std::string address,
     base::expected<bitcoin_rpc::AddressStats, std::string> stats) {
-  DCHECK(context->addresses.contains(address));
-  DCHECK(!context->balances.contains(address));
+  DCHECK(context->pending_addresses.contains(address));
 
   if (!stats.has_value()) {
     context->SetError(stats.error());
-    WorkOnGetBalance(std::move(context));
+    WorkOnUpdateAddressStats(std::move(context));
     return;
   }
 
-  context->addresses.erase(address);
-  auto chain_balance = GetChainBalance(stats->chain_stats);
-  // TODO(apaymyshev): should show only confirmed balance?
-  auto mempool_balance = GetChainBalance(stats->mempool_stats);
-  context->balances[address] = chain_balance + mempool_balance;
-  WorkOnGetBalance(std::move(context));
+  CachedAddressStats cached;
+  cached.stats = stats.value();
+  cached.chain_height = *context->chain_height;
+  GetAddressStatsCache(context->chain_id).Put(address, std::move(cached));
+
+  context->pending_addresses.erase(address);
+  context->address_stats[address] = std::move(stats.value());
+  WorkOnUpdateAddressStats(std::move(context));
 }
 
-void BitcoinWalletService::WorkOnGetBalance(
-    scoped_refptr<GetBalanceContext> context) {
-  if (!context->ShouldRespond()) {
+void BitcoinWalletService::WorkOnUpdateAddressStats(
+    scoped_refptr<UpdateAddressStatsContext> context) {
+  if (!context->callback) {
     return;
   }
 
   if (context->error) {
-    std::move(context->callback).Run(nullptr, std::move(*context->error));
+    std::move(context->callback).Run(base::unexpected(*context->error));
     return;
   }
 
-  auto result = mojom::BitcoinBalance::New();
-  for (auto& balance : context->balances) {
-    result->total_balance += balance.second;
+  if (!context->pending_addresses.empty()) {
+    return;
+  }
+
+  const auto& addresses =
+      keyring_service_->GetBitcoinAddresses(*context->account_id);
+  if (!addresses) {
+    std::move(context->callback).Run(base::unexpected("Couldn't get balance"));
+    return;
   }
-  result->balances.insert(context->balances.begin(), context->balances.end());
-  std::move(context->callback).Run(std::move(result), absl::nullopt);
+
+  for (const auto& address : addresses.value()) {
+    if (context->address_stats.contains(address.first)) {
+      continue;
+    }
+    if (const auto* cached = GetCachedAddressStats(
+            context->chain_id, address.first, *context->chain_height)) {
+      context->address_stats[address.first] = *cached;
+      continue;
+    }
+    context->pending_addresses.insert(address.first);
+  }
+
+  if (!context->pending_addresses.empty()) {
+    // Copied as a failing request may respond synchronously.
+    const auto pending_addresses = context->pending_addresses;
+    for (const auto& address : pending_addresses) {
+      bitcoin_rpc_->GetAddressStats(
+          context->chain_id, address,
+          base::BindOnce(&BitcoinWalletService::OnGetAddressStats,
+                         weak_ptr_factory_.GetWeakPtr(), context, address));
+    }
+    return;
+  }
+
+  // Stats of all addresses are known. Used addresses past the known ones
+  // move the gap forward, so the addresses after them need to be checked.
+  std::map<uint32_t, uint32_t> next_indexes;
+  for (const auto& address : addresses.value()) {
+    if (IsAddressUsed(context->address_stats.at(address.first))) {
+      auto& next_index = next_indexes[address.second->change];
+      next_index = std::max(next_index, address.second->index + 1);
+    }
+  }
+
+  bool discovered = false;
+  for (const auto& [change, next_index] : next_indexes) {
+    if (next_index > keyring_service_->GetBitcoinNextAddressIndex(
+                         *context->account_id, change)) {
+      keyring_service_->UpdateBitcoinNextAddressIndex(*context->account_id,
+                                                      change, next_index);
+      discovered = true;
+    }
+  }
+  if (discovered) {
+    WorkOnUpdateAddressStats(std::move(context));
+    return;
+  }
+
+  AddressStatsMap result;
+  for (const auto& address : addresses.value()) {
+    result[address.first] = context->address_stats.at(address.first);
+  }
+  std::move(context->callback).Run(base::ok(std::move(result)));
+}
+
+const bitcoin_rpc::AddressStats* BitcoinWalletService::GetCachedAddressStats(
+    const std::string& chain_id,
+    const std::string& address,
+    uint32_t chain_height) {
+  auto& cache = GetAddressStatsCache(chain_id);
+  auto it = cache.Get(address);
+  if (it == cache.end()) {
+    return nullptr;
+  }
+
+  // Chain stats only change with new blocks. Unused addresses are where
+  // payments are expected and addresses with mempool transactions are about
+  // to change, so these are always queried. A mempool payment to a used
+  // address without other pending transactions shows up with the next block.
+  const auto& cached = it->second;
+  if (cached.chain_height != chain_height ||
+      !GetTxCount(cached.stats.chain_stats) ||
+      GetTxCount(cached.stats.mempool_stats)) {
+    return nullptr;
+  }
+
+  return &cached.stats;
+}
+
+BitcoinWalletService::AddressStatsCache&
+BitcoinWalletService::GetAddressStatsCache(const std::string& chain_id) {
+  return address_stats_cache_.try_emplace(chain_id, kMaxCachedAddresses)
+      .first->second;
+}
+
+BitcoinWalletService::UtxosCache& BitcoinWalletService::GetUtxosCache(
+    const std::string& chain_id) {
+  return utxos_cache_.try_emplace(chain_id, kMaxCachedAddresses)
+      .first->second;
+}
+
+void BitcoinWalletService::OnUpdateAddressStatsForBalance(
+    GetBalanceCallback callback,
+    base::expected<AddressStatsMap, std::string> address_stats) {
+  if (!address_stats.has_value()) {
+    std::move(callback).Run(nullptr, address_stats.error());
+    return;
+  }
+
+  auto result = mojom::BitcoinBalance::New();
+  for (const auto& [address, stats] : address_stats.value()) {
+    auto chain_balance = GetChainBalance(stats.chain_stats);
+    // TODO(apaymyshev): should show only confirmed balance?
+    auto mempool_balance = GetChainBalance(stats.mempool_stats);
+    result->balances[address] = chain_balance + mempool_balance;
+    result->total_balance += chain_balance + mempool_balance;
+  }
+  std::move(callback).Run(std::move(result), absl::nullopt);
 }
 
 absl::optional<std::string> BitcoinWalletService::GetUnusedChangeAddress(
     const mojom::AccountId& account_id) {
   CHECK(IsBitcoinAccount(account_id));
-  // TODO(apaymyshev): this always returns first change address. Should return
-  // first unused change address.
   return keyring_service_->GetBitcoinAddress(
-      account_id, mojom::BitcoinKeyId(account_id.bitcoin_account_index, 1, 0));
+      account_id,
+      mojom::BitcoinKeyId(account_id.bitcoin_account_index, kBitcoinChangeIndex,
+                          keyring_service_->GetBitcoinNextAddressIndex(
+                              account_id, kBitcoinChangeIndex)));
 }
 
 void BitcoinWalletService::GetUtxos(const std::string& chain_id,
                                     mojom::AccountIdPtr account_id,
                                     GetUtxosCallback callback) {
-  const auto& addresses = keyring_service_->GetBitcoinAddresses(*account_id);
-  if (!addresses) {
-    NOTREACHED();
-    std::move(callback).Run(base::unexpected("Couldn't get balance"));
+  UpdateAddressStats(
+      chain_id, std::move(account_id),
+      base::BindOnce(&BitcoinWalletService::OnUpdateAddressStatsForUtxos,
+                     weak_ptr_factory_.GetWeakPtr(), chain_id,
+                     std::move(callback)));
+}
+
+void BitcoinWalletService::OnUpdateAddressStatsForUtxos(
+    const std::string& chain_id,
+    GetUtxosCallback callback,
+    base::expected<AddressStatsMap, std::string> address_stats) {
+  if (!address_stats.has_value()) {
+    std::move(callback).Run(base::unexpected(address_stats.error()));
     return;
   }
 
   auto context = base::MakeRefCounted<GetUtxosContext>();
   context->callback = std::move(callback);
-  for (const auto& address : addresses.value()) {
-    context->addresses.insert(address.first);
+
+  // Outputs are listed only for addresses which may have some and whose
+  // transactions changed since they were last listed.
+  auto& cached_utxos = GetUtxosCache(chain_id);
+  for (const auto& [address, stats] : address_stats.value()) {
+    auto& utxos = context->utxos[address];
+    if (!MayHaveUnspentOutputs(stats)) {
+      continue;
+    }
+    if (auto it = cached_utxos.Get(address);
+        it != cached_utxos.end() &&
+        HaveSameTransactions(it->second.stats, stats)) {
+      utxos = it->second.utxos;
+      continue;
+    }
+    context->addresses.insert(address);
   }
 
-  for (const auto& address : addresses.value()) {
+  if (context->addresses.empty()) {
+    WorkOnGetUtxos(std::move(context));
+    return;
+  }
+
+  // Copied as a failing request may respond synchronously.
+  const auto addresses = context->addresses;
+  for (const auto& address : addresses) {
     bitcoin_rpc_->GetUtxoList(
-        chain_id, address.first,
+        chain_id, address,
         base::BindOnce(&BitcoinWalletService::OnGetUtxos,
-                       weak_ptr_factory_.GetWeakPtr(), context, address.first));
+                       weak_ptr_factory_.GetWeakPtr(), context, chain_id,
+                       address, address_stats->at(address)));
   }
 }
 
 void BitcoinWalletService::OnGetUtxos(
     scoped_refptr<GetUtxosContext> context,
+    std::string chain_id,
     std::string address,
+    bitcoin_rpc::AddressStats stats,
     base::expected<std::vector<bitcoin_rpc::UnspentOutput>, std::string>
         utxos) {
   if (!utxos.has_value()) {
@@ -484,6 +706,11 @@ void BitcoinWalletService::OnGetUtxos(
     return;
   }
 
+  CachedUtxos cached;
+  cached.stats = std::move(stats);
+  cached.utxos = utxos.value();
+  GetUtxosCache(chain_id).Put(address, std::move(cached));
+
   context->addresses.erase(address);
   context->utxos[address] = std::move(utxos.value());
   WorkOnGetUtxos(std::move(context));
@@ -538,11 +765,12 @@ void BitcoinWalletService::SignAndPostTransaction(
   bitcoin_rpc_->PostTransaction(
       chain_id, serialized_transaction,
       base::BindOnce(&BitcoinWalletService::OnPostTransaction,
-                     weak_ptr_factory_.GetWeakPtr(),
+                     weak_ptr_factory_.GetWeakPtr(), chain_id,
                      std::move(bitcoin_transaction), std::move(callback)));
 }
 
 void BitcoinWalletService::OnPostTransaction(
+    const std::string& chain_id,
     BitcoinTransaction bitcoin_transaction,
     SignAndPostTransactionCallback callback,
     base::expected<std::string, std::string> txid) {
@@ -551,6 +779,15 @@ void BitcoinWalletService::OnPostTransaction(
     return;
   }
 
+  // Spent addresses change before the next block.
+  auto& cached_stats = GetAddressStatsCache(chain_id);
+  for (const auto& input : bitcoin_transaction.inputs()) {
+    if (auto it = cached_stats.Peek(input.utxo_address);
+        it != cached_stats.end()) {
+      cached_stats.Erase(it);
+    }
+  }
+
   std::move(callback).Run(txid.value(), std::move(bitcoin_transaction), "");
 }
 
@@ -595,31 +832,49 @@ bool BitcoinWalletService::SignTransactionInternal(
     address_map.emplace(std::move(addr));
   }
 
+  // Inputs are grouped by address so each key is derived once per
+  // transaction rather than twice per input.
+  std::map<std::string, std::vector<size_t>> inputs_by_address;
   for (size_t input_index = 0; input_index < tx.inputs().size();
        ++input_index) {
-    auto hash = BitcoinSerializer::SerializeInputForSign(tx, input_index);
-    if (!hash) {
+    const auto& utxo_address = tx.inputs()[input_index].utxo_address;
+    if (!address_map.contains(utxo_address)) {
       return false;
     }
-    auto& input = tx.inputs()[input_index];
-
-    if (!address_map.contains(input.utxo_address)) {
-      return false;
+    inputs_by_address[utxo_address].push_back(input_index);
+  }
+
+  const auto midstate = BitcoinSerializer::ComputeSigHashMidstate(tx);
+  for (const auto& [address, input_indexes] : inputs_by_address) {
+    std::vector<SHA256HashArray> hashes;
+    hashes.reserve(input_indexes.size());
+    for (const auto input_index : input_indexes) {
+      auto hash =
+          BitcoinSerializer::SerializeInputForSign(tx, midstate, input_index);
+      if (!hash) {
+        return false;
+      }
+      hashes.push_back(*hash);
     }
-    auto& key_id = address_map.at(input.utxo_address);
 
-    auto signature = keyring_service_->SignMessageByBitcoinKeyring(
-        *account_id, *key_id, *hash);
-    if (!signature) {
+    auto& key_id = address_map.at(address);
+    auto signatures = keyring_service_->SignMessagesByBitcoinKeyring(
+        *account_id, *key_id, hashes);
+    if (!signatures || signatures->size() != input_indexes.size()) {
       return false;
     }
-    signature->push_back(tx.sighash_type());
 
     auto pubkey = keyring_service_->GetBitcoinPubkey(*account_id, *key_id);
     if (!pubkey) {
       return false;
     }
-    input.witness = BitcoinSerializer::SerializeWitness(*signature, *pubkey);
+
+    for (size_t i = 0; i < input_indexes.size(); ++i) {
+      auto& signature = (*signatures)[i];
+      signature.push_back(tx.sighash_type());
+      tx.inputs()[input_indexes[i]].witness =
+          BitcoinSerializer::SerializeWitness(signature, *pubkey);
+    }
   }
 
   return true;
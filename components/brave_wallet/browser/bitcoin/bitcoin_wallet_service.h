@@ -13,6 +13,7 @@
 #include <utility>
 #include <vector>
 
+#include "base/containers/lru_cache.h"
 #include "base/memory/weak_ptr.h"
 #include "base/types/expected.h"
 #include "brave/components/api_request_helper/api_request_helper.h"
@@ -22,12 +23,13 @@
 #include "brave/components/brave_wallet/browser/keyring_service_observer_base.h"
 #include "brave/components/brave_wallet/common/brave_wallet.mojom.h"
 #include "components/keyed_service/core/keyed_service.h"
+#include "mojo/public/cpp/bindings/receiver.h"
 #include "mojo/public/cpp/bindings/receiver_set.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
 
 namespace brave_wallet {
-class GetBalanceContext;
 class GetUtxosContext;
+class UpdateAddressStatsContext;
 class CreateTransactionTask;
 
 class BitcoinWalletService : public KeyedService,
@@ -89,6 +91,10 @@ class BitcoinWalletService : public KeyedService,
                             const std::string& txid,
                             GetTransactionStatusCallback callback);
 
+  using AddressStatsMap = std::map<std::string, bitcoin_rpc::AddressStats>;
+  using UpdateAddressStatsCallback =
+      base::OnceCallback<void(base::expected<AddressStatsMap, std::string>)>;
+
   bitcoin_rpc::BitcoinRpc& bitcoin_rpc() { return *bitcoin_rpc_; }
 
   absl::optional<std::string> GetUnusedChangeAddress(
@@ -97,19 +103,65 @@ class BitcoinWalletService : public KeyedService,
  private:
   friend CreateTransactionTask;
 
-  void OnGetAddressStatsForBalance(
-      scoped_refptr<GetBalanceContext> context,
+  struct CachedAddressStats {
+    bitcoin_rpc::AddressStats stats;
+    uint32_t chain_height = 0;
+  };
+  struct CachedUtxos {
+    bitcoin_rpc::AddressStats stats;
+    std::vector<bitcoin_rpc::UnspentOutput> utxos;
+  };
+  // <address, stats>
+  using AddressStatsCache = base::LRUCache<std::string, CachedAddressStats>;
+  // <address, utxos>
+  using UtxosCache = base::LRUCache<std::string, CachedUtxos>;
+
+  // KeyringServiceObserverBase:
+  void KeyringReset() override;
+  void Locked() override;
+
+  void ClearCaches();
+
+  // Fetches stats of the account's addresses, moving the gap of unused
+  // addresses forward while addresses in it turn out to be used. Stats which
+  // can't have changed since the last block height are taken from the cache.
+  void UpdateAddressStats(const std::string& chain_id,
+                          mojom::AccountIdPtr account_id,
+                          UpdateAddressStatsCallback callback);
+  void OnGetChainHeightForAddressStats(
+      scoped_refptr<UpdateAddressStatsContext> context,
+      base::expected<uint32_t, std::string> chain_height);
+  void OnGetAddressStats(
+      scoped_refptr<UpdateAddressStatsContext> context,
       std::string address,
       base::expected<bitcoin_rpc::AddressStats, std::string> stats);
-  void WorkOnGetBalance(scoped_refptr<GetBalanceContext> context);
+  void WorkOnUpdateAddressStats(
+      scoped_refptr<UpdateAddressStatsContext> context);
+  const bitcoin_rpc::AddressStats* GetCachedAddressStats(
+      const std::string& chain_id,
+      const std::string& address,
+      uint32_t chain_height);
+  AddressStatsCache& GetAddressStatsCache(const std::string& chain_id);
+  UtxosCache& GetUtxosCache(const std::string& chain_id);
 
+  void OnUpdateAddressStatsForBalance(
+      GetBalanceCallback callback,
+      base::expected<AddressStatsMap, std::string> address_stats);
+
+  void OnUpdateAddressStatsForUtxos(
+      const std::string& chain_id,
+      GetUtxosCallback callback,
+      base::expected<AddressStatsMap, std::string> address_stats);
   void OnGetUtxos(scoped_refptr<GetUtxosContext> context,
+                  std::string chain_id,
                   std::string address,
+                  bitcoin_rpc::AddressStats stats,
                   base::expected<std::vector<bitcoin_rpc::UnspentOutput>,
                                  std::string> utxos);
   void WorkOnGetUtxos(scoped_refptr<GetUtxosContext> context);
 
-  void OnPostTransaction(BitcoinTransaction bitcoin_transaction,
+  void OnPostTransaction(const std::string& chain_id,
+                         BitcoinTransaction bitcoin_transaction,
                          SignAndPostTransactionCallback callback,
                          base::expected<std::string, std::string> txid);
 
@@ -127,6 +179,11 @@ class BitcoinWalletService : public KeyedService,
   std::list<std::unique_ptr<CreateTransactionTask>> create_transaction_tasks_;
   mojo::ReceiverSet<mojom::BitcoinWalletService> receivers_;
   std::unique_ptr<bitcoin_rpc::BitcoinRpc> bitcoin_rpc_;
+  // <chain_id, cache>, cleared when the wallet is locked or reset.
+  std::map<std::string, AddressStatsCache> address_stats_cache_;
+  std::map<std::string, UtxosCache> utxos_cache_;
+  mojo::Receiver<brave_wallet::mojom::KeyringServiceObserver>
+      keyring_observer_receiver_{this};
   base::WeakPtrFactory<BitcoinWalletService> weak_ptr_factory_{this};
 };
 
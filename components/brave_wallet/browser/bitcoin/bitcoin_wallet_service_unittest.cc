@@ -17,6 +17,7 @@
 #include "brave/components/brave_wallet/browser/brave_wallet_prefs.h"
 #include "brave/components/brave_wallet/browser/brave_wallet_utils.h"
 #include "brave/components/brave_wallet/browser/test_utils.h"
+#include "brave/components/brave_wallet/common/bitcoin_utils.h"
 #include "brave/components/brave_wallet/common/brave_wallet.mojom.h"
 #include "brave/components/brave_wallet/common/features.h"
 #include "brave/components/brave_wallet/common/test_utils.h"
@@ -41,6 +42,7 @@ const char kTxid2[] =
 const char kTxid3[] =
     "f4024cb219b898ed51a5c2a2d0589c1de4bb35e329ad15ab08b6ac9ffcc95ae2";
 const char kAddress[] = "bc1qw508d6qejxtdg4y5r3zarvary0c5xw7kv8f3t4";
+constexpr uint32_t kUsedAddressesCount = 200;
 }  // namespace
 
 namespace bitcoin_rpc {
@@ -96,7 +98,7 @@ class BitcoinWalletServiceUnitTest : public testing::Test {
     auto addresses =
         keyring_service_->GetBitcoinAddresses(*btc_account_->account_id);
     ASSERT_TRUE(addresses);
-    EXPECT_EQ(addresses->size(), 5u + 5u);
+    EXPECT_EQ(addresses->size(), 2 * kBitcoinAddressGap);
     for (auto& address : *addresses) {
       auto& stats = address_stats_map_[address.first];
       stats.address = address.first;
@@ -116,7 +118,8 @@ class BitcoinWalletServiceUnitTest : public testing::Test {
     stats_0.mempool_stats.funded_txo_sum = "8888";
     stats_0.mempool_stats.spent_txo_sum = "2222";
 
-    address_6_ = addresses->at(6).first;
+    // Change address with index 1.
+    address_6_ = addresses->at(kBitcoinAddressGap + 1).first;
     auto& stats_6 = address_stats_map_[address_6_];
     stats_6.address = address_6_;
     stats_6.chain_stats.funded_txo_sum = "100000";
@@ -145,9 +148,33 @@ class BitcoinWalletServiceUnitTest : public testing::Test {
     return AccountUtils(keyring_service_.get());
   }
 
+  bitcoin_rpc::AddressStats& SetUpAddressStats(uint32_t change,
+                                                uint32_t index) {
+    auto address = keyring_service_->GetBitcoinAddress(
+        *account_id(), mojom::BitcoinKeyId(0, change, index));
+    EXPECT_TRUE(address);
+    auto& stats = address_stats_map_[*address];
+    stats.address = *address;
+    stats.chain_stats.tx_count = "0";
+    stats.chain_stats.funded_txo_sum = "0";
+    stats.chain_stats.spent_txo_sum = "0";
+    stats.mempool_stats.tx_count = "0";
+    stats.mempool_stats.funded_txo_sum = "0";
+    stats.mempool_stats.spent_txo_sum = "0";
+    return stats;
+  }
+
   void RequestInterceptor(const network::ResourceRequest& request) {
     url_loader_factory_.ClearResponses();
 
+    if (base::StartsWith(request.url.path_piece(), "/address/")) {
+      if (base::EndsWith(request.url.path_piece(), "/utxo")) {
+        utxo_list_requests_++;
+      } else {
+        address_stats_requests_++;
+      }
+    }
+
     if (request.method == net::HttpRequestHeaders::kPostMethod &&
         request.url.path_piece() == "/tx") {
       auto request_string(request.request_body->elements()
@@ -205,6 +232,8 @@ class BitcoinWalletServiceUnitTest : public testing::Test {
   std::map<std::string, bitcoin_rpc::AddressStats> address_stats_map_;
   std::map<std::string, std::vector<bitcoin_rpc::UnspentOutput>> utxos_map_;
   std::string captured_raw_tx_;
+  size_t address_stats_requests_ = 0;
+  size_t utxo_list_requests_ = 0;
 
   base::test::TaskEnvironment task_environment_;
   sync_preferences::TestingPrefServiceSyncable prefs_;
@@ -237,6 +266,165 @@ TEST_F(BitcoinWalletServiceUnitTest, GetBalance) {
   testing::Mock::VerifyAndClearExpectations(&callback);
 }
 
+TEST_F(BitcoinWalletServiceUnitTest, GetBalanceDiscoversUsedAddresses) {
+  for (uint32_t i = 0; i < kUsedAddressesCount + kBitcoinAddressGap; ++i) {
+    auto& stats = SetUpAddressStats(kBitcoinReceiveIndex, i);
+    if (i < kUsedAddressesCount) {
+      stats.chain_stats.tx_count = "2";
+      stats.chain_stats.funded_txo_sum = "1000";
+      stats.chain_stats.spent_txo_sum = "1000";
+    }
+    if (i == 10) {
+      stats.mempool_stats.tx_count = "1";
+    }
+  }
+
+  base::MockCallback<BitcoinWalletService::GetBalanceCallback> callback;
+  mojom::BitcoinBalancePtr balance;
+  EXPECT_CALL(callback, Run(_, absl::optional<std::string>()))
+      .Times(4)
+      .WillRepeatedly(WithArg<0>([&](const mojom::BitcoinBalancePtr& arg) {
+        balance = arg.Clone();
+      }));
+
+  // Each used address is queried once while the gap moves forward.
+  bitcoin_wallet_service_->GetBalance(mojom::kBitcoinMainnet, account_id(),
+                                      callback.Get());
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(address_stats_requests_,
+            kUsedAddressesCount + 2 * kBitcoinAddressGap);
+  EXPECT_EQ(balance->balances.size(),
+            kUsedAddressesCount + 2 * kBitcoinAddressGap);
+  EXPECT_EQ(keyring_service_->GetBitcoinNextAddressIndex(*account_id(),
+                                                         kBitcoinReceiveIndex),
+            kUsedAddressesCount);
+  EXPECT_EQ(keyring_service_->GetBitcoinNextAddressIndex(*account_id(),
+                                                         kBitcoinChangeIndex),
+            0u);
+
+  // Without a new block only unused addresses and addresses with mempool
+  // transactions are queried.
+  address_stats_requests_ = 0;
+  bitcoin_wallet_service_->GetBalance(mojom::kBitcoinMainnet, account_id(),
+                                      callback.Get());
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(address_stats_requests_, 2 * kBitcoinAddressGap + 1);
+  EXPECT_EQ(balance->balances.size(),
+            kUsedAddressesCount + 2 * kBitcoinAddressGap);
+
+  // A new block may change any address.
+  address_stats_requests_ = 0;
+  mainnet_height_++;
+  bitcoin_wallet_service_->GetBalance(mojom::kBitcoinMainnet, account_id(),
+                                      callback.Get());
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(address_stats_requests_,
+            kUsedAddressesCount + 2 * kBitcoinAddressGap);
+
+  // Locking the wallet drops cached stats.
+  address_stats_requests_ = 0;
+  keyring_service_->Lock();
+  base::RunLoop().RunUntilIdle();
+  bitcoin_wallet_service_->GetBalance(mojom::kBitcoinMainnet, account_id(),
+                                      callback.Get());
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(address_stats_requests_,
+            kUsedAddressesCount + 2 * kBitcoinAddressGap);
+  testing::Mock::VerifyAndClearExpectations(&callback);
+}
+
+TEST_F(BitcoinWalletServiceUnitTest, GetBalanceOfNewWallet) {
+  base::MockCallback<BitcoinWalletService::GetBalanceCallback> callback;
+  EXPECT_CALL(callback, Run(_, absl::optional<std::string>()));
+
+  // Only the gap of receive and change addresses is queried.
+  bitcoin_wallet_service_->GetBalance(mojom::kBitcoinMainnet, account_id(),
+                                      callback.Get());
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(address_stats_requests_, 2 * kBitcoinAddressGap);
+  testing::Mock::VerifyAndClearExpectations(&callback);
+}
+
+TEST_F(BitcoinWalletServiceUnitTest, AddressesArePersisted) {
+  auto addresses =
+      keyring_service_->GetBitcoinAddresses(*btc_account_->account_id);
+  ASSERT_TRUE(addresses);
+
+  // Addresses and public keys derived when the account was created are known
+  // while the wallet is locked.
+  keyring_service_->Lock();
+  auto locked_addresses =
+      keyring_service_->GetBitcoinAddresses(*btc_account_->account_id);
+  ASSERT_TRUE(locked_addresses);
+  EXPECT_EQ(*locked_addresses, *addresses);
+  EXPECT_TRUE(keyring_service_->GetBitcoinPubkey(
+      *account_id(), mojom::BitcoinKeyId(0, kBitcoinChangeIndex, 1)));
+
+  // Addresses past the persisted ones can't be derived while locked.
+  keyring_service_->UpdateBitcoinNextAddressIndex(*account_id(),
+                                                  kBitcoinReceiveIndex, 1);
+  EXPECT_FALSE(
+      keyring_service_->GetBitcoinAddresses(*btc_account_->account_id));
+}
+
+TEST_F(BitcoinWalletServiceUnitTest, GetUtxosListsOnlyChangedAddresses) {
+  using GetUtxosResult =
+      base::expected<BitcoinWalletService::UtxoMap, std::string>;
+  base::MockCallback<BitcoinWalletService::GetUtxosCallback> callback;
+
+  for (uint32_t i = 0; i < kUsedAddressesCount + kBitcoinAddressGap; ++i) {
+    auto& stats = SetUpAddressStats(kBitcoinReceiveIndex, i);
+    if (i < kUsedAddressesCount) {
+      stats.chain_stats.tx_count = "2";
+      stats.chain_stats.funded_txo_sum = "1000";
+      stats.chain_stats.spent_txo_sum = "1000";
+    }
+  }
+  auto& stats_150 = SetUpAddressStats(kBitcoinReceiveIndex, 150);
+  stats_150.chain_stats.tx_count = "1";
+  stats_150.chain_stats.funded_txo_sum = "7000";
+  auto& utxos_150 = utxos_map_[stats_150.address];
+  utxos_150.emplace_back();
+  utxos_150.back().txid = kTxid3;
+  utxos_150.back().vout = "0";
+  utxos_150.back().value = "7000";
+  utxos_150.back().status.confirmed = true;
+
+  EXPECT_CALL(callback, Run(Truly([&](const GetUtxosResult& arg) {
+                EXPECT_TRUE(arg.has_value());
+                EXPECT_EQ(arg.value().size(),
+                          kUsedAddressesCount + 2 * kBitcoinAddressGap);
+                EXPECT_EQ(arg.value().at(stats_150.address).size(), 1u);
+                EXPECT_EQ(arg.value().at(address_6_).size(), 1u);
+                return true;
+              })))
+      .Times(3);
+
+  // Only addresses which received more than they spent are listed.
+  bitcoin_wallet_service_->GetUtxos(mojom::kBitcoinMainnet, account_id(),
+                                    callback.Get());
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(utxo_list_requests_, 2u);
+
+  // Unchanged addresses are not listed again, even after a new block.
+  utxo_list_requests_ = 0;
+  mainnet_height_++;
+  bitcoin_wallet_service_->GetUtxos(mojom::kBitcoinMainnet, account_id(),
+                                    callback.Get());
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(utxo_list_requests_, 0u);
+
+  // New transactions of an address make it listed again.
+  utxo_list_requests_ = 0;
+  mainnet_height_++;
+  stats_150.chain_stats.tx_count = "2";
+  bitcoin_wallet_service_->GetUtxos(mojom::kBitcoinMainnet, account_id(),
+                                    callback.Get());
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(utxo_list_requests_, 1u);
+  testing::Mock::VerifyAndClearExpectations(&callback);
+}
+
 TEST_F(BitcoinWalletServiceUnitTest, GetBitcoinAccountInfo_DISABLED) {
   // TODO(apaymyshev): test in case we need GetBitcoinAccountInfo.
 }
@@ -138,6 +138,7 @@ void RegisterProfilePrefs(user_prefs::PrefRegistrySyncable* registry) {
   registry->RegisterIntegerPref(kBraveWalletAutoLockMinutes,
                                 kDefaultWalletAutoLockMinutes);
   registry->RegisterDictionaryPref(kBraveWalletEthAllowancesCache);
+  registry->RegisterDictionaryPref(kBraveWalletNftTokenUrlIndex);
   registry->RegisterBooleanPref(kSupportEip1559OnLocalhostChain, false);
   registry->RegisterDictionaryPref(kBraveWalletLastTransactionSentTimeDict);
   registry->RegisterTimePref(kBraveWalletLastDiscoveredAssetsAt, base::Time());
@@ -247,6 +248,7 @@ void ClearJsonRpcServiceProfilePrefs(PrefService* prefs) {
   prefs->ClearPref(kBraveWalletSelectedNetworks);
   prefs->ClearPref(kBraveWalletSelectedNetworksPerOrigin);
   prefs->ClearPref(kSupportEip1559OnLocalhostChain);
+  prefs->ClearPref(kBraveWalletNftTokenUrlIndex);
 }
 
 void ClearKeyringServiceProfilePrefs(PrefService* prefs) {
@@ -5,11 +5,77 @@
 
 #include "brave/components/brave_wallet/browser/eth_logs_tracker.h"
 
+#include <algorithm>
 #include <string>
 #include <utility>
 
+#include "base/strings/string_util.h"
+#include "brave/components/brave_wallet/common/hex_utils.h"
+
 namespace brave_wallet {
 
+namespace {
+
+constexpr char kAddress[] = "address";
+constexpr char kTopics[] = "topics";
+constexpr char kFromBlock[] = "fromBlock";
+constexpr char kToBlock[] = "toBlock";
+
+// Parses a filter's address or topics position, which is either a single
+// value or a list of alternatives. Anything else matches any value.
+absl::optional<std::set<std::string>> ParseFilterValues(
+    const base::Value* value) {
+  if (!value) {
+    return absl::nullopt;
+  }
+
+  if (value->is_string()) {
+    return std::set<std::string>{base::ToLowerASCII(value->GetString())};
+  }
+
+  if (!value->is_list() || value->GetList().empty()) {
+    return absl::nullopt;
+  }
+
+  std::set<std::string> result;
+  for (const auto& item : value->GetList()) {
+    if (!item.is_string()) {
+      return absl::nullopt;
+    }
+    result.insert(base::ToLowerASCII(item.GetString()));
+  }
+  return result;
+}
+
+base::Value FilterValuesToValue(
+    const absl::optional<std::set<std::string>>& values) {
+  if (!values) {
+    return base::Value();
+  }
+
+  base::Value::List result;
+  for (const auto& value : *values) {
+    result.Append(value);
+  }
+  return base::Value(std::move(result));
+}
+
+bool MatchesFilterValues(const absl::optional<std::set<std::string>>& values,
+                         const std::string* value) {
+  if (!values) {
+    return true;
+  }
+  return value && values->contains(base::ToLowerASCII(*value));
+}
+
+}  // namespace
+
+EthLogsTracker::LogsFilter::LogsFilter() = default;
+EthLogsTracker::LogsFilter::~LogsFilter() = default;
+EthLogsTracker::LogsFilter::LogsFilter(const LogsFilter&) = default;
+EthLogsTracker::LogsFilter& EthLogsTracker::LogsFilter::operator=(
+    const LogsFilter&) = default;
+
 EthLogsTracker::EthLogsTracker(JsonRpcService* json_rpc_service)
     : json_rpc_service_(json_rpc_service) {
   DCHECK(json_rpc_service_);
@@ -26,6 +92,10 @@ void EthLogsTracker::Start(const std::string& chain_id,
 
 void EthLogsTracker::Stop() {
   timer_.Stop();
+  // Subscriptions made after a restart only get logs from then on.
+  weak_factory_.InvalidateWeakPtrs();
+  request_in_flight_ = false;
+  next_from_block_.clear();
 }
 
 bool EthLogsTracker::IsRunning() const {
@@ -34,8 +104,8 @@ bool EthLogsTracker::IsRunning() const {
 
 void EthLogsTracker::AddSubscriber(const std::string& subscription_id,
                                    base::Value::Dict filter) {
-  eth_logs_subscription_info_.insert(std::pair<std::string, base::Value::Dict>(
-      subscription_id, std::move(filter)));
+  eth_logs_subscription_info_.insert(
+      std::pair<std::string, LogsFilter>(subscription_id, ParseFilter(filter)));
 }
 
 void EthLogsTracker::RemoveSubscriber(const std::string& subscription_id) {
@@ -51,26 +121,198 @@ void EthLogsTracker::RemoveObserver(EthLogsTracker::Observer* observer) {
 }
 
 void EthLogsTracker::GetLogs(const std::string& chain_id) {
-  for (auto const& esi : std::as_const(eth_logs_subscription_info_)) {
-    json_rpc_service_->EthGetLogs(
-        chain_id, esi.second.Clone(),
-        base::BindOnce(&EthLogsTracker::OnGetLogs, weak_factory_.GetWeakPtr(),
-                       esi.first));
+  // A query covering the same blocks as the one in flight would deliver its
+  // logs twice.
+  if (eth_logs_subscription_info_.empty() || request_in_flight_) {
+    return;
+  }
+
+  request_in_flight_ = true;
+  json_rpc_service_->GetBlockNumber(
+      chain_id, base::BindOnce(&EthLogsTracker::OnGetBlockNumber,
+                               weak_factory_.GetWeakPtr(), chain_id));
+}
+
+void EthLogsTracker::OnGetBlockNumber(const std::string& chain_id,
+                                      uint256_t block_number,
+                                      mojom::ProviderError error,
+                                      const std::string& error_message) {
+  if (error != mojom::ProviderError::kSuccess) {
+    request_in_flight_ = false;
+    LOG(ERROR) << "OnGetBlockNumber failed";
+    return;
   }
+
+  // The first query only covers the latest block.
+  uint256_t from_block = block_number;
+  if (auto it = next_from_block_.find(chain_id); it != next_from_block_.end()) {
+    from_block = it->second;
+  }
+
+  if (from_block > block_number) {
+    request_in_flight_ = false;
+    return;
+  }
+
+  GetLogsChunk(chain_id, from_block, block_number);
+}
+
+void EthLogsTracker::GetLogsChunk(const std::string& chain_id,
+                                  uint256_t from_block,
+                                  uint256_t latest_block) {
+  DCHECK(request_in_flight_);
+  if (eth_logs_subscription_info_.empty()) {
+    request_in_flight_ = false;
+    return;
+  }
+
+  const uint256_t to_block =
+      std::min(latest_block, from_block + (kMaxBlocksPerQuery - 1));
+
+  std::vector<std::string> subscriptions;
+  for (const auto& esi : eth_logs_subscription_info_) {
+    subscriptions.push_back(esi.first);
+  }
+
+  base::Value::Dict filter = MergeFilters();
+  filter.Set(kFromBlock, Uint256ValueToHex(from_block));
+  filter.Set(kToBlock, Uint256ValueToHex(to_block));
+  json_rpc_service_->EthGetLogs(
+      chain_id, std::move(filter),
+      base::BindOnce(&EthLogsTracker::OnGetLogs, weak_factory_.GetWeakPtr(),
+                     chain_id, to_block, latest_block,
+                     std::move(subscriptions)));
 }
 
-void EthLogsTracker::OnGetLogs(const std::string& subscription,
+void EthLogsTracker::OnGetLogs(const std::string& chain_id,
+                               uint256_t to_block,
+                               uint256_t latest_block,
+                               const std::vector<std::string>& subscriptions,
                                [[maybe_unused]] const std::vector<Log>& logs,
                                base::Value rawlogs,
                                mojom::ProviderError error,
                                const std::string& error_message) {
+  const base::Value::List* results = nullptr;
   if (error == mojom::ProviderError::kSuccess && rawlogs.is_dict()) {
+    results = rawlogs.GetDict().FindList("result");
+  }
+  if (!results) {
+    // The same range is queried again on the next tick.
+    request_in_flight_ = false;
+    LOG(ERROR) << "OnGetLogs failed";
+    return;
+  }
+
+  next_from_block_[chain_id] = to_block + 1;
+
+  // Observers may stop the tracker, which invalidates |weak_self|.
+  auto weak_self = weak_factory_.GetWeakPtr();
+  for (const auto& subscription : subscriptions) {
+    auto it = eth_logs_subscription_info_.find(subscription);
+    if (it == eth_logs_subscription_info_.end()) {
+      continue;
+    }
+
+    base::Value::List subscription_logs;
+    for (const auto& result : *results) {
+      if (result.is_dict() && MatchesFilter(it->second, result.GetDict())) {
+        subscription_logs.Append(result.Clone());
+      }
+    }
+    if (subscription_logs.empty()) {
+      continue;
+    }
+
     for (auto& observer : observers_) {
-      observer.OnLogsReceived(subscription, rawlogs.Clone());
+      observer.OnLogsReceived(subscription, subscription_logs);
     }
-  } else {
-    LOG(ERROR) << "OnGetLogs failed";
   }
+
+  if (!weak_self) {
+    return;
+  }
+
+  if (to_block < latest_block) {
+    GetLogsChunk(chain_id, to_block + 1, latest_block);
+    return;
+  }
+
+  request_in_flight_ = false;
+}
+
+// static
+EthLogsTracker::LogsFilter EthLogsTracker::ParseFilter(
+    const base::Value::Dict& filter) {
+  LogsFilter result;
+  result.addresses = ParseFilterValues(filter.Find(kAddress));
+  if (const auto* topics = filter.FindList(kTopics)) {
+    for (const auto& topic : *topics) {
+      result.topics.push_back(ParseFilterValues(&topic));
+    }
+  }
+  return result;
+}
+
+// static
+bool EthLogsTracker::MatchesFilter(const LogsFilter& filter,
+                                   const base::Value::Dict& log) {
+  if (!MatchesFilterValues(filter.addresses, log.FindString(kAddress))) {
+    return false;
+  }
+
+  const auto* topics = log.FindList(kTopics);
+  for (size_t i = 0; i < filter.topics.size(); ++i) {
+    const std::string* topic = nullptr;
+    if (topics && i < topics->size()) {
+      topic = (*topics)[i].GetIfString();
+    }
+    if (!MatchesFilterValues(filter.topics[i], topic)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// The merged filter matches every log any of the subscriptions does: addresses
+// and topics are united, and a position which some subscription doesn't
+// constrain is left unconstrained.
+base::Value::Dict EthLogsTracker::MergeFilters() const {
+  DCHECK(!eth_logs_subscription_info_.empty());
+
+  LogsFilter merged = eth_logs_subscription_info_.begin()->second;
+  for (const auto& esi : eth_logs_subscription_info_) {
+    const LogsFilter& filter = esi.second;
+    if (!filter.addresses) {
+      merged.addresses.reset();
+    } else if (merged.addresses) {
+      merged.addresses->insert(filter.addresses->begin(),
+                               filter.addresses->end());
+    }
+
+    merged.topics.resize(std::min(merged.topics.size(), filter.topics.size()));
+    for (size_t i = 0; i < merged.topics.size(); ++i) {
+      if (!filter.topics[i]) {
+        merged.topics[i].reset();
+      } else if (merged.topics[i]) {
+        merged.topics[i]->insert(filter.topics[i]->begin(),
+                                 filter.topics[i]->end());
+      }
+    }
+  }
+
+  base::Value::Dict result;
+  if (merged.addresses) {
+    result.Set(kAddress, FilterValuesToValue(merged.addresses));
+  }
+  if (!merged.topics.empty()) {
+    base::Value::List topics;
+    for (const auto& topic : merged.topics) {
+      topics.Append(FilterValuesToValue(topic));
+    }
+    result.Set(kTopics, std::move(topics));
+  }
+  return result;
 }
 
 }  // namespace brave_wallet
@@ -7,6 +7,7 @@
 #define BRAVE_COMPONENTS_BRAVE_WALLET_BROWSER_ETH_LOGS_TRACKER_H_
 
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -18,13 +19,22 @@
 #include "brave/components/brave_wallet/browser/json_rpc_service.h"
 #include "brave/components/brave_wallet/common/brave_wallet.mojom.h"
 #include "brave/components/brave_wallet/common/brave_wallet_types.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
 
 namespace brave_wallet {
 
 class JsonRpcService;
 
+// Polls logs for eth_subscribe('logs') subscriptions. Filters of all
+// subscriptions are merged into a single eth_getLogs query per new block
+// range, and the results are matched against each subscription locally.
+// Ranges longer than kMaxBlocksPerQuery are queried in consecutive chunks.
 class EthLogsTracker {
  public:
+  // Nodes reject or time out on eth_getLogs queries over long ranges, e.g.
+  // after the tracker was paused for a while.
+  static constexpr uint64_t kMaxBlocksPerQuery = 1000;
+
   explicit EthLogsTracker(JsonRpcService* json_rpc_service);
   EthLogsTracker(const EthLogsTracker&) = delete;
   EthLogsTracker& operator=(const EthLogsTracker&) = delete;
@@ -35,8 +45,10 @@ class EthLogsTracker {
 
   class Observer : public base::CheckedObserver {
    public:
+    // |logs| are the new logs matching the subscription's filter. The same
+    // list is handed to every observer.
     virtual void OnLogsReceived(const std::string& subscription,
-                                base::Value rawlogs) = 0;
+                                const base::Value::List& logs) = 0;
   };
 
   // If timer is already running, it will be replaced with new interval
@@ -52,17 +64,49 @@ class EthLogsTracker {
   void RemoveObserver(Observer* observer);
 
  private:
+  // Values of the filter's address and topics positions. absl::nullopt
+  // matches any value.
+  struct LogsFilter {
+    LogsFilter();
+    ~LogsFilter();
+    LogsFilter(const LogsFilter&);
+    LogsFilter& operator=(const LogsFilter&);
+
+    absl::optional<std::set<std::string>> addresses;
+    std::vector<absl::optional<std::set<std::string>>> topics;
+  };
+
   void GetLogs(const std::string& chain_id);
-  void OnGetLogs(const std::string& subscription,
+  void OnGetBlockNumber(const std::string& chain_id,
+                        uint256_t block_number,
+                        mojom::ProviderError error,
+                        const std::string& error_message);
+  // Queries the logs of the blocks from |from_block| to |latest_block|, at
+  // most kMaxBlocksPerQuery of them at a time.
+  void GetLogsChunk(const std::string& chain_id,
+                    uint256_t from_block,
+                    uint256_t latest_block);
+  void OnGetLogs(const std::string& chain_id,
+                 uint256_t to_block,
+                 uint256_t latest_block,
+                 const std::vector<std::string>& subscriptions,
                  const std::vector<Log>& logs,
                  base::Value rawlogs,
                  mojom::ProviderError error,
                  const std::string& error_message);
 
+  static LogsFilter ParseFilter(const base::Value::Dict& filter);
+  static bool MatchesFilter(const LogsFilter& filter,
+                            const base::Value::Dict& log);
+  base::Value::Dict MergeFilters() const;
+
   base::RepeatingTimer timer_;
   raw_ptr<JsonRpcService> json_rpc_service_ = nullptr;
 
-  std::map<std::string, base::Value::Dict> eth_logs_subscription_info_;
+  std::map<std::string, LogsFilter> eth_logs_subscription_info_;
+  // <chain_id, first block whose logs were not delivered yet>
+  std::map<std::string, uint256_t> next_from_block_;
+  bool request_in_flight_ = false;
 
   base::ObserverList<Observer> observers_;
 
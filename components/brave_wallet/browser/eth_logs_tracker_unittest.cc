@@ -0,0 +1,377 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_wallet/browser/eth_logs_tracker.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "base/containers/contains.h"
+#include "base/json/json_writer.h"
+#include "base/scoped_observation.h"
+#include "base/strings/strcat.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/test/bind.h"
+#include "base/test/task_environment.h"
+#include "base/test/values_test_util.h"
+#include "brave/components/brave_wallet/browser/brave_wallet_prefs.h"
+#include "brave/components/brave_wallet/browser/json_rpc_service.h"
+#include "brave/components/brave_wallet/common/hex_utils.h"
+#include "components/sync_preferences/testing_pref_service_syncable.h"
+#include "net/http/http_status_code.h"
+#include "services/data_decoder/public/cpp/test_support/in_process_data_decoder.h"
+#include "services/network/public/cpp/resource_request.h"
+#include "services/network/public/cpp/weak_wrapper_shared_url_loader_factory.h"
+#include "services/network/test/test_url_loader_factory.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using base::test::ParseJsonDict;
+
+namespace brave_wallet {
+
+namespace {
+
+constexpr size_t kSubscriptionsCount = 100;
+constexpr char kTransferTopic[] =
+    "0xddf252ad1be2c89b69c2b068fc378daa952ba7f163c4a11628f55a4df523b3ef";
+
+std::string GetContractAddress(size_t index) {
+  std::string hex = base::NumberToString(index);
+  return "0x" + std::string(40 - hex.size(), '0') + hex;
+}
+
+std::string GetSubscriptionId(size_t index) {
+  return "0x" + base::NumberToString(index);
+}
+
+base::Value::Dict MakeLog(const std::string& address, uint256_t block_number) {
+  base::Value::List topics;
+  topics.Append(kTransferTopic);
+
+  base::Value::Dict log;
+  log.Set("address", address);
+  log.Set("blockHash",
+          "0x2961ceb6c16bab72a55f79e394a35f2bf1c62b30446e3537280f7c22c3115e6e");
+  log.Set("blockNumber", Uint256ValueToHex(block_number));
+  log.Set("data", "0x");
+  log.Set("logIndex", "0x0");
+  log.Set("removed", false);
+  log.Set("transactionHash",
+          "0x4ec3d9ce4ad0b8a3a7c0a4f1c5f0f0fb5d2c1c29d7f0e6b2e5b59e6c5f2c9a11");
+  log.Set("transactionIndex", "0x0");
+  log.Set("topics", std::move(topics));
+  return log;
+}
+
+class TestLogsObserver : public EthLogsTracker::Observer {
+ public:
+  explicit TestLogsObserver(EthLogsTracker* tracker) {
+    observation_.Observe(tracker);
+  }
+
+  void OnLogsReceived(const std::string& subscription,
+                      const base::Value::List& logs) override {
+    for (const auto& log : logs) {
+      logs_[subscription].push_back(log.Clone());
+    }
+  }
+
+  const std::map<std::string, std::vector<base::Value>>& logs() const {
+    return logs_;
+  }
+  void Reset() { logs_.clear(); }
+
+ private:
+  std::map<std::string, std::vector<base::Value>> logs_;
+  base::ScopedObservation<EthLogsTracker, EthLogsTracker::Observer>
+      observation_{this};
+};
+
+}  // namespace
+
+class EthLogsTrackerUnitTest : public testing::Test {
+ public:
+  EthLogsTrackerUnitTest()
+      : task_environment_(base::test::TaskEnvironment::TimeSource::MOCK_TIME),
+        shared_url_loader_factory_(
+            base::MakeRefCounted<network::WeakWrapperSharedURLLoaderFactory>(
+                &url_loader_factory_)) {}
+
+  void SetUp() override {
+    RegisterProfilePrefs(prefs_.registry());
+    json_rpc_service_ =
+        std::make_unique<JsonRpcService>(shared_url_loader_factory_, &prefs_);
+
+    url_loader_factory_.SetInterceptor(base::BindLambdaForTesting(
+        [&](const network::ResourceRequest& request) {
+          url_loader_factory_.ClearResponses();
+          std::string_view request_string(request.request_body->elements()
+                                              ->at(0)
+                                              .As<network::DataElementBytes>()
+                                              .AsStringPiece());
+          base::Value::Dict request_value = ParseJsonDict(request_string);
+          const std::string* method = request_value.FindString("method");
+          ASSERT_TRUE(method);
+
+          if (*method == "eth_blockNumber") {
+            block_number_requests_++;
+            url_loader_factory_.AddResponse(
+                request.url.spec(),
+                R"({"id":1,"jsonrpc":"2.0","result":")" +
+                    Uint256ValueToHex(block_number_) + R"("})");
+            return;
+          }
+
+          ASSERT_EQ(*method, "eth_getLogs");
+          get_logs_requests_++;
+          if (fail_get_logs_) {
+            url_loader_factory_.AddResponse(request.url.spec(), "",
+                                            net::HTTP_INTERNAL_SERVER_ERROR);
+            return;
+          }
+
+          const auto* params = request_value.FindList("params");
+          ASSERT_TRUE(params && params->size() == 1u);
+          last_filter_ = (*params)[0].GetDict().Clone();
+          queried_ranges_.emplace_back(*last_filter_.FindString("fromBlock"),
+                                       *last_filter_.FindString("toBlock"));
+          url_loader_factory_.AddResponse(request.url.spec(),
+                                          GetLogsResponse(last_filter_));
+        }));
+  }
+
+  // Returns the logs of the chain within the filter's block range and
+  // addresses.
+  std::string GetLogsResponse(const base::Value::Dict& filter) const {
+    uint256_t from_block = 0;
+    uint256_t to_block = 0;
+    EXPECT_TRUE(
+        HexValueToUint256(*filter.FindString("fromBlock"), &from_block));
+    EXPECT_TRUE(HexValueToUint256(*filter.FindString("toBlock"), &to_block));
+    const auto* addresses = filter.FindList("address");
+
+    base::Value::List result;
+    for (const auto& log : chain_logs_) {
+      uint256_t block_number = 0;
+      EXPECT_TRUE(
+          HexValueToUint256(*log.FindString("blockNumber"), &block_number));
+      if (block_number < from_block || block_number > to_block) {
+        continue;
+      }
+      const std::string* address = log.FindString("address");
+      if (addresses && !base::Contains(*addresses, base::Value(*address))) {
+        continue;
+      }
+      result.Append(log.Clone());
+    }
+
+    base::Value::Dict response;
+    response.Set("id", 1);
+    response.Set("jsonrpc", "2.0");
+    response.Set("result", std::move(result));
+    std::string json;
+    base::JSONWriter::Write(response, &json);
+    return json;
+  }
+
+  void AddSubscribers(EthLogsTracker* tracker) {
+    for (size_t i = 0; i < kSubscriptionsCount; ++i) {
+      base::Value::List topics;
+      topics.Append(kTransferTopic);
+      base::Value::Dict filter;
+      filter.Set("address", GetContractAddress(i));
+      filter.Set("topics", std::move(topics));
+      tracker->AddSubscriber(GetSubscriptionId(i), std::move(filter));
+    }
+  }
+
+ protected:
+  base::test::TaskEnvironment task_environment_;
+  sync_preferences::TestingPrefServiceSyncable prefs_;
+  network::TestURLLoaderFactory url_loader_factory_;
+  data_decoder::test::InProcessDataDecoder in_process_data_decoder_;
+  scoped_refptr<network::SharedURLLoaderFactory> shared_url_loader_factory_;
+  std::unique_ptr<JsonRpcService> json_rpc_service_;
+
+  uint256_t block_number_ = 0x100;
+  std::vector<base::Value::Dict> chain_logs_;
+  base::Value::Dict last_filter_;
+  std::vector<std::pair<std::string, std::string>> queried_ranges_;
+  size_t block_number_requests_ = 0;
+  size_t get_logs_requests_ = 0;
+  bool fail_get_logs_ = false;
+};
+
+TEST_F(EthLogsTrackerUnitTest, MergesSubscriptionsIntoOneQuery) {
+  EthLogsTracker tracker(json_rpc_service_.get());
+  TestLogsObserver observer(&tracker);
+  AddSubscribers(&tracker);
+  for (size_t i = 0; i < kSubscriptionsCount; ++i) {
+    chain_logs_.push_back(MakeLog(GetContractAddress(i), block_number_));
+  }
+  // Not subscribed to.
+  chain_logs_.push_back(
+      MakeLog(GetContractAddress(kSubscriptionsCount), block_number_));
+
+  tracker.Start(mojom::kMainnetChainId, base::Seconds(5));
+  task_environment_.FastForwardBy(base::Seconds(5));
+
+  // A subscription used to cost an eth_getLogs query per tick.
+  EXPECT_EQ(block_number_requests_, 1u);
+  EXPECT_EQ(get_logs_requests_, 1u);
+  const auto* addresses = last_filter_.FindList("address");
+  ASSERT_TRUE(addresses);
+  EXPECT_EQ(addresses->size(), kSubscriptionsCount);
+  const auto* topics = last_filter_.FindList("topics");
+  ASSERT_TRUE(topics);
+  EXPECT_EQ(*topics, base::test::ParseJsonList(
+                         base::StrCat({R"([[")", kTransferTopic, R"("]])"})));
+  EXPECT_EQ(*last_filter_.FindString("fromBlock"), "0x100");
+  EXPECT_EQ(*last_filter_.FindString("toBlock"), "0x100");
+
+  ASSERT_EQ(observer.logs().size(), kSubscriptionsCount);
+  for (size_t i = 0; i < kSubscriptionsCount; ++i) {
+    const auto& logs = observer.logs().at(GetSubscriptionId(i));
+    ASSERT_EQ(logs.size(), 1u);
+    EXPECT_EQ(*logs[0].GetDict().FindString("address"), GetContractAddress(i));
+  }
+
+  // No new block, nothing is queried or delivered again.
+  observer.Reset();
+  task_environment_.FastForwardBy(base::Seconds(5));
+  EXPECT_EQ(block_number_requests_, 2u);
+  EXPECT_EQ(get_logs_requests_, 1u);
+  EXPECT_TRUE(observer.logs().empty());
+
+  // Only the new block is queried and only its log is delivered.
+  block_number_ = 0x102;
+  chain_logs_.push_back(MakeLog(GetContractAddress(7), 0x101));
+  task_environment_.FastForwardBy(base::Seconds(5));
+  EXPECT_EQ(block_number_requests_, 3u);
+  EXPECT_EQ(get_logs_requests_, 2u);
+  EXPECT_EQ(*last_filter_.FindString("fromBlock"), "0x101");
+  EXPECT_EQ(*last_filter_.FindString("toBlock"), "0x102");
+  ASSERT_EQ(observer.logs().size(), 1u);
+  EXPECT_EQ(observer.logs().at(GetSubscriptionId(7)).size(), 1u);
+
+  // Removed subscriptions are dropped from the query.
+  tracker.RemoveSubscriber(GetSubscriptionId(7));
+  block_number_ = 0x103;
+  task_environment_.FastForwardBy(base::Seconds(5));
+  EXPECT_EQ(get_logs_requests_, 3u);
+  EXPECT_EQ(last_filter_.FindList("address")->size(), kSubscriptionsCount - 1);
+}
+
+TEST_F(EthLogsTrackerUnitTest, WildcardFilters) {
+  EthLogsTracker tracker(json_rpc_service_.get());
+  TestLogsObserver observer(&tracker);
+  AddSubscribers(&tracker);
+  // Any address, any topics.
+  tracker.AddSubscriber("0xall", base::Value::Dict());
+  chain_logs_.push_back(MakeLog(GetContractAddress(3), block_number_));
+  chain_logs_.push_back(
+      MakeLog(GetContractAddress(kSubscriptionsCount), block_number_));
+
+  tracker.Start(mojom::kMainnetChainId, base::Seconds(5));
+  task_environment_.FastForwardBy(base::Seconds(5));
+
+  EXPECT_EQ(get_logs_requests_, 1u);
+  EXPECT_FALSE(last_filter_.Find("address"));
+  EXPECT_FALSE(last_filter_.Find("topics"));
+  ASSERT_EQ(observer.logs().size(), 2u);
+  EXPECT_EQ(observer.logs().at(GetSubscriptionId(3)).size(), 1u);
+  EXPECT_EQ(observer.logs().at("0xall").size(), 2u);
+}
+
+TEST_F(EthLogsTrackerUnitTest, FailedQueryIsRetried) {
+  EthLogsTracker tracker(json_rpc_service_.get());
+  TestLogsObserver observer(&tracker);
+  AddSubscribers(&tracker);
+  tracker.Start(mojom::kMainnetChainId, base::Seconds(5));
+  task_environment_.FastForwardBy(base::Seconds(5));
+  EXPECT_EQ(get_logs_requests_, 1u);
+
+  block_number_ = 0x101;
+  chain_logs_.push_back(MakeLog(GetContractAddress(3), block_number_));
+  fail_get_logs_ = true;
+  task_environment_.FastForwardBy(base::Seconds(5));
+  EXPECT_EQ(get_logs_requests_, 2u);
+  EXPECT_TRUE(observer.logs().empty());
+
+  // The cursor only moves once logs were received.
+  block_number_ = 0x102;
+  fail_get_logs_ = false;
+  task_environment_.FastForwardBy(base::Seconds(5));
+  EXPECT_EQ(get_logs_requests_, 3u);
+  EXPECT_EQ(*last_filter_.FindString("fromBlock"), "0x101");
+  ASSERT_EQ(observer.logs().size(), 1u);
+  EXPECT_EQ(observer.logs().at(GetSubscriptionId(3)).size(), 1u);
+}
+
+TEST_F(EthLogsTrackerUnitTest, LongRangeIsQueriedInChunks) {
+  EthLogsTracker tracker(json_rpc_service_.get());
+  TestLogsObserver observer(&tracker);
+  AddSubscribers(&tracker);
+  tracker.Start(mojom::kMainnetChainId, base::Seconds(5));
+  task_environment_.FastForwardBy(base::Seconds(5));
+  ASSERT_EQ(get_logs_requests_, 1u);
+  queried_ranges_.clear();
+
+  // 2500 new blocks, e.g. after the tracker wasn't polled for a while.
+  const uint256_t first_block = block_number_ + 1;
+  block_number_ += 2500;
+  chain_logs_.push_back(MakeLog(GetContractAddress(1), first_block));
+  chain_logs_.push_back(MakeLog(GetContractAddress(2), first_block + 1000));
+  chain_logs_.push_back(MakeLog(GetContractAddress(3), block_number_));
+  task_environment_.FastForwardBy(base::Seconds(5));
+
+  EXPECT_EQ(block_number_requests_, 2u);
+  const std::vector<std::pair<std::string, std::string>> expected_ranges = {
+      {Uint256ValueToHex(first_block), Uint256ValueToHex(first_block + 999)},
+      {Uint256ValueToHex(first_block + 1000),
+       Uint256ValueToHex(first_block + 1999)},
+      {Uint256ValueToHex(first_block + 2000), Uint256ValueToHex(block_number_)},
+  };
+  EXPECT_EQ(queried_ranges_, expected_ranges);
+  ASSERT_EQ(observer.logs().size(), 3u);
+  EXPECT_EQ(observer.logs().at(GetSubscriptionId(1)).size(), 1u);
+  EXPECT_EQ(observer.logs().at(GetSubscriptionId(2)).size(), 1u);
+  EXPECT_EQ(observer.logs().at(GetSubscriptionId(3)).size(), 1u);
+
+  // The cursor moved past the last chunk.
+  queried_ranges_.clear();
+  block_number_++;
+  task_environment_.FastForwardBy(base::Seconds(5));
+  ASSERT_EQ(queried_ranges_.size(), 1u);
+  EXPECT_EQ(queried_ranges_[0].first, Uint256ValueToHex(block_number_));
+}
+
+TEST_F(EthLogsTrackerUnitTest, FailedChunkIsRetried) {
+  EthLogsTracker tracker(json_rpc_service_.get());
+  TestLogsObserver observer(&tracker);
+  AddSubscribers(&tracker);
+  tracker.Start(mojom::kMainnetChainId, base::Seconds(5));
+  task_environment_.FastForwardBy(base::Seconds(5));
+
+  const uint256_t first_block = block_number_ + 1;
+  block_number_ += 1500;
+  fail_get_logs_ = true;
+  task_environment_.FastForwardBy(base::Seconds(5));
+  EXPECT_EQ(get_logs_requests_, 2u);
+
+  // Querying resumes at the failed chunk.
+  fail_get_logs_ = false;
+  queried_ranges_.clear();
+  task_environment_.FastForwardBy(base::Seconds(5));
+  ASSERT_EQ(queried_ranges_.size(), 2u);
+  EXPECT_EQ(queried_ranges_[0].first, Uint256ValueToHex(first_block));
+  EXPECT_EQ(queried_ranges_[1].second, Uint256ValueToHex(block_number_));
+}
+
+}  // namespace brave_wallet
@@ -1531,20 +1531,13 @@ void EthereumProviderImpl::OnNewBlock(const std::string& chain_id,
                                       uint256_t block_num) {}
 
 void EthereumProviderImpl::OnLogsReceived(const std::string& subscription,
-                                          base::Value rawlogs) {
-  if (!rawlogs.is_dict() || !events_listener_.is_bound()) {
-    return;
-  }
-
-  auto& dict = rawlogs.GetDict();
-  const base::Value::List* results = dict.FindList("result");
-
-  if (results == nullptr) {
+                                          const base::Value::List& logs) {
+  if (!events_listener_.is_bound()) {
     return;
   }
 
-  for (auto& results_item : *results) {
-    events_listener_->MessageEvent(subscription, results_item.Clone());
+  for (const auto& log : logs) {
+    events_listener_->MessageEvent(subscription, log.Clone());
   }
 }
 
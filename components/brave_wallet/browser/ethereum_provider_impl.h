@@ -293,7 +293,7 @@ class EthereumProviderImpl final : public mojom::EthereumProvider,
 
   // EthLogsTracker::Observer:
   void OnLogsReceived(const std::string& subscription,
-                      base::Value rawlogs) override;
+                      const base::Value::List& logs) override;
   bool UnsubscribeLogObserver(const std::string& subscription_id);
 
   raw_ptr<HostContentSettingsMap> host_content_settings_map_ = nullptr;
@@ -242,6 +242,33 @@ T* GetCustomEVMNetworkFromPrefsDict(const std::string& chain_id,
   return nullptr;
 }
 
+// Returns the eth_call data of tokenURI(uint256) for ERC721 or uri(uint256)
+// for ERC1155 metadata interfaces.
+absl::optional<std::string> GetTokenUriCallData(
+    const std::string& token_id,
+    const std::string& interface_id) {
+  brave_wallet::uint256_t token_id_uint = 0;
+  if (!brave_wallet::HexValueToUint256(token_id, &token_id_uint)) {
+    return absl::nullopt;
+  }
+
+  std::string function_signature;
+  if (interface_id == brave_wallet::kERC721MetadataInterfaceId) {
+    if (!brave_wallet::erc721::TokenUri(token_id_uint, &function_signature)) {
+      return absl::nullopt;
+    }
+  } else if (interface_id == brave_wallet::kERC1155MetadataInterfaceId) {
+    if (!brave_wallet::erc1155::Uri(token_id_uint, &function_signature)) {
+      return absl::nullopt;
+    }
+  } else {
+    // Unknown inteface ID
+    return absl::nullopt;
+  }
+
+  return function_signature;
+}
+
 namespace solana {
 // https://github.com/solana-labs/solana/blob/f7b2951c79cd07685ed62717e78ab1c200924924/rpc/src/rpc.rs#L1717
 constexpr char kAccountNotCreatedError[] = "could not find account";
@@ -2403,44 +2430,93 @@ void JsonRpcService::GetEthTokenUri(const std::string& chain_id,
     return;
   }
 
-  uint256_t token_id_uint = 0;
-  if (!HexValueToUint256(token_id, &token_id_uint)) {
+  auto function_signature = GetTokenUriCallData(token_id, interface_id);
+  if (!function_signature) {
     std::move(callback).Run(
         GURL(), mojom::ProviderError::kInvalidParams,
         l10n_util::GetStringUTF8(IDS_WALLET_INVALID_PARAMETERS));
     return;
   }
 
-  std::string function_signature;
-  if (interface_id == kERC721MetadataInterfaceId) {
-    if (!erc721::TokenUri(token_id_uint, &function_signature)) {
-      std::move(callback).Run(
-          GURL(), mojom::ProviderError::kInvalidParams,
-          l10n_util::GetStringUTF8(IDS_WALLET_INVALID_PARAMETERS));
-      return;
-    }
-  } else if (interface_id == kERC1155MetadataInterfaceId) {
-    if (!erc1155::Uri(token_id_uint, &function_signature)) {
+  auto internal_callback =
+      base::BindOnce(&JsonRpcService::OnGetEthTokenUri,
+                     weak_ptr_factory_.GetWeakPtr(), std::move(callback));
+
+  RequestInternal(eth::eth_call("", contract_address, "", "", "",
+                                *function_signature, kEthereumBlockTagLatest),
+                  true, network_url, std::move(internal_callback));
+}
+
+void JsonRpcService::GetEthTokenUris(const std::string& chain_id,
+                                     const std::string& contract_address,
+                                     const std::vector<std::string>& token_ids,
+                                     const std::string& interface_id,
+                                     GetEthTokenUrisCallback callback) {
+  auto network_url = GetNetworkURL(prefs_, chain_id, mojom::CoinType::ETH);
+  if (!network_url.is_valid() ||
+      !EthAddress::IsValidAddress(contract_address)) {
+    std::move(callback).Run(
+        {}, mojom::ProviderError::kInvalidParams,
+        l10n_util::GetStringUTF8(IDS_WALLET_INVALID_PARAMETERS));
+    return;
+  }
+
+  // A JSON-RPC batch, the id of each call is the index of its token.
+  base::Value::List batch;
+  for (size_t i = 0; i < token_ids.size(); ++i) {
+    auto function_signature = GetTokenUriCallData(token_ids[i], interface_id);
+    if (!function_signature) {
       std::move(callback).Run(
-          GURL(), mojom::ProviderError::kInvalidParams,
+          {}, mojom::ProviderError::kInvalidParams,
           l10n_util::GetStringUTF8(IDS_WALLET_INVALID_PARAMETERS));
       return;
     }
-  } else {
-    // Unknown inteface ID
+
+    base::Value::Dict transaction;
+    transaction.Set("to", contract_address);
+    transaction.Set("data", *function_signature);
+    base::Value::List params;
+    params.Append(std::move(transaction));
+    params.Append(kEthereumBlockTagLatest);
+    auto request = GetJsonRpcDictionary("eth_call", std::move(params));
+    request.Set("id", static_cast<int>(i));
+    batch.Append(std::move(request));
+  }
+
+  auto internal_callback = base::BindOnce(
+      &JsonRpcService::OnGetEthTokenUris, weak_ptr_factory_.GetWeakPtr(),
+      token_ids.size(), std::move(callback));
+  RequestInternal(GetJSON(batch), true, network_url,
+                  std::move(internal_callback));
+}
+
+void JsonRpcService::OnGetEthTokenUris(size_t count,
+                                       GetEthTokenUrisCallback callback,
+                                       APIRequestResult api_request_result) {
+  if (!api_request_result.Is2XXResponseCode() ||
+      !api_request_result.value_body().is_list()) {
     std::move(callback).Run(
-        GURL(), mojom::ProviderError::kInvalidParams,
-        l10n_util::GetStringUTF8(IDS_WALLET_INVALID_PARAMETERS));
+        {}, mojom::ProviderError::kInternalError,
+        l10n_util::GetStringUTF8(IDS_WALLET_INTERNAL_ERROR));
     return;
   }
 
-  auto internal_callback =
-      base::BindOnce(&JsonRpcService::OnGetEthTokenUri,
-                     weak_ptr_factory_.GetWeakPtr(), std::move(callback));
+  // Responses may come in any order.
+  std::vector<GURL> uris(count);
+  for (const auto& response : api_request_result.value_body().GetList()) {
+    const auto* response_dict = response.GetIfDict();
+    absl::optional<int> id =
+        response_dict ? response_dict->FindInt("id") : absl::nullopt;
+    if (!id || *id < 0 || static_cast<size_t>(*id) >= count) {
+      continue;
+    }
+    GURL url;
+    if (eth::ParseTokenUri(response, &url)) {
+      uris[*id] = std::move(url);
+    }
+  }
 
-  RequestInternal(eth::eth_call("", contract_address, "", "", "",
-                                function_signature, kEthereumBlockTagLatest),
-                  true, network_url, std::move(internal_callback));
+  std::move(callback).Run(uris, mojom::ProviderError::kSuccess, "");
 }
 
 void JsonRpcService::OnGetEthTokenUri(GetEthTokenUriCallback callback,
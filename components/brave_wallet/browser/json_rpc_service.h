@@ -378,6 +378,19 @@ class JsonRpcService : public KeyedService, public mojom::JsonRpcService {
                       const std::string& interface_id,
                       GetEthTokenUriCallback callback);
 
+  using GetEthTokenUrisCallback =
+      base::OnceCallback<void(const std::vector<GURL>& uris,
+                              mojom::ProviderError error,
+                              const std::string& error_message)>;
+  // Batched GetEthTokenUri, the calls for all |token_ids| are sent in a single
+  // JSON-RPC batch request. |uris| are in the order of |token_ids|, calls which
+  // failed have an invalid URL.
+  void GetEthTokenUris(const std::string& chain_id,
+                       const std::string& contract_address,
+                       const std::vector<std::string>& token_ids,
+                       const std::string& interface_id,
+                       GetEthTokenUrisCallback callback);
+
   void EthGetLogs(const std::string& chain_id,
                   base::Value::Dict filter_options,
                   EthGetLogsCallback callback);
@@ -649,6 +662,9 @@ class JsonRpcService : public KeyedService, public mojom::JsonRpcService {
 
   void OnGetEthTokenUri(GetEthTokenUriCallback callback,
                         const APIRequestResult api_request_result);
+  void OnGetEthTokenUris(size_t count,
+                         GetEthTokenUrisCallback callback,
+                         APIRequestResult api_request_result);
 
   void OnGetSupportsInterface(GetSupportsInterfaceCallback callback,
                               APIRequestResult api_request_result);
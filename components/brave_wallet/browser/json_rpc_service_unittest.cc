@@ -6647,6 +6647,70 @@ TEST_F(JsonRpcServiceUnitTest, GetEthTokenUri) {
                      mojom::ProviderError::kSuccess, "");
 }
 
+TEST_F(JsonRpcServiceUnitTest, GetEthTokenUris) {
+  const std::vector<std::string> token_ids = {"0x1", "0x2", "0x3"};
+  auto network = GetNetwork(mojom::kMainnetChainId, mojom::CoinType::ETH);
+  size_t requests = 0;
+  url_loader_factory_.SetInterceptor(
+      base::BindLambdaForTesting([&](const network::ResourceRequest& request) {
+        requests++;
+        auto batch = ToValue(request);
+        ASSERT_TRUE(batch && batch->is_list());
+        ASSERT_EQ(batch->GetList().size(), token_ids.size());
+        for (const auto& call : batch->GetList()) {
+          EXPECT_EQ(*call.GetDict().FindString("method"), "eth_call");
+        }
+
+        // Out of order, the call of the second token failed.
+        url_loader_factory_.ClearResponses();
+        url_loader_factory_.AddResponse(network.spec(), R"([{
+            "jsonrpc":"2.0",
+            "id":2,
+            "result":"0x0000000000000000000000000000000000000000000000000000000000000020000000000000000000000000000000000000000000000000000000000000002468747470733a2f2f696e76697369626c65667269656e64732e696f2f6170692f3138313700000000000000000000000000000000000000000000000000000000"
+          }, {
+            "jsonrpc":"2.0",
+            "id":1,
+            "error":{"code":-32005,"message":"Request exceeds defined limit"}
+          }, {
+            "jsonrpc":"2.0",
+            "id":0,
+            "result":"0x0000000000000000000000000000000000000000000000000000000000000020000000000000000000000000000000000000000000000000000000000000002468747470733a2f2f696e76697369626c65667269656e64732e696f2f6170692f3138313700000000000000000000000000000000000000000000000000000000"
+          }])");
+      }));
+
+  base::RunLoop run_loop;
+  json_rpc_service_->GetEthTokenUris(
+      mojom::kMainnetChainId, "0x59468516a8259058bad1ca5f8f4bff190d30e066",
+      token_ids, kERC721MetadataInterfaceId,
+      base::BindLambdaForTesting([&](const std::vector<GURL>& uris,
+                                     mojom::ProviderError error,
+                                     const std::string& error_message) {
+        EXPECT_EQ(error, mojom::ProviderError::kSuccess);
+        ASSERT_EQ(uris.size(), token_ids.size());
+        EXPECT_EQ(uris[0], GURL("https://invisiblefriends.io/api/1817"));
+        EXPECT_FALSE(uris[1].is_valid());
+        EXPECT_EQ(uris[2], GURL("https://invisiblefriends.io/api/1817"));
+        run_loop.Quit();
+      }));
+  run_loop.Run();
+  EXPECT_EQ(requests, 1u);
+
+  // A provider which doesn't support batches.
+  SetInvalidJsonInterceptor();
+  base::RunLoop run_loop2;
+  json_rpc_service_->GetEthTokenUris(
+      mojom::kMainnetChainId, "0x59468516a8259058bad1ca5f8f4bff190d30e066",
+      token_ids, kERC721MetadataInterfaceId,
+      base::BindLambdaForTesting([&](const std::vector<GURL>& uris,
+                                     mojom::ProviderError error,
+                                     const std::string& error_message) {
+        EXPECT_EQ(error, mojom::ProviderError::kInternalError);
+        EXPECT_TRUE(uris.empty());
+        run_loop2.Quit();
+      }));
+  run_loop2.Run();
+}
+
 TEST_F(JsonRpcServiceUnitTest, GetEthNftStandard) {
   std::vector<std::string> interfaces;
   // Empty interface IDs yields invalid params error
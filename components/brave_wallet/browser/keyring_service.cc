@@ -33,6 +33,7 @@
 #include "brave/components/brave_wallet/browser/pref_names.h"
 #include "brave/components/brave_wallet/browser/solana_keyring.h"
 #include "brave/components/brave_wallet/browser/zcash/zcash_keyring.h"
+#include "brave/components/brave_wallet/common/bitcoin_utils.h"
 #include "brave/components/brave_wallet/common/brave_wallet.mojom.h"
 #include "brave/components/brave_wallet/common/brave_wallet_constants.h"
 #include "brave/components/brave_wallet/common/brave_wallet_types.h"
@@ -145,6 +146,11 @@ const char kCoinType[] = "coin_type";
 const char kLegacyBraveWallet[] = "legacy_brave_wallet";
 const char kHardwareAccounts[] = "hardware";
 const char kHardwareDerivationPath[] = "derivation_path";
+const char kBitcoinNextReceiveIndex[] = "bitcoin_next_receive_index";
+const char kBitcoinNextChangeIndex[] = "bitcoin_next_change_index";
+const char kBitcoinPublicKeys[] = "bitcoin_public_keys";
+const char kBitcoinAddress[] = "address";
+const char kBitcoinPubkey[] = "pubkey";
 
 std::string KeyringIdPrefString(mojom::KeyringId keyring_id) {
   switch (keyring_id) {
@@ -345,6 +351,49 @@ base::Value::Dict& GetDictPrefForKeyringUpdate(
               ->EnsureDict(key);
 }
 
+// Persisted addresses and public keys of the receive or change chain of a
+// bitcoin account, indexed by address index.
+const base::Value::List* GetBitcoinPublicKeys(
+    const PrefService& profile_prefs,
+    const mojom::AccountId& account_id,
+    uint32_t change) {
+  const base::Value::Dict* public_keys = GetPrefForKeyringDict(
+      profile_prefs, kBitcoinPublicKeys, account_id.keyring_id);
+  if (!public_keys) {
+    return nullptr;
+  }
+  const base::Value::Dict* account_public_keys = public_keys->FindDict(
+      base::NumberToString(account_id.bitcoin_account_index));
+  if (!account_public_keys) {
+    return nullptr;
+  }
+  return account_public_keys->FindList(base::NumberToString(change));
+}
+
+const base::Value::Dict* FindBitcoinPublicKey(
+    const PrefService& profile_prefs,
+    const mojom::AccountId& account_id,
+    const mojom::BitcoinKeyId& key_id) {
+  const base::Value::List* public_keys =
+      GetBitcoinPublicKeys(profile_prefs, account_id, key_id.change);
+  if (!public_keys || key_id.index >= public_keys->size()) {
+    return nullptr;
+  }
+  return (*public_keys)[key_id.index].GetIfDict();
+}
+
+base::Value::List& GetBitcoinPublicKeysForUpdate(
+    ScopedDictPrefUpdate& dict_update,
+    const mojom::AccountId& account_id,
+    uint32_t change) {
+  base::Value::Dict& public_keys = GetDictPrefForKeyringUpdate(
+      dict_update, kBitcoinPublicKeys, account_id.keyring_id);
+  const std::string account_index =
+      base::NumberToString(account_id.bitcoin_account_index);
+  return *public_keys.EnsureDict(account_index)
+              ->EnsureList(base::NumberToString(change));
+}
+
 // Utility structure that helps storing imported accounts in prefs.
 struct ImportedAccountInfo {
   ImportedAccountInfo(std::string account_name,
@@ -465,6 +514,14 @@ struct DerivedAccountInfo {
     derived_account.Set(kAccountIndex, base::NumberToString(account_index));
     derived_account.Set(kAccountName, account_name);
     derived_account.Set(kAccountAddress, account_address);
+    if (bitcoin_next_receive_index) {
+      derived_account.Set(kBitcoinNextReceiveIndex,
+                          base::NumberToString(*bitcoin_next_receive_index));
+    }
+    if (bitcoin_next_change_index) {
+      derived_account.Set(kBitcoinNextChangeIndex,
+                          base::NumberToString(*bitcoin_next_change_index));
+    }
     return base::Value(std::move(derived_account));
   }
 
@@ -488,12 +545,30 @@ struct DerivedAccountInfo {
       return absl::nullopt;
     }
 
-    return DerivedAccountInfo(account_index, *account_name, *account_address);
+    DerivedAccountInfo result(account_index, *account_name, *account_address);
+    uint32_t next_index = 0;
+    if (const auto* next_receive_index =
+            value_dict->FindString(kBitcoinNextReceiveIndex);
+        next_receive_index &&
+        base::StringToUint(*next_receive_index, &next_index)) {
+      result.bitcoin_next_receive_index = next_index;
+    }
+    if (const auto* next_change_index =
+            value_dict->FindString(kBitcoinNextChangeIndex);
+        next_change_index &&
+        base::StringToUint(*next_change_index, &next_index)) {
+      result.bitcoin_next_change_index = next_index;
+    }
+    return result;
   }
 
   uint32_t account_index;
   std::string account_name;
   std::string account_address;
+  // Indexes of the first unused receive and change addresses of a bitcoin
+  // account.
+  absl::optional<uint32_t> bitcoin_next_receive_index;
+  absl::optional<uint32_t> bitcoin_next_change_index;
 };
 
 // Gets all hd account from prefs.
@@ -1500,7 +1575,16 @@ mojom::AccountInfoPtr KeyringService::AddAccountForKeyring(
   AddDerivedAccountInfoForKeyring(profile_prefs_, derived_account_info,
                                   keyring_id);
 
-  return MakeAccountInfoForDerivedAccount(derived_account_info, keyring_id);
+  auto account_info =
+      MakeAccountInfoForDerivedAccount(derived_account_info, keyring_id);
+  if (IsBitcoinKeyring(keyring_id)) {
+    for (const uint32_t change : {kBitcoinReceiveIndex, kBitcoinChangeIndex}) {
+      PersistBitcoinPublicKeys(*account_info->account_id, change,
+                               kBitcoinAddressGap);
+    }
+  }
+
+  return account_info;
 }
 
 mojom::AccountInfoPtr KeyringService::ImportAccountForKeyring(
@@ -2517,36 +2601,118 @@ absl::optional<std::vector<std::pair<std::string, mojom::BitcoinKeyIdPtr>>>
 KeyringService::GetBitcoinAddresses(const mojom::AccountId& account_id) {
   CHECK(IsBitcoinAccount(account_id));
 
+  // Used addresses followed by a gap of unused ones.
+  std::vector<std::pair<std::string, mojom::BitcoinKeyIdPtr>> addresses;
+  for (const uint32_t change : {kBitcoinReceiveIndex, kBitcoinChangeIndex}) {
+    const uint32_t addresses_count =
+        GetBitcoinNextAddressIndex(account_id, change) + kBitcoinAddressGap;
+    for (uint32_t i = 0; i < addresses_count; ++i) {
+      auto key_id = mojom::BitcoinKeyId::New(account_id.bitcoin_account_index,
+                                             change, i);
+      auto address = GetBitcoinAddress(account_id, *key_id);
+      if (!address) {
+        return absl::nullopt;
+      }
+      addresses.emplace_back(std::move(*address), std::move(key_id));
+    }
+  }
+
+  return addresses;
+}
+
+bool KeyringService::PersistBitcoinPublicKeys(
+    const mojom::AccountId& account_id,
+    uint32_t change,
+    uint32_t count) {
+  const base::Value::List* persisted_public_keys =
+      GetBitcoinPublicKeys(*profile_prefs_, account_id, change);
+  if (persisted_public_keys && persisted_public_keys->size() >= count) {
+    return true;
+  }
+
   auto* bitcoin_keyring = GetBitcoinKeyringById(account_id.keyring_id);
   if (!bitcoin_keyring) {
-    return absl::nullopt;
+    return false;
   }
 
-  // TODO(apaymyshev): store used addresses indexes in prefs.
+  ScopedDictPrefUpdate keyrings_update(profile_prefs_, kBraveWalletKeyrings);
+  base::Value::List& public_keys =
+      GetBitcoinPublicKeysForUpdate(keyrings_update, account_id, change);
+  for (uint32_t i = public_keys.size(); i < count; ++i) {
+    const mojom::BitcoinKeyId key_id(account_id.bitcoin_account_index, change,
+                                     i);
+    auto address = bitcoin_keyring->GetAddress(key_id);
+    auto pubkey = bitcoin_keyring->GetPubkey(key_id);
+    if (!address || !pubkey) {
+      return false;
+    }
+    base::Value::Dict public_key;
+    public_key.Set(kBitcoinAddress, *address);
+    public_key.Set(kBitcoinPubkey, base::HexEncode(*pubkey));
+    public_keys.Append(std::move(public_key));
+  }
 
-  // TODO(apaymyshev): temporarily just return first 5 recieve and 5 change
-  // addresses.
-  std::vector<std::pair<std::string, mojom::BitcoinKeyIdPtr>> addresses;
-  for (auto i = 0; i < 5; ++i) {
-    auto key_id =
-        mojom::BitcoinKeyId::New(account_id.bitcoin_account_index, 0, i);
-    auto address = bitcoin_keyring->GetAddress(*key_id);
-    if (!address) {
-      return absl::nullopt;
+  return true;
+}
+
+uint32_t KeyringService::GetBitcoinNextAddressIndex(
+    const mojom::AccountId& account_id,
+    uint32_t change) {
+  CHECK(IsBitcoinAccount(account_id));
+  DCHECK(change == kBitcoinReceiveIndex || change == kBitcoinChangeIndex);
+
+  for (const auto& derived_account :
+       GetDerivedAccountsForKeyring(profile_prefs_, account_id.keyring_id)) {
+    if (derived_account.account_index != account_id.bitcoin_account_index) {
+      continue;
     }
-    addresses.emplace_back(*address, std::move(key_id));
+    return (change == kBitcoinChangeIndex
+                ? derived_account.bitcoin_next_change_index
+                : derived_account.bitcoin_next_receive_index)
+        .value_or(0);
   }
-  for (auto i = 0; i < 5; ++i) {
-    auto key_id =
-        mojom::BitcoinKeyId::New(account_id.bitcoin_account_index, 1, i);
-    auto address = bitcoin_keyring->GetAddress(*key_id);
-    if (!address) {
-      return absl::nullopt;
+
+  return 0;
+}
+
+void KeyringService::UpdateBitcoinNextAddressIndex(
+    const mojom::AccountId& account_id,
+    uint32_t change,
+    uint32_t next_index) {
+  CHECK(IsBitcoinAccount(account_id));
+  DCHECK(change == kBitcoinReceiveIndex || change == kBitcoinChangeIndex);
+
+  bool updated = false;
+  {
+    ScopedDictPrefUpdate keyrings_update(profile_prefs_, kBraveWalletKeyrings);
+    base::Value::List& account_metas = GetListPrefForKeyringUpdate(
+        keyrings_update, kAccountMetas, account_id.keyring_id);
+    for (auto& item : account_metas) {
+      auto derived_account = DerivedAccountInfo::FromValue(item);
+      if (!derived_account ||
+          derived_account->account_index != account_id.bitcoin_account_index) {
+        continue;
+      }
+
+      auto& stored_index = change == kBitcoinChangeIndex
+                               ? derived_account->bitcoin_next_change_index
+                               : derived_account->bitcoin_next_receive_index;
+      // Addresses never become unused again.
+      if (stored_index.value_or(0) < next_index) {
+        stored_index = next_index;
+        item = derived_account->ToValue();
+        updated = true;
+      }
+      break;
     }
-    addresses.emplace_back(*address, std::move(key_id));
   }
 
-  return addresses;
+  if (updated) {
+    // Keys of the addresses the gap moved over are derived and persisted once
+    // here, as the addresses are listed on every refresh.
+    PersistBitcoinPublicKeys(account_id, change,
+                             next_index + kBitcoinAddressGap);
+  }
 }
 
 absl::optional<std::string> KeyringService::GetBitcoinAddress(
@@ -2555,6 +2721,13 @@ absl::optional<std::string> KeyringService::GetBitcoinAddress(
   CHECK(IsBitcoinAccount(account_id));
   CHECK_EQ(account_id.bitcoin_account_index, key_id.account);
 
+  if (const auto* public_key =
+          FindBitcoinPublicKey(*profile_prefs_, account_id, key_id)) {
+    if (const auto* address = public_key->FindString(kBitcoinAddress)) {
+      return *address;
+    }
+  }
+
   auto* bitcoin_keyring = GetBitcoinKeyringById(account_id.keyring_id);
   if (!bitcoin_keyring) {
     return absl::nullopt;
@@ -2569,6 +2742,15 @@ absl::optional<std::vector<uint8_t>> KeyringService::GetBitcoinPubkey(
   CHECK(IsBitcoinAccount(account_id));
   CHECK_EQ(account_id.bitcoin_account_index, key_id.account);
 
+  if (const auto* public_key =
+          FindBitcoinPublicKey(*profile_prefs_, account_id, key_id)) {
+    std::vector<uint8_t> pubkey;
+    if (const auto* pubkey_hex = public_key->FindString(kBitcoinPubkey);
+        pubkey_hex && base::HexStringToBytes(*pubkey_hex, &pubkey)) {
+      return pubkey;
+    }
+  }
+
   auto* bitcoin_keyring = GetBitcoinKeyringById(account_id.keyring_id);
   if (!bitcoin_keyring) {
     return absl::nullopt;
@@ -2593,6 +2775,22 @@ KeyringService::SignMessageByBitcoinKeyring(
   return bitcoin_keyring->SignMessage(key_id, message);
 }
 
+absl::optional<std::vector<std::vector<uint8_t>>>
+KeyringService::SignMessagesByBitcoinKeyring(
+    const mojom::AccountId& account_id,
+    const mojom::BitcoinKeyId& key_id,
+    const std::vector<SHA256HashArray>& messages) {
+  CHECK(IsBitcoinAccount(account_id));
+  CHECK_EQ(account_id.bitcoin_account_index, key_id.account);
+
+  auto* bitcoin_keyring = GetBitcoinKeyringById(account_id.keyring_id);
+  if (!bitcoin_keyring) {
+    return absl::nullopt;
+  }
+
+  return bitcoin_keyring->SignMessages(key_id, messages);
+}
+
 void KeyringService::ResetAllAccountInfosCache() {
   account_info_cache_.reset();
 }
@@ -19,6 +19,7 @@
 #include "brave/components/brave_wallet/browser/password_encryptor.h"
 #include "brave/components/brave_wallet/common/brave_wallet.mojom.h"
 #include "brave/components/brave_wallet/common/brave_wallet_types.h"
+#include "brave/components/brave_wallet/common/hash_utils.h"
 #include "components/keyed_service/core/keyed_service.h"
 #include "mojo/public/cpp/bindings/pending_remote.h"
 #include "mojo/public/cpp/bindings/receiver_set.h"
@@ -215,8 +216,21 @@ class KeyringService : public KeyedService, public mojom::KeyringService {
       HasPendingUnlockRequestCallback callback) override;
   absl::optional<size_t> GetAccountsNumber(mojom::KeyringId keyring_id);
 
+  // Returns the used addresses of a bitcoin account followed by
+  // kBitcoinAddressGap unused ones, for both receive and change chains.
+  // Addresses and public keys are persisted in prefs when the account is
+  // created and when discovery moves the gap forward, so they are known while
+  // the wallet is locked. Others are derived without being persisted.
   absl::optional<std::vector<std::pair<std::string, mojom::BitcoinKeyIdPtr>>>
   GetBitcoinAddresses(const mojom::AccountId& account_id);
+  // Index of the first address after the last used one on the receive
+  // (kBitcoinReceiveIndex) or change (kBitcoinChangeIndex) chain. Persisted in
+  // prefs.
+  uint32_t GetBitcoinNextAddressIndex(const mojom::AccountId& account_id,
+                                      uint32_t change);
+  void UpdateBitcoinNextAddressIndex(const mojom::AccountId& account_id,
+                                     uint32_t change,
+                                     uint32_t next_index);
   absl::optional<std::string> GetBitcoinAddress(
       const mojom::AccountId& account_id,
       const mojom::BitcoinKeyId& key_id);
@@ -227,6 +241,10 @@ class KeyringService : public KeyedService, public mojom::KeyringService {
       const mojom::AccountId& account_id,
       const mojom::BitcoinKeyId& key_id,
       base::span<const uint8_t, 32> message);
+  absl::optional<std::vector<std::vector<uint8_t>>>
+  SignMessagesByBitcoinKeyring(const mojom::AccountId& account_id,
+                               const mojom::BitcoinKeyId& key_id,
+                               const std::vector<SHA256HashArray>& messages);
 
   const std::vector<mojom::AccountInfoPtr>& GetAllAccountInfos();
   mojom::AccountInfoPtr GetSelectedWalletAccount();
@@ -307,6 +325,13 @@ class KeyringService : public KeyedService, public mojom::KeyringService {
   void OnAutoLockFired();
   HDKeyring* GetHDKeyringById(mojom::KeyringId keyring_id) const;
   BitcoinKeyring* GetBitcoinKeyringById(mojom::KeyringId keyring_id) const;
+  // Derives and persists the address and public key of the first |count| keys
+  // of the receive or change chain of a bitcoin account. Returns false if some
+  // aren't persisted yet and the wallet is locked. Called when the account is
+  // created and when its next address index moves forward.
+  bool PersistBitcoinPublicKeys(const mojom::AccountId& account_id,
+                                uint32_t change,
+                                uint32_t count);
   std::vector<mojom::AccountInfoPtr> GetHardwareAccountsSync(
       mojom::KeyringId keyring_id) const;
   // Address will be returned when success
@@ -5,18 +5,26 @@
 
 #include "brave/components/brave_wallet/browser/nft_metadata_fetcher.h"
 
+#include <algorithm>
 #include <utility>
 #include <vector>
 
 #include "base/base64.h"
+#include "base/json/values_util.h"
+#include "base/strings/strcat.h"
+#include "base/strings/string_util.h"
+#include "base/task/sequenced_task_runner.h"
 #include "brave/components/brave_wallet/browser/brave_wallet_constants.h"
 #include "brave/components/brave_wallet/browser/brave_wallet_utils.h"
 #include "brave/components/brave_wallet/browser/eth_data_builder.h"
 #include "brave/components/brave_wallet/browser/eth_response_parser.h"
 #include "brave/components/brave_wallet/browser/json_rpc_service.h"
+#include "brave/components/brave_wallet/browser/pref_names.h"
 #include "brave/components/brave_wallet/common/hex_utils.h"
 #include "brave/components/ipfs/buildflags/buildflags.h"
 #include "build/build_config.h"
+#include "components/prefs/pref_service.h"
+#include "components/prefs/scoped_user_pref_update.h"
 #include "services/network/public/cpp/shared_url_loader_factory.h"
 #include "ui/base/l10n/l10n_util.h"
 
@@ -27,6 +35,20 @@
 
 namespace {
 
+constexpr char kTokenUrlKey[] = "token_url";
+constexpr char kFetchedAtKey[] = "fetched_at";
+
+constexpr base::TimeDelta kEthTokenMetadataCacheTTL = base::Days(1);
+constexpr size_t kMaxEthTokenMetadataCacheBytes = 4 * 1024 * 1024;
+// Metadata with inlined images would crowd out everything else.
+constexpr size_t kMaxCachedEthTokenMetadataSize = 32 * 1024;
+constexpr size_t kMaxEthTokenUrlIndexSize = 1000;
+constexpr size_t kMaxIndexedEthTokenUrlSize = 2 * 1024;
+
+// tokenURI calls requested within this delay are sent in the same batch.
+constexpr base::TimeDelta kTokenUriBatchDelay = base::Milliseconds(20);
+constexpr size_t kMaxTokenUriBatchSize = 100;
+
 absl::optional<uint32_t> DecodeUint32(const std::vector<uint8_t>& input,
                                       size_t& offset) {
   if (offset >= input.size() || input.size() - offset < sizeof(uint32_t)) {
@@ -47,6 +69,11 @@ absl::optional<uint32_t> DecodeUint32(const std::vector<uint8_t>& input,
 #endif
 }
 
+template <typename T>
+size_t GetCachedSize(const T& entry) {
+  return entry.token_url.size() + entry.metadata.size();
+}
+
 net::NetworkTrafficAnnotationTag GetNetworkTrafficAnnotationTag() {
   return net::DefineNetworkTrafficAnnotation("nft_metadata_fetcher", R"(
       semantics {
@@ -107,66 +134,317 @@ void NftMetadataFetcher::GetEthTokenMetadata(
     return;
   }
 
-  auto internal_callback =
-      base::BindOnce(&NftMetadataFetcher::OnGetSupportsInterface,
-                     weak_ptr_factory_.GetWeakPtr(), contract_address,
-                     interface_id, token_id, chain_id, std::move(callback));
+  const ContractKey contract_key(chain_id, base::ToLowerASCII(contract_address),
+                                 interface_id);
+  const std::string cache_key = GetMetadataCacheKey(contract_key, token_id);
+  std::string token_url;
+  std::string metadata;
+  if (GetCachedEthTokenMetadata(cache_key, &token_url, &metadata)) {
+    std::move(callback).Run(token_url, metadata,
+                            mojom::ProviderError::kSuccess, "");
+    return;
+  }
+
+  auto& callbacks = pending_metadata_callbacks_[cache_key];
+  callbacks.push_back(std::move(callback));
+  if (callbacks.size() > 1) {
+    return;
+  }
+
+  // A token URL resolved in an earlier session saves the supportsInterface
+  // and tokenURI calls.
+  if (auto indexed_token_url = GetIndexedEthTokenUrl(cache_key)) {
+    OnGetEthTokenUri(cache_key, *indexed_token_url,
+                     mojom::ProviderError::kSuccess, "");
+    return;
+  }
+
+  auto supports_interface = supports_interface_cache_.find(contract_key);
+  if (supports_interface != supports_interface_cache_.end()) {
+    if (!supports_interface->second) {
+      RunEthTokenMetadataCallbacks(
+          cache_key, "", "", mojom::ProviderError::kMethodNotSupported,
+          l10n_util::GetStringUTF8(IDS_WALLET_METHOD_NOT_SUPPORTED_ERROR));
+      return;
+    }
+    QueueEthTokenUri(contract_key, token_id);
+    return;
+  }
+
+  auto& waiting_tokens = pending_supports_interface_[contract_key];
+  waiting_tokens.push_back(token_id);
+  if (waiting_tokens.size() > 1) {
+    return;
+  }
 
   json_rpc_service_->GetSupportsInterface(
-      contract_address, interface_id, chain_id, std::move(internal_callback));
+      contract_address, interface_id, chain_id,
+      base::BindOnce(&NftMetadataFetcher::OnGetSupportsInterface,
+                     weak_ptr_factory_.GetWeakPtr(), contract_key));
+}
+
+// static
+std::string NftMetadataFetcher::GetMetadataCacheKey(
+    const ContractKey& contract_key,
+    const std::string& token_id) {
+  const auto& [chain_id, contract_address, interface_id] = contract_key;
+  return base::StrCat({chain_id, ".", contract_address, ".", interface_id, ".",
+                       base::ToLowerASCII(token_id)});
+}
+
+bool NftMetadataFetcher::GetCachedEthTokenMetadata(
+    const std::string& cache_key,
+    std::string* token_url,
+    std::string* metadata) {
+  auto it = metadata_cache_.Get(cache_key);
+  if (it == metadata_cache_.end()) {
+    return false;
+  }
+
+  if (base::Time::Now() - it->second.fetched_at > kEthTokenMetadataCacheTTL) {
+    metadata_cache_bytes_ -= GetCachedSize(it->second);
+    metadata_cache_.Erase(it);
+    return false;
+  }
+
+  *token_url = it->second.token_url;
+  *metadata = it->second.metadata;
+  return true;
+}
+
+void NftMetadataFetcher::CacheEthTokenMetadata(const std::string& cache_key,
+                                               const std::string& token_url,
+                                               const std::string& metadata) {
+  const base::Time now = base::Time::Now();
+  IndexEthTokenUrl(cache_key, token_url, now);
+
+  auto existing = metadata_cache_.Peek(cache_key);
+  if (existing != metadata_cache_.end()) {
+    metadata_cache_bytes_ -= GetCachedSize(existing->second);
+    metadata_cache_.Erase(existing);
+  }
+  if (metadata.size() > kMaxCachedEthTokenMetadataSize) {
+    return;
+  }
+
+  CachedEthTokenMetadata entry{token_url, metadata, now};
+  metadata_cache_bytes_ += GetCachedSize(entry);
+  metadata_cache_.Put(cache_key, std::move(entry));
+
+  while (metadata_cache_bytes_ > kMaxEthTokenMetadataCacheBytes) {
+    auto oldest = metadata_cache_.rbegin();
+    metadata_cache_bytes_ -= GetCachedSize(oldest->second);
+    metadata_cache_.Erase(oldest);
+  }
+}
+
+void NftMetadataFetcher::LoadEthTokenUrlIndex() {
+  if (token_url_index_loaded_) {
+    return;
+  }
+  token_url_index_loaded_ = true;
+
+  std::vector<std::pair<std::string, IndexedEthTokenUrl>> entries;
+  const auto& persisted = prefs_->GetDict(kBraveWalletNftTokenUrlIndex);
+  for (const auto [key, value] : persisted) {
+    if (!value.is_dict()) {
+      continue;
+    }
+    const std::string* token_url = value.GetDict().FindString(kTokenUrlKey);
+    auto fetched_at = base::ValueToTime(value.GetDict().Find(kFetchedAtKey));
+    if (!token_url || !fetched_at) {
+      continue;
+    }
+    entries.emplace_back(key, IndexedEthTokenUrl{*token_url, *fetched_at});
+  }
+
+  // The most recently fetched entry goes in last, at the front of the cache.
+  std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+    return a.second.fetched_at < b.second.fetched_at;
+  });
+  for (auto& [key, entry] : entries) {
+    token_url_index_.Put(key, std::move(entry));
+  }
+}
+
+absl::optional<GURL> NftMetadataFetcher::GetIndexedEthTokenUrl(
+    const std::string& cache_key) {
+  LoadEthTokenUrlIndex();
+  auto it = token_url_index_.Peek(cache_key);
+  if (it == token_url_index_.end() ||
+      base::Time::Now() - it->second.fetched_at > kEthTokenMetadataCacheTTL) {
+    return absl::nullopt;
+  }
+
+  GURL token_url(it->second.token_url);
+  if (!token_url.is_valid()) {
+    return absl::nullopt;
+  }
+  return token_url;
+}
+
+void NftMetadataFetcher::IndexEthTokenUrl(const std::string& cache_key,
+                                          const std::string& token_url,
+                                          base::Time fetched_at) {
+  // data: URIs carry the metadata itself, they are left to the memory cache.
+  if (token_url.size() > kMaxIndexedEthTokenUrlSize) {
+    return;
+  }
+
+  LoadEthTokenUrlIndex();
+  ScopedDictPrefUpdate update(prefs_, kBraveWalletNftTokenUrlIndex);
+  base::Value::Dict entry;
+  entry.Set(kTokenUrlKey, token_url);
+  entry.Set(kFetchedAtKey, base::TimeToValue(fetched_at));
+  update->Set(cache_key, std::move(entry));
+  token_url_index_.Put(cache_key, IndexedEthTokenUrl{token_url, fetched_at});
+
+  while (token_url_index_.size() > kMaxEthTokenUrlIndexSize) {
+    auto oldest = token_url_index_.rbegin();
+    update->Remove(oldest->first);
+    token_url_index_.Erase(oldest);
+  }
 }
 
 void NftMetadataFetcher::OnGetSupportsInterface(
-    const std::string& contract_address,
-    const std::string& interface_id,
-    const std::string& token_id,
-    const std::string& chain_id,
-    GetEthTokenMetadataCallback callback,
+    const ContractKey& contract_key,
     bool is_supported,
     mojom::ProviderError error,
     const std::string& error_message) {
+  std::vector<std::string> token_ids;
+  std::swap(token_ids, pending_supports_interface_[contract_key]);
+  pending_supports_interface_.erase(contract_key);
+
   if (error != mojom::ProviderError::kSuccess) {
-    std::move(callback).Run("", "", error, error_message);
+    for (const auto& token_id : token_ids) {
+      RunEthTokenMetadataCallbacks(GetMetadataCacheKey(contract_key, token_id),
+                                   "", "", error, error_message);
+    }
     return;
   }
 
-  if (!is_supported) {
-    std::move(callback).Run(
-        "", "", mojom::ProviderError::kMethodNotSupported,
-        l10n_util::GetStringUTF8(IDS_WALLET_METHOD_NOT_SUPPORTED_ERROR));
+  supports_interface_cache_[contract_key] = is_supported;
+  for (const auto& token_id : token_ids) {
+    if (!is_supported) {
+      RunEthTokenMetadataCallbacks(
+          GetMetadataCacheKey(contract_key, token_id), "", "",
+          mojom::ProviderError::kMethodNotSupported,
+          l10n_util::GetStringUTF8(IDS_WALLET_METHOD_NOT_SUPPORTED_ERROR));
+      continue;
+    }
+    QueueEthTokenUri(contract_key, token_id);
+  }
+}
+
+void NftMetadataFetcher::QueueEthTokenUri(const ContractKey& contract_key,
+                                          const std::string& token_id) {
+  auto& token_ids = pending_token_uris_[contract_key];
+  token_ids.push_back(token_id);
+  if (token_ids.size() > 1) {
     return;
   }
 
-  auto internal_callback =
+  base::SequencedTaskRunner::GetCurrentDefault()->PostDelayedTask(
+      FROM_HERE,
+      base::BindOnce(&NftMetadataFetcher::FlushEthTokenUris,
+                     weak_ptr_factory_.GetWeakPtr(), contract_key),
+      kTokenUriBatchDelay);
+}
+
+void NftMetadataFetcher::FlushEthTokenUris(const ContractKey& contract_key) {
+  std::vector<std::string> token_ids;
+  std::swap(token_ids, pending_token_uris_[contract_key]);
+  pending_token_uris_.erase(contract_key);
+
+  if (token_ids.size() == 1) {
+    GetEthTokenUri(contract_key, token_ids.front());
+    return;
+  }
+
+  const auto& [chain_id, contract_address, interface_id] = contract_key;
+  for (size_t begin = 0; begin < token_ids.size();
+       begin += kMaxTokenUriBatchSize) {
+    const size_t end =
+        std::min(begin + kMaxTokenUriBatchSize, token_ids.size());
+    std::vector<std::string> batch(token_ids.begin() + begin,
+                                   token_ids.begin() + end);
+    json_rpc_service_->GetEthTokenUris(
+        chain_id, contract_address, batch, interface_id,
+        base::BindOnce(&NftMetadataFetcher::OnGetEthTokenUris,
+                       weak_ptr_factory_.GetWeakPtr(), contract_key, batch));
+  }
+}
+
+void NftMetadataFetcher::GetEthTokenUri(const ContractKey& contract_key,
+                                        const std::string& token_id) {
+  const auto& [chain_id, contract_address, interface_id] = contract_key;
+  json_rpc_service_->GetEthTokenUri(
+      chain_id, contract_address, token_id, interface_id,
       base::BindOnce(&NftMetadataFetcher::OnGetEthTokenUri,
-                     weak_ptr_factory_.GetWeakPtr(), std::move(callback));
+                     weak_ptr_factory_.GetWeakPtr(),
+                     GetMetadataCacheKey(contract_key, token_id)));
+}
+
+void NftMetadataFetcher::OnGetEthTokenUris(
+    const ContractKey& contract_key,
+    const std::vector<std::string>& token_ids,
+    const std::vector<GURL>& uris,
+    mojom::ProviderError error,
+    const std::string& error_message) {
+  for (size_t i = 0; i < token_ids.size(); ++i) {
+    // Calls which failed, or the whole batch if the provider doesn't support
+    // batches, are made again one by one for their errors.
+    if (error != mojom::ProviderError::kSuccess || i >= uris.size() ||
+        !uris[i].is_valid()) {
+      GetEthTokenUri(contract_key, token_ids[i]);
+      continue;
+    }
 
-  json_rpc_service_->GetEthTokenUri(chain_id, contract_address, token_id,
-                                    interface_id, std::move(internal_callback));
+    OnGetEthTokenUri(GetMetadataCacheKey(contract_key, token_ids[i]), uris[i],
+                     mojom::ProviderError::kSuccess, "");
+  }
 }
 
-void NftMetadataFetcher::OnGetEthTokenUri(GetEthTokenMetadataCallback callback,
+void NftMetadataFetcher::OnGetEthTokenUri(const std::string& cache_key,
                                           const GURL& uri,
                                           mojom::ProviderError error,
                                           const std::string& error_message) {
   if (error != mojom::ProviderError::kSuccess) {
-    std::move(callback).Run("", "", error, error_message);
+    RunEthTokenMetadataCallbacks(cache_key, "", "", error, error_message);
     return;
   }
 
   if (!uri.is_valid()) {
-    std::move(callback).Run(
-        "", "", mojom::ProviderError::kInternalError,
+    RunEthTokenMetadataCallbacks(
+        cache_key, "", "", mojom::ProviderError::kInternalError,
         l10n_util::GetStringUTF8(IDS_WALLET_INTERNAL_ERROR));
     return;
   }
 
   auto internal_callback =
       base::BindOnce(&NftMetadataFetcher::CompleteGetEthTokenMetadata,
-                     weak_ptr_factory_.GetWeakPtr(), std::move(callback), uri);
+                     weak_ptr_factory_.GetWeakPtr(), cache_key, uri);
   FetchMetadata(uri, std::move(internal_callback));
 }
 
+void NftMetadataFetcher::RunEthTokenMetadataCallbacks(
+    const std::string& cache_key,
+    const std::string& token_url,
+    const std::string& result,
+    mojom::ProviderError error,
+    const std::string& error_message) {
+  auto it = pending_metadata_callbacks_.find(cache_key);
+  if (it == pending_metadata_callbacks_.end()) {
+    return;
+  }
+
+  auto callbacks = std::move(it->second);
+  pending_metadata_callbacks_.erase(it);
+  for (auto& callback : callbacks) {
+    std::move(callback).Run(token_url, result, error, error_message);
+  }
+}
+
 void NftMetadataFetcher::FetchMetadata(
     GURL url,
     GetTokenMetadataIntermediateCallback callback) {
@@ -259,7 +537,7 @@ void NftMetadataFetcher::OnGetTokenMetadataPayload(
 }
 
 void NftMetadataFetcher::CompleteGetEthTokenMetadata(
-    GetEthTokenMetadataCallback callback,
+    const std::string& cache_key,
     const GURL& uri,
     const std::string& response,
     int error,
@@ -268,7 +546,11 @@ void NftMetadataFetcher::CompleteGetEthTokenMetadata(
   if (!mojom::IsKnownEnumValue(mojo_err)) {
     mojo_err = mojom::ProviderError::kUnknown;
   }
-  std::move(callback).Run(uri.spec(), response, mojo_err, error_message);
+  if (mojo_err == mojom::ProviderError::kSuccess) {
+    CacheEthTokenMetadata(cache_key, uri.spec(), response);
+  }
+  RunEthTokenMetadataCallbacks(cache_key, uri.spec(), response, mojo_err,
+                               error_message);
 }
 
 void NftMetadataFetcher::GetSolTokenMetadata(
@@ -6,10 +6,13 @@
 #ifndef BRAVE_COMPONENTS_BRAVE_WALLET_BROWSER_NFT_METADATA_FETCHER_H_
 #define BRAVE_COMPONENTS_BRAVE_WALLET_BROWSER_NFT_METADATA_FETCHER_H_
 
+#include <map>
 #include <memory>
 #include <string>
+#include <tuple>
 #include <vector>
 
+#include "base/containers/lru_cache.h"
 #include "base/gtest_prod_util.h"
 #include "base/memory/raw_ptr.h"
 #include "base/memory/weak_ptr.h"
@@ -23,6 +26,12 @@ namespace brave_wallet {
 
 class JsonRpcService;
 
+// Resolves NFT metadata. Answers of supportsInterface are kept per contract
+// for the session, tokenURI calls for tokens of the same contract are sent as
+// JSON-RPC batches, and resolved ETH token metadata is kept in memory. The
+// token URLs are also persisted in a small index so a later session only has
+// to fetch the metadata, which the HTTP cache usually answers. Concurrent
+// requests for the same token share a single resolution.
 class NftMetadataFetcher {
  public:
   NftMetadataFetcher(
@@ -56,20 +65,57 @@ class NftMetadataFetcher {
                            GetSolTokenMetadataCallback callback);
 
  private:
-  void OnGetSupportsInterface(const std::string& contract_address,
-                              const std::string& interface_id,
-                              const std::string& token_id,
-                              const std::string& chain_id,
-                              // const GURL& network_url,
-                              GetEthTokenMetadataCallback callback,
+  // <chain_id, contract_address, interface_id>
+  using ContractKey = std::tuple<std::string, std::string, std::string>;
+
+  struct CachedEthTokenMetadata {
+    std::string token_url;
+    std::string metadata;
+    base::Time fetched_at;
+  };
+  struct IndexedEthTokenUrl {
+    std::string token_url;
+    base::Time fetched_at;
+  };
+
+  static std::string GetMetadataCacheKey(const ContractKey& contract_key,
+                                         const std::string& token_id);
+  bool GetCachedEthTokenMetadata(const std::string& cache_key,
+                                 std::string* token_url,
+                                 std::string* metadata);
+  void CacheEthTokenMetadata(const std::string& cache_key,
+                             const std::string& token_url,
+                             const std::string& metadata);
+  void LoadEthTokenUrlIndex();
+  absl::optional<GURL> GetIndexedEthTokenUrl(const std::string& cache_key);
+  void IndexEthTokenUrl(const std::string& cache_key,
+                        const std::string& token_url,
+                        base::Time fetched_at);
+
+  void OnGetSupportsInterface(const ContractKey& contract_key,
                               bool is_supported,
                               mojom::ProviderError error,
                               const std::string& error_message);
-
-  void OnGetEthTokenUri(GetEthTokenMetadataCallback callback,
+  void QueueEthTokenUri(const ContractKey& contract_key,
+                        const std::string& token_id);
+  void FlushEthTokenUris(const ContractKey& contract_key);
+  void GetEthTokenUri(const ContractKey& contract_key,
+                      const std::string& token_id);
+  void OnGetEthTokenUris(const ContractKey& contract_key,
+                         const std::vector<std::string>& token_ids,
+                         const std::vector<GURL>& uris,
+                         mojom::ProviderError error,
+                         const std::string& error_message);
+  void OnGetEthTokenUri(const std::string& cache_key,
                         const GURL& uri,
                         mojom::ProviderError error,
                         const std::string& error_message);
+  void RunEthTokenMetadataCallbacks(const std::string& cache_key,
+                                    const std::string& token_url,
+                                    const std::string& result,
+                                    mojom::ProviderError error,
+                                    const std::string& error_message);
+
   // GetTokenMetadataIntermediateCallbacks convert the int error to a
   // mojom::ProviderError or mojom::SolanaProviderError
   using GetTokenMetadataIntermediateCallback =
@@ -86,7 +132,7 @@ class NftMetadataFetcher {
       absl::optional<SolanaAccountInfo> account_info,
       mojom::SolanaProviderError error,
       const std::string& error_message);
-  void CompleteGetEthTokenMetadata(GetEthTokenMetadataCallback callback,
+  void CompleteGetEthTokenMetadata(const std::string& cache_key,
                                    const GURL& uri,
                                    const std::string& response,
                                    int error,
@@ -107,6 +153,26 @@ class NftMetadataFetcher {
   std::unique_ptr<APIRequestHelper> api_request_helper_;
   raw_ptr<JsonRpcService> json_rpc_service_ = nullptr;
   raw_ptr<PrefService> prefs_ = nullptr;
+
+  std::map<ContractKey, bool> supports_interface_cache_;
+  // Tokens waiting for the supportsInterface call of their contract.
+  std::map<ContractKey, std::vector<std::string>> pending_supports_interface_;
+  // Tokens waiting for their tokenURI call to be sent in the next batch.
+  std::map<ContractKey, std::vector<std::string>> pending_token_uris_;
+  // Callbacks of the tokens being resolved, by metadata cache key.
+  std::map<std::string, std::vector<GetEthTokenMetadataCallback>>
+      pending_metadata_callbacks_;
+  // Resolved metadata by cache key, evicted least recently used first once
+  // |metadata_cache_bytes_| goes over kMaxEthTokenMetadataCacheBytes.
+  base::LRUCache<std::string, CachedEthTokenMetadata> metadata_cache_{
+      base::LRUCache<std::string, CachedEthTokenMetadata>::NO_AUTO_EVICT};
+  size_t metadata_cache_bytes_ = 0;
+  // Mirrors kBraveWalletNftTokenUrlIndex, least recently fetched last, so
+  // evicting from the pref doesn't need a scan. Loaded on first use.
+  base::LRUCache<std::string, IndexedEthTokenUrl> token_url_index_{
+      base::LRUCache<std::string, IndexedEthTokenUrl>::NO_AUTO_EVICT};
+  bool token_url_index_loaded_ = false;
+
   base::WeakPtrFactory<NftMetadataFetcher> weak_ptr_factory_;
 };
 
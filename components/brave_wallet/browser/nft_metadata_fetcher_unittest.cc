@@ -6,17 +6,23 @@
 #include "brave/components/brave_wallet/browser/nft_metadata_fetcher.h"
 
 #include <memory>
+#include <string>
 #include <string_view>
+#include <vector>
 
 #include "base/base64.h"
 #include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/strings/strcat.h"
 #include "base/test/bind.h"
 #include "base/test/task_environment.h"
 #include "brave/components/brave_wallet/browser/brave_wallet_constants.h"
 #include "brave/components/brave_wallet/browser/brave_wallet_prefs.h"
 #include "brave/components/brave_wallet/browser/brave_wallet_utils.h"
 #include "brave/components/brave_wallet/browser/json_rpc_service.h"
+#include "brave/components/brave_wallet/browser/pref_names.h"
 #include "brave/components/brave_wallet/common/hash_utils.h"
+#include "brave/components/brave_wallet/common/hex_utils.h"
 #include "brave/components/ipfs/ipfs_service.h"
 #include "components/sync_preferences/testing_pref_service_syncable.h"
 #include "services/data_decoder/public/cpp/test_support/in_process_data_decoder.h"
@@ -100,6 +106,32 @@ constexpr char https_metadata_response[] = R"({
     "name": "Invisible Friends #1817"
   })";
 
+// Decoded result is `true`
+constexpr char kInterfaceSupportedResponse[] = R"({
+    "jsonrpc":"2.0",
+    "id":1,
+    "result": "0x0000000000000000000000000000000000000000000000000000000000000001"
+})";
+
+// Decoded result is `https://invisiblefriends.io/api/1817`
+constexpr char kTokenUriResponse[] = R"({
+    "jsonrpc":"2.0",
+    "id":1,
+    "result":"0x0000000000000000000000000000000000000000000000000000000000000020000000000000000000000000000000000000000000000000000000000000002468747470733a2f2f696e76697369626c65667269656e64732e696f2f6170692f3138313700000000000000000000000000000000000000000000000000000000"
+})";
+
+constexpr char kCollectionContract[] =
+    "0x59468516a8259058bad1ca5f8f4bff190d30e066";
+constexpr size_t kCollectionSize = 200;
+
+std::vector<std::string> GetCollectionTokenIds() {
+  std::vector<std::string> token_ids;
+  for (size_t i = 0; i < kCollectionSize; ++i) {
+    token_ids.push_back(Uint256ValueToHex(i));
+  }
+  return token_ids;
+}
+
 }  // namespace
 
 class NftMetadataFetcherUnitTest : public testing::Test {
@@ -119,6 +151,95 @@ class NftMetadataFetcherUnitTest : public testing::Test {
 
   PrefService* GetPrefs() { return &prefs_; }
 
+  void ResetNftMetadataFetcher() {
+    prefs_.ClearPref(kBraveWalletNftTokenUrlIndex);
+    nft_metadata_fetcher_ = std::make_unique<NftMetadataFetcher>(
+        shared_url_loader_factory_, json_rpc_service_.get(), GetPrefs());
+  }
+
+  // Requests all |token_ids| at once and waits for all of them.
+  void GetCollectionMetadata(const std::string& contract,
+                             const std::vector<std::string>& token_ids,
+                             const std::string& expected_response) {
+    base::RunLoop run_loop;
+    size_t pending = token_ids.size();
+    for (const auto& token_id : token_ids) {
+      nft_metadata_fetcher_->GetEthTokenMetadata(
+          contract, token_id, mojom::kMainnetChainId,
+          kERC721MetadataInterfaceId,
+          base::BindLambdaForTesting(
+              [&](const std::string& url, const std::string& response,
+                  mojom::ProviderError error,
+                  const std::string& error_message) {
+                CompareJSON(response, expected_response);
+                EXPECT_EQ(error, mojom::ProviderError::kSuccess);
+                if (--pending == 0) {
+                  run_loop.Quit();
+                }
+              }));
+    }
+    run_loop.Run();
+  }
+
+  // Answers supportsInterface and tokenURI calls, single or batched, and
+  // metadata requests, counting the round trips of each.
+  void SetCollectionInterceptor(const std::string& metadata_response) {
+    url_loader_factory_.SetInterceptor(base::BindLambdaForTesting(
+        [&, metadata_response](const network::ResourceRequest& request) {
+          url_loader_factory_.ClearResponses();
+          if (request.method != "POST") {
+            metadata_requests_++;
+            url_loader_factory_.AddResponse(request.url.spec(),
+                                            metadata_response);
+            return;
+          }
+
+          std::string_view request_string(request.request_body->elements()
+                                              ->at(0)
+                                              .As<network::DataElementBytes>()
+                                              .AsStringPiece());
+          if (request_string.find(GetFunctionHash(
+                  "supportsInterface(bytes4)")) != std::string::npos) {
+            supports_interface_requests_++;
+            url_loader_factory_.AddResponse(request.url.spec(),
+                                            kInterfaceSupportedResponse);
+            return;
+          }
+
+          auto calls = base::JSONReader::Read(request_string);
+          ASSERT_TRUE(calls);
+          if (calls->is_dict()) {
+            token_uri_requests_++;
+            url_loader_factory_.AddResponse(request.url.spec(),
+                                            kTokenUriResponse);
+            return;
+          }
+
+          token_uri_batch_requests_++;
+          base::Value::List responses;
+          for (const auto& call : calls->GetList()) {
+            auto response = base::JSONReader::Read(kTokenUriResponse);
+            response->GetDict().Set("id", call.GetDict().FindInt("id").value());
+            responses.Append(std::move(*response));
+          }
+          std::string responses_json;
+          base::JSONWriter::Write(responses, &responses_json);
+          url_loader_factory_.AddResponse(request.url.spec(), responses_json);
+        }));
+  }
+
+  size_t GetRoundTrips() const {
+    return supports_interface_requests_ + token_uri_requests_ +
+           token_uri_batch_requests_ + metadata_requests_;
+  }
+
+  void ResetRoundTrips() {
+    supports_interface_requests_ = 0;
+    token_uri_requests_ = 0;
+    token_uri_batch_requests_ = 0;
+    metadata_requests_ = 0;
+  }
+
   GURL GetNetwork(const std::string& chain_id, mojom::CoinType coin) {
     return brave_wallet::GetNetworkURL(GetPrefs(), chain_id, coin);
   }
@@ -147,6 +268,9 @@ class NftMetadataFetcherUnitTest : public testing::Test {
                                const std::string& expected_response,
                                mojom::ProviderError expected_error,
                                const std::string& expected_error_message) {
+    // Every case starts cold, nothing is resolved from earlier cases.
+    ResetNftMetadataFetcher();
+
     base::RunLoop run_loop;
     nft_metadata_fetcher_->GetEthTokenMetadata(
         contract, token_id, chain_id, interface_id,
@@ -281,7 +405,8 @@ class NftMetadataFetcherUnitTest : public testing::Test {
   }
 
  protected:
-  base::test::TaskEnvironment task_environment_;
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
   sync_preferences::TestingPrefServiceSyncable prefs_;
   network::TestURLLoaderFactory url_loader_factory_;
   data_decoder::test::InProcessDataDecoder in_process_data_decoder_;
@@ -289,6 +414,10 @@ class NftMetadataFetcherUnitTest : public testing::Test {
   std::unique_ptr<JsonRpcService> json_rpc_service_;
   // NftMetadataFetcher nft_metadata_fetcher_;
   std::unique_ptr<NftMetadataFetcher> nft_metadata_fetcher_;
+  size_t supports_interface_requests_ = 0;
+  size_t token_uri_requests_ = 0;
+  size_t token_uri_batch_requests_ = 0;
+  size_t metadata_requests_ = 0;
 };
 
 TEST_F(NftMetadataFetcherUnitTest, FetchMetadata) {
@@ -628,6 +757,89 @@ TEST_F(NftMetadataFetcherUnitTest, GetEthTokenMetadata) {
                           mojom::ProviderError::kSuccess, "");
 }
 
+TEST_F(NftMetadataFetcherUnitTest, GetEthTokenMetadataForCollection) {
+  SetCollectionInterceptor(https_metadata_response);
+  const auto token_ids = GetCollectionTokenIds();
+
+  // Cold, one supportsInterface call for the contract and the tokenURI calls
+  // in batches of 100. Each token used to take 3 round trips, i.e. 600.
+  GetCollectionMetadata(kCollectionContract, token_ids,
+                        https_metadata_response);
+  EXPECT_EQ(supports_interface_requests_, 1u);
+  EXPECT_EQ(token_uri_requests_, 0u);
+  EXPECT_EQ(token_uri_batch_requests_, 2u);
+  EXPECT_EQ(metadata_requests_, kCollectionSize);
+  EXPECT_EQ(GetRoundTrips(), kCollectionSize + 3);
+
+  // Warm, everything comes from the cache.
+  ResetRoundTrips();
+  GetCollectionMetadata(kCollectionContract, token_ids,
+                        https_metadata_response);
+  EXPECT_EQ(GetRoundTrips(), 0u);
+
+  // The token URLs are persisted, after a restart only the metadata is
+  // fetched again.
+  nft_metadata_fetcher_ = std::make_unique<NftMetadataFetcher>(
+      shared_url_loader_factory_, json_rpc_service_.get(), GetPrefs());
+  GetCollectionMetadata(kCollectionContract, token_ids,
+                        https_metadata_response);
+  EXPECT_EQ(supports_interface_requests_, 0u);
+  EXPECT_EQ(token_uri_requests_, 0u);
+  EXPECT_EQ(token_uri_batch_requests_, 0u);
+  EXPECT_EQ(metadata_requests_, kCollectionSize);
+  EXPECT_EQ(GetPrefs()->GetDict(kBraveWalletNftTokenUrlIndex).size(),
+            kCollectionSize);
+}
+
+TEST_F(NftMetadataFetcherUnitTest, EthTokenMetadataCacheIsBounded) {
+  const std::string large_metadata_response = base::StrCat(
+      {R"({"name": ")", std::string(30 * 1024, 'a'), R"("})"});
+  SetCollectionInterceptor(large_metadata_response);
+  const auto token_ids = GetCollectionTokenIds();
+  GetCollectionMetadata(kCollectionContract, token_ids,
+                        large_metadata_response);
+
+  // 200 tokens of 30KB don't fit, the least recently used ones are fetched
+  // again. Their token URLs are still known.
+  ResetRoundTrips();
+  GetCollectionMetadata(kCollectionContract, token_ids,
+                        large_metadata_response);
+  EXPECT_EQ(supports_interface_requests_, 0u);
+  EXPECT_EQ(token_uri_requests_, 0u);
+  EXPECT_EQ(token_uri_batch_requests_, 0u);
+  EXPECT_GT(metadata_requests_, 0u);
+  EXPECT_LT(metadata_requests_, kCollectionSize);
+}
+
+TEST_F(NftMetadataFetcherUnitTest, GetEthTokenMetadataCoalescesRequests) {
+  SetCollectionInterceptor(https_metadata_response);
+
+  // Concurrent requests for a token share a single resolution.
+  GetCollectionMetadata(kCollectionContract, {"0x719", "0x719", "0x719"},
+                        https_metadata_response);
+  EXPECT_EQ(supports_interface_requests_, 1u);
+  EXPECT_EQ(token_uri_requests_, 1u);
+  EXPECT_EQ(token_uri_batch_requests_, 0u);
+  EXPECT_EQ(metadata_requests_, 1u);
+}
+
+TEST_F(NftMetadataFetcherUnitTest, EthTokenMetadataCacheExpires) {
+  SetCollectionInterceptor(https_metadata_response);
+  GetCollectionMetadata(kCollectionContract, {"0x719"},
+                        https_metadata_response);
+  EXPECT_EQ(GetRoundTrips(), 3u);
+
+  task_environment_.FastForwardBy(base::Days(2));
+
+  // Interface support is still known, only the token is resolved again.
+  ResetRoundTrips();
+  GetCollectionMetadata(kCollectionContract, {"0x719"},
+                        https_metadata_response);
+  EXPECT_EQ(supports_interface_requests_, 0u);
+  EXPECT_EQ(token_uri_requests_, 1u);
+  EXPECT_EQ(metadata_requests_, 1u);
+}
+
 TEST_F(NftMetadataFetcherUnitTest, GetSolTokenMetadata) {
   // Valid inputs should yield metadata JSON (happy case)
   std::string get_account_info_response = R"({
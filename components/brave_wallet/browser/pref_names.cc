@@ -46,6 +46,7 @@ const char kBraveWalletKeyrings[] = "brave.wallet.keyrings";
 const char kBraveWalletUserAssets[] = "brave.wallet.wallet_user_assets";
 const char kBraveWalletEthAllowancesCache[] =
     "brave.wallet.eth_allowances_cache";
+const char kBraveWalletNftTokenUrlIndex[] = "brave.wallet.nft_token_url_index";
 const char kBraveWalletUserAssetEthContractAddressMigrated[] =
     "brave.wallet.user.asset.eth_contract_address_migrated";
 const char kBraveWalletUserAssetsAddPreloadingNetworksMigrated[] =
@@ -29,6 +29,7 @@ extern const char kBraveWalletSelectedNetworks[];
 extern const char kBraveWalletSelectedNetworksPerOrigin[];
 extern const char kBraveWalletUserAssets[];
 extern const char kBraveWalletEthAllowancesCache[];
+extern const char kBraveWalletNftTokenUrlIndex[];
 // Added 10/2021 to migrate contract address to an empty string for ETH.
 extern const char kBraveWalletUserAssetEthContractAddressMigrated[];
 // Added 06/2022 to add native assets of preloading networks to user assets.
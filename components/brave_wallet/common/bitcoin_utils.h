@@ -17,6 +17,15 @@ namespace brave_wallet {
 
 constexpr uint8_t kBitcoinSigHashAll = 1;
 
+// Values of the change level of BIP44 key paths.
+constexpr uint32_t kBitcoinReceiveIndex = 0;
+constexpr uint32_t kBitcoinChangeIndex = 1;
+
+// Number of unused addresses after the last used one which are queried on each
+// refresh, per chain. Any of them turning out to be used moves the gap forward.
+// https://github.com/bitcoin/bips/blob/master/bip-0044.mediawiki#address-gap-limit
+constexpr uint32_t kBitcoinAddressGap = 20;
+
 // TODO(apaymyshev): support more
 enum BitcoinAddressType {
   kWitnessV0ScriptHash,
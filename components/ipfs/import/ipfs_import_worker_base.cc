@@ -11,7 +11,6 @@
 #include "base/command_line.h"
 #include "base/files/file_util.h"
 #include "base/strings/strcat.h"
-#include "base/strings/string_split.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/task/thread_pool.h"
@@ -43,6 +42,10 @@
 
 namespace {
 
+// The add response is a stream of small JSON objects, one per line. Anything
+// longer is not a response we can handle and must not grow without bound.
+constexpr size_t kMaxAddResponseLineSize = 64 * 1024;
+
 // Return a date string formatted as "YYYY-MM-DD".
 std::string TimeFormatDate(const base::Time& time) {
   base::Time::Exploded exploded_time;
@@ -118,6 +121,13 @@ void IpfsImportWorkerBase::ImportText(const std::string& text,
                        std::move(upload_callback));
 }
 
+void IpfsImportWorkerBase::StartUpload(
+    const std::string& filename,
+    std::unique_ptr<network::ResourceRequest> request) {
+  data_->filename = filename;
+  UploadData(std::move(request));
+}
+
 void IpfsImportWorkerBase::UploadData(
     std::unique_ptr<network::ResourceRequest> request) {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
@@ -135,36 +145,66 @@ void IpfsImportWorkerBase::UploadData(
   DCHECK(!url_loader_);
   simple_url_loader_ = CreateURLLoader(url, "POST", std::move(request));
 
-  simple_url_loader_->DownloadToStringOfUnboundedSizeUntilCrashAndDie(
-      url_loader_factory_.get(),
-      base::BindOnce(&IpfsImportWorkerBase::OnImportAddComplete,
-                     weak_factory_.GetWeakPtr()));
+  add_response_line_.clear();
+  simple_url_loader_->DownloadAsStream(url_loader_factory_.get(), this);
 }
 
-bool IpfsImportWorkerBase::ParseResponseBody(const std::string& response_body,
-                                             ipfs::ImportedData* data) {
-  DCHECK(data);
-  std::vector<std::string> parts = base::SplitString(
-      response_body, "\n", base::KEEP_WHITESPACE, base::SPLIT_WANT_ALL);
-  if (!parts.size())
-    return IPFSJSONParser::GetImportResponseFromJSON(response_body, data);
-  for (const auto& item : parts) {
-    if (item.front() != '{' || item.back() != '}')
-      continue;
-    ipfs::ImportedData imported_item;
-    if (IPFSJSONParser::GetImportResponseFromJSON(item, &imported_item)) {
-      if (imported_item.filename != data->filename)
-        continue;
-      data->hash = imported_item.hash;
-      data->size = imported_item.size;
-      return true;
+void IpfsImportWorkerBase::OnDataReceived(std::string_view string_piece,
+                                          base::OnceClosure resume) {
+  size_t line_start = 0;
+  for (size_t line_end = string_piece.find('\n');
+       line_end != std::string_view::npos;
+       line_end = string_piece.find('\n', line_start)) {
+    std::string_view line =
+        string_piece.substr(line_start, line_end - line_start);
+    if (add_response_line_.empty()) {
+      ParseResponseLine(line);
+    } else {
+      add_response_line_.append(line);
+      ParseResponseLine(add_response_line_);
+      add_response_line_.clear();
     }
+    line_start = line_end + 1;
+  }
+  add_response_line_.append(string_piece.substr(line_start));
+  if (add_response_line_.size() > kMaxAddResponseLineSize) {
+    VLOG(1) << "Import response line exceeds " << kMaxAddResponseLineSize
+            << " bytes";
+    OnImportAddComplete(false);
+    return;
+  }
+  std::move(resume).Run();
+}
+
+void IpfsImportWorkerBase::OnComplete(bool success) {
+  if (!add_response_line_.empty()) {
+    ParseResponseLine(add_response_line_);
+    add_response_line_.clear();
   }
-  return false;
+  OnImportAddComplete(success);
 }
 
-void IpfsImportWorkerBase::OnImportAddComplete(
-    std::unique_ptr<std::string> response_body) {
+void IpfsImportWorkerBase::OnRetry(base::OnceClosure start_retry) {
+  add_response_line_.clear();
+  data_->hash.clear();
+  std::move(start_retry).Run();
+}
+
+void IpfsImportWorkerBase::ParseResponseLine(std::string_view line) {
+  if (line.empty() || line.front() != '{' || line.back() != '}')
+    return;
+  ipfs::ImportedData imported_item;
+  if (!IPFSJSONParser::GetImportResponseFromJSON(std::string(line),
+                                                 &imported_item)) {
+    return;
+  }
+  if (imported_item.filename != data_->filename)
+    return;
+  data_->hash = imported_item.hash;
+  data_->size = imported_item.size;
+}
+
+void IpfsImportWorkerBase::OnImportAddComplete(bool success) {
   int error_code = simple_url_loader_->NetError();
   int response_code = -1;
   if (simple_url_loader_->ResponseInfo() &&
@@ -172,11 +212,9 @@ void IpfsImportWorkerBase::OnImportAddComplete(
     response_code =
         simple_url_loader_->ResponseInfo()->headers->response_code();
 
-  bool success = (error_code == net::OK && response_code == net::HTTP_OK);
-  if (success) {
-    success = ParseResponseBody(*response_body, data_.get());
-  }
+  success = success && error_code == net::OK && response_code == net::HTTP_OK;
   simple_url_loader_.reset();
+  add_response_line_.clear();
   if (success && !data_->hash.empty()) {
     CreateBraveDirectory();
     return;
@@ -9,6 +9,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -23,6 +24,7 @@
 #include "brave/components/ipfs/ipfs_network_utils.h"
 #include "components/version_info/channel.h"
 #include "services/network/public/cpp/shared_url_loader_factory.h"
+#include "services/network/public/cpp/simple_url_loader_stream_consumer.h"
 #include "url/gurl.h"
 
 namespace network {
@@ -40,11 +42,12 @@ namespace ipfs {
 // Worker:
 //   1. Worker prepares a blob block of data to import
 // IpfsImportWorkerBase:
-//   2. Sends blob to ifps using IPFS api (/api/v0/add)
+//   2. Sends blob to ifps using IPFS api (/api/v0/add), the response is
+//      parsed line by line as it arrives
 //   3. Creates target directory for import using IPFS api(/api/v0/files/mkdir)
 //   4. Moves objects to target directory using IPFS api(/api/v0/files/cp)
 //   5. Publishes objects under passed IPNS key(/api/v0/name/publish)
-class IpfsImportWorkerBase {
+class IpfsImportWorkerBase : public network::SimpleURLLoaderStreamConsumer {
  public:
   IpfsImportWorkerBase(
       BlobContextGetterFactory* blob_context_getter_factory,
@@ -52,7 +55,7 @@ class IpfsImportWorkerBase {
       const GURL& endpoint,
       ImportCompletedCallback callback,
       const std::string& key = std::string());
-  virtual ~IpfsImportWorkerBase();
+  ~IpfsImportWorkerBase() override;
 
   IpfsImportWorkerBase(const IpfsImportWorkerBase&) = delete;
   IpfsImportWorkerBase& operator=(const IpfsImportWorkerBase&) = delete;
@@ -69,18 +72,28 @@ class IpfsImportWorkerBase {
 
   virtual void NotifyImportCompleted(ipfs::ImportState state);
 
+  // Sends |request| for |filename| to /api/v0/add. The body may be a chunked
+  // data pipe which is still being written by the worker.
+  void StartUpload(const std::string& filename,
+                   std::unique_ptr<network::ResourceRequest> request);
+
  private:
   void UploadData(std::unique_ptr<network::ResourceRequest> request);
 
-  void OnImportAddComplete(std::unique_ptr<std::string> response_body);
+  // network::SimpleURLLoaderStreamConsumer
+  void OnDataReceived(std::string_view string_piece,
+                      base::OnceClosure resume) override;
+  void OnComplete(bool success) override;
+  void OnRetry(base::OnceClosure start_retry) override;
+
+  void OnImportAddComplete(bool success);
 
   void CreateBraveDirectory();
   void OnImportDirectoryCreated(const std::string& directory,
                                 api_request_helper::APIRequestResult response);
   void CopyFilesToBraveDirectory();
   void OnImportFilesMoved(api_request_helper::APIRequestResult response);
-  bool ParseResponseBody(const std::string& response_body,
-                         ipfs::ImportedData* data);
+  void ParseResponseLine(std::string_view line);
   void PublishContent();
   void OnContentPublished(api_request_helper::APIRequestResult response);
 
@@ -92,6 +105,8 @@ class IpfsImportWorkerBase {
   scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory_;
   std::unique_ptr<api_request_helper::APIRequestHelper> url_loader_;
   std::unique_ptr<network::SimpleURLLoader> simple_url_loader_;
+  // Incomplete trailing line of the /api/v0/add response.
+  std::string add_response_line_;
   GURL server_endpoint_;
   std::string key_to_publish_;
   base::WeakPtrFactory<IpfsImportWorkerBase> weak_factory_;
@@ -5,18 +5,30 @@
 
 #include "brave/components/ipfs/import/ipfs_link_import_worker.h"
 
+#include <string_view>
 #include <utility>
 
-#include "base/task/thread_pool.h"
+#include "base/numerics/safe_conversions.h"
+#include "base/task/sequenced_task_runner.h"
+#include "brave/components/ipfs/ipfs_constants.h"
 #include "brave/components/ipfs/ipfs_network_utils.h"
 #include "content/public/browser/browser_thread.h"
+#include "mojo/public/cpp/bindings/receiver.h"
+#include "mojo/public/cpp/system/data_pipe.h"
+#include "mojo/public/cpp/system/simple_watcher.h"
 #include "net/base/mime_util.h"
+#include "net/base/net_errors.h"
 #include "net/http/http_request_headers.h"
 #include "net/http/http_response_headers.h"
 #include "net/http/http_status_code.h"
+#include "services/network/public/cpp/resource_request.h"
+#include "services/network/public/cpp/resource_request_body.h"
 #include "services/network/public/cpp/shared_url_loader_factory.h"
 #include "services/network/public/cpp/simple_url_loader.h"
+#include "services/network/public/cpp/simple_url_loader_stream_consumer.h"
+#include "services/network/public/mojom/chunked_data_pipe_getter.mojom.h"
 #include "services/network/public/mojom/url_response_head.mojom.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
 #include "url/gurl.h"
 
 namespace {
@@ -27,6 +39,194 @@ const char kLinkMimeType[] = "text/html";
 
 namespace ipfs {
 
+// Downloads the linked content and writes it, framed as a multipart form,
+// into the chunked data pipe the network service reads the upload body from.
+// The download is only resumed once the previous chunk went into the pipe, so
+// a slow node throttles the download instead of growing the buffer.
+class IpfsLinkImportWorker::ContentStream
+    : public network::SimpleURLLoaderStreamConsumer,
+      public network::mojom::ChunkedDataPipeGetter {
+ public:
+  using ResponseStartedCallback =
+      base::OnceCallback<void(const std::string& mime_type)>;
+
+  ContentStream(const GURL& url,
+                network::SharedURLLoaderFactory* url_loader_factory,
+                ResponseStartedCallback response_started_callback,
+                base::OnceClosure download_failed_callback)
+      : response_started_callback_(std::move(response_started_callback)),
+        download_failed_callback_(std::move(download_failed_callback)),
+        pipe_watcher_(FROM_HERE,
+                      mojo::SimpleWatcher::ArmingPolicy::MANUAL,
+                      base::SequencedTaskRunner::GetCurrentDefault()) {
+    url_loader_ = CreateURLLoader(url, "GET");
+    url_loader_->SetOnResponseStartedCallback(base::BindOnce(
+        &ContentStream::OnResponseStarted, base::Unretained(this)));
+    url_loader_->DownloadAsStream(url_loader_factory, this);
+  }
+
+  ~ContentStream() override = default;
+
+  ContentStream(const ContentStream&) = delete;
+  ContentStream& operator=(const ContentStream&) = delete;
+
+  // Returns a read-once body which yields |header|, the downloaded content and
+  // |footer|.
+  scoped_refptr<network::ResourceRequestBody> CreateRequestBody(
+      const std::string& header,
+      const std::string& footer) {
+    DCHECK(!receiver_.is_bound());
+    pending_data_ = header;
+    footer_ = footer;
+    mojo::PendingRemote<network::mojom::ChunkedDataPipeGetter> remote;
+    receiver_.Bind(remote.InitWithNewPipeAndPassReceiver());
+    auto body = base::MakeRefCounted<network::ResourceRequestBody>();
+    body->SetToChunkedDataPipe(
+        std::move(remote), network::ResourceRequestBody::ReadOnlyOnce(true));
+    return body;
+  }
+
+ private:
+  void OnResponseStarted(const GURL& final_url,
+                         const network::mojom::URLResponseHead& response_head) {
+    if (!response_head.headers ||
+        response_head.headers->response_code() != net::HTTP_OK) {
+      // Other 2xx responses still deliver a body, which would wait forever
+      // for an upload that never starts. Stop here instead.
+      VLOG(1) << "Unable to download linked content, response_code:"
+              << (response_head.headers
+                      ? response_head.headers->response_code()
+                      : -1);
+      url_loader_.reset();
+      response_started_callback_.Reset();
+      std::move(download_failed_callback_).Run();
+      return;
+    }
+    std::string mime_type = kLinkMimeType;
+    response_head.headers->GetMimeType(&mime_type);
+    std::move(response_started_callback_).Run(mime_type);
+  }
+
+  // network::SimpleURLLoaderStreamConsumer
+  void OnDataReceived(std::string_view string_piece,
+                      base::OnceClosure resume) override {
+    DCHECK(!resume_download_);
+    pending_data_.append(string_piece);
+    resume_download_ = std::move(resume);
+    WritePendingData();
+  }
+
+  void OnComplete(bool success) override {
+    int error_code = url_loader_->NetError();
+    download_complete_ = true;
+    url_loader_.reset();
+    if (response_started_callback_) {
+      VLOG(1) << "Unable to download linked content, error_code:"
+              << error_code;
+      std::move(download_failed_callback_).Run();
+      return;
+    }
+    if (!success) {
+      VLOG(1) << "Linked content download failed, error_code:" << error_code;
+      Finish(net::ERR_FAILED);
+      return;
+    }
+    pending_data_.append(footer_);
+    WritePendingData();
+  }
+
+  void OnRetry(base::OnceClosure start_retry) override { NOTREACHED(); }
+
+  // network::mojom::ChunkedDataPipeGetter
+  void GetSize(GetSizeCallback callback) override {
+    if (status_) {
+      std::move(callback).Run(*status_, bytes_written_);
+      return;
+    }
+    get_size_callback_ = std::move(callback);
+  }
+
+  void StartReading(mojo::ScopedDataPipeProducerHandle pipe) override {
+    if (status_ || pipe_.is_valid())
+      return;
+    pipe_ = std::move(pipe);
+    pipe_watcher_.Watch(pipe_.get(),
+                        MOJO_HANDLE_SIGNAL_WRITABLE |
+                            MOJO_HANDLE_SIGNAL_PEER_CLOSED,
+                        base::BindRepeating(&ContentStream::OnPipeWritable,
+                                            base::Unretained(this)));
+    WritePendingData();
+  }
+
+  void OnPipeWritable(MojoResult result) {
+    if (result != MOJO_RESULT_OK) {
+      Finish(net::ERR_FAILED);
+      return;
+    }
+    WritePendingData();
+  }
+
+  void WritePendingData() {
+    if (!pipe_.is_valid())
+      return;
+    while (pending_offset_ < pending_data_.size()) {
+      uint32_t num_bytes = base::saturated_cast<uint32_t>(
+          pending_data_.size() - pending_offset_);
+      MojoResult result =
+          pipe_->WriteData(pending_data_.data() + pending_offset_, &num_bytes,
+                           MOJO_WRITE_DATA_FLAG_NONE);
+      if (result == MOJO_RESULT_SHOULD_WAIT) {
+        pipe_watcher_.ArmOrNotify();
+        return;
+      }
+      if (result != MOJO_RESULT_OK) {
+        Finish(net::ERR_FAILED);
+        return;
+      }
+      pending_offset_ += num_bytes;
+      bytes_written_ += num_bytes;
+    }
+    pending_data_.clear();
+    pending_offset_ = 0;
+    if (resume_download_) {
+      std::move(resume_download_).Run();
+      return;
+    }
+    if (download_complete_)
+      Finish(net::OK);
+  }
+
+  // Closes the pipe and reports the final size or the error to the network
+  // service, which aborts the upload on error.
+  void Finish(int32_t status) {
+    status_ = status;
+    url_loader_.reset();
+    resume_download_.Reset();
+    pending_data_.clear();
+    pending_offset_ = 0;
+    pipe_watcher_.Cancel();
+    pipe_.reset();
+    if (get_size_callback_)
+      std::move(get_size_callback_).Run(status, bytes_written_);
+  }
+
+  std::unique_ptr<network::SimpleURLLoader> url_loader_;
+  ResponseStartedCallback response_started_callback_;
+  base::OnceClosure download_failed_callback_;
+  mojo::Receiver<network::mojom::ChunkedDataPipeGetter> receiver_{this};
+  mojo::ScopedDataPipeProducerHandle pipe_;
+  mojo::SimpleWatcher pipe_watcher_;
+  // Bytes waiting to be written into |pipe_|, starting at |pending_offset_|.
+  std::string pending_data_;
+  size_t pending_offset_ = 0;
+  std::string footer_;
+  base::OnceClosure resume_download_;
+  bool download_complete_ = false;
+  uint64_t bytes_written_ = 0;
+  absl::optional<int32_t> status_;
+  GetSizeCallback get_size_callback_;
+};
+
 IpfsLinkImportWorker::IpfsLinkImportWorker(
     BlobContextGetterFactory* blob_context_getter_factory,
     network::SharedURLLoaderFactory* url_loader_factory,
@@ -42,9 +242,7 @@ IpfsLinkImportWorker::IpfsLinkImportWorker(
   DownloadLinkContent(url);
 }
 
-IpfsLinkImportWorker::~IpfsLinkImportWorker() {
-  RemoveDownloadedFile();
-}
+IpfsLinkImportWorker::~IpfsLinkImportWorker() = default;
 
 void IpfsLinkImportWorker::DownloadLinkContent(const GURL& url) {
   if (!url.is_valid()) {
@@ -52,50 +250,41 @@ void IpfsLinkImportWorker::DownloadLinkContent(const GURL& url) {
     return;
   }
   import_url_ = url;
-  DCHECK(!url_loader_);
-  url_loader_ = CreateURLLoader(import_url_, "GET");
-  url_loader_->DownloadToTempFile(
-      GetUrlLoaderFactory().get(),
-      base::BindOnce(&IpfsLinkImportWorker::OnImportDataAvailable,
+  DCHECK(!content_stream_);
+  content_stream_ = std::make_unique<ContentStream>(
+      import_url_, GetUrlLoaderFactory().get(),
+      base::BindOnce(&IpfsLinkImportWorker::OnResponseStarted,
+                     base::Unretained(this)),
+      base::BindOnce(&IpfsLinkImportWorker::OnDownloadFailed,
                      base::Unretained(this)));
 }
 
-void IpfsLinkImportWorker::OnImportDataAvailable(base::FilePath path) {
-  int error_code = url_loader_->NetError();
-  int response_code = -1;
-  std::string mime_type = kLinkMimeType;
-  if (url_loader_->ResponseInfo() && url_loader_->ResponseInfo()->headers) {
-    response_code = url_loader_->ResponseInfo()->headers->response_code();
-    url_loader_->ResponseInfo()->headers->GetMimeType(&mime_type);
-  }
-  bool success =
-      (error_code == net::OK && response_code == net::HTTP_OK && !path.empty());
-  url_loader_.reset();
-  if (!success) {
-    VLOG(1) << "error_code:" << error_code << " response_code:" << response_code
-            << " response_body:" << path.value();
-    NotifyImportCompleted(IPFS_IMPORT_ERROR_REQUEST_EMPTY);
-    return;
-  }
-  temp_file_path_ = path;
+void IpfsLinkImportWorker::OnResponseStarted(const std::string& mime_type) {
   std::string filename = import_url_.ExtractFileName();
   if (filename.empty())
     filename = import_url_.host();
 
-  ImportFile(path, mime_type, filename);
-}
+  std::string mime_boundary = net::GenerateMimeMultipartBoundary();
+  std::string header;
+  AddMultipartHeaderForUploadWithFileName(kFileValueName, filename,
+                                          std::string(), mime_boundary,
+                                          mime_type, &header);
+  std::string footer = "\r\n";
+  net::AddMultipartFinalDelimiterForUpload(mime_boundary, &footer);
 
-void IpfsLinkImportWorker::RemoveDownloadedFile() {
-  if (!temp_file_path_.empty()) {
-    base::ThreadPool::PostTask(
-        FROM_HERE, {base::TaskPriority::BEST_EFFORT, base::MayBlock()},
-        base::GetDeleteFileCallback(temp_file_path_));
-    temp_file_path_ = base::FilePath();
-  }
+  std::string content_type = kIPFSImportMultipartContentType;
+  content_type += " boundary=";
+  content_type += mime_boundary;
+
+  auto request = std::make_unique<network::ResourceRequest>();
+  request->request_body = content_stream_->CreateRequestBody(header, footer);
+  request->headers.SetHeader(net::HttpRequestHeaders::kContentType,
+                             content_type);
+  StartUpload(filename, std::move(request));
 }
 
-void IpfsLinkImportWorker::NotifyImportCompleted(ipfs::ImportState state) {
-  RemoveDownloadedFile();
-  IpfsImportWorkerBase::NotifyImportCompleted(state);
+void IpfsLinkImportWorker::OnDownloadFailed() {
+  NotifyImportCompleted(IPFS_IMPORT_ERROR_REQUEST_EMPTY);
 }
+
 }  // namespace ipfs
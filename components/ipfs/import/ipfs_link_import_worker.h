@@ -12,6 +12,7 @@
 #include <utility>
 #include <vector>
 
+#include "base/memory/weak_ptr.h"
 #include "brave/components/ipfs/blob_context_getter_factory.h"
 #include "brave/components/ipfs/import/imported_data.h"
 #include "brave/components/ipfs/import/ipfs_import_worker_base.h"
@@ -20,8 +21,8 @@
 namespace ipfs {
 
 // Implements preparation steps for importing linked objects into ipfs.
-// Creates a blob from downloaded data available by a link.
-// Puts the blob to the base class for the upload using IPFS api
+// Streams data available by a link straight into the body of the upload
+// request, so the download and the add overlap and nothing is written to disk.
 class IpfsLinkImportWorker : public IpfsImportWorkerBase {
  public:
   IpfsLinkImportWorker(BlobContextGetterFactory* blob_context_getter_factory,
@@ -35,15 +36,14 @@ class IpfsLinkImportWorker : public IpfsImportWorkerBase {
   IpfsLinkImportWorker& operator=(const IpfsLinkImportWorker&) = delete;
 
  private:
+  class ContentStream;
+
   void DownloadLinkContent(const GURL& url);
-  void OnImportDataAvailable(base::FilePath path);
-  void RemoveDownloadedFile();
-  // IpfsImportWorkerBase
-  void NotifyImportCompleted(ipfs::ImportState state) override;
+  void OnResponseStarted(const std::string& mime_type);
+  void OnDownloadFailed();
 
-  base::FilePath temp_file_path_;
   GURL import_url_;
-  std::unique_ptr<network::SimpleURLLoader> url_loader_;
+  std::unique_ptr<ContentStream> content_stream_;
   base::WeakPtrFactory<IpfsLinkImportWorker> weak_factory_;
 };
 
@@ -5,32 +5,191 @@
 
 #include "brave/components/p3a/constellation_log_store.h"
 
+#include <map>
 #include <memory>
 #include <set>
 #include <string_view>
-
+#include <utility>
+#include <vector>
+
+#include "base/barrier_callback.h"
+#include "base/base64.h"
+#include "base/containers/contains.h"
+#include "base/files/file.h"
+#include "base/files/file_enumerator.h"
+#include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
+#include "base/functional/bind.h"
+#include "base/functional/callback_helpers.h"
 #include "base/logging.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/rand_util.h"
+#include "base/strings/strcat.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
+#include "base/task/thread_pool.h"
 #include "brave/components/p3a/uploader.h"
 #include "components/prefs/pref_registry_simple.h"
 #include "components/prefs/pref_service.h"
-#include "components/prefs/scoped_user_pref_update.h"
 
 namespace p3a {
 
 namespace {
 
+// Only read to move messages persisted by older versions to the spool.
 constexpr char kPrefName[] = "p3a.constellation_logs";
 
+constexpr char kSpoolFileExtension[] = ".log";
+
+// Spool records are lines of either form:
+//   +<histogram name> <base64 encoded message>
+//   -<histogram name>
+// for the update and the removal of a message.
+constexpr char kUpdateRecordPrefix = '+';
+constexpr char kRemoveRecordPrefix = '-';
+
+std::string BuildUpdateRecord(const std::string& histogram_name,
+                              const std::string& message) {
+  return base::StrCat({std::string(1, kUpdateRecordPrefix), histogram_name,
+                       " ", base::Base64Encode(message), "\n"});
+}
+
+std::string BuildRemoveRecord(const std::string& histogram_name) {
+  return base::StrCat(
+      {std::string(1, kRemoveRecordPrefix), histogram_name, "\n"});
+}
+
 }  // namespace
 
+struct ConstellationLogStore::LoadedSpool {
+  std::map<LogKey, std::string, LogKeyCompare> messages;
+  base::flat_map<uint8_t, size_t> record_counts;
+};
+
+// Owns the spool files on a background sequence.
+class ConstellationLogStore::Spool {
+ public:
+  explicit Spool(const base::FilePath& dir) : dir_(dir) {}
+  Spool(const Spool&) = delete;
+  Spool& operator=(const Spool&) = delete;
+  ~Spool() = default;
+
+  LoadedSpool Load() {
+    LoadedSpool loaded;
+    if (!base::CreateDirectory(dir_)) {
+      VLOG(1) << "ConstellationLogStore: failed to create " << dir_;
+      return loaded;
+    }
+
+    base::FileEnumerator enumerator(
+        dir_, false, base::FileEnumerator::FILES,
+        base::FilePath::FromASCII(base::StrCat({"*", kSpoolFileExtension}))
+            .value());
+    for (base::FilePath path = enumerator.Next(); !path.empty();
+         path = enumerator.Next()) {
+      unsigned epoch;
+      if (!base::StringToUint(path.BaseName().RemoveExtension().MaybeAsASCII(),
+                              &epoch) ||
+          epoch > UINT8_MAX) {
+        continue;
+      }
+      std::string contents;
+      if (!base::ReadFileToString(path, &contents)) {
+        continue;
+      }
+      const size_t valid_size =
+          ParseRecords(static_cast<uint8_t>(epoch), contents, &loaded);
+      if (valid_size < contents.size()) {
+        // The last record was torn by a crash while it was appended. Drop it,
+        // so that the next record doesn't get appended to it.
+        base::File file(path, base::File::FLAG_OPEN | base::File::FLAG_WRITE);
+        if (!file.IsValid() || !file.SetLength(valid_size)) {
+          VLOG(1) << "ConstellationLogStore: failed to truncate " << path;
+        }
+      }
+    }
+    return loaded;
+  }
+
+  void Append(uint8_t epoch, const std::string& records) {
+    if (!base::AppendToFile(GetPath(epoch), records)) {
+      VLOG(1) << "ConstellationLogStore: failed to append to epoch "
+              << static_cast<int>(epoch);
+    }
+  }
+
+  bool Rewrite(uint8_t epoch, const std::string& records) {
+    if (records.empty()) {
+      return Delete(epoch);
+    }
+    if (!base::ImportantFileWriter::WriteFileAtomically(GetPath(epoch),
+                                                        records)) {
+      VLOG(1) << "ConstellationLogStore: failed to rewrite epoch "
+              << static_cast<int>(epoch);
+      return false;
+    }
+    return true;
+  }
+
+  bool Delete(uint8_t epoch) { return base::DeleteFile(GetPath(epoch)); }
+
+ private:
+  base::FilePath GetPath(uint8_t epoch) const {
+    return dir_.AppendASCII(
+        base::StrCat({base::NumberToString(epoch), kSpoolFileExtension}));
+  }
+
+  // Applies the records of |contents| to |loaded|, and returns the size of
+  // its complete records. Malformed records are skipped.
+  static size_t ParseRecords(uint8_t epoch,
+                             std::string_view contents,
+                             LoadedSpool* loaded) {
+    size_t record_count = 0;
+    size_t pos = 0;
+    for (size_t end = contents.find('\n'); end != std::string_view::npos;
+         pos = end + 1, end = contents.find('\n', pos)) {
+      const std::string_view record = contents.substr(pos, end - pos);
+      if (record.size() < 2) {
+        continue;
+      }
+      if (record[0] == kRemoveRecordPrefix) {
+        loaded->messages.erase(LogKey(epoch, std::string(record.substr(1))));
+        ++record_count;
+        continue;
+      }
+
+      const size_t separator = record.find(' ');
+      std::string message;
+      if (record[0] != kUpdateRecordPrefix ||
+          separator == std::string_view::npos ||
+          !base::Base64Decode(record.substr(separator + 1), &message)) {
+        continue;
+      }
+      loaded->messages.insert_or_assign(
+          LogKey(epoch, std::string(record.substr(1, separator - 1))),
+          std::move(message));
+      ++record_count;
+    }
+    loaded->record_counts[epoch] = record_count;
+    return pos;
+  }
+
+  const base::FilePath dir_;
+};
+
 ConstellationLogStore::ConstellationLogStore(PrefService& local_state,
+                                             const base::FilePath& spool_dir,
                                              size_t keep_epoch_count)
-    : local_state_(local_state), keep_epoch_count_(keep_epoch_count) {
+    : local_state_(local_state),
+      spool_(base::ThreadPool::CreateSequencedTaskRunner(
+                 {base::MayBlock(), base::TaskPriority::BEST_EFFORT,
+                  base::TaskShutdownBehavior::BLOCK_SHUTDOWN}),
+             spool_dir),
+      keep_epoch_count_(keep_epoch_count) {
   CHECK_GT(keep_epoch_count, 0U);
+  spool_.AsyncCall(&Spool::Load).Then(
+      base::BindOnce(&ConstellationLogStore::OnSpoolLoaded,
+                     weak_ptr_factory_.GetWeakPtr()));
 }
 
 ConstellationLogStore::~ConstellationLogStore() = default;
@@ -42,33 +201,29 @@ bool ConstellationLogStore::LogKeyCompare::operator()(const LogKey& lhs,
 }
 
 void ConstellationLogStore::RegisterPrefs(PrefRegistrySimple* registry) {
+  // Still registered to migrate messages from it.
   registry->RegisterDictionaryPref(kPrefName);
 }
 
 void ConstellationLogStore::UpdateMessage(const std::string& histogram_name,
                                           uint8_t epoch,
                                           const std::string& msg) {
-  ScopedDictPrefUpdate update(&*local_state_, kPrefName);
-  std::string epoch_key = base::NumberToString(epoch);
-  base::Value::Dict* epoch_dict = update->EnsureDict(epoch_key);
-  epoch_dict->Set(histogram_name, msg);
+  LogKey key(epoch, histogram_name);
+  log_[key] = msg;
+  AppendToSpool(key, &msg);
 
   if (current_epoch_ != epoch) {
-    LogKey key(epoch, histogram_name);
-    log_[key] = msg;
     unsent_entries_.insert(key);
   }
 }
 
 void ConstellationLogStore::RemoveMessageIfExists(const LogKey& key) {
-  log_.erase(key);
   unsent_entries_.erase(key);
 
   // Update the persistent value.
-  ScopedDictPrefUpdate update(&*local_state_, kPrefName);
-  std::string epoch_key = base::NumberToString(key.epoch);
-  base::Value::Dict* epoch_dict = update->EnsureDict(epoch_key);
-  epoch_dict->Remove(key.histogram_name);
+  if (log_.erase(key)) {
+    AppendToSpool(key, nullptr);
+  }
 
   if (has_staged_log() && staged_entry_key_->epoch == key.epoch &&
       staged_entry_key_->histogram_name == key.histogram_name) {
@@ -77,6 +232,112 @@ void ConstellationLogStore::RemoveMessageIfExists(const LogKey& key) {
   }
 }
 
+void ConstellationLogStore::AppendToSpool(const LogKey& key,
+                                          const std::string* message) {
+  if (!is_spool_loaded_) {
+    keys_changed_before_load_.insert(key);
+  }
+  ++spool_record_counts_[key.epoch];
+  spool_.AsyncCall(&Spool::Append)
+      .WithArgs(key.epoch, message
+                               ? BuildUpdateRecord(key.histogram_name, *message)
+                               : BuildRemoveRecord(key.histogram_name));
+}
+
+void ConstellationLogStore::RewriteSpool(
+    uint8_t epoch,
+    base::OnceCallback<void(bool)> on_written) {
+  std::string records;
+  size_t record_count = 0;
+  for (auto it = log_.lower_bound(LogKey(epoch, std::string()));
+       it != log_.end() && it->first.epoch == epoch; ++it) {
+    records += BuildUpdateRecord(it->first.histogram_name, it->second);
+    ++record_count;
+  }
+
+  if (record_count) {
+    spool_record_counts_[epoch] = record_count;
+  } else {
+    spool_record_counts_.erase(epoch);
+  }
+  spool_.AsyncCall(&Spool::Rewrite)
+      .WithArgs(epoch, std::move(records))
+      .Then(std::move(on_written));
+}
+
+void ConstellationLogStore::OnSpoolLoaded(LoadedSpool loaded) {
+  std::vector<std::pair<LogKey, std::string>> messages;
+  for (auto& [key, message] : loaded.messages) {
+    if (!base::Contains(keys_changed_before_load_, key) &&
+        !base::Contains(log_, key)) {
+      messages.emplace_back(key, std::move(message));
+    }
+  }
+  log_.insert(std::make_move_iterator(messages.begin()),
+              std::make_move_iterator(messages.end()));
+  for (const auto [epoch, record_count] : loaded.record_counts) {
+    spool_record_counts_[epoch] += record_count;
+  }
+  keys_changed_before_load_.clear();
+  is_spool_loaded_ = true;
+
+  MigrateFromPrefs();
+
+  if (load_unsent_logs_pending_) {
+    load_unsent_logs_pending_ = false;
+    LoadPersistedUnsentLogs();
+  }
+}
+
+void ConstellationLogStore::MigrateFromPrefs() {
+  const base::Value::Dict& log_dict = local_state_->GetDict(kPrefName);
+  if (log_dict.empty()) {
+    return;
+  }
+
+  base::flat_set<uint8_t> migrated_epochs;
+  for (const auto [epoch_key, inner_epoch_dict] : log_dict) {
+    uint64_t parsed_epoch;
+    if (!base::StringToUint64(epoch_key, &parsed_epoch) ||
+        !inner_epoch_dict.is_dict()) {
+      continue;
+    }
+    uint8_t item_epoch = (uint8_t)parsed_epoch;
+
+    for (const auto [histogram_name, log_value] : inner_epoch_dict.GetDict()) {
+      if (!log_value.is_string()) {
+        continue;
+      }
+      // Messages already in the spool are newer.
+      if (log_.emplace(LogKey(item_epoch, histogram_name),
+                       log_value.GetString())
+              .second) {
+        migrated_epochs.insert(item_epoch);
+      }
+    }
+  }
+
+  // The pref is only cleared once the messages are on disk, so that they
+  // survive a crash in between.
+  auto on_written = base::BarrierCallback<bool>(
+      migrated_epochs.size(),
+      base::BindOnce(&ConstellationLogStore::OnMigratedToSpool,
+                     weak_ptr_factory_.GetWeakPtr()));
+  for (uint8_t epoch : migrated_epochs) {
+    RewriteSpool(epoch, on_written);
+  }
+}
+
+void ConstellationLogStore::OnMigratedToSpool(
+    const std::vector<bool>& results) {
+  if (base::Contains(results, false)) {
+    // Migrated again on the next start. Messages in the spool take precedence.
+    VLOG(1) << "ConstellationLogStore: failed to migrate messages from prefs";
+    return;
+  }
+  local_state_->ClearPref(kPrefName);
+}
+
 void ConstellationLogStore::SetCurrentEpoch(uint8_t current_epoch) {
   current_epoch_ = current_epoch;
 }
@@ -155,47 +416,46 @@ void ConstellationLogStore::TrimAndPersistUnsentLogs(
 }
 
 void ConstellationLogStore::LoadPersistedUnsentLogs() {
-  log_.clear();
-  unsent_entries_.clear();
-
-  std::vector<std::string> epochs_to_remove;
+  if (!is_spool_loaded_) {
+    load_unsent_logs_pending_ = true;
+    return;
+  }
 
-  const base::Value::Dict& log_dict = local_state_->GetDict(kPrefName);
-  for (const auto [epoch_key, inner_epoch_dict] : log_dict) {
-    uint64_t parsed_epoch;
-    if (!base::StringToUint64(epoch_key, &parsed_epoch)) {
-      continue;
-    }
-    uint8_t item_epoch = (uint8_t)parsed_epoch;
+  unsent_entries_.clear();
 
-    if (current_epoch_ == item_epoch) {
+  base::flat_set<uint8_t> epochs_to_remove;
+  base::flat_map<uint8_t, size_t> message_counts;
+  for (const auto& [key, message] : log_) {
+    if (current_epoch_ == key.epoch) {
       // Do not load/send messages from the current epoch
       continue;
     }
 
-    if ((current_epoch_ - item_epoch) >= keep_epoch_count_) {
+    if ((current_epoch_ - key.epoch) >= keep_epoch_count_) {
       // If epoch is too old, delete it
-      epochs_to_remove.push_back(epoch_key);
+      epochs_to_remove.insert(key.epoch);
       continue;
     }
 
-    for (const auto [histogram_name, log_value] : inner_epoch_dict.GetDict()) {
-      if (!log_value.is_string()) {
-        continue;
-      }
-      LogKey key(item_epoch, histogram_name);
-      log_[key] = log_value.GetString();
-
-      unsent_entries_.insert(key);
-    }
+    unsent_entries_.insert(key);
+    ++message_counts[key.epoch];
   }
 
-  if (!epochs_to_remove.empty()) {
-    ScopedDictPrefUpdate update(&*local_state_, kPrefName);
-    for (const std::string& epoch : epochs_to_remove) {
-      update->Remove(epoch);
+  base::EraseIf(log_, [&](const auto& entry) {
+    return base::Contains(epochs_to_remove, entry.first.epoch);
+  });
+
+  // Compact the spool files of previous epochs: sent messages and superseded
+  // updates are dropped, along with the files of removed epochs.
+  std::vector<uint8_t> epochs_to_compact;
+  for (const auto [epoch, record_count] : spool_record_counts_) {
+    if (epoch != current_epoch_ && record_count > message_counts[epoch]) {
+      epochs_to_compact.push_back(epoch);
     }
   }
+  for (uint8_t epoch : epochs_to_compact) {
+    RewriteSpool(epoch, base::DoNothing());
+  }
 }
 
 }  // namespace p3a
@@ -13,7 +13,11 @@
 
 #include "base/containers/flat_map.h"
 #include "base/containers/flat_set.h"
+#include "base/files/file_path.h"
+#include "base/functional/callback_forward.h"
 #include "base/memory/raw_ref.h"
+#include "base/memory/weak_ptr.h"
+#include "base/threading/sequence_bound.h"
 #include "base/time/time.h"
 #include "components/metrics/log_store.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
@@ -23,13 +27,18 @@ class PrefRegistrySimple;
 
 namespace p3a {
 
-// Stores messages from previous epochs in memory and persists all messages in
-// prefs on the fly. All messages from previous epochs could be loaded using
-// |LoadPersistedUnsentLogs()|. The function will also remove epochs are exceed
-// the "keep epoch count".
+// Stores messages in memory and persists all messages on the fly, in an
+// append-only spool file per epoch under |spool_dir|. The spool is read in the
+// background once the store is created. All messages from previous epochs
+// could be loaded using |LoadPersistedUnsentLogs()|. The function will also
+// remove epochs are exceed the "keep epoch count", and compact the spool files
+// of the others. Messages persisted in prefs by older versions are moved to
+// the spool once it's read.
 class ConstellationLogStore : public metrics::LogStore {
  public:
-  ConstellationLogStore(PrefService& local_state, size_t keep_epoch_count);
+  ConstellationLogStore(PrefService& local_state,
+                        const base::FilePath& spool_dir,
+                        size_t keep_epoch_count);
   ~ConstellationLogStore() override;
 
   ConstellationLogStore(const ConstellationLogStore&) = delete;
@@ -58,7 +67,8 @@ class ConstellationLogStore : public metrics::LogStore {
   // |TrimAndPersistUnsentLogs| should not be used, since we persist everything
   // on the fly.
   void TrimAndPersistUnsentLogs(bool overwrite_in_memory_store) override;
-  // Returns early if founds malformed persisted values.
+  // Skips malformed persisted values. Runs once the spool is read, if it
+  // isn't yet.
   void LoadPersistedUnsentLogs() override;
 
  private:
@@ -73,13 +83,37 @@ class ConstellationLogStore : public metrics::LogStore {
     bool operator()(const LogKey& lhs, const LogKey& rhs) const;
   };
 
+  class Spool;
+  struct LoadedSpool;
+
   void RemoveMessageIfExists(const LogKey& key);
 
+  // Appends the update of |key| to |message|, or its removal if |message| is
+  // null, to the spool.
+  void AppendToSpool(const LogKey& key, const std::string* message);
+  // Replaces the spool file of |epoch| with just its current messages, then
+  // runs |on_written| with whether that succeeded.
+  void RewriteSpool(uint8_t epoch, base::OnceCallback<void(bool)> on_written);
+  void OnSpoolLoaded(LoadedSpool loaded);
+  void MigrateFromPrefs();
+  void OnMigratedToSpool(const std::vector<bool>& results);
+
   const raw_ref<PrefService> local_state_;
 
+  // Messages of all epochs, including the current one.
   base::flat_map<LogKey, std::string, LogKeyCompare> log_;
   base::flat_set<LogKey, LogKeyCompare> unsent_entries_;
 
+  base::SequenceBound<Spool> spool_;
+  bool is_spool_loaded_ = false;
+  bool load_unsent_logs_pending_ = false;
+  // Messages updated or removed before the spool was read, which are newer
+  // than what it holds.
+  base::flat_set<LogKey, LogKeyCompare> keys_changed_before_load_;
+  // The number of records in each epoch's spool file, including superseded
+  // ones.
+  base::flat_map<uint8_t, size_t> spool_record_counts_;
+
   std::unique_ptr<LogKey> staged_entry_key_;
   std::string staged_log_;
 
@@ -89,6 +123,8 @@ class ConstellationLogStore : public metrics::LogStore {
 
   uint8_t current_epoch_;
   size_t keep_epoch_count_;
+
+  base::WeakPtrFactory<ConstellationLogStore> weak_ptr_factory_{this};
 };
 
 }  // namespace p3a
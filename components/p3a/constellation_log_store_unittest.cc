@@ -5,11 +5,23 @@
 
 #include "brave/components/p3a/constellation_log_store.h"
 
+#include <algorithm>
 #include <memory>
 #include <set>
-
+#include <string>
+#include <vector>
+
+#include "base/files/file_enumerator.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/logging.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/test/task_environment.h"
+#include "base/values.h"
+#include "components/prefs/pref_store.h"
 #include "components/prefs/testing_pref_service.h"
+#include "components/prefs/testing_pref_store.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace p3a {
@@ -17,6 +29,23 @@ namespace p3a {
 namespace {
 
 constexpr size_t kTestKeepEpochCount = 4;
+constexpr size_t kMetricsPerEpoch = 300;
+
+constexpr char kPrefName[] = "p3a.constellation_logs";
+
+// Counts the changes to local state, each of which would have it written to
+// disk.
+class PrefChangeCounter : public PrefStore::Observer {
+ public:
+  // PrefStore::Observer:
+  void OnPrefValueChanged(const std::string& key) override { ++count_; }
+  void OnInitializationCompleted(bool succeeded) override {}
+
+  size_t count() const { return count_; }
+
+ private:
+  size_t count_ = 0;
+};
 
 }  // namespace
 
@@ -26,9 +55,36 @@ class P3AConstellationLogStoreTest : public testing::Test {
 
  protected:
   void SetUp() override {
+    ASSERT_TRUE(spool_dir.CreateUniqueTempDir());
     ConstellationLogStore::RegisterPrefs(local_state.registry());
-    log_store = std::make_unique<ConstellationLogStore>(local_state,
-                                                        kTestKeepEpochCount);
+    CreateLogStore();
+  }
+
+  void CreateLogStore() {
+    log_store = std::make_unique<ConstellationLogStore>(
+        local_state, spool_dir.GetPath(), kTestKeepEpochCount);
+    task_environment.RunUntilIdle();
+  }
+
+  // Destroys the log store as if the browser was closed or crashed, once
+  // everything is written to the spool, and creates it again.
+  void RestartLogStore(uint8_t current_epoch) {
+    log_store.reset();
+    task_environment.RunUntilIdle();
+    CreateLogStore();
+    log_store->SetCurrentEpoch(current_epoch);
+    log_store->LoadPersistedUnsentLogs();
+  }
+
+  std::vector<base::FilePath> GetSpoolFiles() {
+    std::vector<base::FilePath> files;
+    base::FileEnumerator enumerator(spool_dir.GetPath(), false,
+                                    base::FileEnumerator::FILES);
+    for (base::FilePath path = enumerator.Next(); !path.empty();
+         path = enumerator.Next()) {
+      files.push_back(path);
+    }
+    return files;
   }
 
   std::string GenerateMockConstellationMessage() {
@@ -68,7 +124,9 @@ class P3AConstellationLogStoreTest : public testing::Test {
     ASSERT_FALSE(log_store->has_staged_log());
   }
 
+  base::test::TaskEnvironment task_environment;
   size_t curr_test_constellation_message_id;
+  base::ScopedTempDir spool_dir;
   std::unique_ptr<ConstellationLogStore> log_store;
   TestingPrefServiceSimple local_state;
 };
@@ -165,4 +223,124 @@ TEST_F(P3AConstellationLogStoreTest, ShouldDeleteOldMessages) {
   // Should only consume messages from the latest previous epoch
 }
 
+TEST_F(P3AConstellationLogStoreTest, PersistsMessagesAcrossRestarts) {
+  log_store->SetCurrentEpoch(1);
+  UpdateSomeMessages(1, 5);
+
+  RestartLogStore(2);
+
+  ConsumeMessages(5);
+
+  // Sent messages aren't loaded again.
+  RestartLogStore(2);
+  ASSERT_FALSE(log_store->has_unsent_logs());
+}
+
+TEST_F(P3AConstellationLogStoreTest, RecoversFromTornRecords) {
+  log_store->SetCurrentEpoch(1);
+  UpdateSomeMessages(1, 3);
+  log_store.reset();
+  task_environment.RunUntilIdle();
+
+  // A crash while a record was appended leaves part of it behind.
+  std::vector<base::FilePath> files = GetSpoolFiles();
+  ASSERT_EQ(1u, files.size());
+  ASSERT_TRUE(base::AppendToFile(files[0], "+Brave.Test.Metric4 bG9"));
+
+  CreateLogStore();
+  log_store->SetCurrentEpoch(1);
+  UpdateSomeMessages(1, 5);
+
+  // The torn record is dropped, and doesn't affect the ones after it.
+  RestartLogStore(2);
+  ConsumeMessages(5);
+}
+
+TEST_F(P3AConstellationLogStoreTest, IgnoresMalformedRecords) {
+  log_store->SetCurrentEpoch(1);
+  UpdateSomeMessages(1, 2);
+  log_store.reset();
+  task_environment.RunUntilIdle();
+
+  std::vector<base::FilePath> files = GetSpoolFiles();
+  ASSERT_EQ(1u, files.size());
+  ASSERT_TRUE(base::AppendToFile(
+      files[0], "+Brave.Test.Metric3 not*base64\n?Brave.Test.Metric4\n\n"));
+
+  RestartLogStore(2);
+  ConsumeMessages(2);
+}
+
+TEST_F(P3AConstellationLogStoreTest, CompactsSpoolAtRotation) {
+  log_store->SetCurrentEpoch(1);
+  UpdateSomeMessages(1, 5);
+  log_store->SetCurrentEpoch(2);
+  UpdateSomeMessages(2, 5);
+  log_store->SetCurrentEpoch(3);
+  log_store->LoadPersistedUnsentLogs();
+  ConsumeMessages(10);
+  // Rotations load the unsent logs again, which compacts the spool.
+  log_store->LoadPersistedUnsentLogs();
+  task_environment.RunUntilIdle();
+
+  // Everything from previous epochs was sent, so their files are gone.
+  EXPECT_TRUE(GetSpoolFiles().empty());
+
+  log_store->SetCurrentEpoch(kTestKeepEpochCount + 3);
+  UpdateSomeMessages(kTestKeepEpochCount + 3, 1);
+  log_store->SetCurrentEpoch(kTestKeepEpochCount + 4);
+  log_store->LoadPersistedUnsentLogs();
+  task_environment.RunUntilIdle();
+
+  // The file of the previous epoch only holds its latest message now.
+  std::vector<base::FilePath> files = GetSpoolFiles();
+  ASSERT_EQ(1u, files.size());
+  std::string contents;
+  ASSERT_TRUE(base::ReadFileToString(files[0], &contents));
+  EXPECT_EQ(1, std::count(contents.begin(), contents.end(), '\n'));
+
+  RestartLogStore(kTestKeepEpochCount + 4);
+  ConsumeMessages(1);
+}
+
+TEST_F(P3AConstellationLogStoreTest, MigratesMessagesFromPrefs) {
+  log_store.reset();
+  task_environment.RunUntilIdle();
+
+  base::Value::Dict epoch_dict;
+  epoch_dict.Set("Brave.Test.Metric1", "log msg a");
+  epoch_dict.Set("Brave.Test.Metric2", "log msg b");
+  base::Value::Dict log_dict;
+  log_dict.Set("1", std::move(epoch_dict));
+  local_state.SetDict(kPrefName, std::move(log_dict));
+
+  CreateLogStore();
+  EXPECT_TRUE(local_state.GetDict(kPrefName).empty());
+
+  // Migrated messages are in the spool.
+  RestartLogStore(2);
+  ConsumeMessages(2);
+}
+
+TEST_F(P3AConstellationLogStoreTest, FullEpochDoesNotWriteLocalState) {
+  PrefChangeCounter counter;
+  local_state.user_prefs_store()->AddObserver(&counter);
+
+  // Prepare a message for every metric during an epoch, then send them all
+  // during the next one.
+  log_store->SetCurrentEpoch(1);
+  UpdateSomeMessages(1, kMetricsPerEpoch);
+  log_store->SetCurrentEpoch(2);
+  log_store->LoadPersistedUnsentLogs();
+  UpdateSomeMessages(2, kMetricsPerEpoch);
+  ConsumeMessages(kMetricsPerEpoch);
+  task_environment.RunUntilIdle();
+
+  LOG(INFO) << "Local state changes over an epoch of " << kMetricsPerEpoch
+            << " metrics: " << counter.count();
+  EXPECT_EQ(0u, counter.count());
+
+  local_state.user_prefs_store()->RemoveObserver(&counter);
+}
+
 }  // namespace p3a
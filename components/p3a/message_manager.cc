@@ -30,11 +30,14 @@ namespace p3a {
 namespace {
 
 const size_t kMaxEpochsToRetain = 4;
+constexpr base::FilePath::CharType kConstellationLogsDirName[] =
+    FILE_PATH_LITERAL("P3A Constellation Logs");
 constexpr base::TimeDelta kPostRotationUploadDelay = base::Seconds(30);
 
 }  // namespace
 
 MessageManager::MessageManager(PrefService& local_state,
+                               const base::FilePath& user_data_dir,
                                const P3AConfig* config,
                                Delegate& delegate,
                                std::string channel,
@@ -53,7 +56,8 @@ MessageManager::MessageManager(PrefService& local_state,
         *this, *local_state_, true, MetricLogType::kTypical);
     constellation_prep_log_store_->LoadPersistedUnsentLogs();
     constellation_send_log_store_ = std::make_unique<ConstellationLogStore>(
-        *local_state_, kMaxEpochsToRetain);
+        *local_state_, user_data_dir.Append(kConstellationLogsDirName),
+        kMaxEpochsToRetain);
   }
 }
 
@@ -11,6 +11,7 @@
 #include <string_view>
 
 #include "base/containers/flat_map.h"
+#include "base/files/file_path.h"
 #include "base/functional/callback.h"
 #include "base/memory/raw_ptr.h"
 #include "base/memory/raw_ref.h"
@@ -63,6 +64,7 @@ class MessageManager : public MetricLogStore::Delegate {
     virtual ~Delegate() {}
   };
   MessageManager(PrefService& local_state,
+                 const base::FilePath& user_data_dir,
                  const P3AConfig* config,
                  Delegate& delegate,
                  std::string channel,
@@ -11,6 +11,7 @@
 #include <string_view>
 #include <vector>
 
+#include "base/files/scoped_temp_dir.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/test/bind.h"
 #include "base/test/scoped_feature_list.h"
@@ -70,6 +71,8 @@ class P3AMessageManagerTest : public testing::Test,
           {});
     }
 
+    ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+
     base::Time future_mock_time;
     if (base::Time::FromString("2050-01-04", &future_mock_time)) {
       task_environment_.AdvanceClock(future_mock_time - base::Time::Now());
@@ -145,7 +148,8 @@ class P3AMessageManagerTest : public testing::Test,
         }));
 
     message_manager = std::make_unique<MessageManager>(
-        local_state, &p3a_config, *this, "release", "2099-01-01");
+        local_state, temp_dir.GetPath(), &p3a_config, *this, "release",
+        "2099-01-01");
 
     message_manager->Init(shared_url_loader_factory);
 
@@ -190,6 +194,7 @@ class P3AMessageManagerTest : public testing::Test,
   network::TestURLLoaderFactory url_loader_factory;
   scoped_refptr<network::SharedURLLoaderFactory> shared_url_loader_factory;
   P3AConfig p3a_config;
+  base::ScopedTempDir temp_dir;
   std::unique_ptr<MessageManager> message_manager;
   TestingPrefServiceSimple local_state;
 
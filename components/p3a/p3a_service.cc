@@ -74,12 +74,13 @@ inline void DCheckCurrentlyOnUIThread() {
 }  // namespace
 
 P3AService::P3AService(PrefService& local_state,
+                       const base::FilePath& user_data_dir,
                        std::string channel,
                        std::string week_of_install,
                        P3AConfig config)
     : local_state_(local_state), config_(std::move(config)) {
   message_manager_ = std::make_unique<MessageManager>(
-      local_state, &config_, *this, channel, week_of_install);
+      local_state, user_data_dir, &config_, *this, channel, week_of_install);
 }
 
 P3AService::~P3AService() = default;
@@ -13,6 +13,7 @@
 
 #include "base/callback_list.h"
 #include "base/containers/flat_map.h"
+#include "base/files/file_path.h"
 #include "base/memory/raw_ref.h"
 #include "base/memory/ref_counted.h"
 #include "base/metrics/histogram_base.h"
@@ -42,7 +43,10 @@ struct P3AConfig;
 class P3AService : public base::RefCountedThreadSafe<P3AService>,
                    public MessageManager::Delegate {
  public:
+  // |user_data_dir| is where Constellation messages are persisted, until
+  // they're sent.
   P3AService(PrefService& local_state,
+             const base::FilePath& user_data_dir,
              std::string channel,
              std::string week_of_install,
              P3AConfig config);
@@ -11,6 +11,7 @@
 #include <vector>
 
 #include "base/command_line.h"
+#include "base/files/scoped_temp_dir.h"
 #include "base/memory/scoped_refptr.h"
 #include "base/metrics/histogram_functions.h"
 #include "base/strings/string_number_conversions.h"
@@ -56,6 +57,8 @@ class P3AServiceTest : public testing::Test {
 
  protected:
   void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+
     base::Time future_mock_time;
     if (base::Time::FromString("2050-01-04", &future_mock_time)) {
       task_environment_.AdvanceClock(future_mock_time - base::Time::Now());
@@ -81,8 +84,9 @@ class P3AServiceTest : public testing::Test {
   }
 
   void SetUpP3AService() {
-    p3a_service_ = scoped_refptr(new P3AService(
-        local_state_, "release", "2049-01-01", P3AConfig(config_)));
+    p3a_service_ = scoped_refptr(
+        new P3AService(local_state_, temp_dir_.GetPath(), "release",
+                       "2049-01-01", P3AConfig(config_)));
 
     p3a_service_->DisableStarAttestationForTesting();
     p3a_service_->Init(shared_url_loader_factory_);
@@ -125,6 +129,7 @@ class P3AServiceTest : public testing::Test {
   scoped_refptr<network::SharedURLLoaderFactory> shared_url_loader_factory_;
 
   P3AConfig config_;
+  base::ScopedTempDir temp_dir_;
   scoped_refptr<P3AService> p3a_service_;
   TestingPrefServiceSimple local_state_;
 
@@ -0,0 +1,207 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/tor/fake_tor_control_server.h"
+
+#include <utility>
+
+#include "base/containers/contains.h"
+#include "base/functional/bind.h"
+#include "base/ranges/algorithm.h"
+#include "base/run_loop.h"
+#include "base/strings/strcat.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "net/base/io_buffer.h"
+#include "net/base/ip_address.h"
+#include "net/base/ip_endpoint.h"
+#include "net/base/net_errors.h"
+#include "net/socket/stream_socket.h"
+#include "net/socket/tcp_server_socket.h"
+#include "net/traffic_annotation/network_traffic_annotation_test_helper.h"
+
+namespace tor {
+
+namespace {
+
+constexpr int kReadBufferSize = 4096;
+constexpr char kExtendCircuitCmd[] = "EXTENDCIRCUIT";
+
+}  // namespace
+
+FakeTorControlServer::FakeTorControlServer() = default;
+FakeTorControlServer::~FakeTorControlServer() = default;
+
+bool FakeTorControlServer::Start() {
+  server_socket_ =
+      std::make_unique<net::TCPServerSocket>(nullptr, net::NetLogSource());
+  if (server_socket_->Listen(
+          net::IPEndPoint(net::IPAddress::IPv4Localhost(), 0), 1,
+          /*ipv6_only=*/absl::nullopt) != net::OK) {
+    return false;
+  }
+  net::IPEndPoint address;
+  if (server_socket_->GetLocalAddress(&address) != net::OK) {
+    return false;
+  }
+  port_ = address.port();
+
+  const int rv = server_socket_->Accept(
+      &socket_, base::BindOnce(&FakeTorControlServer::OnAccept,
+                               weak_ptr_factory_.GetWeakPtr()));
+  if (rv != net::ERR_IO_PENDING) {
+    OnAccept(rv);
+  }
+  return true;
+}
+
+void FakeTorControlServer::SendEvent(const std::string& event) {
+  Write(base::StrCat({"650 ", event, "\r\n"}));
+}
+
+bool FakeTorControlServer::HasCommand(const std::string& command) const {
+  return base::Contains(commands_, command);
+}
+
+size_t FakeTorControlServer::CountCommands(const std::string& prefix) const {
+  return base::ranges::count_if(commands_, [&prefix](const auto& command) {
+    return base::StartsWith(command, prefix);
+  });
+}
+
+void FakeTorControlServer::WaitForCommand(const std::string& command) {
+  WaitUntil(base::BindRepeating(&FakeTorControlServer::HasCommand,
+                                base::Unretained(this), command));
+}
+
+void FakeTorControlServer::WaitForCommands(const std::string& prefix,
+                                           size_t count) {
+  WaitUntil(base::BindRepeating(
+      [](FakeTorControlServer* server, const std::string& prefix,
+         size_t count) { return server->CountCommands(prefix) >= count; },
+      base::Unretained(this), prefix, count));
+}
+
+void FakeTorControlServer::WaitUntil(
+    base::RepeatingCallback<bool()> condition) {
+  if (condition.Run()) {
+    return;
+  }
+  base::RunLoop run_loop;
+  wait_condition_ = std::move(condition);
+  wait_quit_closure_ = run_loop.QuitClosure();
+  run_loop.Run();
+  wait_condition_.Reset();
+}
+
+void FakeTorControlServer::OnAccept(int rv) {
+  if (rv != net::OK) {
+    return;
+  }
+  read_buffer_ = base::MakeRefCounted<net::IOBufferWithSize>(kReadBufferSize);
+  DoRead();
+}
+
+void FakeTorControlServer::DoRead() {
+  int rv;
+  do {
+    rv = socket_->Read(read_buffer_.get(), kReadBufferSize,
+                       base::BindOnce(&FakeTorControlServer::OnRead,
+                                      weak_ptr_factory_.GetWeakPtr()));
+  } while (rv != net::ERR_IO_PENDING && HandleRead(rv));
+}
+
+void FakeTorControlServer::OnRead(int rv) {
+  if (HandleRead(rv)) {
+    DoRead();
+  }
+}
+
+bool FakeTorControlServer::HandleRead(int rv) {
+  if (rv <= 0) {
+    socket_.reset();
+    return false;
+  }
+  pending_input_.append(read_buffer_->data(), rv);
+  size_t end;
+  while ((end = pending_input_.find("\r\n")) != std::string::npos) {
+    const std::string command = pending_input_.substr(0, end);
+    pending_input_.erase(0, end + 2);
+    HandleCommand(command);
+  }
+  return true;
+}
+
+void FakeTorControlServer::HandleCommand(const std::string& command) {
+  commands_.push_back(command);
+  if (wait_quit_closure_ && wait_condition_.Run()) {
+    std::move(wait_quit_closure_).Run();
+  }
+  if (!base::StartsWith(command, kExtendCircuitCmd)) {
+    Write("250 OK\r\n");
+    return;
+  }
+
+  const std::string circuit_id = base::NumberToString(next_circuit_id_++);
+  Write(base::StrCat({"250 EXTENDED ", circuit_id, "\r\n"}));
+  if (auto_build_circuits_) {
+    SendEvent(base::StrCat({"CIRC ", circuit_id,
+                            " BUILT $0123456789ABCDEF~relay "
+                            "PURPOSE=CONTROLLER"}));
+  }
+}
+
+void FakeTorControlServer::Write(const std::string& data) {
+  if (!socket_) {
+    return;
+  }
+  pending_output_ += data;
+  if (!write_buffer_) {
+    DoWrite();
+  }
+}
+
+void FakeTorControlServer::DoWrite() {
+  while (!pending_output_.empty() || write_buffer_) {
+    if (!write_buffer_) {
+      auto buffer = base::MakeRefCounted<net::StringIOBuffer>(
+          std::exchange(pending_output_, std::string()));
+      write_buffer_ = base::MakeRefCounted<net::DrainableIOBuffer>(
+          buffer, buffer->size());
+    }
+    const int rv = socket_->Write(
+        write_buffer_.get(), write_buffer_->BytesRemaining(),
+        base::BindOnce(&FakeTorControlServer::OnWrite,
+                       weak_ptr_factory_.GetWeakPtr()),
+        TRAFFIC_ANNOTATION_FOR_TESTS);
+    if (rv == net::ERR_IO_PENDING) {
+      return;
+    }
+    if (rv < 0) {
+      socket_.reset();
+      write_buffer_.reset();
+      return;
+    }
+    write_buffer_->DidConsume(rv);
+    if (!write_buffer_->BytesRemaining()) {
+      write_buffer_.reset();
+    }
+  }
+}
+
+void FakeTorControlServer::OnWrite(int rv) {
+  if (rv < 0) {
+    socket_.reset();
+    write_buffer_.reset();
+    return;
+  }
+  write_buffer_->DidConsume(rv);
+  if (!write_buffer_->BytesRemaining()) {
+    write_buffer_.reset();
+  }
+  DoWrite();
+}
+
+}  // namespace tor
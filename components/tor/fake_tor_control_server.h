@@ -0,0 +1,90 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_TOR_FAKE_TOR_CONTROL_SERVER_H_
+#define BRAVE_COMPONENTS_TOR_FAKE_TOR_CONTROL_SERVER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/functional/callback.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/memory/weak_ptr.h"
+
+namespace net {
+class DrainableIOBuffer;
+class IOBuffer;
+class StreamSocket;
+class TCPServerSocket;
+}  // namespace net
+
+namespace tor {
+
+// Minimal Tor control port listening on localhost. It accepts a single
+// connection, answers every command with "250 OK", hands out sequential
+// circuit ids for EXTENDCIRCUIT and records the received commands. SOCKS
+// clients are simulated by sending STREAM events, which is how Tor reports
+// them to the controller.
+class FakeTorControlServer {
+ public:
+  FakeTorControlServer();
+  FakeTorControlServer(const FakeTorControlServer&) = delete;
+  FakeTorControlServer& operator=(const FakeTorControlServer&) = delete;
+  ~FakeTorControlServer();
+
+  bool Start();
+  int port() const { return port_; }
+
+  // When set, EXTENDCIRCUIT replies are followed by a CIRC BUILT event.
+  void set_auto_build_circuits(bool auto_build) {
+    auto_build_circuits_ = auto_build;
+  }
+
+  // Sends an asynchronous "650 <event>" line.
+  void SendEvent(const std::string& event);
+
+  const std::vector<std::string>& commands() const { return commands_; }
+  bool HasCommand(const std::string& command) const;
+  size_t CountCommands(const std::string& prefix) const;
+
+  // Run a RunLoop until |command| has been received.
+  void WaitForCommand(const std::string& command);
+  // Run a RunLoop until |count| commands starting with |prefix| have been
+  // received.
+  void WaitForCommands(const std::string& prefix, size_t count);
+
+ private:
+  void WaitUntil(base::RepeatingCallback<bool()> condition);
+  void OnAccept(int rv);
+  void DoRead();
+  void OnRead(int rv);
+  bool HandleRead(int rv);
+  void HandleCommand(const std::string& command);
+  void Write(const std::string& data);
+  void DoWrite();
+  void OnWrite(int rv);
+
+  int port_ = 0;
+  bool auto_build_circuits_ = true;
+  int next_circuit_id_ = 1;
+
+  std::unique_ptr<net::TCPServerSocket> server_socket_;
+  std::unique_ptr<net::StreamSocket> socket_;
+  scoped_refptr<net::IOBuffer> read_buffer_;
+  std::string pending_input_;
+  std::string pending_output_;
+  scoped_refptr<net::DrainableIOBuffer> write_buffer_;
+  std::vector<std::string> commands_;
+
+  base::RepeatingCallback<bool()> wait_condition_;
+  base::OnceClosure wait_quit_closure_;
+
+  base::WeakPtrFactory<FakeTorControlServer> weak_ptr_factory_{this};
+};
+
+}  // namespace tor
+
+#endif  // BRAVE_COMPONENTS_TOR_FAKE_TOR_CONTROL_SERVER_H_
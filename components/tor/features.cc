@@ -0,0 +1,18 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/tor/features.h"
+
+namespace tor {
+namespace features {
+
+// When enabled, a few Tor circuits are built ahead of time and handed to new
+// first-party isolation keys.
+BASE_FEATURE(kBraveTorCircuitPrewarming,
+             "BraveTorCircuitPrewarming",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+
+}  // namespace features
+}  // namespace tor
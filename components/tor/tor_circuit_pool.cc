@@ -0,0 +1,249 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/tor/tor_circuit_pool.h"
+
+#include <utility>
+#include <vector>
+
+#include "base/containers/contains.h"
+#include "base/functional/bind.h"
+#include "base/functional/callback_helpers.h"
+#include "base/ranges/algorithm.h"
+#include "base/strings/string_split.h"
+#include "brave/components/tor/tor_control.h"
+
+namespace tor {
+
+namespace {
+
+constexpr char kNoCircuit[] = "0";
+constexpr char kGeneralPurpose[] = "general";
+
+// CIRC event statuses
+constexpr char kCircuitBuilt[] = "BUILT";
+constexpr char kCircuitFailed[] = "FAILED";
+constexpr char kCircuitClosed[] = "CLOSED";
+
+// STREAM event statuses which require the controller to attach the stream.
+constexpr char kStreamNew[] = "NEW";
+constexpr char kStreamNewResolve[] = "NEWRESOLVE";
+constexpr char kStreamDetached[] = "DETACHED";
+
+constexpr char kSocksUsername[] = "SOCKS_USERNAME";
+constexpr char kSocksPassword[] = "SOCKS_PASSWORD";
+
+}  // namespace
+
+TorCircuitPool::TorCircuitPool(TorControl* control, size_t pool_size)
+    : control_(control), pool_size_(pool_size) {
+  DCHECK(control_);
+  DCHECK_GT(pool_size_, 0u);
+}
+
+TorCircuitPool::~TorCircuitPool() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+}
+
+void TorCircuitPool::Start() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (running_) {
+    return;
+  }
+  running_ = true;
+  control_->DoSubscribe(TorControlEvent::CIRC, base::DoNothing());
+  control_->DoSubscribe(TorControlEvent::STREAM, base::DoNothing());
+  control_->SetLeaveStreamsUnattached(
+      true, base::BindOnce(&TorCircuitPool::OnLeaveStreamsUnattached,
+                           weak_ptr_factory_.GetWeakPtr()));
+  Refill();
+}
+
+void TorCircuitPool::OnLeaveStreamsUnattached(bool error) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (error) {
+    // Tor keeps attaching streams on its own, stop handing out circuits.
+    VLOG(1) << "Failed to leave streams unattached!";
+    running_ = false;
+  }
+}
+
+void TorCircuitPool::OnTorEvent(TorControlEvent event,
+                                const std::string& initial) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (!running_) {
+    return;
+  }
+  if (event == TorControlEvent::CIRC) {
+    OnCircuitEvent(initial);
+  } else if (event == TorControlEvent::STREAM) {
+    OnStreamEvent(initial);
+  }
+}
+
+// static
+std::string TorCircuitPool::GetEventParam(const std::string& initial,
+                                          const std::string& key) {
+  const std::string needle = " " + key + "=";
+  const size_t begin = initial.find(needle);
+  if (begin == std::string::npos) {
+    return std::string();
+  }
+  std::string parsed_key;
+  std::string value;
+  size_t end;
+  if (!TorControl::ParseKV(initial.substr(begin + 1), &parsed_key, &value,
+                           &end)) {
+    return std::string();
+  }
+  return value;
+}
+
+std::string TorCircuitPool::GetCircuitForTesting(
+    const std::string& isolation_key) const {
+  auto it = circuit_by_key_.find(isolation_key);
+  return it == circuit_by_key_.end() ? std::string() : it->second;
+}
+
+void TorCircuitPool::Refill() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  for (size_t i = warm_circuits_.size() + building_circuits_count();
+       i < pool_size_; ++i) {
+    ++pending_extends_;
+    control_->ExtendCircuit(base::BindOnce(&TorCircuitPool::OnCircuitExtended,
+                                           weak_ptr_factory_.GetWeakPtr()));
+  }
+}
+
+void TorCircuitPool::ScheduleRefill() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (refill_timer_.IsRunning()) {
+    return;
+  }
+  refill_timer_.Start(
+      FROM_HERE, kRefillDelay,
+      base::BindOnce(&TorCircuitPool::Refill, base::Unretained(this)));
+}
+
+void TorCircuitPool::OnCircuitExtended(bool error,
+                                       const std::string& circuit_id) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK_GT(pending_extends_, 0u);
+  --pending_extends_;
+  if (error) {
+    // Don't retry right away, the next stream bound to a warm circuit or a
+    // closed pool circuit triggers another refill.
+    VLOG(1) << "Failed to extend circuit!";
+    return;
+  }
+  building_circuits_.insert(circuit_id);
+}
+
+// CIRC events look like "<CircuitID> <CircStatus> [<Path>] [KEY=VALUE...]".
+void TorCircuitPool::OnCircuitEvent(const std::string& initial) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  const std::vector<std::string> args = base::SplitString(
+      initial, " ", base::KEEP_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+  if (args.size() < 2) {
+    return;
+  }
+  const std::string& circuit_id = args[0];
+  const std::string& status = args[1];
+
+  if (status == kCircuitBuilt) {
+    if (building_circuits_.erase(circuit_id)) {
+      warm_circuits_.push_back(circuit_id);
+    }
+  } else if (status == kCircuitFailed || status == kCircuitClosed) {
+    RemoveCircuit(circuit_id);
+    ScheduleRefill();
+  }
+}
+
+// STREAM events look like
+// "<StreamID> <StreamStatus> <CircuitID> <Target> [KEY=VALUE...]".
+void TorCircuitPool::OnStreamEvent(const std::string& initial) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  const std::vector<std::string> args = base::SplitString(
+      initial, " ", base::KEEP_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+  if (args.size() < 3) {
+    return;
+  }
+  const std::string& stream_id = args[0];
+  const std::string& status = args[1];
+
+  if (status == kStreamDetached) {
+    // Let Tor pick a replacement circuit under its own isolation rules.
+    AttachStream(stream_id, kNoCircuit);
+    return;
+  }
+  if (status != kStreamNew && status != kStreamNewResolve) {
+    return;
+  }
+
+  const std::string username = GetEventParam(initial, kSocksUsername);
+  if (username.empty() || warm_circuits_.empty()) {
+    AttachStream(stream_id, kNoCircuit);
+    return;
+  }
+
+  // Password changes on new identity requests, so it is part of the key.
+  const std::string isolation_key =
+      username + ":" + GetEventParam(initial, kSocksPassword);
+  if (base::Contains(circuit_by_key_, isolation_key)) {
+    // The key already owns a circuit, Tor reuses it while it isn't dirty.
+    AttachStream(stream_id, kNoCircuit);
+    return;
+  }
+
+  const std::string circuit_id = warm_circuits_.front();
+  warm_circuits_.pop_front();
+  circuit_by_key_[isolation_key] = circuit_id;
+  key_by_circuit_[circuit_id] = isolation_key;
+  control_->AttachStream(
+      stream_id, circuit_id,
+      base::BindOnce(&TorCircuitPool::OnStreamAttachedToWarmCircuit,
+                     weak_ptr_factory_.GetWeakPtr(), stream_id, circuit_id));
+  Refill();
+}
+
+void TorCircuitPool::AttachStream(const std::string& stream_id,
+                                  const std::string& circuit_id) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  control_->AttachStream(stream_id, circuit_id, base::DoNothing());
+}
+
+void TorCircuitPool::OnStreamAttachedToWarmCircuit(
+    const std::string& stream_id,
+    const std::string& circuit_id,
+    bool error) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (error) {
+    // The circuit might have been closed in the meantime, don't leave the
+    // stream hanging.
+    RemoveCircuit(circuit_id);
+    AttachStream(stream_id, kNoCircuit);
+    return;
+  }
+  // The circuit is isolated to the key now, let Tor attach the key's later
+  // streams to it.
+  control_->SetCircuitPurpose(circuit_id, kGeneralPurpose, base::DoNothing());
+}
+
+void TorCircuitPool::RemoveCircuit(const std::string& circuit_id) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  building_circuits_.erase(circuit_id);
+  auto warm_it = base::ranges::find(warm_circuits_, circuit_id);
+  if (warm_it != warm_circuits_.end()) {
+    warm_circuits_.erase(warm_it);
+  }
+  auto key_it = key_by_circuit_.find(circuit_id);
+  if (key_it != key_by_circuit_.end()) {
+    circuit_by_key_.erase(key_it->second);
+    key_by_circuit_.erase(key_it);
+  }
+}
+
+}  // namespace tor
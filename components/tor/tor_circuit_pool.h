@@ -0,0 +1,106 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_TOR_TOR_CIRCUIT_POOL_H_
+#define BRAVE_COMPONENTS_TOR_TOR_CIRCUIT_POOL_H_
+
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+
+#include "base/memory/raw_ptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/sequence_checker.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+#include "brave/components/tor/tor_control_event.h"
+
+namespace tor {
+
+class TorControl;
+
+// Keeps a small pool of pre-built circuits so the first request of a new
+// first-party isolation key doesn't wait for Tor to build a circuit.
+//
+// Pool circuits are built with the controller purpose, so Tor never attaches
+// streams to them on its own. While the pool is running Tor leaves new streams
+// unattached. The first stream of every new SOCKS username/password pair is
+// attached to a warm circuit, after which the circuit is switched to the
+// general purpose: its isolation is now bound to that key and Tor keeps using
+// it for the key's later streams under its usual rules. Every other stream is
+// attached with circuit id 0. A warm circuit is never handed to a second
+// isolation key.
+//
+// Owned by TorControl and lives on its IO sequence, where circuit and stream
+// events are parsed, so attaching a stream never waits on another thread.
+// Circuits lost to CIRC FAILED or CLOSED events are replaced after
+// kRefillDelay, which folds a burst of closed circuits into a single refill.
+class TorCircuitPool {
+ public:
+  static constexpr size_t kDefaultPoolSize = 3;
+  static constexpr base::TimeDelta kRefillDelay = base::Seconds(1);
+
+  TorCircuitPool(TorControl* control, size_t pool_size);
+  TorCircuitPool(const TorCircuitPool&) = delete;
+  TorCircuitPool& operator=(const TorCircuitPool&) = delete;
+  ~TorCircuitPool();
+
+  // Subscribes to circuit and stream events, takes over stream attachment and
+  // starts building circuits.
+  void Start();
+
+  void OnTorEvent(TorControlEvent event, const std::string& initial);
+
+  size_t warm_circuits_count() const { return warm_circuits_.size(); }
+  size_t building_circuits_count() const {
+    return building_circuits_.size() + pending_extends_;
+  }
+  // Returns the circuit bound to |isolation_key| or an empty string.
+  std::string GetCircuitForTesting(const std::string& isolation_key) const;
+
+ private:
+  // Looks up |key| among the KEY=VALUE pairs following the positional
+  // arguments of an event line.
+  static std::string GetEventParam(const std::string& initial,
+                                   const std::string& key);
+
+  void OnLeaveStreamsUnattached(bool error);
+  void Refill();
+  void ScheduleRefill();
+  void OnCircuitExtended(bool error, const std::string& circuit_id);
+  void OnCircuitEvent(const std::string& initial);
+  void OnStreamEvent(const std::string& initial);
+  void AttachStream(const std::string& stream_id,
+                    const std::string& circuit_id);
+  void OnStreamAttachedToWarmCircuit(const std::string& stream_id,
+                                     const std::string& circuit_id,
+                                     bool error);
+  void RemoveCircuit(const std::string& circuit_id);
+
+  raw_ptr<TorControl> control_;
+  const size_t pool_size_;
+  bool running_ = false;
+
+  // EXTENDCIRCUIT requests which haven't returned a circuit id yet.
+  size_t pending_extends_ = 0;
+  // Circuits waiting for CIRC BUILT.
+  std::set<std::string> building_circuits_;
+  // Built circuits not bound to any isolation key yet.
+  std::deque<std::string> warm_circuits_;
+  // Isolation key <-> circuit bindings, dropped when the circuit closes.
+  std::map<std::string, std::string> circuit_by_key_;
+  std::map<std::string, std::string> key_by_circuit_;
+
+  base::OneShotTimer refill_timer_;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+
+  base::WeakPtrFactory<TorCircuitPool> weak_ptr_factory_{this};
+};
+
+}  // namespace tor
+
+#endif  // BRAVE_COMPONENTS_TOR_TOR_CIRCUIT_POOL_H_
@@ -0,0 +1,192 @@
+/* Copyright (c) 2023 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/tor/tor_circuit_pool.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "base/run_loop.h"
+#include "base/strings/strcat.h"
+#include "base/test/test_future.h"
+#include "base/time/time.h"
+#include "brave/components/tor/fake_tor_control_server.h"
+#include "brave/components/tor/tor_control.h"
+#include "content/public/browser/browser_task_traits.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/test/browser_task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace tor {
+
+namespace {
+
+constexpr size_t kPoolSize = 2;
+
+class TestTorControlDelegate : public TorControl::Delegate {
+ public:
+  void OnTorControlReady() override { ready_.SetValue(); }
+  void OnTorControlClosed(bool was_running) override {}
+  void OnTorEvent(TorControlEvent event,
+                  const std::string& initial,
+                  const std::map<std::string, std::string>& extra) override {}
+
+  bool WaitForReady() { return ready_.Wait(); }
+
+ private:
+  base::test::TestFuture<void> ready_;
+};
+
+std::string NewStreamEvent(const std::string& stream_id,
+                           const std::string& username,
+                           const std::string& password) {
+  return base::StrCat({"STREAM ", stream_id,
+                       " NEW 0 example.com:443 SOURCE_ADDR=127.0.0.1:50000 "
+                       "PURPOSE=USER SOCKS_USERNAME=\"",
+                       username, "\" SOCKS_PASSWORD=\"", password, "\""});
+}
+
+}  // namespace
+
+class TorCircuitPoolTest : public testing::Test {
+ public:
+  void SetUp() override {
+    ASSERT_TRUE(server_.Start());
+    control_ = std::make_unique<TorControl>(
+        delegate_.AsWeakPtr(), content::GetIOThreadTaskRunner({}));
+    control_->Start({0x01, 0x02}, server_.port());
+    ASSERT_TRUE(delegate_.WaitForReady());
+  }
+
+  void TearDown() override {
+    control_->Stop();
+    content::GetIOThreadTaskRunner({})->DeleteSoon(FROM_HERE,
+                                                   std::move(control_));
+    base::RunLoop().RunUntilIdle();
+  }
+
+  void StartPool() {
+    control_->StartCircuitPool(kPoolSize);
+    server_.WaitForCommand("SETCONF __LeaveStreamsUnattached=1");
+  }
+
+  TorCircuitPool* pool() { return control_->circuit_pool_for_testing(); }
+
+  // Round trip through the control connection, after which everything the
+  // server sent before has reached the pool.
+  void Sync() {
+    base::test::TestFuture<bool, const std::string&> future;
+    control_->GetVersion(future.GetCallback());
+    ASSERT_TRUE(future.Wait());
+  }
+
+  // Waits until |extends| circuits have been requested in total and the pool
+  // is full again.
+  void WaitForFullPool(size_t extends) {
+    server_.WaitForCommands("EXTENDCIRCUIT", extends);
+    Sync();
+    EXPECT_EQ(kPoolSize, pool()->warm_circuits_count());
+    EXPECT_EQ(0u, pool()->building_circuits_count());
+  }
+
+ protected:
+  content::BrowserTaskEnvironment task_environment_{
+      content::BrowserTaskEnvironment::IO_MAINLOOP,
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+  FakeTorControlServer server_;
+  TestTorControlDelegate delegate_;
+  std::unique_ptr<TorControl> control_;
+};
+
+TEST_F(TorCircuitPoolTest, FillsPool) {
+  StartPool();
+  WaitForFullPool(kPoolSize);
+  EXPECT_EQ(kPoolSize, server_.CountCommands("EXTENDCIRCUIT"));
+  EXPECT_TRUE(server_.HasCommand("EXTENDCIRCUIT 0 purpose=controller"));
+}
+
+TEST_F(TorCircuitPoolTest, BindsNewIsolationKeysToWarmCircuits) {
+  StartPool();
+  WaitForFullPool(kPoolSize);
+
+  // The first stream of a new key takes a warm circuit, which is then handed
+  // over to Tor for the key's later streams.
+  server_.SendEvent(NewStreamEvent("10", "a.com", "password1"));
+  server_.WaitForCommand("ATTACHSTREAM 10 1");
+  server_.WaitForCommand("SETCIRCUITPURPOSE 1 purpose=general");
+  EXPECT_EQ("1", pool()->GetCircuitForTesting("a.com:password1"));
+
+  // The pool is refilled.
+  WaitForFullPool(kPoolSize + 1);
+  EXPECT_EQ(kPoolSize + 1, server_.CountCommands("EXTENDCIRCUIT"));
+
+  // Later streams of the same key are left to Tor.
+  server_.SendEvent(NewStreamEvent("11", "a.com", "password1"));
+  server_.WaitForCommand("ATTACHSTREAM 11 0");
+
+  // Another key never shares a circuit.
+  server_.SendEvent(NewStreamEvent("12", "b.com", "password2"));
+  server_.WaitForCommand("ATTACHSTREAM 12 2");
+  EXPECT_EQ("2", pool()->GetCircuitForTesting("b.com:password2"));
+
+  // New identity for the same site is a new key.
+  server_.SendEvent(NewStreamEvent("13", "a.com", "password3"));
+  server_.WaitForCommand("ATTACHSTREAM 13 3");
+  EXPECT_EQ("1", pool()->GetCircuitForTesting("a.com:password1"));
+  EXPECT_EQ("3", pool()->GetCircuitForTesting("a.com:password3"));
+
+  // Streams without SOCKS credentials are left to Tor.
+  server_.SendEvent("STREAM 14 NEW 0 example.com:443 PURPOSE=USER");
+  server_.WaitForCommand("ATTACHSTREAM 14 0");
+
+  // Detached streams are left to Tor as well.
+  server_.SendEvent("STREAM 10 DETACHED 1 example.com:443 REASON=TIMEOUT");
+  server_.WaitForCommand("ATTACHSTREAM 10 0");
+}
+
+TEST_F(TorCircuitPoolTest, ClosedCircuitsAreReplaced) {
+  StartPool();
+  WaitForFullPool(kPoolSize);
+
+  server_.SendEvent(NewStreamEvent("10", "a.com", "password1"));
+  server_.WaitForCommand("ATTACHSTREAM 10 1");
+  WaitForFullPool(kPoolSize + 1);
+
+  // Closing a bound circuit drops the binding, the key gets a warm circuit
+  // again.
+  server_.SendEvent("CIRC 1 CLOSED $0123456789ABCDEF~relay REASON=FINISHED");
+  Sync();
+  EXPECT_TRUE(pool()->GetCircuitForTesting("a.com:password1").empty());
+  server_.SendEvent(NewStreamEvent("11", "a.com", "password1"));
+  server_.WaitForCommand("ATTACHSTREAM 11 2");
+  WaitForFullPool(kPoolSize + 2);
+
+  // Failed warm circuits are rebuilt once the refill delay has passed.
+  const base::TimeTicks failed_at = base::TimeTicks::Now();
+  server_.SendEvent("CIRC 3 FAILED REASON=TIMEOUT");
+  server_.SendEvent("CIRC 4 FAILED REASON=TIMEOUT");
+  WaitForFullPool(kPoolSize + 4);
+  EXPECT_GE(base::TimeTicks::Now() - failed_at, TorCircuitPool::kRefillDelay);
+  EXPECT_EQ(kPoolSize + 4, server_.CountCommands("EXTENDCIRCUIT"));
+}
+
+TEST_F(TorCircuitPoolTest, EmptyPoolFallsBackToTor) {
+  server_.set_auto_build_circuits(false);
+  StartPool();
+  server_.WaitForCommands("EXTENDCIRCUIT", kPoolSize);
+
+  server_.SendEvent(NewStreamEvent("10", "a.com", "password1"));
+  server_.WaitForCommand("ATTACHSTREAM 10 0");
+  EXPECT_TRUE(pool()->GetCircuitForTesting("a.com:password1").empty());
+
+  // Once built, the circuit goes to the next new key.
+  server_.SendEvent("CIRC 1 BUILT $0123456789ABCDEF~relay PURPOSE=CONTROLLER");
+  server_.SendEvent(NewStreamEvent("11", "b.com", "password2"));
+  server_.WaitForCommand("ATTACHSTREAM 11 1");
+}
+
+}  // namespace tor
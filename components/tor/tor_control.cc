@@ -17,6 +17,7 @@
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/task/sequenced_task_runner.h"
+#include "brave/components/tor/tor_circuit_pool.h"
 #include "net/base/io_buffer.h"
 #include "net/base/net_errors.h"
 #include "net/socket/tcp_client_socket.h"
@@ -49,6 +50,13 @@ constexpr char kGetSOCKSListenersReply[] = "net/listeners/socks=";
 constexpr char kGetCircuitEstablishedCmd[] =
     "GETINFO status/circuit-established";
 constexpr char kGetCircuitEstablishedReply[] = "status/circuit-established=";
+constexpr char kExtendCircuitCmd[] = "EXTENDCIRCUIT 0 purpose=controller";
+constexpr char kExtendCircuitReply[] = "EXTENDED ";
+
+// CIRC and STREAM event fields which are not passed on to the delegate.
+constexpr char kSocksUsername[] = "SOCKS_USERNAME";
+constexpr char kSocksPassword[] = "SOCKS_PASSWORD";
+constexpr char kScrubbed[] = "[scrubbed]";
 
 static std::string escapify(const char* buf, int len) {
   std::ostringstream s;
@@ -160,6 +168,7 @@ void TorControl::StopOnTaskRunner() {
 
   running_ = false;
   async_events_.clear();
+  delegate_events_.clear();
   Error();
 }
 
@@ -229,9 +238,37 @@ void TorControl::Subscribe(TorControlEvent event,
                            base::OnceCallback<void(bool error)> callback) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(owner_sequence_checker_);
   io_task_runner_->PostTask(
-      FROM_HERE,
-      base::BindOnce(&TorControl::DoSubscribe, weak_ptr_factory_.GetWeakPtr(),
-                     event, std::move(callback)));
+      FROM_HERE, base::BindOnce(&TorControl::DoDelegateSubscribe,
+                                weak_ptr_factory_.GetWeakPtr(), event,
+                                std::move(callback)));
+}
+
+// DoDelegateSubscribe(event, callback)
+//
+//      Subscribe on behalf of the delegate.  Events the circuit pool
+//      subscribed to on its own are handled on the IO thread only and
+//      never reach the delegate.
+//
+void TorControl::DoDelegateSubscribe(
+    TorControlEvent event,
+    base::OnceCallback<void(bool error)> callback) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
+  delegate_events_[event]++;
+  DoSubscribe(event, base::BindOnce(&TorControl::DelegateSubscribed,
+                                    weak_ptr_factory_.GetWeakPtr(), event,
+                                    std::move(callback)));
+}
+
+void TorControl::DelegateSubscribed(
+    TorControlEvent event,
+    base::OnceCallback<void(bool error)> callback,
+    bool error) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
+  if (error && delegate_events_.count(event) &&
+      --delegate_events_[event] == 0) {
+    delegate_events_.erase(event);
+  }
+  std::move(callback).Run(error);
 }
 
 void TorControl::DoSubscribe(TorControlEvent event,
@@ -280,9 +317,19 @@ void TorControl::Unsubscribe(TorControlEvent event,
                              base::OnceCallback<void(bool error)> callback) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(owner_sequence_checker_);
   io_task_runner_->PostTask(
-      FROM_HERE,
-      base::BindOnce(&TorControl::DoUnsubscribe, weak_ptr_factory_.GetWeakPtr(),
-                     event, std::move(callback)));
+      FROM_HERE, base::BindOnce(&TorControl::DoDelegateUnsubscribe,
+                                weak_ptr_factory_.GetWeakPtr(), event,
+                                std::move(callback)));
+}
+
+void TorControl::DoDelegateUnsubscribe(
+    TorControlEvent event,
+    base::OnceCallback<void(bool error)> callback) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
+  DCHECK_GE(delegate_events_[event], 1u);
+  if (--delegate_events_[event] == 0)
+    delegate_events_.erase(event);
+  DoUnsubscribe(event, std::move(callback));
 }
 
 void TorControl::DoUnsubscribe(TorControlEvent event,
@@ -597,6 +644,118 @@ void TorControl::SetupBridges(const std::vector<std::string>& bridges,
   }
 }
 
+// SetLeaveStreamsUnattached(leave_unattached, callback)
+//
+//      Toggle __LeaveStreamsUnattached.  While it is set, Tor doesn't
+//      attach new streams on its own and the controller has to issue
+//      ATTACHSTREAM for every STREAM NEW event.
+//
+void TorControl::SetLeaveStreamsUnattached(
+    bool leave_unattached,
+    base::OnceCallback<void(bool error)> callback) {
+  if (owner_task_runner_->RunsTasksInCurrentSequence()) {
+    io_task_runner_->PostTask(
+        FROM_HERE, base::BindOnce(&TorControl::SetLeaveStreamsUnattached,
+                                  weak_ptr_factory_.GetWeakPtr(),
+                                  leave_unattached, std::move(callback)));
+    return;
+  }
+  DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
+  DoCmd(leave_unattached ? "SETCONF __LeaveStreamsUnattached=1"
+                         : "RESETCONF __LeaveStreamsUnattached",
+        base::DoNothing(),
+        base::BindOnce(&TorControl::OnLeaveStreamsUnattachedConfigured,
+                       weak_ptr_factory_.GetWeakPtr(), std::move(callback)));
+}
+
+// ExtendCircuit(callback)
+//
+//      Ask Tor to build a new controller purpose circuit and call
+//      callback(error, circuit_id) once Tor has accepted the request.
+//      The circuit is usable after the CIRC BUILT event.  Tor doesn't
+//      attach streams to controller purpose circuits by itself.
+//
+void TorControl::ExtendCircuit(
+    base::OnceCallback<void(bool error, const std::string& circuit_id)>
+        callback) {
+  if (owner_task_runner_->RunsTasksInCurrentSequence()) {
+    io_task_runner_->PostTask(
+        FROM_HERE, base::BindOnce(&TorControl::ExtendCircuit,
+                                  weak_ptr_factory_.GetWeakPtr(),
+                                  std::move(callback)));
+    return;
+  }
+  DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
+  DoCmd(kExtendCircuitCmd, base::DoNothing(),
+        base::BindOnce(&TorControl::OnCircuitExtended,
+                       weak_ptr_factory_.GetWeakPtr(), std::move(callback)));
+}
+
+// AttachStream(stream_id, circuit_id, callback)
+//
+//      Attach an unattached stream to the circuit.  Circuit id "0"
+//      lets Tor pick a circuit according to its own isolation rules.
+//
+void TorControl::AttachStream(const std::string& stream_id,
+                              const std::string& circuit_id,
+                              base::OnceCallback<void(bool error)> callback) {
+  if (owner_task_runner_->RunsTasksInCurrentSequence()) {
+    io_task_runner_->PostTask(
+        FROM_HERE, base::BindOnce(&TorControl::AttachStream,
+                                  weak_ptr_factory_.GetWeakPtr(), stream_id,
+                                  circuit_id, std::move(callback)));
+    return;
+  }
+  DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
+  DoCmd(base::StrCat({"ATTACHSTREAM ", stream_id, " ", circuit_id}),
+        base::DoNothing(),
+        base::BindOnce(&TorControl::OnStreamAttached,
+                       weak_ptr_factory_.GetWeakPtr(), std::move(callback)));
+}
+
+// SetCircuitPurpose(circuit_id, purpose, callback)
+//
+//      Change the purpose of an existing circuit.
+//
+void TorControl::SetCircuitPurpose(
+    const std::string& circuit_id,
+    const std::string& purpose,
+    base::OnceCallback<void(bool error)> callback) {
+  if (owner_task_runner_->RunsTasksInCurrentSequence()) {
+    io_task_runner_->PostTask(
+        FROM_HERE, base::BindOnce(&TorControl::SetCircuitPurpose,
+                                  weak_ptr_factory_.GetWeakPtr(), circuit_id,
+                                  purpose, std::move(callback)));
+    return;
+  }
+  DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
+  DoCmd(base::StrCat({"SETCIRCUITPURPOSE ", circuit_id, " purpose=", purpose}),
+        base::DoNothing(),
+        base::BindOnce(&TorControl::OnCircuitPurposeSet,
+                       weak_ptr_factory_.GetWeakPtr(), std::move(callback)));
+}
+
+// StartCircuitPool(pool_size)
+//
+//      Create the circuit pool on the IO thread.  Circuit and stream
+//      events are handed to it from ReadLine directly, so it decides
+//      where to attach a stream without a round trip to the owner.
+//
+void TorControl::StartCircuitPool(size_t pool_size) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(owner_sequence_checker_);
+  io_task_runner_->PostTask(
+      FROM_HERE, base::BindOnce(&TorControl::DoStartCircuitPool,
+                                weak_ptr_factory_.GetWeakPtr(), pool_size));
+}
+
+void TorControl::DoStartCircuitPool(size_t pool_size) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
+  if (!socket_ || circuit_pool_)
+    return;
+  circuit_pool_ = std::make_unique<TorCircuitPool>(this, pool_size);
+  circuit_pool_->Start();
+}
+
 void TorControl::OnPluggableTransportsConfigured(
     base::OnceCallback<void(bool error)> callback,
     bool error,
@@ -617,6 +776,57 @@ void TorControl::OnBrigdesConfigured(
   std::move(callback).Run(error || status != "250" || reply != "OK");
 }
 
+void TorControl::OnLeaveStreamsUnattachedConfigured(
+    base::OnceCallback<void(bool error)> callback,
+    bool error,
+    const std::string& status,
+    const std::string& reply) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
+  VLOG(1) << __func__ << " " << reply;
+  std::move(callback).Run(error || status != "250" || reply != "OK");
+}
+
+void TorControl::OnCircuitExtended(
+    base::OnceCallback<void(bool error, const std::string& circuit_id)>
+        callback,
+    bool error,
+    const std::string& status,
+    const std::string& reply) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
+  if (error || status != "250" ||
+      !base::StartsWith(reply, kExtendCircuitReply,
+                        base::CompareCase::SENSITIVE)) {
+    VLOG(1) << "tor: unexpected " << kExtendCircuitCmd << " reply: " << reply;
+    std::move(callback).Run(true, "");
+    return;
+  }
+  const std::string circuit_id = reply.substr(strlen(kExtendCircuitReply));
+  if (circuit_id.empty()) {
+    std::move(callback).Run(true, "");
+    return;
+  }
+  std::move(callback).Run(false, circuit_id);
+}
+
+void TorControl::OnStreamAttached(base::OnceCallback<void(bool error)> callback,
+                                  bool error,
+                                  const std::string& status,
+                                  const std::string& reply) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
+  VLOG(1) << __func__ << " " << reply;
+  std::move(callback).Run(error || status != "250" || reply != "OK");
+}
+
+void TorControl::OnCircuitPurposeSet(
+    base::OnceCallback<void(bool error)> callback,
+    bool error,
+    const std::string& status,
+    const std::string& reply) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
+  VLOG(1) << __func__ << " " << reply;
+  std::move(callback).Run(error || status != "250" || reply != "OK");
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Writing state machine
 
@@ -895,8 +1105,8 @@ bool TorControl::ReadLine(const std::string& line) {
 
   // Determine whether it is an asynchronous reply, status 6yz.
   if (status[0] == '6') {
-    // Notify delegate of the raw reply.
-    NotifyTorRawAsync(status, reply);
+    // Notify delegate of the raw reply, without stream credentials.
+    NotifyTorRawAsync(status, ScrubAsyncLine(reply));
 
     // Is this a new async reply?
     if (!async_) {
@@ -1056,6 +1266,9 @@ void TorControl::Error() {
 
   VLOG(1) << "tor: closing control on " << (running_ ? "request" : "error");
 
+  // The pool's circuits and streams are gone with the connection.
+  circuit_pool_.reset();
+
   NotifyTorControlClosed();
 
   // Invoke all callbacks with errors and clear read state.
@@ -1097,9 +1310,18 @@ void TorControl::NotifyTorEvent(
     const std::string& initial,
     const std::map<std::string, std::string>& extra) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
+  if (circuit_pool_)
+    circuit_pool_->OnTorEvent(event, initial);
+  // The circuit pool may be the only subscriber.
+  if (!delegate_events_.count(event))
+    return;
+  std::map<std::string, std::string> scrubbed_extra = extra;
+  scrubbed_extra.erase(kSocksUsername);
+  scrubbed_extra.erase(kSocksPassword);
   owner_task_runner_->PostTask(
-      FROM_HERE,
-      base::BindOnce(&Delegate::OnTorEvent, delegate_, event, initial, extra));
+      FROM_HERE, base::BindOnce(&Delegate::OnTorEvent, delegate_, event,
+                                ScrubEventLine(event, initial),
+                                std::move(scrubbed_extra)));
 }
 
 void TorControl::NotifyTorRawCmd(const std::string& cmd) {
@@ -1132,6 +1354,71 @@ void TorControl::NotifyTorRawEnd(const std::string& status,
       base::BindOnce(&Delegate::OnTorRawEnd, delegate_, status, line));
 }
 
+// ScrubEventLine(event, initial)
+//
+//      Return the initial line of a CIRC or STREAM event with the SOCKS
+//      credentials removed and the stream target replaced, so that
+//      neither the isolation keys nor the visited hosts end up in logs
+//      or on tor-internals.  Other events are returned unchanged.
+//
+// static
+std::string TorControl::ScrubEventLine(TorControlEvent event,
+                                       const std::string& initial) {
+  if (event != TorControlEvent::CIRC && event != TorControlEvent::STREAM)
+    return initial;
+
+  // STREAM events start with `StreamID StreamStatus CircuitID Target'.
+  constexpr size_t kStreamTargetIndex = 3;
+  std::vector<std::string> fields;
+  size_t pos = 0;
+  while (pos < initial.size()) {
+    size_t end = initial.find(' ', pos);
+    if (end == std::string::npos)
+      end = initial.size();
+    size_t next = end + 1;
+    std::string key;
+    const size_t eq = initial.find('=', pos);
+    if (eq < end)
+      key = initial.substr(pos, eq - pos);
+    if (eq < end && eq + 1 < initial.size() && initial[eq + 1] == '"') {
+      // Quoted values may contain spaces.
+      std::string value;
+      size_t consumed;
+      if (ParseKV(initial.substr(pos), &key, &value, &consumed)) {
+        next = pos + consumed;
+        end = initial.find_last_not_of(' ', next - 1) + 1;
+      }
+    }
+    if (key == kSocksUsername || key == kSocksPassword) {
+      // Drop the isolation credentials.
+    } else if (event == TorControlEvent::STREAM && key.empty() &&
+               fields.size() == kStreamTargetIndex) {
+      fields.push_back(kScrubbed);
+    } else {
+      fields.push_back(initial.substr(pos, end - pos));
+    }
+    pos = next;
+  }
+  return base::JoinString(fields, " ");
+}
+
+// ScrubAsyncLine(reply)
+//
+//      Scrub the raw text of an asynchronous reply line, which starts
+//      with the event keyword, the same way as ScrubEventLine.
+//
+// static
+std::string TorControl::ScrubAsyncLine(const std::string& reply) {
+  const size_t sp = reply.find(' ');
+  if (sp == std::string::npos)
+    return reply;
+  const std::string event_name = reply.substr(0, sp);
+  const auto& found = kTorControlEventByName.find(event_name);
+  if (found == kTorControlEventByName.end())
+    return reply;
+  return event_name + " " + ScrubEventLine(found->second, reply.substr(sp + 1));
+}
+
 // ParseKV(string, key, value)
 //
 //      Parse KEY=VALUE notation from string into key and value,
@@ -32,6 +32,8 @@ class TCPClientSocket;
 
 namespace tor {
 
+class TorCircuitPool;
+
 // This class is resposible for talking to Tor executable to get status, send
 // command or subsribe to events through the control channel.
 // Tor Control Channel spec:
@@ -100,11 +102,33 @@ class TorControl {
   void SetupBridges(const std::vector<std::string>& bridges,
                     base::OnceCallback<void(bool error)> callback);
 
+  // Circuit and stream management, used for circuit pre-warming.
+  void SetLeaveStreamsUnattached(bool leave_unattached,
+                                 base::OnceCallback<void(bool error)> callback);
+  void ExtendCircuit(
+      base::OnceCallback<void(bool error, const std::string& circuit_id)>
+          callback);
+  void AttachStream(const std::string& stream_id,
+                    const std::string& circuit_id,
+                    base::OnceCallback<void(bool error)> callback);
+  void SetCircuitPurpose(const std::string& circuit_id,
+                         const std::string& purpose,
+                         base::OnceCallback<void(bool error)> callback);
+
+  // Starts pre-warming |pool_size| circuits. The pool runs on the IO thread,
+  // where it sees circuit and stream events as soon as they are parsed, and
+  // goes away when the connection is closed.
+  void StartCircuitPool(size_t pool_size);
+
+  TorCircuitPool* circuit_pool_for_testing() { return circuit_pool_.get(); }
+
  protected:
+  friend class TorCircuitPool;
   friend class TorControlTest;
   FRIEND_TEST_ALL_PREFIXES(TorControlTest, ParseQuoted);
   FRIEND_TEST_ALL_PREFIXES(TorControlTest, ParseKV);
   FRIEND_TEST_ALL_PREFIXES(TorControlTest, ReadLine);
+  FRIEND_TEST_ALL_PREFIXES(TorControlTest, ScrubEventLine);
   FRIEND_TEST_ALL_PREFIXES(TorControlTest, GetCircuitEstablishedDone);
 
   static bool ParseKV(const std::string& string,
@@ -117,6 +141,9 @@ class TorControl {
   static bool ParseQuoted(const std::string& string,
                           std::string* value,
                           size_t* end);
+  static std::string ScrubEventLine(TorControlEvent event,
+                                    const std::string& initial);
+  static std::string ScrubAsyncLine(const std::string& reply);
 
  private:
   void OpenControl(int port, std::vector<uint8_t> cookie);
@@ -157,6 +184,13 @@ class TorControl {
       const std::string& status,
       const std::string& reply);
 
+  void DoDelegateSubscribe(TorControlEvent event,
+                           base::OnceCallback<void(bool error)> callback);
+  void DelegateSubscribed(TorControlEvent event,
+                          base::OnceCallback<void(bool error)> callback,
+                          bool error);
+  void DoDelegateUnsubscribe(TorControlEvent event,
+                             base::OnceCallback<void(bool error)> callback);
   void DoSubscribe(TorControlEvent event,
                    base::OnceCallback<void(bool error)> callback);
   void Subscribed(TorControlEvent event,
@@ -173,6 +207,8 @@ class TorControl {
                     const std::string& reply);
   std::string SetEventsCmd();
 
+  void DoStartCircuitPool(size_t pool_size);
+
   void OnPluggableTransportsConfigured(
       base::OnceCallback<void(bool error)> callback,
       bool error,
@@ -182,6 +218,25 @@ class TorControl {
                            bool error,
                            const std::string& status,
                            const std::string& reply);
+  void OnLeaveStreamsUnattachedConfigured(
+      base::OnceCallback<void(bool error)> callback,
+      bool error,
+      const std::string& status,
+      const std::string& reply);
+  void OnCircuitExtended(
+      base::OnceCallback<void(bool error, const std::string& circuit_id)>
+          callback,
+      bool error,
+      const std::string& status,
+      const std::string& reply);
+  void OnStreamAttached(base::OnceCallback<void(bool error)> callback,
+                        bool error,
+                        const std::string& status,
+                        const std::string& reply);
+  void OnCircuitPurposeSet(base::OnceCallback<void(bool error)> callback,
+                           bool error,
+                           const std::string& status,
+                           const std::string& reply);
 
   // Notify delegate on UI thread
   void NotifyTorControlReady();
@@ -234,6 +289,8 @@ class TorControl {
 
   // Asynchronous command response callback state machine.
   std::map<TorControlEvent, size_t> async_events_;
+  // Subset of |async_events_| the delegate subscribed to.
+  std::map<TorControlEvent, size_t> delegate_events_;
   struct Async {
     Async();
     ~Async();
@@ -244,6 +301,9 @@ class TorControl {
   };
   std::unique_ptr<Async> async_;
 
+  // Only set while circuit pre-warming is running on this connection.
+  std::unique_ptr<TorCircuitPool> circuit_pool_;
+
   base::WeakPtr<TorControl::Delegate> delegate_;
 
   base::WeakPtrFactory<TorControl> weak_ptr_factory_{this};
@@ -148,6 +148,12 @@ TEST(TorControlTest, ReadLine) {
   EXPECT_CALL(delegate, OnTorRawAsync("650", "CIRC 1000 EXTENDED")).Times(1);
   EXPECT_CALL(delegate, OnTorRawAsync("650", "EXTRAMAGIC=99")).Times(1);
   EXPECT_CALL(delegate, OnTorRawAsync("650", "ANONYMITY=high")).Times(1);
+  EXPECT_CALL(delegate,
+              OnTorRawAsync("650", "STREAM 12 NEW 0 [scrubbed] PURPOSE=USER"))
+      .Times(1);
+  EXPECT_CALL(delegate, OnTorEvent(TorControlEvent::STREAM, testing::_,
+                                   testing::_))
+      .Times(0);
   EXPECT_CALL(delegate,
               OnTorEvent(TorControlEvent::NETWORK_LIVENESS, "DOWN", testing::_))
       .Times(1);
@@ -164,6 +170,7 @@ TEST(TorControlTest, ReadLine) {
             EXPECT_TRUE(control->ReadLine("650 NETWORK_LIVENESS UP"));
             // Emulate subscribe
             control->async_events_[TorControlEvent::NETWORK_LIVENESS] = 1;
+            control->delegate_events_[TorControlEvent::NETWORK_LIVENESS] = 1;
             EXPECT_TRUE(control->ReadLine("650 NETWORK_LIVENESS DOWN"));
             // Async skip
             EXPECT_TRUE(control->ReadLine("650-FAKEVENT BEGIN"));
@@ -174,18 +181,44 @@ TEST(TorControlTest, ReadLine) {
             EXPECT_FALSE(control->async_);
             // Normal multi async
             control->async_events_[TorControlEvent::CIRC] = 1;
+            control->delegate_events_[TorControlEvent::CIRC] = 1;
             EXPECT_TRUE(control->ReadLine("650-CIRC 1000 EXTENDED"));
             EXPECT_TRUE(control->async_);
             EXPECT_FALSE(control->async_->skip);
             EXPECT_TRUE(control->ReadLine("650-EXTRAMAGIC=99"));
             EXPECT_TRUE(control->ReadLine("650 ANONYMITY=high"));
             EXPECT_FALSE(control->async_);
+            // Events only the circuit pool subscribed to are not forwarded.
+            control->async_events_[TorControlEvent::STREAM] = 1;
+            EXPECT_TRUE(control->ReadLine(
+                "650 STREAM 12 NEW 0 example.com:443 PURPOSE=USER "
+                "SOCKS_USERNAME=\"key\" SOCKS_PASSWORD=\"secret\""));
           },
           std::move(control)));
 
   base::RunLoop().RunUntilIdle();
 }
 
+TEST(TorControlTest, ScrubEventLine) {
+  EXPECT_EQ("12 NEW 0 [scrubbed] SOURCE_ADDR=127.0.0.1:50000 PURPOSE=USER",
+            TorControl::ScrubEventLine(
+                TorControlEvent::STREAM,
+                "12 NEW 0 example.com:443 SOURCE_ADDR=127.0.0.1:50000 "
+                "PURPOSE=USER SOCKS_USERNAME=\"a b\" SOCKS_PASSWORD=\"x=y\""));
+  EXPECT_EQ("12 SUCCEEDED 5 [scrubbed]",
+            TorControl::ScrubEventLine(TorControlEvent::STREAM,
+                                       "12 SUCCEEDED 5 example.com:443"));
+  EXPECT_EQ("5 BUILT $A~a,$B~b PURPOSE=GENERAL TIME_CREATED=2023",
+            TorControl::ScrubEventLine(
+                TorControlEvent::CIRC,
+                "5 BUILT $A~a,$B~b PURPOSE=GENERAL SOCKS_USERNAME=key "
+                "SOCKS_PASSWORD=secret TIME_CREATED=2023"));
+  EXPECT_EQ("BOOTSTRAP PROGRESS=100 SOCKS_USERNAME=x",
+            TorControl::ScrubEventLine(
+                TorControlEvent::STATUS_CLIENT,
+                "BOOTSTRAP PROGRESS=100 SOCKS_USERNAME=x"));
+}
+
 TEST(TorControlTest, GetCircuitEstablishedDone) {
   content::BrowserTaskEnvironment task_environment;
   scoped_refptr<base::SequencedTaskRunner> io_task_runner =
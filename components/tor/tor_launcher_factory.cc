@@ -13,6 +13,8 @@
 #include "base/no_destructor.h"
 #include "base/task/bind_post_task.h"
 #include "base/task/sequenced_task_runner.h"
+#include "brave/components/tor/features.h"
+#include "brave/components/tor/tor_circuit_pool.h"
 #include "brave/components/tor/tor_file_watcher.h"
 #include "brave/components/tor/tor_launcher_observer.h"
 #include "brave/components/tor/tor_utils.h"
@@ -267,6 +269,11 @@ void TorLauncherFactory::OnTorControlReady() {
   control_->Subscribe(tor::TorControlEvent::WARN, base::DoNothing());
   control_->Subscribe(tor::TorControlEvent::ERR, base::DoNothing());
 
+  if (base::FeatureList::IsEnabled(
+          tor::features::kBraveTorCircuitPrewarming)) {
+    control_->StartCircuitPool(tor::TorCircuitPool::kDefaultPoolSize);
+  }
+
   for (auto& observer : observers_) {
     observer.OnTorControlReady();
   }
@@ -5,6 +5,7 @@
 
 #include "net/http/transport_security_state.h"
 
+#include "base/strings/string_number_conversions.h"
 #include "base/test/scoped_feature_list.h"
 #include "net/base/features.h"
 #include "net/base/isolation_info.h"
@@ -284,4 +285,86 @@ TEST_F(TransportSecurityState_EnableHSTSPartitionTest,
   ExpectHasHSTS(&state, CreateNetworkAnonymizationKey(b_com_origin), "b.com");
 }
 
+TEST_F(TransportSecurityState_EnableHSTSPartitionTest,
+       PartitionedOpaqueTopFrameSite) {
+  TransportSecurityState state;
+
+  auto a_com_origin = url::Origin::Create(GURL("https://a.com"));
+  // Opaque origins are partitioned by their precursor eTLD+1.
+  auto opaque_a_com_origin =
+      url::Origin::Create(GURL("https://sub.a.com")).DeriveNewOpaqueOrigin();
+  auto opaque_origin = url::Origin();
+
+  EXPECT_TRUE(state.AddHSTSHeader(
+      CreateIsolationInfo(a_com_origin,
+                          SiteForCookies::FromOrigin(a_com_origin)),
+      "b.com", kHSTSHeaderValue));
+
+  // Repeat checks to make sure memoized hashes return the same results.
+  for (int i = 0; i < 2; ++i) {
+    ExpectHasHSTSOnlyWithNIK(
+        &state, CreateNetworkAnonymizationKey(opaque_a_com_origin), "b.com");
+    ExpectNoHSTS(&state, CreateNetworkAnonymizationKey(opaque_origin), "b.com");
+  }
+
+  // Opaque origin without a precursor is an invalid partition.
+  EXPECT_FALSE(state.AddHSTSHeader(
+      CreateIsolationInfo(opaque_origin, SiteForCookies()), "c.com",
+      kHSTSHeaderValue));
+  ExpectNoHSTS(&state, CreateNetworkAnonymizationKey(opaque_origin), "c.com");
+}
+
+TEST_F(TransportSecurityState_EnableHSTSPartitionTest,
+       PartitionedIPAddressTopFrameSite) {
+  TransportSecurityState state;
+
+  auto ip_origin = url::Origin::Create(GURL("https://127.0.0.1"));
+  auto other_ip_origin = url::Origin::Create(GURL("https://127.0.0.2"));
+
+  EXPECT_TRUE(state.AddHSTSHeader(
+      CreateIsolationInfo(ip_origin, SiteForCookies::FromOrigin(ip_origin)),
+      "a.com", kHSTSHeaderValue));
+
+  for (int i = 0; i < 2; ++i) {
+    ExpectHasHSTSOnlyWithNIK(&state, CreateNetworkAnonymizationKey(ip_origin),
+                             "a.com");
+    ExpectNoHSTS(&state, CreateNetworkAnonymizationKey(other_ip_origin),
+                 "a.com");
+  }
+}
+
+TEST_F(TransportSecurityState_EnableHSTSPartitionTest,
+       PartitionHashCacheIsBoundedAndCleared) {
+  TransportSecurityState state;
+
+  auto a_com_origin = url::Origin::Create(GURL("https://a.com"));
+  EXPECT_TRUE(state.AddHSTSHeader(
+      CreateIsolationInfo(a_com_origin,
+                          SiteForCookies::FromOrigin(a_com_origin)),
+      "a.com", kHSTSHeaderValue));
+  EXPECT_EQ(1u, state.partition_hash_cache_size_for_testing());
+
+  // The same top frame site should reuse the cached hash.
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_TRUE(state.ShouldUpgradeToSSL(
+        CreateNetworkAnonymizationKey(a_com_origin), "a.com"));
+  }
+  EXPECT_EQ(1u, state.partition_hash_cache_size_for_testing());
+
+  // Many distinct top frame sites shouldn't grow the cache unbounded.
+  for (int i = 0; i < 1000; ++i) {
+    auto origin = url::Origin::Create(
+        GURL("https://site" + base::NumberToString(i) + ".com"));
+    EXPECT_FALSE(state.ShouldUpgradeToSSL(
+        CreateNetworkAnonymizationKey(origin), "a.com"));
+  }
+  // Bounded by the LRU capacity, kPartitionHashCacheSize.
+  EXPECT_LE(state.partition_hash_cache_size_for_testing(), 32u);
+  ExpectHasHSTS(&state, CreateNetworkAnonymizationKey(a_com_origin), "a.com");
+
+  state.ClearDynamicData();
+  EXPECT_EQ(0u, state.partition_hash_cache_size_for_testing());
+  ExpectNoHSTS(&state, CreateNetworkAnonymizationKey(a_com_origin), "a.com");
+}
+
 }  // namespace net
@@ -12,6 +12,7 @@
 #include <utility>
 #include <vector>
 
+#include "base/functional/bind.h"
 #include "base/no_destructor.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
@@ -26,28 +27,6 @@
 
 namespace net {
 
-// Used to cache <username, password> of proxies
-class TorProxyMap {
- public:
-  TorProxyMap();
-  TorProxyMap(const TorProxyMap&) = delete;
-  TorProxyMap& operator=(const TorProxyMap&) = delete;
-  ~TorProxyMap();
-  std::string Get(const std::string& key);
-  void Erase(const std::string& key);
-  void MaybeExpire(const std::string& key, const base::Time& timestamp);
-  size_t size() const;
-
- private:
-  // Generate a new base 64-encoded 128 bit random tag
-  static std::string GenerateNewPassword();
-  // Clear expired entries in the queue from the map.
-  void ClearExpiredEntries();
-  std::map<std::string, std::pair<std::string, base::Time>> map_;
-  std::priority_queue<std::pair<base::Time, std::string>> queue_;
-  base::OneShotTimer timer_;
-};
-
 namespace {
 
 constexpr NetworkTrafficAnnotationTag kTorProxyTrafficAnnotation =
@@ -70,30 +49,38 @@ constexpr NetworkTrafficAnnotationTag kTorProxyTrafficAnnotation =
         policy_exception_justification: "Not implemented."
       })");
 
-static base::NoDestructor<std::map<
-    ProxyResolutionService*, TorProxyMap>> tor_proxy_map_;
+// ProxyConfigServiceTor lives in the browser process while proxy resolution
+// happens in the network service, so credentials have to be keyed by the
+// resolution service rather than owned by the config service.
+using TorProxyMaps =
+    std::map<ProxyResolutionService*, std::unique_ptr<TorProxyMap>>;
 
-TorProxyMap* GetTorProxyMap(
-    ProxyResolutionService* service) {
-  return &(tor_proxy_map_.get()->operator[](service));
+TorProxyMaps& GetTorProxyMaps() {
+  static base::NoDestructor<TorProxyMaps> tor_proxy_maps;
+  return *tor_proxy_maps;
 }
 
-bool IsTorProxyConfig(const ProxyConfigWithAnnotation& config) {
-  auto tag = config.traffic_annotation();
-  // iterate through tor_proxy_map_ and remove any entries with
-  // empty TorProxyMap (all entries have expired)
-  // we do this here because the other methods are only called when
-  // IsTorProxy is true so the last entry will never be deleted
-  for (auto it = tor_proxy_map_.get()->cbegin();
-       it != tor_proxy_map_.get()->cend(); ) {
-    if (it->second.size() == 0) {
-      tor_proxy_map_->erase(it++);
-    } else {
-      ++it;
-    }
+void RemoveTorProxyMapIfEmpty(ProxyResolutionService* service) {
+  auto& tor_proxy_maps = GetTorProxyMaps();
+  auto it = tor_proxy_maps.find(service);
+  if (it != tor_proxy_maps.end() && it->second->size() == 0) {
+    tor_proxy_maps.erase(it);
+  }
+}
+
+TorProxyMap* GetTorProxyMap(ProxyResolutionService* service) {
+  auto& tor_proxy_map = GetTorProxyMaps()[service];
+  if (!tor_proxy_map) {
+    // Drop the map once all of its entries have expired, so maps of destroyed
+    // resolution services don't outlive their last circuit.
+    tor_proxy_map = std::make_unique<TorProxyMap>(
+        base::BindRepeating(&RemoveTorProxyMapIfEmpty, service));
   }
+  return tor_proxy_map.get();
+}
 
-  return tag.unique_id_hash_code ==
+bool IsTorProxyConfig(const ProxyConfigWithAnnotation& config) {
+  return config.traffic_annotation().unique_id_hash_code ==
          kTorProxyTrafficAnnotation.unique_id_hash_code;
 }
 
@@ -241,9 +228,11 @@ void ProxyConfigServiceTor::SetBypassTorProxyConfigForTesting(bool bypass) {
 }
 
 TorProxyMap::TorProxyMap() = default;
-TorProxyMap::~TorProxyMap() {
-  timer_.Stop();
-}
+
+TorProxyMap::TorProxyMap(base::RepeatingClosure on_empty)
+    : on_empty_(std::move(on_empty)) {}
+
+TorProxyMap::~TorProxyMap() = default;
 
 // static
 std::string TorProxyMap::GenerateNewPassword() {
@@ -252,29 +241,28 @@ std::string TorProxyMap::GenerateNewPassword() {
   return base::HexEncode(password.data(), password.size());
 }
 
-std::string TorProxyMap::Get(
-    const std::string& username) {
+std::string TorProxyMap::Get(const std::string& username) {
   // Clear any expired entries, in case this one has expired.
   ClearExpiredEntries();
 
   // Check for an entry for this username.
   auto found = map_.find(username);
-  if (found != map_.end())
+  if (found != map_.end()) {
     return found->second.first;
+  }
 
   // No entry yet.  Check our watch and create one.
   const base::Time now = base::Time::Now();
   const std::string password = GenerateNewPassword();
   map_.emplace(username, std::make_pair(password, now));
-  queue_.emplace(now, username);
+  expiry_queue_.emplace(now, username);
 
-  // Reschedule the timer for ten minutes from now so that this entry
-  // won't last more than about ten minutes even if the user stops
-  // using Tor for a while.
-  // TODO(bridiver) - the timer should be in the ProxyConfigServiceTor class
-  timer_.Stop();
-  timer_.Start(FROM_HERE, kTenMins, this,
-               &TorProxyMap::ClearExpiredEntries);
+  // New entries always expire last, so the timer only has to be started when
+  // nothing is scheduled yet. This keeps entries from lasting more than about
+  // ten minutes even if the user stops using Tor for a while.
+  if (!timer_.IsRunning()) {
+    ScheduleNextExpiry();
+  }
 
   return password;
 }
@@ -283,50 +271,62 @@ size_t TorProxyMap::size() const {
   return map_.size();
 }
 
+size_t TorProxyMap::expiry_queue_size_for_testing() const {
+  return expiry_queue_.size();
+}
+
 void TorProxyMap::Erase(const std::string& username) {
-  // Just erase it from the map.  There will remain an entry in the
-  // queue, but it is harmless.  If anyone creates a new entry in the
-  // map, the old entry in the queue will cease to affect it because
-  // the timestamps won't match, and they will simultaneously create a
-  // new entry in the queue.
-  map_.erase(username);
+  auto found = map_.find(username);
+  if (found == map_.end()) {
+    return;
+  }
+  // Keep the queue in sync with the map so re-keyed circuits don't leave
+  // stale entries behind. If this was the next entry to expire, the timer
+  // fires early and reschedules itself.
+  expiry_queue_.erase(std::make_pair(found->second.second, username));
+  map_.erase(found);
 }
 
-void TorProxyMap::MaybeExpire(
-    const std::string& username,
-    const base::Time& timestamp) {
+void TorProxyMap::MaybeExpire(const std::string& username,
+                              const base::Time& timestamp) {
   auto found = map_.find(username);
-  if (found != map_.end() &&
-      timestamp >= found->second.second) {
+  if (found != map_.end() && timestamp >= found->second.second) {
     Erase(username);
   }
 }
 
 void TorProxyMap::ClearExpiredEntries() {
   const base::Time cutoff = base::Time::Now() - kTenMins;
-  for (; !queue_.empty(); queue_.pop()) {
-    // Check the timestamp.  If it's not older than the cutoff, stop.
-    const std::pair<base::Time, std::string>* entry = &queue_.top();
-    const base::Time timestamp = entry->first;
-    if (!(timestamp < cutoff))
+  while (!expiry_queue_.empty()) {
+    // The queue is ordered by timestamp, stop at the first live entry.
+    auto oldest = expiry_queue_.begin();
+    if (oldest->first > cutoff) {
       break;
-
-    // Remove the corresponding entry in the map if there is one and
-    // if its timestamp is not newer.
-    const std::string& username = entry->second;
-    auto found = map_.find(username);
-    if (found != map_.end()) {
-      // If the timestamp on the map entry is the same as the
-      // timestamp on the queue entry, then delete the map entry.
-      // Otherwise, we assume the map entry was created by an explicit
-      // request for a new identity, which will have its own entry in
-      // the queue in order to last the full ten minutes.
-      const base::Time map_timestamp = found->second.second;
-      if (map_timestamp == timestamp) {
-        map_.erase(username);
-      }
     }
+    map_.erase(oldest->second);
+    expiry_queue_.erase(oldest);
+  }
+}
+
+void TorProxyMap::ScheduleNextExpiry() {
+  if (expiry_queue_.empty()) {
+    timer_.Stop();
+    return;
+  }
+  const base::TimeDelta delay =
+      expiry_queue_.begin()->first + kTenMins - base::Time::Now();
+  timer_.Start(FROM_HERE, std::max(delay, base::TimeDelta()), this,
+               &TorProxyMap::OnExpiryTimer);
+}
+
+void TorProxyMap::OnExpiryTimer() {
+  ClearExpiredEntries();
+  if (map_.empty() && on_empty_) {
+    // |this| may be deleted by the callback.
+    on_empty_.Run();
+    return;
   }
+  ScheduleNextExpiry();
 }
 
 }  // namespace net
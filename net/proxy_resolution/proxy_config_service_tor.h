@@ -7,12 +7,14 @@
 #define BRAVE_NET_PROXY_RESOLUTION_PROXY_CONFIG_SERVICE_TOR_H_
 
 #include <map>
-#include <queue>
+#include <set>
 #include <string>
 #include <utility>
 
 #include "base/compiler_specific.h"
+#include "base/functional/callback.h"
 #include "base/observer_list.h"
+#include "base/time/time.h"
 #include "base/timer/timer.h"
 #include "net/base/net_export.h"
 #include "net/base/proxy_server.h"
@@ -21,16 +23,48 @@
 
 class GURL;
 
-namespace base {
-class Time;
-}
-
 namespace net {
 
 class ProxyConfigWithAnnotation;
 class ProxyInfo;
 class ProxyResolutionService;
 
+// Used to cache <username, password> of proxies. Entries expire ten minutes
+// after creation, a single timer is armed for the oldest entry.
+class NET_EXPORT TorProxyMap {
+ public:
+  TorProxyMap();
+  // |on_empty| runs when the expiry timer removes the last entry, the map may
+  // be destroyed from within the callback.
+  explicit TorProxyMap(base::RepeatingClosure on_empty);
+  TorProxyMap(const TorProxyMap&) = delete;
+  TorProxyMap& operator=(const TorProxyMap&) = delete;
+  ~TorProxyMap();
+
+  std::string Get(const std::string& username);
+  void Erase(const std::string& username);
+  void MaybeExpire(const std::string& username, const base::Time& timestamp);
+  size_t size() const;
+
+  size_t expiry_queue_size_for_testing() const;
+
+ private:
+  // Generate a new base 64-encoded 128 bit random tag
+  static std::string GenerateNewPassword();
+  // Clear expired entries in the queue from the map.
+  void ClearExpiredEntries();
+  // Arms |timer_| for the oldest entry in |expiry_queue_|.
+  void ScheduleNextExpiry();
+  void OnExpiryTimer();
+
+  // username -> <password, creation time>
+  std::map<std::string, std::pair<std::string, base::Time>> map_;
+  // <creation time, username>, ordered so the oldest entry comes first.
+  std::set<std::pair<base::Time, std::string>> expiry_queue_;
+  base::OneShotTimer timer_;
+  base::RepeatingClosure on_empty_;
+};
+
 // Implementation of ProxyConfigService that returns a tor specific result.
 class NET_EXPORT ProxyConfigServiceTor : public net::ProxyConfigService {
  public:
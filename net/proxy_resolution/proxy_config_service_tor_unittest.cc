@@ -8,7 +8,9 @@
 #include <string>
 #include <memory>
 
+#include "base/strings/string_number_conversions.h"
 #include "base/task/single_thread_task_runner.h"
+#include "base/test/bind.h"
 #include "net/base/proxy_server.h"
 #include "net/proxy_resolution/configured_proxy_resolution_service.h"
 #include "net/proxy_resolution/mock_proxy_resolver.h"
@@ -212,4 +214,117 @@ TEST_F(ProxyConfigServiceTorTest, SetProxyAuthorization) {
   EXPECT_EQ(host_port_pair.port(), 5566);
 }
 
+class TorProxyMapTest : public TestWithTaskEnvironment {
+ public:
+  TorProxyMapTest()
+      : TestWithTaskEnvironment(
+            base::test::TaskEnvironment::TimeSource::MOCK_TIME) {}
+};
+
+TEST_F(TorProxyMapTest, Expiry) {
+  TorProxyMap map;
+  const std::string password = map.Get("a.com");
+  EXPECT_FALSE(password.empty());
+  EXPECT_EQ(password, map.Get("a.com"));
+
+  FastForwardBy(base::Minutes(5));
+  const std::string password2 = map.Get("b.com");
+  EXPECT_EQ(password, map.Get("a.com"));
+  EXPECT_EQ(2u, map.size());
+
+  // a.com expires ten minutes after it was created, b.com is still alive.
+  FastForwardBy(base::Minutes(5) + base::Seconds(1));
+  EXPECT_EQ(1u, map.size());
+  EXPECT_EQ(1u, map.expiry_queue_size_for_testing());
+  EXPECT_EQ(password2, map.Get("b.com"));
+
+  // Expired entries get a new password.
+  const std::string password3 = map.Get("a.com");
+  EXPECT_NE(password, password3);
+
+  FastForwardBy(base::Minutes(5));
+  EXPECT_EQ(1u, map.size());
+  EXPECT_EQ(password3, map.Get("a.com"));
+
+  FastForwardBy(base::Minutes(5));
+  EXPECT_EQ(0u, map.size());
+  EXPECT_EQ(0u, map.expiry_queue_size_for_testing());
+}
+
+TEST_F(TorProxyMapTest, MaybeExpire) {
+  TorProxyMap map;
+  const std::string password = map.Get("a.com");
+
+  // Older circuits don't affect newer entries.
+  map.MaybeExpire("a.com", base::Time::Now() - base::Seconds(1));
+  EXPECT_EQ(password, map.Get("a.com"));
+
+  // Re-keying a circuit many times shouldn't leave stale queue entries.
+  std::string last_password = password;
+  for (int i = 0; i < 100; ++i) {
+    FastForwardBy(base::Seconds(1));
+    map.MaybeExpire("a.com", base::Time::Now());
+    const std::string new_password = map.Get("a.com");
+    EXPECT_NE(last_password, new_password);
+    last_password = new_password;
+  }
+  EXPECT_EQ(1u, map.size());
+  EXPECT_EQ(1u, map.expiry_queue_size_for_testing());
+
+  // The re-keyed entry lasts the full ten minutes.
+  FastForwardBy(base::Minutes(10) - base::Seconds(1));
+  EXPECT_EQ(last_password, map.Get("a.com"));
+  FastForwardBy(base::Seconds(2));
+  EXPECT_EQ(0u, map.size());
+
+  map.Get("b.com");
+  map.Erase("b.com");
+  EXPECT_EQ(0u, map.size());
+  EXPECT_EQ(0u, map.expiry_queue_size_for_testing());
+}
+
+TEST_F(TorProxyMapTest, OnEmpty) {
+  int on_empty_count = 0;
+  TorProxyMap map(
+      base::BindLambdaForTesting([&on_empty_count]() { ++on_empty_count; }));
+  map.Get("a.com");
+  FastForwardBy(base::Minutes(1));
+  map.Get("b.com");
+
+  FastForwardBy(base::Minutes(9) + base::Seconds(1));
+  EXPECT_EQ(0, on_empty_count);
+  FastForwardBy(base::Minutes(1));
+  EXPECT_EQ(1, on_empty_count);
+  EXPECT_EQ(0u, map.size());
+}
+
+TEST_F(TorProxyMapTest, ManyIsolationKeys) {
+  constexpr int kNumKeys = 100000;
+  TorProxyMap map;
+
+  for (int i = 0; i < kNumKeys; ++i) {
+    map.Get(base::NumberToString(i) + ".com");
+  }
+  EXPECT_EQ(static_cast<size_t>(kNumKeys), map.size());
+
+  // Re-key every other circuit, the queue must not grow past the map.
+  FastForwardBy(base::Minutes(1));
+  for (int i = 0; i < kNumKeys; i += 2) {
+    const std::string username = base::NumberToString(i) + ".com";
+    map.MaybeExpire(username, base::Time::Now());
+    map.Get(username);
+  }
+  EXPECT_EQ(static_cast<size_t>(kNumKeys), map.size());
+  EXPECT_EQ(map.size(), map.expiry_queue_size_for_testing());
+
+  // Original entries expire together, re-keyed ones a minute later.
+  FastForwardBy(base::Minutes(9) + base::Seconds(1));
+  EXPECT_EQ(static_cast<size_t>(kNumKeys / 2), map.size());
+  EXPECT_EQ(map.size(), map.expiry_queue_size_for_testing());
+
+  FastForwardBy(base::Minutes(1));
+  EXPECT_EQ(0u, map.size());
+  EXPECT_EQ(0u, map.expiry_queue_size_for_testing());
+}
+
 }  // namespace net